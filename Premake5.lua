@@ -72,7 +72,7 @@ include "dependencies/glad"
 include "dependencies/imgui"
 include "dependencies/stbs"
 include "dependencies/spdlog"
-include "dependencies/tinyGLTF"
+include "dependencies/tinygltf"
 
 -- Add all the core dependencies to the project includes
 -- We will reserve the first include directory for the project's source
@@ -86,10 +86,10 @@ ProjIncludes = {
 	"dependencies/stbs",
 	"dependencies/fmod/include",
 	"dependencies/spdlog/include",
-	"dependencies/entt",
+	"dependencies/ENTT",
 	"dependencies/cereal",
 	"dependencies/gzip",
-	"dependencies/tinyGLTF",
+	"dependencies/tinygltf",
 	"dependencies/json",
 	"dependencies/bullet3/include",
 }
@@ -100,10 +100,26 @@ Dependencies = {
 	"Glad",
 	"stbs",
 	"ImGui",
+	"tinyGLTF",
+}
+
+-- Windows system libraries, only linked on Windows builds
+DependenciesWindows = {
 	"opengl32.lib",
 	"imagehlp.lib",
 	"dependencies/gzip/zlib.lib",
-	"tinyGLTF",
+}
+
+-- Linux system libraries for the gmake builds, Bullet is expected to be the installed 3.05 release that matches our headers
+DependenciesLinux = {
+	"BulletDynamics",
+	"BulletCollision",
+	"LinearMath",
+	"GL",
+	"X11",
+	"z",
+	"dl",
+	"pthread",
 }
 
 DependenciesDebug = {
@@ -210,24 +226,36 @@ function CreateDefaultModule(folderName)
 	        defines {
 	            "WINDOWS",
 	        }
+
+	        links(DependenciesWindows)
+
+	    filter "system:linux"
+	        links(DependenciesLinux)
 	        
 	    filter "configurations:Debug"
 	        runtime "Debug"
 	        symbols "on"
 
-	    	links(linkListDebug)
-
 	    filter "configurations:Release"
 	        runtime "Release"
 	        optimize "on"
 
+	    -- The prebuilt libs are MSVC only
+	    filter { "system:windows", "configurations:Debug" }
+	    	links(linkListDebug)
+
+	    filter { "system:windows", "configurations:Release" }
 	    	links(linkListRelease)
         
 end
 
--- Executes an xcopy command to copy all newer files from one folder to another
+-- Executes an xcopy command (or cp off of Windows) to copy all newer files from one folder to another
 function CopyFolder(sourcePath, destPath)
-	os.execute("xcopy /Q /E /Y /I /C \"" .. sourcePath .. "\" \"" .. destPath .. "\"")
+	if os.host() == "windows" then
+		os.execute("xcopy /Q /E /Y /I /C \"" .. sourcePath .. "\" \"" .. destPath .. "\"")
+	else
+		os.execute("mkdir -p \"" .. destPath .. "\" && cp -r \"" .. sourcePath .. "\"/. \"" .. destPath .. "\"")
+	end
 end
 
 if not os.isdir(path.join(rootDir, "shared_assets")) then
@@ -334,6 +362,7 @@ function AddProjects(groupName, folders)
 			local srcdir = path.join(relpath, "src")
 
 			-- These are the commands that get executed after build, but before debugging
+			filter "system:windows"
 			postbuildcommands {
 				-- This step copies over anything in the dll folder to the output directory
 		  		"(xcopy /Q /E /Y /I /C \"%{wks.location}shared_assets\\dll\" \"%{absdir}\")",
@@ -345,6 +374,17 @@ function AddProjects(groupName, folders)
 		  		"(xcopy /Q /E /Y /I /C \"%{resdir}\" \"%{absdir}\")"
 			} 
 
+			-- Same copies for the gmake builds
+			filter "system:linux"
+			postbuildcommands {
+				"mkdir -p \"%{absdir}\" \"%{resdir}\"",
+				"cp -r \"%{wks.location}shared_assets/dll/.\" \"%{absdir}\"",
+				"cp -r \"%{wks.location}shared_assets/res/.\" \"%{absdir}\"",
+				"cp -r \"%{resdir}/.\" \"%{absdir}\""
+			}
+
+			filter {}
+
 			-- Our source files are everything in the src folder
 			files {
 				"%{prj.location}\\src\\**.h",
@@ -366,18 +406,31 @@ function AddProjects(groupName, folders)
 			-- Link to the dependencies and modules
 			links(ProjLinks)
 
-		    buildoptions { "/bigobj" }
-
 			-- This filters for our windows builds
 			filter "system:windows"
 				systemversion "latest"
 
+				buildoptions { "/bigobj" }
+
 				-- Set some defines for the windows builds
 				defines {
 					"GLFW_INCLUDE_NONE", 
 					"WINDOWS"
 				}
 
+				links(DependenciesWindows)
+
+			-- gmake builds on Linux
+			filter "system:linux"
+				defines {
+					"GLFW_INCLUDE_NONE"
+				}
+
+				-- Our static libs depend on each other, so let the linker resolve them in any order
+				linkgroups "On"
+
+				links(DependenciesLinux)
+
 			-- Filters for our debug configurations
 			filter "configurations:Debug"
 				runtime "Debug"
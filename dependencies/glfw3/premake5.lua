@@ -41,5 +41,26 @@ project "GLFW"
             "_GLFW_WIN32",
             "_CRT_SECURE_NO_WARNINGS"
 		}
+
+	filter "system:linux"
+        files
+        {
+            "src/x11_init.c",
+            "src/x11_monitor.c",
+            "src/x11_window.c",
+            "src/xkb_unicode.c",
+            "src/posix_time.c",
+            "src/posix_thread.c",
+            "src/glx_context.c",
+            "src/egl_context.c",
+            "src/osmesa_context.c",
+            "src/linux_joystick.c"
+        }
+
+		defines 
+		{ 
+            "_GLFW_X11"
+		}
+
     filter { "system:windows", "configurations:Release" }
 buildoptions "/MT"
\ No newline at end of file
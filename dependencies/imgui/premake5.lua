@@ -32,8 +32,7 @@ project "ImGui"
 
     links { 
         "GLFW",
-        "Glad",
-        "opengl32.lib"
+        "Glad"
     }
 
     disablewarnings {
@@ -45,6 +44,13 @@ project "ImGui"
         cppdialect "C++17"
         staticruntime "On"
 
+        links {
+            "opengl32.lib"
+        }
+
+    filter "system:linux"
+        cppdialect "C++17"
+
     filter { "system:windows", "configurations:Debug" }
         buildoptions "/MTd"
         
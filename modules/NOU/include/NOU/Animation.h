@@ -0,0 +1,119 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+Animation.h
+Skeletons, animation clips, and the functions for sampling a clip into
+a pose and turning a pose into the joint matrices used for skinning.
+*/
+
+#pragma once
+
+#include "GLM/glm.hpp"
+#include "GLM/gtc/quaternion.hpp"
+
+#include <string>
+#include <vector>
+
+namespace nou
+{
+	//The local translation, rotation and scale of every joint in a skeleton.
+	//Each is kept in its own array (rather than an array of transforms), so
+	//sampling and blending run through contiguous memory.
+	struct Pose
+	{
+		std::vector<glm::vec3> pos;
+		std::vector<glm::quat> rot;
+		std::vector<glm::vec3> scale;
+
+		void Resize(size_t numJoints);
+		size_t Size() const;
+	};
+
+	//A hierarchy of joints, as used by a skinned mesh.
+	//Joints are in the order the mesh's joint indices refer to - which
+	//isn't necessarily parents before children, so we keep that order separately.
+	struct Skeleton
+	{
+		std::vector<std::string> names;
+
+		//Index of each joint's parent joint (-1 for joints at the top of the hierarchy).
+		std::vector<int> parents;
+
+		//Takes a vertex from model space to the joint's local space in the bind pose.
+		std::vector<glm::mat4> inverseBind;
+
+		//Every joint, parents before children - the order to compute global transforms in.
+		std::vector<int> evalOrder;
+
+		//Used for joints that a clip doesn't animate.
+		Pose restPose;
+
+		//Transform applied to joints at the top of the hierarchy (e.g., an
+		//armature node above the skeleton in the model file).
+		glm::mat4 root = glm::mat4(1.0f);
+
+		//The model file's node index for each joint, for binding clips
+		//straight out of the file (see BindToSkeleton).
+		std::vector<int> nodes;
+
+		size_t NumJoints() const;
+		//Returns -1 if there's no joint with that name.
+		int FindJoint(const std::string& name) const;
+
+		//Fills in evalOrder from parents.
+		void BuildEvalOrder();
+	};
+
+	//The keyframes for one property of one joint.
+	//Times are kept in one array and values in another, so finding the
+	//keyframes for a given time only touches the times.
+	struct AnimationChannel
+	{
+		enum class Path
+		{
+			TRANSLATION,
+			ROTATION,
+			SCALE
+		};
+
+		//The joint this channel animates. Clips loaded from a model file
+		//target node indices until they're bound to a skeleton.
+		int target = -1;
+		Path path = Path::TRANSLATION;
+
+		//STEP holds each keyframe until the next, instead of interpolating.
+		bool step = false;
+
+		std::vector<float> times;
+		//Every value is a vec4 (w is unused for translation and scale), so
+		//all three paths share one layout. Rotations are stored (x, y, z, w).
+		std::vector<glm::vec4> values;
+	};
+
+	struct AnimationClip
+	{
+		std::string name;
+		float duration = 0.0f;
+		std::vector<AnimationChannel> channels;
+	};
+
+	//Returns a copy of a clip loaded from a model file, with its channels
+	//targeting the skeleton's joints instead of the file's nodes.
+	//Channels animating nodes that aren't part of the skeleton are dropped.
+	AnimationClip BindToSkeleton(const AnimationClip& clip, const Skeleton& skeleton);
+
+	//Samples a clip at the given time (clamped to the clip's length) into pose.
+	//Joints the clip doesn't animate are left as they are - start from
+	//the skeleton's rest pose to leave them there.
+	//Doesn't allocate, so it's safe to call for many characters in parallel.
+	void SampleClip(const AnimationClip& clip, float time, Pose& pose);
+
+	//Works out the global transform of every joint, then the matrix taking
+	//each vertex from its bind position to its posed position - the joint
+	//palette sent to the vertex shader.
+	//globals and palette are resized to fit the skeleton.
+	void ComputePalette(const Skeleton& skeleton, const Pose& pose,
+						std::vector<glm::mat4>& globals,
+						std::vector<glm::mat4>& palette);
+}
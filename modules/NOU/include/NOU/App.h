@@ -20,10 +20,23 @@ Minimal utility class for GLFW window management.
 #include "GLFW/glfw3.h"
 #include "GLM/glm.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace nou
 {
+	//Frame times (or input latencies) over the last few seconds, in seconds.
+	struct FrameStats
+	{
+		float mean = 0.0f;
+		//99% of samples were at least this quick - catches the hitches a mean hides.
+		float p99 = 0.0f;
+		float worst = 0.0f;
+		int samples = 0;
+	};
+
 	class App
 	{
 		public:
@@ -41,7 +54,47 @@ namespace nou
 		static void StartImgui();
 		static void EndImgui();
 
+		//Runs the main loop until the window closes:
+		//- fixedUpdate gets called at a fixed rate (see SetFixedStep) as many
+		//  times as it takes to catch up - for physics and gameplay that should
+		//  behave the same at any frame rate.
+		//- update gets called once a frame with the frame's delta time.
+		//- render gets called once a frame, with how far we are between the
+		//  last fixed update and the next one (0 to 1), for interpolating.
+		//Any of them can be empty. The frame starts, ends, and waits for the
+		//frame cap, same as calling FrameStart and SwapBuffers yourself.
+		//Input inside fixedUpdate only reflects events up to that update's
+		//point in time (see Input::BeginTick).
+		static void Run(const std::function<void(float)>& fixedUpdate,
+						const std::function<void(float)>& update,
+						const std::function<void(float)>& render);
+
+		//Seconds between fixed updates (default 1/60).
+		static void SetFixedStep(float seconds);
+		static float GetFixedStep();
+
+		//The most frames per second, 0 for no cap. Frames that finish early
+		//sleep for most of the remaining time and spin for the last bit,
+		//since sleeping alone can overshoot by a millisecond or more.
+		static void SetFrameCap(float framesPerSecond);
+
+		//Waits for the display's refresh before swapping when on.
+		static void SetVSync(bool enabled);
+
 		static float GetDeltaTime();
+		//Seconds since Init, from GLFW's integer timer - unlike a float
+		//time, this doesn't lose precision the longer the app runs.
+		static double GetTime();
+
+		//Frame times (start of one frame to the start of the next) over the
+		//last STATS_FRAMES frames.
+		static FrameStats GetFrameStats();
+
+		//How long key and mouse button events took to reach the screen - from
+		//GLFW handing them to us to the end of SwapBuffers for the frame that
+		//first saw them - over the last STATS_FRAMES events.
+		static FrameStats GetInputLatency();
+
 		static bool IsClosing();
 
 		static void SetClearColor(const glm::vec4& clearColor);
@@ -52,9 +105,37 @@ namespace nou
 		//is exposed statically.
 		App() = default;
 
+		static constexpr size_t STATS_FRAMES = 240;
+
+		//Below this, we spin instead of sleeping until the next frame.
+		static constexpr double SPIN_SECONDS = 0.002;
+
+		//The longest frame the fixed update will try to catch up on, so one
+		//long hitch (e.g., loading) doesn't turn into a pile of fixed updates.
+		static constexpr double MAX_CATCH_UP = 0.25;
+
 		static GLFWwindow* m_window;
-		static float m_prevTime;
-		static float m_deltaTime;
 		static bool m_imguiInit;
+
+		static uint64_t m_timerFreq;
+		static uint64_t m_startTicks;
+		static uint64_t m_prevTicks;
+		static float m_deltaTime;
+
+		static double m_fixedStep;
+		static double m_framePeriod;
+		//When the next frame is due to start, with a frame cap.
+		static uint64_t m_nextFrameTicks;
+
+		static std::vector<float> m_frameTimes;
+		static size_t m_frameIndex;
+		static std::vector<float> m_inputLatencies;
+		static size_t m_latencyIndex;
+
+		static double TicksToSeconds(uint64_t ticks);
+		//Adds to a ring of the last STATS_FRAMES samples.
+		static void AddSample(std::vector<float>& samples, size_t& index, float sample);
+		static FrameStats Summarize(const std::vector<float>& samples);
+		static void WaitForFrameCap();
 	};
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+CAnimator.h
+Plays an animation clip on a skeleton, producing the joint palette
+used by CSkinnedMeshRenderer.
+
+As a convention in NOU, we put "C" before a class name to signify
+that we intend the class for use as a component with the ENTT framework.
+*/
+
+#pragma once
+
+#include "Animation.h"
+#include "Entity.h"
+#include "SystemScheduler.h"
+
+namespace nou
+{
+	class CAnimator
+	{
+		public:
+
+		//The skeleton (and any clips played) have to outlive the animator.
+		CAnimator(Entity& owner, const Skeleton& skeleton);
+		virtual ~CAnimator() = default;
+
+		CAnimator(CAnimator&&) = default;
+		CAnimator& operator=(CAnimator&&) = default;
+
+		//Starts a clip from the beginning. The clip has to be bound to
+		//this animator's skeleton (see BindToSkeleton).
+		void Play(const AnimationClip& clip, bool loop = true);
+		void Stop();
+
+		void SetSpeed(float speed);
+		void SetTime(float time);
+		float GetTime() const;
+
+		//Advances the clip and recomputes the joint palette.
+		//Doesn't touch OpenGL or any other component, so animators can be
+		//updated on worker threads (see UpdateAll).
+		void Update(float deltaTime);
+
+		const Skeleton& GetSkeleton() const;
+		const Pose& GetPose() const;
+		//One matrix per joint, in the skeleton's order.
+		const std::vector<glm::mat4>& GetPalette() const;
+
+		//Updates every animator in the world, split across the scheduler's threads.
+		static void UpdateAll(World& world, float deltaTime, SystemScheduler& scheduler);
+
+		protected:
+
+		Entity* m_owner;
+		const Skeleton* m_skeleton;
+		const AnimationClip* m_clip;
+
+		float m_time;
+		float m_speed;
+		bool m_loop;
+
+		Pose m_pose;
+		std::vector<glm::mat4> m_globals;
+		std::vector<glm::mat4> m_palette;
+	};
+}
@@ -12,6 +12,7 @@ that we intend the class for use as a component with the ENTT framework.
 #pragma once
 
 #include "Entity.h"
+#include "GLObjects.h"
 
 namespace nou
 {
@@ -24,6 +25,18 @@ namespace nou
 		//(e.g., for UI, portals, security cameras, etc.)
 		static Entity* current;
 
+		//The uniform block binding point the view-projection matrix goes to
+		//("layout(std140, binding = 0) uniform Camera" in our shaders).
+		static constexpr GLuint UBO_BINDING = 0;
+
+		//Uploads the current camera's view-projection matrix to the camera
+		//uniform block and binds it. The upload is skipped if the matrix hasn't
+		//changed since the last call, so in practice it happens once a frame.
+		static void BindCurrent();
+
+		//Frees the camera uniform buffer - call before the GL context goes away.
+		static void Cleanup();
+
 		CCamera(Entity& owner);
 		virtual ~CCamera();
 
@@ -44,6 +57,9 @@ namespace nou
 
 		protected:
 
+		static std::unique_ptr<UniformBuffer> m_ubo;
+		static glm::mat4 m_uploadedVP;
+
 		Entity* m_owner;
 		glm::mat4 m_view;
 		glm::mat4 m_projection;
@@ -45,14 +45,31 @@ namespace nou
 
 		void SetMesh(const Mesh& mesh);
 		void SetMaterial(Material& mat);
+		Material& GetMaterial() const;
+
+		//Uses the material and binds the current camera, then draws.
+		//Drawing lots of meshes? RenderList does the same with far fewer state changes.
 		virtual void Draw();
 
+		//Draws assuming the material (and camera) are already in use - see RenderList.
+		virtual void DrawInBatch();
+
 		protected:
 
 		Entity* m_owner;
 		Material* m_mat;
 		std::unique_ptr<VertexArray> m_vao;
 
+		//The program we last drew with, and where its per-draw uniforms are.
+		//Locations only change if the program does, so we look them up once.
+		const ShaderProgram* m_program;
+		GLint m_modelLoc;
+		GLint m_normalLoc;
+
+		//Sets the uniforms for drawing, once the material's shader is bound.
+		//Derived renderers can add their own on top.
+		virtual void SetUniforms();
+
 		//Having a default constructor makes it easier for us to inherit from
 		//this class later on (e.g., for a mesh renderer with skeletal animation).
 		//However, it does not make sense to instantiate this class on its own
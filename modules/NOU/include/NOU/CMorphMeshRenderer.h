@@ -0,0 +1,71 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+CMorphMeshRenderer.h
+Mesh renderer for meshes with morph targets (blend shapes) - set the
+weights each frame, and the vertex shader blends the targets.
+
+As a convention in NOU, we put "C" before a class name to signify
+that we intend the class for use as a component with the ENTT framework.
+*/
+
+#pragma once
+
+#include "CMeshRenderer.h"
+
+#include <vector>
+
+namespace nou
+{
+	class CMorphMeshRenderer : public CMeshRenderer
+	{
+		public:
+
+		//The texture unit the morph deltas are bound to - out of the way
+		//of the units materials use for their textures.
+		static constexpr GLuint DELTA_TEXTURE_UNIT = 15;
+
+		//With gpuMorphing, targets are blended by res/shaders/morph.vert,
+		//so changing a weight is just a uniform update.
+		//Without it (or if the mesh has no deltas on the GPU), the mesh's
+		//sparse CPU copy is blended and re-uploaded whenever the weights change -
+		//this needs a mesh that keeps its CPU data.
+		//The mesh has to outlive the renderer.
+		CMorphMeshRenderer(Entity& owner, const Mesh& mesh, Material& mat, bool gpuMorphing = true);
+		virtual ~CMorphMeshRenderer() = default;
+
+		CMorphMeshRenderer(CMorphMeshRenderer&&) = default;
+		CMorphMeshRenderer& operator=(CMorphMeshRenderer&&) = default;
+
+		void SetWeight(size_t target, float weight);
+		void SetWeights(const std::vector<float>& weights);
+		const std::vector<float>& GetWeights() const;
+
+		bool IsGPUMorphing() const;
+
+		virtual void DrawInBatch() override;
+
+		protected:
+
+		const Mesh* m_mesh;
+		std::vector<float> m_weights;
+		bool m_gpuMorphing;
+		bool m_weightsChanged;
+
+		//Only the targets with a non-zero weight, so the shader skips the rest.
+		std::vector<int> m_activeTargets;
+		std::vector<float> m_activeWeights;
+
+		//For the CPU path - the blended vertices, and the buffers they go to.
+		std::vector<glm::vec3> m_morphedVerts;
+		std::vector<glm::vec3> m_morphedNormals;
+		std::unique_ptr<VertexBuffer> m_morphedPosVBO;
+		std::unique_ptr<VertexBuffer> m_morphedNormalVBO;
+
+		virtual void SetUniforms() override;
+
+		//Blends the targets on the CPU and uploads the result.
+		void ApplyOnCPU();
+	};
+}
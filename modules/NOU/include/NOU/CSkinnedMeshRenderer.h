@@ -0,0 +1,45 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+CSkinnedMeshRenderer.h
+Mesh renderer for skinned meshes - the entity's CAnimator supplies
+the joint palette, and the vertex shader does the skinning.
+
+As a convention in NOU, we put "C" before a class name to signify
+that we intend the class for use as a component with the ENTT framework.
+*/
+
+#pragma once
+
+#include "CMeshRenderer.h"
+
+namespace nou
+{
+	class CSkinnedMeshRenderer : public CMeshRenderer
+	{
+		public:
+
+		//The most joints a skeleton can have - this has to match the
+		//size of the joint array in the skinned vertex shader.
+		static constexpr size_t MAX_JOINTS = 128;
+
+		//The uniform block binding point the joint palette goes to
+		//(see res/shaders/skinned.vert).
+		static constexpr GLuint PALETTE_BINDING = 1;
+
+		//The owner needs a CAnimator by the time the renderer is drawn.
+		CSkinnedMeshRenderer(Entity& owner, const Mesh& mesh, Material& mat);
+		virtual ~CSkinnedMeshRenderer() = default;
+
+		CSkinnedMeshRenderer(CSkinnedMeshRenderer&&) = default;
+		CSkinnedMeshRenderer& operator=(CSkinnedMeshRenderer&&) = default;
+
+		//Uploads the animator's palette, then draws as usual.
+		virtual void DrawInBatch() override;
+
+		protected:
+
+		std::unique_ptr<UniformBuffer> m_palette;
+	};
+}
@@ -9,6 +9,7 @@ Minimal and lightly OOP wrapper for the ENTT framework.
 #pragma once
 
 #include "Transform.h"
+#include "World.h"
 
 #include "entt.hpp"
 
@@ -28,10 +29,11 @@ namespace nou
 		//in a hierarchy with transforms storing pointers to parent/child objects.
 		Transform transform;
 
-		static Entity Create();
-		static std::unique_ptr<Entity> Allocate();
+		//Entities go in the default world unless you give them another one.
+		static Entity Create(World& world = World::Default());
+		static std::unique_ptr<Entity> Allocate(World& world = World::Default());
 
-		Entity(entt::entity id);
+		Entity(entt::entity id, World& world = World::Default());
 		Entity(Entity&&) = delete;
 
 		virtual ~Entity();
@@ -39,24 +41,27 @@ namespace nou
 		template<typename T, typename... Args>
 		T& Add(Args&&... args)
 		{
-			return ecs.emplace<T>(m_id, std::forward<Args>(args)...);
+			return m_world->GetRegistry().emplace<T>(m_id, std::forward<Args>(args)...);
 		}
 
 		template<typename T>
 		T& Get()
 		{
-			return ecs.get<T>(m_id);
+			return m_world->GetRegistry().get<T>(m_id);
 		}
 
 		template<typename T>
 		void Remove()
 		{
-			ecs.remove<T>(m_id);
+			m_world->GetRegistry().remove<T>(m_id);
 		}
 
+		World& GetWorld() const;
+		entt::entity GetID() const;
+
 		protected:
 
-		static entt::registry ecs;
+		World* m_world;
 		entt::entity m_id;	
 	};
 }
\ No newline at end of file
@@ -15,6 +15,7 @@ You'll be learning a LOT more about this in your graphics class.
 #include <string>
 
 #include "glad/glad.h"
+#include "GLState.h"
 
 namespace nou
 {
@@ -28,22 +29,23 @@ namespace nou
 	{
 		public:
 
+		//Dynamic buffers are meant to be updated often (e.g., every frame).
+		//They're split into DYNAMIC_REGIONS regions, and each update writes to
+		//the next one, so we never write over data the GPU may still be drawing from.
+		static const int DYNAMIC_REGIONS = 3;
+
 		template<typename T>
 		VertexBuffer(GLint elementLen, const std::vector<T>& data, bool dynamic = false)
+			: VertexBuffer(elementLen, data.data(), (GLsizei)data.size(), sizeof(T), dynamic)
 		{
-			m_elementLen = elementLen;
-			m_startIndex = 0;
-			m_len = 0;
-			m_dynamic = dynamic;
-
-			glGenBuffers(1, &m_id);
-			UpdateData(data);
 		}
 
-		~VertexBuffer()
-		{
-			glDeleteBuffers(1, &m_id);
-		}
+		//Same as above, for data that isn't in a std::vector of one element type
+		//(e.g., interleaved vertices, where one "element" is a whole vertex).
+		//len is the number of elements and elementSize is the size of one in bytes.
+		VertexBuffer(GLint elementLen, const void* data, GLsizei len, GLsizei elementSize, bool dynamic = false);
+
+		~VertexBuffer();
 
 		//This is called a copy constructor.
 		//The delete keyword tells the compiler we don't want to allow this object
@@ -79,21 +81,42 @@ namespace nou
 
 		GLuint GetID() const { return m_id; }
 
+		bool IsDynamic() const { return m_dynamic; }
+
+		//The bytes of storage we have (per region, for dynamic buffers).
+		GLsizeiptr Capacity() const { return m_capacity; }
+
+		//Where the latest data starts in the buffer, in bytes.
+		//Always 0 for static buffers.
+		GLintptr CurrentOffset() const { return m_dynamic ? m_region * m_capacity : 0; }
+
+		//Changes whenever the buffer's ID or current offset does, so that
+		//vertex arrays know to point their attributes at the new data.
+		unsigned int Revision() const { return m_revision; }
+
 		//This uploads the data specified into our OpenGL buffer on the GPU.
+		//If the data fits in what we already have it's written in place,
+		//otherwise the buffer grows - it never shrinks.
 		template<typename T>
 		void UpdateData(const std::vector<T>& data)
 		{
-			m_len = (GLsizei)data.size();
-			m_elementSize = sizeof(T);
-
-			GLenum usage = (m_dynamic) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
-
-			glBindBuffer(GL_ARRAY_BUFFER, m_id);
-			glBufferData(GL_ARRAY_BUFFER, m_len * m_elementSize, &(data[0]), usage);
+			UpdateData(data.data(), (GLsizei)data.size(), sizeof(T));
 		}
 
+		void UpdateData(const void* data, GLsizei len, GLsizei elementSize);
+
 		protected:
 
+		void UpdateStatic(const void* data, GLsizeiptr size);
+		void UpdateDynamic(const void* data, GLsizeiptr size);
+
+		//(Re)creates a dynamic buffer's storage with the given capacity per region.
+		void AllocateDynamic(GLsizeiptr capacity);
+		//Blocks until the GPU is done with a region (normally it already is).
+		void WaitForRegion(int region);
+		//Deletes our fences and unmaps the buffer, if it's mapped.
+		void ReleaseDynamic();
+
 		//The OpenGL ID of our VBO.
 		GLuint m_id;
 
@@ -111,6 +134,144 @@ namespace nou
 
 		//Whether we expect to update this data frequently.
 		bool m_dynamic;
+
+		//How many bytes we've allocated (per region, for dynamic buffers).
+		GLsizeiptr m_capacity;
+
+		//The region of a dynamic buffer the latest data is in, and a fence
+		//for each region marking the last draws that could have read from it.
+		int m_region;
+		GLsync m_fences[DYNAMIC_REGIONS];
+
+		//With GL 4.4+, dynamic buffers stay mapped for their whole life
+		//and we just copy into them. Otherwise this is nullptr.
+		void* m_mapped;
+
+		unsigned int m_revision;
+	};
+
+	//Class for managing OpenGL index (element) buffers.
+	//An index buffer lists which vertices make up each face, so vertices
+	//shared between faces only need to be stored once.
+	//As with VertexBuffer, use these through pointers.
+	class IndexBuffer
+	{
+		public:
+
+		//type is GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT,
+		//and count is the number of indices (not bytes).
+		IndexBuffer(const void* data, GLsizei count, GLenum type);
+		~IndexBuffer();
+
+		IndexBuffer(const IndexBuffer&) = delete;
+
+		//Writes in place if the data fits in what we already have.
+		void UpdateData(const void* data, GLsizei count, GLenum type);
+
+		GLsizei Count() const { return m_count; }
+
+		GLenum Type() const { return m_type; }
+
+		GLuint GetID() const { return m_id; }
+
+		//The size of one index of the given type, in bytes.
+		static GLsizei TypeSize(GLenum type);
+
+		protected:
+
+		//The OpenGL ID of our buffer.
+		GLuint m_id;
+
+		GLsizei m_count;
+		GLenum m_type;
+
+		//How many bytes we've allocated.
+		GLsizeiptr m_capacity;
+	};
+
+	//Class for managing OpenGL Uniform Buffer Objects (UBOs).
+	//A uniform buffer holds a block of uniforms (e.g., an array of matrices)
+	//that shaders read from whichever binding point the buffer is bound to.
+	//Intended to be used via pointers, like the other buffers here.
+	class UniformBuffer
+	{
+		public:
+
+		//size is in bytes - the most UpdateData can write at once.
+		UniformBuffer(GLsizeiptr size);
+		~UniformBuffer();
+
+		UniformBuffer(const UniformBuffer&) = delete;
+
+		//Replaces the start of the buffer with size bytes of data.
+		//Meant for data that changes every frame - the old contents are
+		//orphaned first, so we don't wait on draws still reading them.
+		void UpdateData(const void* data, GLsizeiptr size);
+
+		//Binds the buffer to the given binding point
+		//(matching "layout(binding = N)" in the shader).
+		void Bind(GLuint bindingPoint) const;
+
+		GLsizeiptr Size() const { return m_size; }
+
+		GLuint GetID() const { return m_id; }
+
+		protected:
+
+		GLuint m_id;
+		GLsizeiptr m_size;
+	};
+
+	//Class for managing OpenGL buffer textures.
+	//A buffer texture lets a shader read a (potentially very large) buffer
+	//one texel at a time with texelFetch - handy for per-vertex data that
+	//doesn't fit as vertex attributes, like morph target deltas.
+	class TextureBuffer
+	{
+		public:
+
+		//format is the sized format of each texel (e.g., GL_RGB32F).
+		TextureBuffer(GLenum format, const void* data, GLsizeiptr size);
+		~TextureBuffer();
+
+		TextureBuffer(const TextureBuffer&) = delete;
+
+		//Writes in place if the data fits in what we already have.
+		void UpdateData(const void* data, GLsizeiptr size);
+
+		//Binds the texture to the given texture unit (0, 1, 2...),
+		//for a samplerBuffer uniform set to the same unit.
+		void Bind(GLuint unit) const;
+
+		GLsizeiptr Size() const { return m_size; }
+
+		GLuint GetID() const { return m_id; }
+
+		protected:
+
+		//The buffer holding the data, and the texture shaders read it through.
+		GLuint m_id;
+		GLuint m_texture;
+		GLenum m_format;
+
+		GLsizeiptr m_size;
+		GLsizeiptr m_capacity;
+	};
+
+	//Describes where one attribute lives inside a vertex buffer.
+	//A buffer holding a single attribute is tightly packed (stride 0, offset 0),
+	//while an interleaved buffer has every attribute at its own offset within
+	//each vertex, with the stride being the size of the whole vertex.
+	struct VertexAttribLayout
+	{
+		//The number of components in the attribute (e.g., Vector3 = 3 components).
+		GLint elementLen = 3;
+		GLenum type = GL_FLOAT;
+		GLboolean normalized = GL_FALSE;
+		//Bytes from the start of one vertex to the start of the next (0 = tightly packed).
+		GLsizei stride = 0;
+		//Bytes from the start of the buffer to the attribute in the first vertex.
+		size_t offset = 0;
 	};
 
 	//Class for managing OpenGL Vertex Array Objects (VAOs).
@@ -136,11 +297,13 @@ namespace nou
 			m_drawMode = DrawMode::TRIANGLES;
 			glGenVertexArrays(1, &m_id);
 			m_len = 0;
+			m_ibo = nullptr;
 		}
 
 		~VertexArray()
 		{
 			glDeleteVertexArrays(1, &m_id);
+			GLState::ForgetVertexArray(m_id);
 		}
 
 		/*The functions commented out here would be necessary if you wanted
@@ -227,17 +390,46 @@ namespace nou
 		//buffer specified to be found in the location specified.
 		void BindAttrib(const VertexBuffer& buf, GLuint attribLoc)
 		{
+			VertexAttribLayout layout;
+			layout.elementLen = buf.ElementLength();
+			layout.offset = (size_t)buf.StartIndex() * (size_t)buf.ElementSize();
+
+			BindAttrib(buf, attribLoc, layout);
+		}
+
+		//Same as above, but with the attribute's type, stride and offset spelled out
+		//(e.g., for one attribute out of an interleaved buffer).
+		void BindAttrib(const VertexBuffer& buf, GLuint attribLoc, const VertexAttribLayout& layout)
+		{
+			//Enabling an attribute sticks with the VAO, so rebinding one
+			//(e.g., from RefreshAttribs) doesn't need to do it again.
+			bool enabled = m_vbos.count(attribLoc) > 0;
+
 			m_vbos[attribLoc] = &buf;
+			m_layouts[attribLoc] = layout;
+			m_revisions[attribLoc] = buf.Revision();
 
 			m_len = buf.Length();
 
-			glBindVertexArray(m_id);
-			glEnableVertexAttribArray(attribLoc);
-			glBindBuffer(GL_ARRAY_BUFFER, buf.GetID());
-			glVertexAttribPointer(attribLoc, buf.ElementLength(), 
-								  GL_FLOAT, GL_FALSE, 0,
-								 reinterpret_cast<void*>((long long)buf.StartIndex() *
-														 (long long)buf.ElementSize()));
+			GLState::BindVertexArray(m_id);
+			if (!enabled)
+				glEnableVertexAttribArray(attribLoc);
+			GLState::BindBuffer(GL_ARRAY_BUFFER, buf.GetID());
+			glVertexAttribPointer(attribLoc, layout.elementLen,
+								  layout.type, layout.normalized, layout.stride,
+								  reinterpret_cast<void*>(layout.offset + buf.CurrentOffset()));
+		}
+
+		//Dynamic buffers move their data to a new region on every update
+		//(or to a new buffer, when they grow), so any attributes reading
+		//from them need to follow. Called before drawing.
+		void RefreshAttribs()
+		{
+			for (auto& [attribLoc, buf] : m_vbos)
+			{
+				if (buf->Revision() != m_revisions[attribLoc])
+					BindAttrib(*buf, attribLoc, m_layouts[attribLoc]);
+			}
 		}
 
 		void SetDrawMode(DrawMode drawMode)
@@ -245,11 +437,29 @@ namespace nou
 			m_drawMode = drawMode;
 		}
 
+		//Once set, Draw uses the index buffer to pick which vertices to draw.
+		//Pass in nullptr to go back to drawing the vertices in order.
+		void SetIndexBuffer(const IndexBuffer* ibo)
+		{
+			m_ibo = ibo;
+
+			//The element buffer binding is part of the VAO's state.
+			GLState::BindVertexArray(m_id);
+			GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, (ibo != nullptr) ? ibo->GetID() : 0);
+		}
+
 		void Draw()
 		{
-			m_len = m_vbos.begin()->second->Length();
+			RefreshAttribs();
+			GLState::BindVertexArray(m_id);
 
-			glBindVertexArray(m_id);
+			if (m_ibo != nullptr)
+			{
+				glDrawElements((int)m_drawMode, m_ibo->Count(), m_ibo->Type(), nullptr);
+				return;
+			}
+
+			m_len = m_vbos.begin()->second->Length();
 			glDrawArrays((int)m_drawMode, 0, m_len);
 		}
 
@@ -258,7 +468,8 @@ namespace nou
 			if (count == 0)
 				return;
 
-			glBindVertexArray(m_id);
+			RefreshAttribs();
+			GLState::BindVertexArray(m_id);
 			glDrawElements((int)m_drawMode,
 						   static_cast<GLsizei>(count),
 						   GL_UNSIGNED_INT,
@@ -275,6 +486,13 @@ namespace nou
 
 		//A record of the VBOs associated with this VAO.
 		std::map<GLint, const VertexBuffer*> m_vbos;
+
+		//How each attribute was bound, and the revision of its buffer at the time.
+		std::map<GLint, VertexAttribLayout> m_layouts;
+		std::map<GLint, unsigned int> m_revisions;
+
+		//The index buffer to draw with, if any.
+		const IndexBuffer* m_ibo;
 	};
 }
 
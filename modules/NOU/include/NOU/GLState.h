@@ -0,0 +1,107 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+GLState.h
+Keeps track of the OpenGL state we've set, so binding something
+that's already bound doesn't cost a call into the driver.
+*/
+
+#pragma once
+
+#include "GLM/glm.hpp"
+#include "glad/glad.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace nou
+{
+	//OpenGL remembers what's bound until something else is bound in its place,
+	//but every call still goes through the driver - even one that changes nothing.
+	//Everything that binds or enables things (our GL object wrappers, and anything
+	//else sharing the context) goes through here instead, and calls that wouldn't
+	//change anything are skipped.
+	//There's one OpenGL context per app, so this is all static. Only call it from
+	//the thread that owns the context.
+	class GLState
+	{
+		public:
+
+		struct Stats
+		{
+			//Calls passed on to OpenGL.
+			unsigned int issued = 0;
+			//Calls skipped because the state was already set.
+			unsigned int elided = 0;
+		};
+
+		static void UseProgram(GLuint program);
+		static void BindVertexArray(GLuint vao);
+		static void BindBuffer(GLenum target, GLuint buffer);
+		//Binds to an indexed binding point (e.g., a uniform block binding).
+		//Like glBindBufferBase, this also binds to the target itself.
+		static void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+		//Takes the unit's number (0, 1, 2...), not the GL_TEXTUREn enum.
+		static void ActiveTexture(GLuint unit);
+		//Binds to the active texture unit.
+		static void BindTexture(GLenum target, GLuint texture);
+		//Binds to the given unit without changing the active one (OpenGL 4.5).
+		static void BindTextureUnit(GLuint unit, GLuint texture);
+
+		static void Enable(GLenum cap);
+		static void Disable(GLenum cap);
+		static void BlendFunc(GLenum src, GLenum dst);
+		static void DepthFunc(GLenum func);
+		static void DepthMask(bool write);
+		static void CullFace(GLenum face);
+		static void ClearColor(const glm::vec4& color);
+
+		//Deleting an object unbinds it, so call these after deleting one,
+		//otherwise a new object reusing its ID could look like it's already bound.
+		static void ForgetProgram(GLuint program);
+		static void ForgetVertexArray(GLuint vao);
+		static void ForgetBuffer(GLuint buffer);
+		static void ForgetTexture(GLuint texture);
+
+		//Forgets everything, so the next call of every kind goes through.
+		//Call after code that changes GL state directly (and doesn't put it back).
+		static void Invalidate();
+
+		//Finishes counting calls for this frame. Called when buffers are swapped.
+		static void EndFrame();
+		//The counts for the last full frame.
+		static const Stats& GetFrameStats();
+		//The counts for the frame so far.
+		static const Stats& GetCurrentStats();
+
+		protected:
+
+		//Stands in for state we haven't set (or have lost track of).
+		static constexpr GLuint UNKNOWN = 0xFFFFFFFF;
+
+		//Returns true (and remembers the new value) if the call needs to go through.
+		static bool Change(GLuint& current, GLuint value);
+
+		static GLuint m_program;
+		static GLuint m_vao;
+		static GLuint m_activeUnit;
+		static std::unordered_map<GLenum, GLuint> m_buffers;
+		//Keyed by target in the top 16 bits and the binding index in the bottom 16.
+		static std::unordered_map<GLuint, GLuint> m_indexedBuffers;
+		//The last texture bound to each unit.
+		static std::vector<GLuint> m_textures;
+		static std::unordered_map<GLenum, GLuint> m_caps;
+		static GLuint m_blendSrc;
+		static GLuint m_blendDst;
+		static GLuint m_depthFunc;
+		static GLuint m_depthMask;
+		static GLuint m_cullFace;
+		static glm::vec4 m_clearColor;
+		static bool m_clearColorKnown;
+
+		static Stats m_frame;
+		static Stats m_lastFrame;
+	};
+}
@@ -10,13 +10,18 @@ Helpful reference: https://www.khronos.org/files/gltf20-reference-guide.pdf
 #pragma once
 
 #include "Mesh.h"
+#include "Transform.h"
+#include "Animation.h"
 
 #include <string>
+#include <vector>
+#include <memory>
 
 //Forward declaration of objects defined by the tinyGLTF library.
 namespace tinygltf
 {
 	class Model;
+	class Node;
 	struct Primitive;
 }
 
@@ -30,8 +35,71 @@ namespace nou::GLTF
 		int elementSize;
 	};
 
+	//One node from a glTF scene. Each node's transform is parented to its
+	//parent node's, so the hierarchy from the file is kept as is.
+	struct SceneNode
+	{
+		std::string name;
+		Transform transform;
+
+		//Index into Scene::meshes, or -1 for nodes without a mesh.
+		int mesh = -1;
+
+		//Index into Scene::skeletons for skinned meshes, or -1.
+		int skin = -1;
+
+		//The node's starting morph target weights (from the node, or else
+		//its mesh) - empty if the mesh has no morph targets.
+		std::vector<float> weights;
+
+		//Indices into Scene::nodes (-1 for nodes at the top of the hierarchy).
+		int parent = -1;
+		std::vector<size_t> children;
+	};
+
+	//Everything in a glTF file - every primitive of every mesh, and every node.
+	struct Scene
+	{
+		//meshes[i] holds one Mesh for each primitive of the file's i-th mesh.
+		std::vector<std::vector<std::unique_ptr<Mesh>>> meshes;
+
+		//Nodes are held through pointers so their transforms stay put
+		//(children point at their parents' transforms).
+		std::vector<std::unique_ptr<SceneNode>> nodes;
+
+		//The nodes at the top of the hierarchy in the file's default scene.
+		std::vector<size_t> roots;
+
+		//One skeleton for each of the file's skins.
+		std::vector<Skeleton> skeletons;
+
+		//Every animation in the file. Their channels target indices into nodes -
+		//use BindToSkeleton to get a clip that can be played on a skeleton.
+		std::vector<AnimationClip> animations;
+
+		Scene() = default;
+		~Scene();
+
+		Scene(const Scene&) = delete;
+		Scene& operator=(const Scene&) = delete;
+
+		//Recomputes the global transform of every node.
+		void DoFK();
+		void Clear();
+	};
+
 	//Loads a 3D model into the mesh object given.
+	//All of the primitives of the file's first mesh are flattened into a single
+	//non-indexed mesh - use LoadScene for anything more than that.
 	void LoadMesh(const std::string& filename, Mesh& mesh, bool flipUVY = true);
+
+	//Loads every mesh, primitive, node, skin and animation from a glTF file
+	//into the scene given.
+	//Meshes are interleaved, keep their indices (8, 16 or 32 bit) in an index
+	//buffer, and don't keep a CPU copy of their data. Skinned primitives
+	//also get their joints (as floats) and weights.
+	//Primitives that can't be loaded are skipped with a warning.
+	bool LoadScene(const std::string& filename, Scene& scene, bool flipUVY = true);
 	
 	void DumpErrorsAndWarnings(const std::string& filename,
 							   const std::string& err,
@@ -51,7 +119,33 @@ namespace nou::GLTF
 						  bool& hasNormals, bool& hasUVs,
 						  std::string& err, std::string& warn);
 
+	//Packs one primitive straight from the glTF buffers into an interleaved,
+	//indexed mesh.
+	//JOINTS_0 and WEIGHTS_0 are included if the primitive has both.
+	//Morph targets' position and normal deltas go to the mesh's texture buffer.
+	bool ExtractPrimitive(const tinygltf::Model& gltf, const tinygltf::Primitive& geom,
+						  Mesh& mesh, bool flipUVY,
+						  std::string& err, std::string& warn);
+
+	//Copies a node's translation, rotation and scale (or its matrix) into a transform.
+	void ExtractTransform(const tinygltf::Node& node, Transform& transform);
+
+	//Builds a skeleton from one of the file's skins, using the scene's
+	//(already loaded) nodes for the rest pose and hierarchy.
+	bool ExtractSkeleton(const tinygltf::Model& gltf, size_t skinIndex,
+						 const Scene& scene, Skeleton& skeleton, std::string& err);
+
+	//Reads one of the file's animations. Cubic spline channels keep
+	//only their keyframe values, and are played back linearly.
+	bool ExtractAnimation(const tinygltf::Model& gltf, size_t animIndex,
+						  AnimationClip& clip, std::string& err, std::string& warn);
+
 	//Utility functions for more easily accessing data stored in glTF buffers.
 	int FindAccessor(const tinygltf::Primitive& geom, const std::string& name);
 	DataGetter BuildGetter(const tinygltf::Model& gltf, int accIndex);
+	//Reads one index, whatever its size (1, 2 or 4 bytes).
+	size_t ReadIndex(const DataGetter& indexer, size_t i);
+	//Reads a float VEC3 accessor, sparse or not (morph targets are often sparse,
+	//and may have no data besides the sparse values).
+	bool ReadVec3s(const tinygltf::Model& gltf, int accIndex, std::vector<glm::vec3>& out);
 }
\ No newline at end of file
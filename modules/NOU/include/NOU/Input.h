@@ -3,7 +3,7 @@ NOU Framework - Created for INFR 2310 at Ontario Tech.
 (c) Samantha Stahlke 2020
 
 Input.h
-Simple utility class for managing basic keyboard input.
+Simple utility class for managing basic keyboard and mouse input.
 */
 
 #pragma once
@@ -18,9 +18,21 @@ Simple utility class for managing basic keyboard input.
 #endif
 
 #include "GLFW/glfw3.h"
+#include "GLM/glm.hpp"
+#include "InputQueue.h"
+
+#include <cstdint>
+#include <vector>
 
 namespace nou
 {
+	//GLFW's callbacks don't change any input state directly - they queue
+	//up timestamped events, and FrameStart applies the ones that arrived
+	//since last frame. So a key pressed and released between two frames
+	//still counts as pressed (and released) that frame.
+	//Inside a fixed update (see App::Run), everything here answers for that
+	//update instead of the frame - each one only sees the events up to its
+	//point in time, the same as if it had run exactly on schedule.
 	class Input
 	{
 		public:
@@ -28,36 +40,109 @@ namespace nou
 		~Input() = default;
 
 		static void GLFWInputCallback(GLFWwindow* win, int key, int scancode, int action, int mods);
+		static void GLFWMouseButtonCallback(GLFWwindow* win, int button, int action, int mods);
+		static void GLFWCursorCallback(GLFWwindow* win, double x, double y);
+		static void GLFWScrollCallback(GLFWwindow* win, double x, double y);
 
 		static void Init();
+		//Applies every event queued since the last call (call after glfwPollEvents).
 		static void FrameStart();
 
+		//Starts keeping events for fixed updates. The first BeginTick does
+		//this too, but only after that frame's FrameStart - so call this
+		//before the first frame if fixed updates shouldn't miss its events.
+		static void StartTicking();
+
+		//Starts a fixed update that covers time up to until (GLFW timer ticks),
+		//applying the events up to then. EndTick goes back to answering for the frame.
+		static void BeginTick(uint64_t until);
+		static void EndTick();
+
 		//Returns true if the key is currently pressed.
 		static bool GetKey(int keycode);
 		//Returns true if the key was pressed down this frame.
 		static bool GetKeyDown(int keycode);
 		//Returns true if the key was released this frame.
 		static bool GetKeyUp(int keycode);
+		//When the key was last pressed or released (GLFW timer ticks, 0 if never).
+		//Handy for things that care how late in a frame something happened.
+		static uint64_t GetKeyTime(int keycode);
+
+		//Same as the above, for GLFW_MOUSE_BUTTON_LEFT etc.
+		static bool GetMouseButton(int button);
+		static bool GetMouseButtonDown(int button);
+		static bool GetMouseButtonUp(int button);
+
+		//In screen coordinates, (0, 0) at the top left of the window.
+		static glm::vec2 GetCursorPos();
+		//How far the wheel scrolled this frame.
+		static glm::vec2 GetScroll();
+
+		//When each key and button event applied this frame happened, for
+		//measuring how long it takes input to make it to the screen.
+		static const std::vector<uint64_t>& GetFrameEventTimes();
+
+		//Events lost because the queue filled up between frames.
+		static size_t GetDroppedEvents();
 
 		protected:
 
 		static const int MAX_KEYS = GLFW_KEY_LAST + 1;
+		static const int MAX_BUTTONS = GLFW_MOUSE_BUTTON_LAST + 1;
 
-		enum class KeyFlag
+		//How long events wait for a fixed update to take them.
+		static constexpr double PENDING_SECONDS = 1.0;
+
+		//Both can be set at once, for a quick tap.
+		enum KeyFlag : uint8_t
 		{
 			PASSIVE = 0,
-			PRESSED,
-			RELEASED
+			PRESSED = 1,
+			RELEASED = 2
+		};
+
+		//Everything we know about the keyboard and mouse, as of the
+		//last event applied to it.
+		struct State
+		{
+			//Stores whether a key is down or not.
+			bool keyStates[MAX_KEYS];
+			//Stores any message about what happened to the key (i.e., pressed or released).
+			uint8_t keyFlags[MAX_KEYS];
+			uint64_t keyTimes[MAX_KEYS];
+
+			bool buttonStates[MAX_BUTTONS];
+			uint8_t buttonFlags[MAX_BUTTONS];
+
+			glm::vec2 cursor;
+			glm::vec2 scroll;
+
+			//The keys (and buttons, after MAX_KEYS) with flags set, so clearing
+			//them doesn't mean wiping every key.
+			std::vector<int> flagged;
+
+			void Reset();
+			void Apply(const InputEvent& e);
+			void ClearFlags();
 		};
 
 		//Instantiating this class doesn't make sense, since all our functionality
 		//is exposed statically.
 		Input() = default;
 
-		//Stores whether a key is down or not.
-		static bool m_keyStates[MAX_KEYS];
+		static InputQueue m_queue;
+
+		static State m_frame;
+		static State m_tick;
+		//m_tick during a fixed update, m_frame the rest of the time.
+		static State* m_current;
+
+		//Events the frame has seen but fixed updates haven't yet.
+		//Only kept once fixed updates start asking for them.
+		static std::vector<InputEvent> m_pending;
+		static size_t m_pendingStart;
+		static bool m_ticking;
 
-		//Stores any message about what happened to the key this frame (i.e., pressed or released)
-		static KeyFlag m_keyFlags[MAX_KEYS];
+		static std::vector<uint64_t> m_frameEventTimes;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,78 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+InputQueue.h
+A queue of timestamped input events, filled by GLFW's callbacks.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace nou
+{
+	struct InputEvent
+	{
+		enum class Type
+		{
+			KEY,
+			MOUSE_BUTTON,
+			CURSOR,
+			SCROLL
+		};
+
+		Type type = Type::KEY;
+
+		//The key or mouse button, and GLFW_PRESS/GLFW_RELEASE/GLFW_REPEAT.
+		int code = 0;
+		int action = 0;
+		int mods = 0;
+
+		//The cursor's position, or how far the wheel scrolled.
+		double x = 0.0;
+		double y = 0.0;
+
+		//When GLFW handed us the event, from glfwGetTimerValue.
+		//GLFW doesn't pass on the OS's own timestamps, so this is when
+		//glfwPollEvents got to it - still much finer than a frame.
+		uint64_t ticks = 0;
+	};
+
+	//A fixed-size ring buffer for one thread to push events into and one
+	//thread to pop them from. Neither side ever takes a lock, so it's safe
+	//to fill from callbacks while the game reads it - even if input gets
+	//polled on a thread of its own one day.
+	class InputQueue
+	{
+		public:
+
+		//Comfortably more than a frame's worth, even with a high-rate mouse.
+		static constexpr size_t CAPACITY = 1024;
+
+		InputQueue() = default;
+
+		InputQueue(const InputQueue&) = delete;
+		InputQueue& operator=(const InputQueue&) = delete;
+
+		//Returns false (and counts the event as dropped) if the queue is full.
+		bool Push(const InputEvent& e);
+		//Returns false if there's nothing to pop.
+		bool Pop(InputEvent& e);
+
+		//Events that didn't fit since the queue was created.
+		size_t GetDropped() const;
+
+		protected:
+
+		InputEvent m_events[CAPACITY];
+
+		//Both only ever count up - the slot is the count modulo CAPACITY.
+		//Each is written by one side and read by the other.
+		std::atomic<size_t> m_head = 0;
+		std::atomic<size_t> m_tail = 0;
+		std::atomic<size_t> m_dropped = 0;
+	};
+}
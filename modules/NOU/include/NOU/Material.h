@@ -33,8 +33,16 @@ namespace nou
 		bool AddTexture(const std::string& name, const Texture2D& tex);
 
 		//Should be called by the material's user before drawing the object (i.e., mesh).
+		//Binds the material's shader program, then does the same as Apply.
 		void Use();
 
+		//Sets the material's color and binds its textures, assuming its
+		//program is already bound (e.g., by RenderList, which binds each
+		//program once for every material using it).
+		void Apply();
+
+		const ShaderProgram& GetProgram() const;
+
 		protected:
 
 		//Small utility struct for managing how and where OpenGL will deal with our texture(s).
@@ -50,5 +58,6 @@ namespace nou
 
 		std::vector<TexUniform> m_tex;
 		const ShaderProgram* m_program;
+		GLint m_colorLoc;
 	};
 }
\ No newline at end of file
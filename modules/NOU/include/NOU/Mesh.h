@@ -34,26 +34,138 @@ namespace nou
 			SKIN_WEIGHT = 4
 		};
 
-		Mesh() = default;
+		//How the mesh's data is laid out on the GPU.
+		//SEPARATE gives every attribute its own VBO.
+		//INTERLEAVED packs them all into one VBO, one whole vertex
+		//(position, normal, UV) after another - one buffer to bind and
+		//every attribute of a vertex next to each other in memory.
+		enum class Layout
+		{
+			SEPARATE,
+			INTERLEAVED
+		};
+
+		//One blend shape - how far each vertex moves (and how its normal turns)
+		//at full weight. One delta per vertex, and normals may be left empty.
+		struct MorphTarget
+		{
+			std::vector<glm::vec3> positions;
+			std::vector<glm::vec3> normals;
+		};
+
+		//The most morph targets a mesh can have - this has to match the
+		//size of the arrays in the morph vertex shader.
+		static constexpr size_t MAX_MORPH_TARGETS = 32;
+
+		//If keepCPUData is false, the mesh frees its copy of the vertex data
+		//as soon as it has been uploaded (see ReleaseCPUData).
+		Mesh(Layout layout = Layout::SEPARATE, bool keepCPUData = true);
 		virtual ~Mesh() = default;
 
+		//With an interleaved layout, each of these repacks and re-uploads
+		//the whole vertex buffer - prefer SetVertexData when setting more than one.
 		void SetVerts(const std::vector<glm::vec3>& verts);
 		void SetNormals(const std::vector<glm::vec3>& normals);
 		void SetUVs(const std::vector<glm::vec2>& uvs);
 
+		//Sets every attribute at once (normals and UVs may be empty).
+		//With an interleaved layout this is a single upload.
+		void SetVertexData(const std::vector<glm::vec3>& verts,
+						   const std::vector<glm::vec3>& normals,
+						   const std::vector<glm::vec2>& uvs);
+
+		//Sets already interleaved vertex data (e.g., straight out of a model file),
+		//with attribs saying where each attribute is within a vertex.
+		//Switches the mesh to the interleaved layout. There's no per-attribute
+		//CPU copy of data set this way, so it can't be repacked later.
+		void SetInterleavedData(const void* data, size_t vertexCount, GLsizei stride,
+								const std::map<Attrib, VertexAttribLayout>& attribs);
+
+		//Sets the mesh's indices - type is GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT
+		//or GL_UNSIGNED_INT, and count is the number of indices.
+		//Indexed meshes are drawn with glDrawElements, so shared vertices are only
+		//stored once. Indices are only kept on the GPU.
+		void SetIndices(const void* data, size_t count, GLenum type);
+		void SetIndices(const std::vector<GLuint>& indices);
+
+		//Uploads every target's deltas to a texture buffer, for the vertex shader
+		//to blend (see CMorphMeshRenderer) - animating the weights after that
+		//is just a few uniforms, with no vertex data re-uploaded.
+		//Targets need one delta per vertex, so set the vertices first.
+		//If the mesh keeps its CPU data, a sparse copy of the deltas (just the
+		//vertices each target actually moves) is kept for ApplyMorphWeights.
+		void SetMorphTargets(const std::vector<MorphTarget>& targets);
+		size_t GetMorphTargetCount() const;
+
+		//The deltas on the GPU, as RGB32F texels - texel (target * vertex count + vertex) * 2
+		//is the position delta, and the texel after it is the normal delta.
+		//Returns nullptr if the mesh has no morph targets.
+		const TextureBuffer* GetMorphDeltas() const;
+
+		//The CPU path: blends the targets into verts and normals, starting from
+		//the mesh's own vertices and only touching the vertices each target moves.
+		//Returns false (leaving verts and normals alone) without the CPU data.
+		bool ApplyMorphWeights(const std::vector<float>& weights,
+							   std::vector<glm::vec3>& verts,
+							   std::vector<glm::vec3>& normals) const;
+
+		//Frees the CPU copies of the vertex data. What's already on the GPU
+		//stays, so the mesh can still be drawn - but an interleaved mesh
+		//can't have its attributes set one at a time anymore, since
+		//repacking needs the others.
+		void ReleaseCPUData();
+		bool HasCPUData() const;
+
+		Layout GetLayout() const;
+		//Still valid after the CPU data has been released.
+		size_t GetVertexCount() const;
+
 		//Fetches a vertex buffer associated with the desired attribute.
 		//Used by mesh rendering components to grab the requisite data
 		//associated with this model in OpenGL.
+		//With an interleaved layout, every attribute returns the same buffer.
 		const VertexBuffer* GetVBO(Attrib attrib) const;
 
+		//Where the attribute is within its VBO, for VertexArray::BindAttrib.
+		VertexAttribLayout GetAttribLayout(Attrib attrib) const;
+
+		//The mesh's index buffer, or nullptr if it isn't indexed.
+		const IndexBuffer* GetIBO() const;
+
 		protected:
 
+		Layout m_layout;
+		bool m_keepCPUData;
+		size_t m_vertexCount;
+
 		std::vector<glm::vec3> m_verts;
 		std::vector<glm::vec3> m_normals;
 		std::vector<glm::vec2> m_uvs;
 
 		std::map<Attrib, std::unique_ptr<VertexBuffer>> m_vbo;
 
+		//The single buffer used with an interleaved layout, along with
+		//where each attribute sits inside it.
+		std::unique_ptr<VertexBuffer> m_interleaved;
+		std::map<Attrib, VertexAttribLayout> m_interleavedAttribs;
+
+		std::unique_ptr<IndexBuffer> m_ibo;
+
+		//A morph target with only the vertices it moves.
+		struct SparseMorph
+		{
+			std::vector<GLuint> indices;
+			std::vector<glm::vec3> positions;
+			std::vector<glm::vec3> normals;
+		};
+
+		size_t m_morphCount;
+		std::unique_ptr<TextureBuffer> m_morphDeltas;
+		std::vector<SparseMorph> m_sparseMorphs;
+
+		//Packs whatever attributes we have into m_interleaved.
+		void UploadInterleaved();
+
 		//Sets up a VertexBuffer for the desired attribute.
 		template<typename T>
 		void SetVBO(Attrib attrib, GLint elementLen, const std::vector<T>& data)
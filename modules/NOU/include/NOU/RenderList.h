@@ -0,0 +1,53 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+RenderList.h
+Collects mesh renderers and draws them sorted by shader program and
+material, so each program and material is only bound once per batch.
+*/
+
+#pragma once
+
+#include "CMeshRenderer.h"
+#include "World.h"
+
+#include <vector>
+
+namespace nou
+{
+	class RenderList
+	{
+		public:
+
+		RenderList();
+
+		void Clear();
+
+		//The renderer has to stay put until the list is drawn -
+		//ENTT moves components around as they're added and removed,
+		//so fill the list again each frame rather than keeping it.
+		void Add(CMeshRenderer& renderer);
+
+		//Adds every mesh renderer in the world - plain, skinned and morph.
+		void Gather(World& world = World::Default());
+
+		//Sorts the list, binds the current camera once, then draws everything,
+		//switching programs and materials only when they change.
+		void Draw();
+
+		size_t Size() const;
+
+		//How many times the last Draw had to switch programs and materials,
+		//for checking how well things are batching.
+		int GetProgramBinds() const;
+		int GetMaterialBinds() const;
+
+		protected:
+
+		std::vector<CMeshRenderer*> m_renderers;
+
+		int m_programBinds;
+		int m_materialBinds;
+	};
+}
@@ -10,6 +10,7 @@ Utility classes for managing OpenGL shaders and shader programs.
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "glad/glad.h"
@@ -64,19 +65,42 @@ namespace nou
 
 		//Utility functions for managing uniforms - variables
 		//we send to the shader that persist until we change them.
+		//Every active uniform's location is looked up once, when the program
+		//is linked, so this doesn't have to ask OpenGL each time.
 		GLint GetUniformLoc(const std::string& name) const;
 
 		template<typename T>
-		void SetUniform(const std::string& name, const T& value) const;
+		void SetUniform(const std::string& name, const T& value) const
+		{
+			SetUniform(GetUniformLoc(name), value);
+		}
 
 		template<typename T>
-		void SetUniformArray(const std::string& name, T* data, int len) const;
+		void SetUniformArray(const std::string& name, T* data, int len) const
+		{
+			SetUniformArray(GetUniformLoc(name), data, len);
+		}
+
+		//Same as above, but with a location from GetUniformLoc - for code
+		//that sets the same uniform over and over (e.g., once per draw).
+		template<typename T>
+		void SetUniform(GLint loc, const T& value) const;
+
+		template<typename T>
+		void SetUniformArray(GLint loc, T* data, int len) const;
 
 		protected:
 
 		//The OpenGL ID of our shader program.
 		GLuint m_id;
 
+		//Uniform names and their locations. Names that aren't active uniforms
+		//(e.g., one element of an array) get added the first time they're asked for.
+		mutable std::unordered_map<std::string, GLint> m_uniformLocs;
+
+		//Fills m_uniformLocs with every active uniform.
+		void CacheUniformLocs();
+
 		//The shader program currently in use.
 		static const ShaderProgram* m_current;
 
@@ -0,0 +1,145 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+SystemScheduler.h
+Runs systems in parallel when the components they touch don't overlap.
+*/
+
+#pragma once
+
+#include "World.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nou
+{
+	//The components a system reads and writes.
+	//Two systems in the same world conflict if either one writes something
+	//the other reads or writes - conflicting systems run one after the other
+	//(in the order they were added), everything else can run at the same time.
+	//Entity transforms aren't ECS components, but systems that move entities
+	//can still declare Write<Transform>() so they don't run alongside each other.
+	class SystemAccess
+	{
+		public:
+
+		template<typename... T>
+		SystemAccess& Read()
+		{
+			(Add<T>(m_reads), ...);
+			return *this;
+		}
+
+		template<typename... T>
+		SystemAccess& Write()
+		{
+			(Add<T>(m_writes), ...);
+			return *this;
+		}
+
+		//For systems that create or destroy entities, or use components they
+		//haven't declared. These run alone in their world.
+		SystemAccess& Exclusive();
+
+		bool ConflictsWith(const SystemAccess& other) const;
+
+		//Makes sure the registry has a pool for every declared component.
+		//ENTT creates pools the first time a type is used, even from a const view,
+		//so this has to happen before systems sharing the registry run in parallel.
+		void Prepare(entt::registry& registry) const;
+
+		protected:
+
+		template<typename T>
+		void Add(std::vector<entt::id_type>& ids)
+		{
+			ids.push_back(entt::type_info<T>::id());
+			m_prepare.push_back([](entt::registry& registry) { registry.prepare<T>(); });
+		}
+
+		std::vector<entt::id_type> m_reads;
+		std::vector<entt::id_type> m_writes;
+		std::vector<void(*)(entt::registry&)> m_prepare;
+		bool m_exclusive = false;
+	};
+
+	//Runs a list of systems once per call to Run, on a pool of worker threads.
+	//Systems are grouped into stages - nothing in a stage conflicts with anything
+	//else in it, and each stage waits for the one before it to finish.
+	class SystemScheduler
+	{
+		public:
+
+		typedef std::function<void(World&, float)> SystemFunc;
+
+		//numThreads includes the thread calling Run, 0 uses every hardware thread.
+		SystemScheduler(int numThreads = 0);
+		~SystemScheduler();
+
+		SystemScheduler(const SystemScheduler&) = delete;
+		SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+		//The world has to outlive the scheduler (or at least its systems).
+		void AddSystem(const std::string& name, World& world, const SystemAccess& access, SystemFunc func);
+		void ClearSystems();
+
+		//Runs every system once and returns when they've all finished.
+		void Run(float deltaTime);
+
+		//Splits [0, count) into chunks and runs func(begin, end) on each,
+		//spread across the same worker threads. Returns when every chunk is done.
+		//For data-parallel work inside a system (e.g., animating every character),
+		//so don't call it from a system that's sharing its stage with others.
+		void ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func);
+
+		int GetNumThreads() const;
+		//The systems' names in each stage, for checking what actually runs together.
+		std::vector<std::vector<std::string>> GetStages();
+
+		protected:
+
+		struct System
+		{
+			std::string name;
+			World* world;
+			SystemAccess access;
+			SystemFunc func;
+		};
+
+		typedef std::function<void(size_t)> Job;
+
+		void BuildStages();
+		void RunStage(const std::vector<size_t>& stage);
+		//Runs job(0) to job(count - 1) across every thread and waits for them all.
+		void RunParallel(const Job& job, size_t count);
+		//Takes jobs until there are none left.
+		void RunJobs(const Job& job, size_t count);
+		void WorkerLoop();
+
+		std::vector<System> m_systems;
+		//Indices into m_systems, rebuilt whenever a system is added.
+		std::vector<std::vector<size_t>> m_stages;
+		bool m_stagesDirty;
+		float m_deltaTime;
+
+		std::vector<std::thread> m_workers;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		//What the workers are currently running, nullptr when idle.
+		const Job* m_job;
+		size_t m_jobCount;
+		size_t m_generation;
+		int m_activeWorkers;
+		std::atomic<size_t> m_nextJob;
+		std::atomic<size_t> m_remainingJobs;
+		bool m_quit;
+	};
+}
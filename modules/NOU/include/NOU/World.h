@@ -0,0 +1,40 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+World.h
+An independent ECS world, each with its own registry.
+*/
+
+#pragma once
+
+#include "entt.hpp"
+
+namespace nou
+{
+	//Entities in one world can't see (or clobber) components in another,
+	//so scenes, tool previews and tests can each have their own.
+	//Worlds are also what lets the SystemScheduler run systems in parallel -
+	//systems in different worlds never touch the same registry.
+	class World
+	{
+		public:
+
+		World() = default;
+		~World() = default;
+
+		//Entities hold a pointer to their world, so worlds stay put.
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		entt::registry& GetRegistry();
+		const entt::registry& GetRegistry() const;
+
+		//The world entities are created in when you don't give them one.
+		static World& Default();
+
+		protected:
+
+		entt::registry m_registry;
+	};
+}
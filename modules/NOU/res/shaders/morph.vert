@@ -0,0 +1,62 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+morph.vert
+Vertex shader.
+Blends the active morph targets into each vertex, then passes world vertex
+position, transformed normal direction, and UV coordinates to the fragment
+shader (same outputs as texturedlit.vert).
+*/
+
+#version 420 core
+
+//Has to match Mesh::MAX_MORPH_TARGETS.
+#define MAX_MORPH_TARGETS 32
+
+uniform mat4 model;
+uniform mat3 normal;
+//Set once per frame for every shader, by CCamera::BindCurrent.
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 viewproj;
+};
+
+//Every target's deltas, two texels per vertex (position, then normal).
+uniform samplerBuffer morphDeltas;
+uniform int morphVertexCount;
+
+//Only the targets with a non-zero weight are passed in.
+uniform int morphCount;
+uniform int morphTargets[MAX_MORPH_TARGETS];
+uniform float morphWeights[MAX_MORPH_TARGETS];
+
+layout(location = 0) in vec4 inPos;
+layout(location = 1) in vec3 inNorm;
+layout(location = 2) in vec2 inUV;
+
+layout(location = 0) out vec4 outPos;
+layout(location = 1) out vec3 outNorm;
+layout(location = 2) out vec2 outUV;
+
+void main()
+{
+    vec3 pos = inPos.xyz;
+    vec3 norm = inNorm;
+
+    //gl_VertexID is the index being drawn, so this works with or without
+    //an index buffer.
+    for (int i = 0; i < morphCount; ++i)
+    {
+        int texel = (morphTargets[i] * morphVertexCount + gl_VertexID) * 2;
+
+        pos += morphWeights[i] * texelFetch(morphDeltas, texel).xyz;
+        norm += morphWeights[i] * texelFetch(morphDeltas, texel + 1).xyz;
+    }
+
+    outNorm = normal * norm;
+    outPos = model * vec4(pos, 1.0);
+    outUV = inUV;
+
+    gl_Position = viewproj * outPos;
+}
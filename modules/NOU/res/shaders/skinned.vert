@@ -0,0 +1,57 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+skinned.vert
+Vertex shader.
+Skins each vertex with up to four joints from the joint palette, then
+passes world vertex position, transformed normal direction, and UV coordinates
+to the fragment shader (same outputs as texturedlit.vert).
+*/
+
+#version 420 core
+
+//Has to match CSkinnedMeshRenderer::MAX_JOINTS.
+#define MAX_JOINTS 128
+
+uniform mat4 model;
+uniform mat3 normal;
+//Set once per frame for every shader, by CCamera::BindCurrent.
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 viewproj;
+};
+
+layout(std140, binding = 1) uniform JointPalette
+{
+    mat4 joints[MAX_JOINTS];
+};
+
+layout(location = 0) in vec4 inPos;
+layout(location = 1) in vec3 inNorm;
+layout(location = 2) in vec2 inUV;
+//Joint indices are stored as floats, so they go through the same
+//vertex buffer as everything else.
+layout(location = 3) in vec4 inJoints;
+layout(location = 4) in vec4 inWeights;
+
+layout(location = 0) out vec4 outPos;
+layout(location = 1) out vec3 outNorm;
+layout(location = 2) out vec2 outUV;
+
+void main()
+{
+    ivec4 j = ivec4(inJoints + 0.5);
+
+    mat4 skin = inWeights.x * joints[j.x] +
+                inWeights.y * joints[j.y] +
+                inWeights.z * joints[j.z] +
+                inWeights.w * joints[j.w];
+
+    //Assumes joints don't scale unevenly - fine for character rigs.
+    outNorm = normal * (mat3(skin) * inNorm);
+    outPos = model * (skin * inPos);
+    outUV = inUV;
+
+    gl_Position = viewproj * outPos;
+}
@@ -12,7 +12,11 @@ to the fragment shader.
 
 uniform mat4 model;
 uniform mat3 normal;
-uniform mat4 viewproj;
+//Set once per frame for every shader, by CCamera::BindCurrent.
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 viewproj;
+};
 
 layout(location = 0) in vec4 inPos;
 layout(location = 1) in vec3 inNorm;
@@ -15,7 +15,11 @@ layout(location = 2) in vec2 inUV;
 layout(location = 2) out vec2 outUV;
 
 uniform mat4 model;
-uniform mat4 viewproj;
+//Set once per frame for every shader, by CCamera::BindCurrent.
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 viewproj;
+};
 
 void main()
 {
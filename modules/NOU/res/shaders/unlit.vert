@@ -12,7 +12,11 @@ Passes world vertex position to the fragment shader.
 layout(location = 0) in vec4 inPos;
 
 uniform mat4 model;
-uniform mat4 viewproj;
+//Set once per frame for every shader, by CCamera::BindCurrent.
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 viewproj;
+};
 
 void main()
 {
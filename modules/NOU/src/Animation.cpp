@@ -0,0 +1,181 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+Animation.cpp
+Skeletons, animation clips, and the functions for sampling a clip into
+a pose and turning a pose into the joint matrices used for skinning.
+*/
+
+#include "NOU/Animation.h"
+
+#include <algorithm>
+
+namespace nou
+{
+	namespace
+	{
+		//Finds the value of a channel at the given time.
+		glm::vec4 SampleChannel(const AnimationChannel& channel, float time)
+		{
+			const std::vector<float>& times = channel.times;
+
+			if (time <= times.front())
+				return channel.values.front();
+
+			if (time >= times.back())
+				return channel.values.back();
+
+			//The first keyframe after time - there's always one before it too,
+			//since we've handled times outside the channel above.
+			size_t next = std::upper_bound(times.begin(), times.end(), time) - times.begin();
+			size_t prev = next - 1;
+
+			if (channel.step)
+				return channel.values[prev];
+
+			float t = (time - times[prev]) / (times[next] - times[prev]);
+			glm::vec4 a = channel.values[prev];
+			glm::vec4 b = channel.values[next];
+
+			if (channel.path == AnimationChannel::Path::ROTATION)
+			{
+				//Normalized lerp along the shorter arc. Keyframes are close enough
+				//together that this is hard to tell apart from a slerp, and it's
+				//the same few multiply-adds as every other path.
+				if (glm::dot(a, b) < 0.0f)
+					b = -b;
+
+				return glm::normalize(glm::mix(a, b, t));
+			}
+
+			return glm::mix(a, b, t);
+		}
+	}
+
+	void Pose::Resize(size_t numJoints)
+	{
+		pos.resize(numJoints, glm::vec3(0.0f));
+		rot.resize(numJoints, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+		scale.resize(numJoints, glm::vec3(1.0f));
+	}
+
+	size_t Pose::Size() const
+	{
+		return pos.size();
+	}
+
+	size_t Skeleton::NumJoints() const
+	{
+		return parents.size();
+	}
+
+	int Skeleton::FindJoint(const std::string& name) const
+	{
+		for (size_t i = 0; i < names.size(); ++i)
+		{
+			if (names[i] == name)
+				return (int)i;
+		}
+
+		return -1;
+	}
+
+	void Skeleton::BuildEvalOrder()
+	{
+		size_t numJoints = NumJoints();
+		std::vector<int> depth(numJoints, 0);
+
+		for (size_t i = 0; i < numJoints; ++i)
+		{
+			//Guard against a broken file with a loop in its hierarchy.
+			for (int p = parents[i]; p != -1 && depth[i] <= (int)numJoints; p = parents[p])
+				++depth[i];
+		}
+
+		evalOrder.resize(numJoints);
+
+		for (size_t i = 0; i < numJoints; ++i)
+			evalOrder[i] = (int)i;
+
+		//Every parent is shallower than its children, so it comes first.
+		std::stable_sort(evalOrder.begin(), evalOrder.end(),
+						 [&](int a, int b) { return depth[a] < depth[b]; });
+	}
+
+	AnimationClip BindToSkeleton(const AnimationClip& clip, const Skeleton& skeleton)
+	{
+		AnimationClip bound;
+		bound.name = clip.name;
+		bound.duration = clip.duration;
+
+		for (const AnimationChannel& channel : clip.channels)
+		{
+			auto it = std::find(skeleton.nodes.begin(), skeleton.nodes.end(), channel.target);
+
+			if (it == skeleton.nodes.end())
+				continue;
+
+			bound.channels.push_back(channel);
+			bound.channels.back().target = (int)(it - skeleton.nodes.begin());
+		}
+
+		return bound;
+	}
+
+	void SampleClip(const AnimationClip& clip, float time, Pose& pose)
+	{
+		for (const AnimationChannel& channel : clip.channels)
+		{
+			if (channel.times.empty() || channel.target < 0 || channel.target >= (int)pose.Size())
+				continue;
+
+			glm::vec4 value = SampleChannel(channel, time);
+
+			switch (channel.path)
+			{
+				case AnimationChannel::Path::TRANSLATION:
+					pose.pos[channel.target] = glm::vec3(value);
+					break;
+
+				case AnimationChannel::Path::ROTATION:
+					pose.rot[channel.target] = glm::quat(value.w, value.x, value.y, value.z);
+					break;
+
+				case AnimationChannel::Path::SCALE:
+					pose.scale[channel.target] = glm::vec3(value);
+					break;
+			}
+		}
+	}
+
+	void ComputePalette(const Skeleton& skeleton, const Pose& pose,
+						std::vector<glm::mat4>& globals,
+						std::vector<glm::mat4>& palette)
+	{
+		size_t numJoints = skeleton.NumJoints();
+
+		globals.resize(numJoints);
+		palette.resize(numJoints);
+
+		if (pose.Size() < numJoints)
+			return;
+
+		for (int joint : skeleton.evalOrder)
+		{
+			//Translation * rotation * scale, built directly rather than
+			//multiplying three matrices together.
+			glm::mat3 rotation = glm::mat3_cast(pose.rot[joint]);
+			const glm::vec3& scale = pose.scale[joint];
+
+			glm::mat4 local = glm::mat4(glm::vec4(rotation[0] * scale.x, 0.0f),
+										glm::vec4(rotation[1] * scale.y, 0.0f),
+										glm::vec4(rotation[2] * scale.z, 0.0f),
+										glm::vec4(pose.pos[joint], 1.0f));
+
+			int parent = skeleton.parents[joint];
+			globals[joint] = ((parent == -1) ? skeleton.root : globals[parent]) * local;
+			palette[joint] = globals[joint] * skeleton.inverseBind[joint];
+		}
+	}
+}
@@ -8,6 +8,8 @@ Minimal utility class for GLFW window management.
 
 #include "NOU/App.h"
 #include "NOU/Input.h"
+#include "NOU/CCamera.h"
+#include "NOU/GLState.h"
 
 #define IMGUI_IMPL_OPENGL_LOADER_GLAD
 #include "imgui.h"
@@ -16,15 +18,30 @@ Minimal utility class for GLFW window management.
 
 #include "glad/glad.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 namespace nou
 {
 	GLFWwindow* App::m_window = nullptr;
-	float App::m_prevTime = 0.0f;
-	float App::m_deltaTime = 0.0f;
 	bool App::m_imguiInit = false;
 
+	uint64_t App::m_timerFreq = 1;
+	uint64_t App::m_startTicks = 0;
+	uint64_t App::m_prevTicks = 0;
+	float App::m_deltaTime = 0.0f;
+
+	double App::m_fixedStep = 1.0 / 60.0;
+	double App::m_framePeriod = 0.0;
+	uint64_t App::m_nextFrameTicks = 0;
+
+	std::vector<float> App::m_frameTimes;
+	size_t App::m_frameIndex = 0;
+	std::vector<float> App::m_inputLatencies;
+	size_t App::m_latencyIndex = 0;
+
 	//Creates our GLFW window.
 	void App::Init(const std::string& name, int width, int height)
 	{
@@ -57,8 +74,12 @@ namespace nou
 		glfwMakeContextCurrent(m_window);
 		
 		//This tells GLFW what function we'd like to use to process its input messages.
-		//(In our case, a static function in the Input class.)
+		//(In our case, static functions in the Input class.)
+		Input::Init();
 		glfwSetKeyCallback(m_window, Input::GLFWInputCallback);
+		glfwSetMouseButtonCallback(m_window, Input::GLFWMouseButtonCallback);
+		glfwSetCursorPosCallback(m_window, Input::GLFWCursorCallback);
+		glfwSetScrollCallback(m_window, Input::GLFWScrollCallback);
 
 		//This initializes OpenGL via GLAD.
 		if (gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) == 0)
@@ -75,21 +96,27 @@ namespace nou
 		//This one makes it so that we can't draw anything on top of something 
 		//that should be in front of it (e.g., our background doesn't accidentally
 		//get drawn on top of our main character).
-		glEnable(GL_DEPTH_TEST);
+		GLState::Enable(GL_DEPTH_TEST);
 
 		//This one makes it so that we won't draw the "back faces" of an object.
 		//(In other words, the stuff we wouldn't be able to see for opaque objects anyway.)
-		glEnable(GL_CULL_FACE);
+		GLState::Enable(GL_CULL_FACE);
 
 		//This one controls how semi-transparent objects will be blended.
 		//If you start playing with alpha textures and things don't look right,
 		//or you want a specific behaviour, you'll want to play with these parameters.
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		GLState::Enable(GL_BLEND);
+		GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		
 		//This initializes the background colour we want to use to clear our window.
 		//This default is black.
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		GLState::ClearColor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+		//Start the clock from here, so the first frame's delta time is sensible.
+		m_timerFreq = glfwGetTimerFrequency();
+		m_startTicks = glfwGetTimerValue();
+		m_prevTicks = m_startTicks;
+		m_nextFrameTicks = m_startTicks;
 	}
 
 	void App::InitImgui()
@@ -122,6 +149,9 @@ namespace nou
 
 	void App::Cleanup()
 	{
+		//Has to go while we still have a GL context.
+		CCamera::Cleanup();
+
 		if (m_imguiInit)
 		{
 			ImGui_ImplOpenGL3_Shutdown();
@@ -135,19 +165,25 @@ namespace nou
 
 	void App::Tick()
 	{
-		float time = static_cast<float>(glfwGetTime());
-		m_deltaTime = time - m_prevTime;
-		m_prevTime = time;
+		//Integer ticks, so the difference is exact however long we've been running.
+		uint64_t ticks = glfwGetTimerValue();
+		m_deltaTime = static_cast<float>(TicksToSeconds(ticks - m_prevTicks));
+		m_prevTicks = ticks;
+
+		AddSample(m_frameTimes, m_frameIndex, m_deltaTime);
 	}
 
 	void App::FrameStart()
 	{
-		//Calculate our delta time for this frame.
+		//Input polling. GLFW calls our input callbacks from in here.
+		glfwPollEvents();
+
+		//Calculate our delta time for this frame - after polling, so every
+		//event we just got happened before the frame's start time.
 		Tick();
 
-		//Input polling.
+		//Apply the events we just got.
 		Input::FrameStart();
-		glfwPollEvents();
 
 		//Clear our window.
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -157,6 +193,165 @@ namespace nou
 	{
 		//This will post the results of all our draw calls to the window.
 		glfwSwapBuffers(m_window);
+		GLState::EndFrame();
+
+		//This is when the frame is handed off to be shown (give or take the
+		//driver's queue), so it's as close as we can get to input-to-screen time.
+		uint64_t presented = glfwGetTimerValue();
+
+		for (uint64_t eventTicks : Input::GetFrameEventTimes())
+			AddSample(m_inputLatencies, m_latencyIndex, static_cast<float>(TicksToSeconds(presented - eventTicks)));
+
+		WaitForFrameCap();
+	}
+
+	void App::Run(const std::function<void(float)>& fixedUpdate,
+				  const std::function<void(float)>& update,
+				  const std::function<void(float)>& render)
+	{
+		double accumulator = 0.0;
+
+		//So the first frame's fixed updates get its events too.
+		Input::StartTicking();
+
+		while (!IsClosing())
+		{
+			FrameStart();
+
+			accumulator += std::min((double)m_deltaTime, MAX_CATCH_UP);
+
+			while (accumulator >= m_fixedStep)
+			{
+				accumulator -= m_fixedStep;
+
+				//Whatever's left in the accumulator is time this update doesn't
+				//reach yet, so it only gets the input from before that.
+				uint64_t until = m_prevTicks - static_cast<uint64_t>(accumulator * m_timerFreq);
+
+				Input::BeginTick(until);
+
+				if (fixedUpdate)
+					fixedUpdate(static_cast<float>(m_fixedStep));
+
+				Input::EndTick();
+			}
+
+			if (update)
+				update(m_deltaTime);
+
+			if (render)
+				render(static_cast<float>(accumulator / m_fixedStep));
+
+			SwapBuffers();
+		}
+	}
+
+	void App::SetFixedStep(float seconds)
+	{
+		if (seconds > 0.0f)
+			m_fixedStep = seconds;
+	}
+
+	float App::GetFixedStep()
+	{
+		return static_cast<float>(m_fixedStep);
+	}
+
+	void App::SetFrameCap(float framesPerSecond)
+	{
+		m_framePeriod = (framesPerSecond > 0.0f) ? 1.0 / framesPerSecond : 0.0;
+		m_nextFrameTicks = glfwGetTimerValue();
+	}
+
+	void App::SetVSync(bool enabled)
+	{
+		glfwSwapInterval(enabled ? 1 : 0);
+	}
+
+	double App::GetTime()
+	{
+		return TicksToSeconds(glfwGetTimerValue() - m_startTicks);
+	}
+
+	FrameStats App::GetFrameStats()
+	{
+		return Summarize(m_frameTimes);
+	}
+
+	FrameStats App::GetInputLatency()
+	{
+		return Summarize(m_inputLatencies);
+	}
+
+	void App::AddSample(std::vector<float>& samples, size_t& index, float sample)
+	{
+		if (samples.size() < STATS_FRAMES)
+			samples.push_back(sample);
+		else
+			samples[index] = sample;
+
+		index = (index + 1) % STATS_FRAMES;
+	}
+
+	FrameStats App::Summarize(const std::vector<float>& samples)
+	{
+		FrameStats stats;
+
+		if (samples.empty())
+			return stats;
+
+		std::vector<float> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		double total = 0.0;
+
+		for (float frameTime : sorted)
+			total += frameTime;
+
+		stats.samples = (int)sorted.size();
+		stats.mean = static_cast<float>(total / sorted.size());
+		stats.p99 = sorted[std::min(sorted.size() - 1, (sorted.size() * 99) / 100)];
+		stats.worst = sorted.back();
+
+		return stats;
+	}
+
+	double App::TicksToSeconds(uint64_t ticks)
+	{
+		return static_cast<double>(ticks) / static_cast<double>(m_timerFreq);
+	}
+
+	void App::WaitForFrameCap()
+	{
+		if (m_framePeriod <= 0.0)
+			return;
+
+		uint64_t periodTicks = static_cast<uint64_t>(m_framePeriod * m_timerFreq);
+		uint64_t now = glfwGetTimerValue();
+
+		//Frames are due on a fixed schedule, so a frame that's a little late
+		//doesn't push every frame after it back. If we've fallen a whole frame
+		//behind, start the schedule over rather than rushing to catch up.
+		m_nextFrameTicks += periodTicks;
+
+		if (now > m_nextFrameTicks + periodTicks)
+			m_nextFrameTicks = now;
+
+		uint64_t spinTicks = static_cast<uint64_t>(SPIN_SECONDS * m_timerFreq);
+
+		//Sleeping gives the CPU back (and saves battery), but can wake up late,
+		//so we sleep in short naps until we're close, then spin the rest of the way.
+		while (now + spinTicks < m_nextFrameTicks)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			now = glfwGetTimerValue();
+		}
+
+		while (now < m_nextFrameTicks)
+		{
+			std::this_thread::yield();
+			now = glfwGetTimerValue();
+		}
 	}
 
 	void App::StartImgui()
@@ -195,6 +390,6 @@ namespace nou
 
 	void App::SetClearColor(const glm::vec4& clearColor)
 	{
-		glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+		GLState::ClearColor(clearColor);
 	}
 }
@@ -0,0 +1,112 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+CAnimator.cpp
+Plays an animation clip on a skeleton, producing the joint palette
+used by CSkinnedMeshRenderer.
+
+As a convention in NOU, we put "C" before a class name to signify
+that we intend the class for use as a component with the ENTT framework.
+*/
+
+#include "NOU/CAnimator.h"
+
+#include <cmath>
+
+namespace nou
+{
+	CAnimator::CAnimator(Entity& owner, const Skeleton& skeleton)
+	{
+		m_owner = &owner;
+		m_skeleton = &skeleton;
+		m_clip = nullptr;
+
+		m_time = 0.0f;
+		m_speed = 1.0f;
+		m_loop = true;
+
+		//Start out in the rest pose, so we have a palette to draw with
+		//before any clip is played.
+		m_pose = skeleton.restPose;
+		ComputePalette(*m_skeleton, m_pose, m_globals, m_palette);
+	}
+
+	void CAnimator::Play(const AnimationClip& clip, bool loop)
+	{
+		m_clip = &clip;
+		m_loop = loop;
+		m_time = 0.0f;
+	}
+
+	void CAnimator::Stop()
+	{
+		m_clip = nullptr;
+	}
+
+	void CAnimator::SetSpeed(float speed)
+	{
+		m_speed = speed;
+	}
+
+	void CAnimator::SetTime(float time)
+	{
+		m_time = time;
+	}
+
+	float CAnimator::GetTime() const
+	{
+		return m_time;
+	}
+
+	void CAnimator::Update(float deltaTime)
+	{
+		if (m_clip == nullptr)
+			return;
+
+		m_time += deltaTime * m_speed;
+
+		float duration = m_clip->duration;
+
+		if (m_loop && duration > 0.0f)
+		{
+			m_time = std::fmod(m_time, duration);
+
+			if (m_time < 0.0f)
+				m_time += duration;
+		}
+
+		SampleClip(*m_clip, m_time, m_pose);
+		ComputePalette(*m_skeleton, m_pose, m_globals, m_palette);
+	}
+
+	const Skeleton& CAnimator::GetSkeleton() const
+	{
+		return *m_skeleton;
+	}
+
+	const Pose& CAnimator::GetPose() const
+	{
+		return m_pose;
+	}
+
+	const std::vector<glm::mat4>& CAnimator::GetPalette() const
+	{
+		return m_palette;
+	}
+
+	void CAnimator::UpdateAll(World& world, float deltaTime, SystemScheduler& scheduler)
+	{
+		auto view = world.GetRegistry().view<CAnimator>();
+
+		//ENTT keeps every animator in one contiguous array, so each thread
+		//gets a run of neighbouring animators to work through.
+		CAnimator* animators = view.raw();
+
+		scheduler.ParallelFor(view.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				animators[i].Update(deltaTime);
+		});
+	}
+}
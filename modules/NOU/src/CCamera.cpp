@@ -16,6 +16,35 @@ that we intend the class for use as a component with the ENTT framework.
 namespace nou
 {
 	Entity* CCamera::current = nullptr;
+	std::unique_ptr<UniformBuffer> CCamera::m_ubo = nullptr;
+	glm::mat4 CCamera::m_uploadedVP = glm::mat4(1.0f);
+
+	void CCamera::BindCurrent()
+	{
+		if (current == nullptr)
+			return;
+
+		const glm::mat4& vp = current->Get<CCamera>().GetVP();
+
+		if (m_ubo == nullptr)
+		{
+			m_ubo = std::make_unique<UniformBuffer>(sizeof(glm::mat4));
+			m_ubo->UpdateData(&vp, sizeof(glm::mat4));
+			m_uploadedVP = vp;
+		}
+		else if (vp != m_uploadedVP)
+		{
+			m_ubo->UpdateData(&vp, sizeof(glm::mat4));
+			m_uploadedVP = vp;
+		}
+
+		m_ubo->Bind(UBO_BINDING);
+	}
+
+	void CCamera::Cleanup()
+	{
+		m_ubo = nullptr;
+	}
 
 	CCamera::CCamera(Entity& owner)
 	{
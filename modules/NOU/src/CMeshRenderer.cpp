@@ -20,6 +20,9 @@ namespace nou
 		m_owner = nullptr;
 		m_mat = nullptr;
 		m_vao = nullptr;
+		m_program = nullptr;
+		m_modelLoc = -1;
+		m_normalLoc = -1;
 	}
 
 	CMeshRenderer::CMeshRenderer(Entity& owner, 
@@ -29,6 +32,9 @@ namespace nou
 		m_owner = &owner;
 		m_mat = &mat;
 		m_vao = std::make_unique<VertexArray>();
+		m_program = nullptr;
+		m_modelLoc = -1;
+		m_normalLoc = -1;
 		SetMesh(mesh);	
 	}
 
@@ -38,16 +44,21 @@ namespace nou
 	//the data needed to draw our 3D model.
 	void CMeshRenderer::SetMesh(const Mesh& mesh)
 	{
-		const VertexBuffer* vbo;
+		//With an interleaved mesh these are all the same buffer, just at
+		//different offsets within each vertex.
+		//Joints and weights are only there on skinned meshes.
+		for (Mesh::Attrib attrib : { Mesh::Attrib::POSITION, Mesh::Attrib::NORMAL, Mesh::Attrib::UV,
+									 Mesh::Attrib::JOINT_INFLUENCE, Mesh::Attrib::SKIN_WEIGHT })
+		{
+			const VertexBuffer* vbo = mesh.GetVBO(attrib);
 
-		if ((vbo = mesh.GetVBO(Mesh::Attrib::POSITION)) != nullptr)
-			m_vao->BindAttrib(*vbo, (GLint)Mesh::Attrib::POSITION);
+			if (vbo != nullptr)
+				m_vao->BindAttrib(*vbo, (GLint)attrib, mesh.GetAttribLayout(attrib));
+		}
 
-		if ((vbo = mesh.GetVBO(Mesh::Attrib::NORMAL)) != nullptr)
-			m_vao->BindAttrib(*vbo, (GLint)Mesh::Attrib::NORMAL);
-
-		if ((vbo = mesh.GetVBO(Mesh::Attrib::UV)) != nullptr)
-			m_vao->BindAttrib(*vbo, (GLint)Mesh::Attrib::UV);
+		//Indexed meshes draw through their index buffer, everything else
+		//draws its vertices in order.
+		m_vao->SetIndexBuffer(mesh.GetIBO());
 	}
 
 	void CMeshRenderer::SetMaterial(Material& mat)
@@ -55,19 +66,41 @@ namespace nou
 		m_mat = &mat;
 	}
 
+	Material& CMeshRenderer::GetMaterial() const
+	{
+		return *m_mat;
+	}
+
 	void CMeshRenderer::Draw()
 	{
 		m_mat->Use();
+		CCamera::BindCurrent();
+		DrawInBatch();
+	}
 
-		auto& transform = m_owner->transform;
+	void CMeshRenderer::DrawInBatch()
+	{
+		SetUniforms();
+		m_vao->Draw();
+	}
+
+	void CMeshRenderer::SetUniforms()
+	{
+		const ShaderProgram* program = ShaderProgram::Current();
 
 		//We are assuming the names used by uniform shader variables as a convention here.
-		//In a larger project, we would have a more elegant system for registering
-		//or even automatically detecting uniform names.
-		ShaderProgram::Current()->SetUniform("viewproj", CCamera::current->Get<CCamera>().GetVP());
-		ShaderProgram::Current()->SetUniform("model", transform.GetGlobal());
-		ShaderProgram::Current()->SetUniform("normal", transform.GetNormal());
-		
-		m_vao->Draw();
+		//The view-projection matrix isn't here - it's shared by every draw,
+		//so CCamera::BindCurrent puts it in a uniform block instead.
+		if (program != m_program)
+		{
+			m_program = program;
+			m_modelLoc = program->GetUniformLoc("model");
+			m_normalLoc = program->GetUniformLoc("normal");
+		}
+
+		auto& transform = m_owner->transform;
+
+		program->SetUniform(m_modelLoc, transform.GetGlobal());
+		program->SetUniform(m_normalLoc, transform.GetNormal());
 	}
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+CMorphMeshRenderer.cpp
+Mesh renderer for meshes with morph targets (blend shapes) - set the
+weights each frame, and the vertex shader blends the targets.
+
+As a convention in NOU, we put "C" before a class name to signify
+that we intend the class for use as a component with the ENTT framework.
+*/
+
+#include "NOU/CMorphMeshRenderer.h"
+
+#include <algorithm>
+
+namespace nou
+{
+	CMorphMeshRenderer::CMorphMeshRenderer(Entity& owner,
+										   const Mesh& mesh,
+										   Material& mat,
+										   bool gpuMorphing)
+		: CMeshRenderer(owner, mesh, mat)
+	{
+		m_mesh = &mesh;
+		m_weights.resize(mesh.GetMorphTargetCount(), 0.0f);
+		m_gpuMorphing = gpuMorphing && mesh.GetMorphDeltas() != nullptr;
+		m_weightsChanged = true;
+	}
+
+	void CMorphMeshRenderer::SetWeight(size_t target, float weight)
+	{
+		if (target >= m_weights.size() || m_weights[target] == weight)
+			return;
+
+		m_weights[target] = weight;
+		m_weightsChanged = true;
+	}
+
+	void CMorphMeshRenderer::SetWeights(const std::vector<float>& weights)
+	{
+		size_t count = std::min(weights.size(), m_weights.size());
+
+		for (size_t i = 0; i < count; ++i)
+			SetWeight(i, weights[i]);
+	}
+
+	const std::vector<float>& CMorphMeshRenderer::GetWeights() const
+	{
+		return m_weights;
+	}
+
+	bool CMorphMeshRenderer::IsGPUMorphing() const
+	{
+		return m_gpuMorphing;
+	}
+
+	void CMorphMeshRenderer::DrawInBatch()
+	{
+		if (m_weightsChanged)
+		{
+			m_activeTargets.clear();
+			m_activeWeights.clear();
+
+			for (size_t i = 0; i < m_weights.size(); ++i)
+			{
+				if (m_weights[i] == 0.0f)
+					continue;
+
+				m_activeTargets.push_back((int)i);
+				m_activeWeights.push_back(m_weights[i]);
+			}
+
+			if (!m_gpuMorphing)
+				ApplyOnCPU();
+
+			m_weightsChanged = false;
+		}
+
+		if (m_gpuMorphing)
+			m_mesh->GetMorphDeltas()->Bind(DELTA_TEXTURE_UNIT);
+
+		CMeshRenderer::DrawInBatch();
+	}
+
+	void CMorphMeshRenderer::SetUniforms()
+	{
+		CMeshRenderer::SetUniforms();
+
+		const ShaderProgram* program = ShaderProgram::Current();
+
+		//On the CPU path the vertices are already blended, so the shader
+		//mustn't blend them again.
+		if (!m_gpuMorphing || m_activeTargets.empty())
+		{
+			program->SetUniform("morphCount", 0);
+			return;
+		}
+
+		program->SetUniform("morphDeltas", (int)DELTA_TEXTURE_UNIT);
+		program->SetUniform("morphVertexCount", (int)m_mesh->GetVertexCount());
+		program->SetUniform("morphCount", (int)m_activeTargets.size());
+		program->SetUniformArray("morphTargets", m_activeTargets.data(), (int)m_activeTargets.size());
+		program->SetUniformArray("morphWeights", m_activeWeights.data(), (int)m_activeWeights.size());
+	}
+
+	void CMorphMeshRenderer::ApplyOnCPU()
+	{
+		if (!m_mesh->ApplyMorphWeights(m_weights, m_morphedVerts, m_morphedNormals))
+			return;
+
+		//Dynamic buffers, since these get rewritten whenever a weight changes.
+		if (m_morphedPosVBO == nullptr)
+		{
+			m_morphedPosVBO = std::make_unique<VertexBuffer>(3, m_morphedVerts, true);
+			m_vao->BindAttrib(*m_morphedPosVBO, (GLint)Mesh::Attrib::POSITION);
+		}
+		else
+			m_morphedPosVBO->UpdateData(m_morphedVerts);
+
+		if (m_morphedNormals.empty())
+			return;
+
+		if (m_morphedNormalVBO == nullptr)
+		{
+			m_morphedNormalVBO = std::make_unique<VertexBuffer>(3, m_morphedNormals, true);
+			m_vao->BindAttrib(*m_morphedNormalVBO, (GLint)Mesh::Attrib::NORMAL);
+		}
+		else
+			m_morphedNormalVBO->UpdateData(m_morphedNormals);
+	}
+}
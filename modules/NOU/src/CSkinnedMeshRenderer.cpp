@@ -0,0 +1,41 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+CSkinnedMeshRenderer.cpp
+Mesh renderer for skinned meshes - the entity's CAnimator supplies
+the joint palette, and the vertex shader does the skinning.
+
+As a convention in NOU, we put "C" before a class name to signify
+that we intend the class for use as a component with the ENTT framework.
+*/
+
+#include "NOU/CSkinnedMeshRenderer.h"
+#include "NOU/CAnimator.h"
+
+#include <algorithm>
+
+namespace nou
+{
+	CSkinnedMeshRenderer::CSkinnedMeshRenderer(Entity& owner,
+											   const Mesh& mesh,
+											   Material& mat)
+		: CMeshRenderer(owner, mesh, mat)
+	{
+		//A mat4 is four vec4 columns, so an array of them has no std140 padding.
+		m_palette = std::make_unique<UniformBuffer>(MAX_JOINTS * sizeof(glm::mat4));
+	}
+
+	void CSkinnedMeshRenderer::DrawInBatch()
+	{
+		const std::vector<glm::mat4>& palette = m_owner->Get<CAnimator>().GetPalette();
+		size_t numJoints = std::min(palette.size(), MAX_JOINTS);
+
+		//Only the joints the skeleton actually has - the rest of the
+		//block is never indexed by this mesh's vertices.
+		m_palette->UpdateData(palette.data(), numJoints * sizeof(glm::mat4));
+		m_palette->Bind(PALETTE_BINDING);
+
+		CMeshRenderer::DrawInBatch();
+	}
+}
@@ -10,28 +10,37 @@ Minimal and lightly OOP wrapper for the ENTT framework.
 
 namespace nou
 {
-	entt::registry Entity::ecs;
-
-	Entity Entity::Create()
+	Entity Entity::Create(World& world)
 	{
-		entt::entity id = ecs.create();
-		return Entity(id);
+		entt::entity id = world.GetRegistry().create();
+		return Entity(id, world);
 	}
 
-	std::unique_ptr<Entity> Entity::Allocate()
+	std::unique_ptr<Entity> Entity::Allocate(World& world)
 	{
-		entt::entity id = ecs.create();
-		return std::move(std::make_unique<Entity>(id));
+		entt::entity id = world.GetRegistry().create();
+		return std::move(std::make_unique<Entity>(id, world));
 	}
 
-	Entity::Entity(entt::entity id)
+	Entity::Entity(entt::entity id, World& world)
 	{
+		m_world = &world;
 		m_id = id;
 	}
 
 	Entity::~Entity()
 	{
 		if(m_id != entt::null)
-			ecs.destroy(m_id);
+			m_world->GetRegistry().destroy(m_id);
+	}
+
+	World& Entity::GetWorld() const
+	{
+		return *m_world;
+	}
+
+	entt::entity Entity::GetID() const
+	{
+		return m_id;
 	}
 }
\ No newline at end of file
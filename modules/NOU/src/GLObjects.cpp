@@ -0,0 +1,318 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+GLObjects.cpp
+Classes for managing OpenGL vertex buffers and vertex array objects.
+You'll be learning a LOT more about this in your graphics class.
+*/
+
+#include "NOU/GLObjects.h"
+#include "NOU/GLState.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace nou
+{
+	VertexBuffer::VertexBuffer(GLint elementLen, const void* data, GLsizei len, GLsizei elementSize, bool dynamic)
+	{
+		m_elementLen = elementLen;
+		m_elementSize = elementSize;
+		m_startIndex = 0;
+		m_len = 0;
+		m_dynamic = dynamic;
+
+		m_capacity = 0;
+		m_region = 0;
+		m_mapped = nullptr;
+		m_revision = 0;
+
+		for (GLsync& fence : m_fences)
+			fence = nullptr;
+
+		glGenBuffers(1, &m_id);
+		UpdateData(data, len, elementSize);
+	}
+
+	VertexBuffer::~VertexBuffer()
+	{
+		ReleaseDynamic();
+		glDeleteBuffers(1, &m_id);
+		GLState::ForgetBuffer(m_id);
+	}
+
+	void VertexBuffer::UpdateData(const void* data, GLsizei len, GLsizei elementSize)
+	{
+		m_len = len;
+		m_elementSize = elementSize;
+
+		GLsizeiptr size = (GLsizeiptr)len * elementSize;
+
+		//Nothing to upload - we hold on to whatever storage we have for next time.
+		if (size == 0 || data == nullptr)
+			return;
+
+		if (m_dynamic)
+			UpdateDynamic(data, size);
+		else
+			UpdateStatic(data, size);
+	}
+
+	void VertexBuffer::UpdateStatic(const void* data, GLsizeiptr size)
+	{
+		GLState::BindBuffer(GL_ARRAY_BUFFER, m_id);
+
+		//Writing into the storage we already have is much cheaper than
+		//glBufferData, which throws it away and allocates new storage.
+		if (size <= m_capacity)
+		{
+			glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+			return;
+		}
+
+		glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+		m_capacity = size;
+	}
+
+	void VertexBuffer::UpdateDynamic(const void* data, GLsizeiptr size)
+	{
+		if (size > m_capacity)
+		{
+			//Grow with some headroom, so a buffer that gets a little bigger
+			//every frame doesn't reallocate every frame.
+			AllocateDynamic(std::max(size, m_capacity + m_capacity / 2));
+		}
+		else
+		{
+			//Every draw that could read the region we're leaving has been issued
+			//by now, so a fence here tells us when the GPU is done with it.
+			m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_region = (m_region + 1) % DYNAMIC_REGIONS;
+			WaitForRegion(m_region);
+		}
+
+		++m_revision;
+
+		GLintptr offset = CurrentOffset();
+
+		if (m_mapped != nullptr)
+		{
+			std::memcpy(static_cast<char*>(m_mapped) + offset, data, size);
+			return;
+		}
+
+		//Our fences already make sure the GPU is done with this region,
+		//so the driver doesn't need to synchronize for us.
+		GLState::BindBuffer(GL_ARRAY_BUFFER, m_id);
+		void* target = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+										GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+										GL_MAP_UNSYNCHRONIZED_BIT);
+
+		if (target != nullptr)
+		{
+			std::memcpy(target, data, size);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		}
+		else
+			glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	}
+
+	void VertexBuffer::AllocateDynamic(GLsizeiptr capacity)
+	{
+		//Storage from glBufferStorage can't be resized, so growing
+		//means starting over with a new buffer. The GL keeps the old
+		//one alive until any draws still using it are done.
+		if (m_capacity > 0)
+		{
+			ReleaseDynamic();
+			glDeleteBuffers(1, &m_id);
+			GLState::ForgetBuffer(m_id);
+			glGenBuffers(1, &m_id);
+		}
+
+		m_capacity = capacity;
+		m_region = 0;
+
+		GLsizeiptr total = m_capacity * DYNAMIC_REGIONS;
+		GLState::BindBuffer(GL_ARRAY_BUFFER, m_id);
+
+		if (GLAD_GL_VERSION_4_4)
+		{
+			//Coherent, so our writes are visible to the GPU without flushing.
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_ARRAY_BUFFER, total, nullptr, flags);
+			m_mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags);
+		}
+		else
+			glBufferData(GL_ARRAY_BUFFER, total, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	void VertexBuffer::WaitForRegion(int region)
+	{
+		GLsync& fence = m_fences[region];
+
+		if (fence == nullptr)
+			return;
+
+		//With three regions the GPU would have to be two updates behind
+		//for this to actually wait.
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+		while (result == GL_TIMEOUT_EXPIRED)
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	void VertexBuffer::ReleaseDynamic()
+	{
+		for (GLsync& fence : m_fences)
+		{
+			if (fence != nullptr)
+				glDeleteSync(fence);
+
+			fence = nullptr;
+		}
+
+		if (m_mapped != nullptr)
+		{
+			GLState::BindBuffer(GL_ARRAY_BUFFER, m_id);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+			m_mapped = nullptr;
+		}
+	}
+
+	IndexBuffer::IndexBuffer(const void* data, GLsizei count, GLenum type)
+	{
+		m_count = 0;
+		m_type = type;
+		m_capacity = 0;
+
+		glGenBuffers(1, &m_id);
+		UpdateData(data, count, type);
+	}
+
+	IndexBuffer::~IndexBuffer()
+	{
+		glDeleteBuffers(1, &m_id);
+		GLState::ForgetBuffer(m_id);
+	}
+
+	void IndexBuffer::UpdateData(const void* data, GLsizei count, GLenum type)
+	{
+		m_count = count;
+		m_type = type;
+
+		GLsizeiptr size = (GLsizeiptr)count * TypeSize(type);
+
+		if (size == 0 || data == nullptr)
+			return;
+
+		//Binding to GL_ELEMENT_ARRAY_BUFFER would change the index buffer of
+		//whatever VAO happens to be bound, so we upload through another target.
+		GLState::BindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+
+		if (size <= m_capacity)
+			glBufferSubData(GL_COPY_WRITE_BUFFER, 0, size, data);
+		else
+		{
+			glBufferData(GL_COPY_WRITE_BUFFER, size, data, GL_STATIC_DRAW);
+			m_capacity = size;
+		}
+	}
+
+	GLsizei IndexBuffer::TypeSize(GLenum type)
+	{
+		switch (type)
+		{
+			case GL_UNSIGNED_BYTE:
+				return 1;
+			case GL_UNSIGNED_SHORT:
+				return 2;
+			default:
+				return 4;
+		}
+	}
+
+	UniformBuffer::UniformBuffer(GLsizeiptr size)
+	{
+		m_size = size;
+
+		glGenBuffers(1, &m_id);
+		GLState::BindBuffer(GL_UNIFORM_BUFFER, m_id);
+		glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	UniformBuffer::~UniformBuffer()
+	{
+		glDeleteBuffers(1, &m_id);
+		GLState::ForgetBuffer(m_id);
+	}
+
+	void UniformBuffer::UpdateData(const void* data, GLsizeiptr size)
+	{
+		size = std::min(size, m_size);
+
+		if (size <= 0 || data == nullptr)
+			return;
+
+		GLState::BindBuffer(GL_UNIFORM_BUFFER, m_id);
+		glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	}
+
+	void UniformBuffer::Bind(GLuint bindingPoint) const
+	{
+		GLState::BindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_id);
+	}
+
+	TextureBuffer::TextureBuffer(GLenum format, const void* data, GLsizeiptr size)
+	{
+		m_format = format;
+		m_size = 0;
+		m_capacity = 0;
+
+		glGenBuffers(1, &m_id);
+		glGenTextures(1, &m_texture);
+		UpdateData(data, size);
+	}
+
+	TextureBuffer::~TextureBuffer()
+	{
+		glDeleteTextures(1, &m_texture);
+		glDeleteBuffers(1, &m_id);
+		GLState::ForgetTexture(m_texture);
+		GLState::ForgetBuffer(m_id);
+	}
+
+	void TextureBuffer::UpdateData(const void* data, GLsizeiptr size)
+	{
+		m_size = size;
+
+		if (size == 0 || data == nullptr)
+			return;
+
+		GLState::BindBuffer(GL_TEXTURE_BUFFER, m_id);
+
+		if (size <= m_capacity)
+			glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+		else
+		{
+			glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STATIC_DRAW);
+			m_capacity = size;
+
+			//The texture refers to the buffer object, not its storage,
+			//so this only needs doing once - but it doesn't hurt to redo it.
+			GLState::BindTexture(GL_TEXTURE_BUFFER, m_texture);
+			glTexBuffer(GL_TEXTURE_BUFFER, m_format, m_id);
+		}
+	}
+
+	void TextureBuffer::Bind(GLuint unit) const
+	{
+		GLState::ActiveTexture(unit);
+		GLState::BindTexture(GL_TEXTURE_BUFFER, m_texture);
+	}
+}
@@ -0,0 +1,275 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+GLState.cpp
+Keeps track of the OpenGL state we've set, so binding something
+that's already bound doesn't cost a call into the driver.
+*/
+
+#include "NOU/GLState.h"
+
+namespace nou
+{
+	GLuint GLState::m_program = GLState::UNKNOWN;
+	GLuint GLState::m_vao = GLState::UNKNOWN;
+	GLuint GLState::m_activeUnit = GLState::UNKNOWN;
+	std::unordered_map<GLenum, GLuint> GLState::m_buffers;
+	std::unordered_map<GLuint, GLuint> GLState::m_indexedBuffers;
+	std::vector<GLuint> GLState::m_textures;
+	std::unordered_map<GLenum, GLuint> GLState::m_caps;
+	GLuint GLState::m_blendSrc = GLState::UNKNOWN;
+	GLuint GLState::m_blendDst = GLState::UNKNOWN;
+	GLuint GLState::m_depthFunc = GLState::UNKNOWN;
+	GLuint GLState::m_depthMask = GLState::UNKNOWN;
+	GLuint GLState::m_cullFace = GLState::UNKNOWN;
+	glm::vec4 GLState::m_clearColor = glm::vec4(0.0f);
+	bool GLState::m_clearColorKnown = false;
+	GLState::Stats GLState::m_frame;
+	GLState::Stats GLState::m_lastFrame;
+
+	bool GLState::Change(GLuint& current, GLuint value)
+	{
+		if (current == value)
+		{
+			++m_frame.elided;
+			return false;
+		}
+
+		current = value;
+		++m_frame.issued;
+		return true;
+	}
+
+	void GLState::UseProgram(GLuint program)
+	{
+		if (Change(m_program, program))
+			glUseProgram(program);
+	}
+
+	void GLState::BindVertexArray(GLuint vao)
+	{
+		if (!Change(m_vao, vao))
+			return;
+
+		glBindVertexArray(vao);
+
+		//The element buffer binding belongs to the VAO, so it just changed too.
+		m_buffers[GL_ELEMENT_ARRAY_BUFFER] = UNKNOWN;
+	}
+
+	void GLState::BindBuffer(GLenum target, GLuint buffer)
+	{
+		GLuint& current = m_buffers.try_emplace(target, UNKNOWN).first->second;
+
+		if (Change(current, buffer))
+			glBindBuffer(target, buffer);
+	}
+
+	void GLState::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		GLuint key = (target << 16) | (index & 0xFFFF);
+		GLuint& current = m_indexedBuffers.try_emplace(key, UNKNOWN).first->second;
+
+		if (!Change(current, buffer))
+			return;
+
+		glBindBufferBase(target, index, buffer);
+		m_buffers[target] = buffer;
+	}
+
+	void GLState::ActiveTexture(GLuint unit)
+	{
+		if (Change(m_activeUnit, unit))
+			glActiveTexture(GL_TEXTURE0 + unit);
+	}
+
+	void GLState::BindTexture(GLenum target, GLuint texture)
+	{
+		//We can't tell which unit this goes to.
+		if (m_activeUnit == UNKNOWN)
+		{
+			++m_frame.issued;
+			glBindTexture(target, texture);
+			return;
+		}
+
+		if (m_activeUnit >= m_textures.size())
+			m_textures.resize(m_activeUnit + 1, UNKNOWN);
+
+		//A unit has a binding for each target, and we only remember the last
+		//texture bound to it - which is enough to know that texture is still bound,
+		//but not that nothing is. So unbinding (texture 0) always goes through.
+		GLuint& current = m_textures[m_activeUnit];
+
+		if (texture != 0 && current == texture)
+		{
+			++m_frame.elided;
+			return;
+		}
+
+		current = texture;
+		++m_frame.issued;
+		glBindTexture(target, texture);
+	}
+
+	void GLState::BindTextureUnit(GLuint unit, GLuint texture)
+	{
+		if (unit >= m_textures.size())
+			m_textures.resize(unit + 1, UNKNOWN);
+
+		GLuint& current = m_textures[unit];
+
+		if (texture != 0 && current == texture)
+		{
+			++m_frame.elided;
+			return;
+		}
+
+		current = texture;
+		++m_frame.issued;
+		glBindTextureUnit(unit, texture);
+	}
+
+	void GLState::Enable(GLenum cap)
+	{
+		GLuint& current = m_caps.try_emplace(cap, UNKNOWN).first->second;
+
+		if (Change(current, GL_TRUE))
+			glEnable(cap);
+	}
+
+	void GLState::Disable(GLenum cap)
+	{
+		GLuint& current = m_caps.try_emplace(cap, UNKNOWN).first->second;
+
+		if (Change(current, GL_FALSE))
+			glDisable(cap);
+	}
+
+	void GLState::BlendFunc(GLenum src, GLenum dst)
+	{
+		if (m_blendSrc == src && m_blendDst == dst)
+		{
+			++m_frame.elided;
+			return;
+		}
+
+		m_blendSrc = src;
+		m_blendDst = dst;
+		++m_frame.issued;
+		glBlendFunc(src, dst);
+	}
+
+	void GLState::DepthFunc(GLenum func)
+	{
+		if (Change(m_depthFunc, func))
+			glDepthFunc(func);
+	}
+
+	void GLState::DepthMask(bool write)
+	{
+		if (Change(m_depthMask, write ? GL_TRUE : GL_FALSE))
+			glDepthMask(write ? GL_TRUE : GL_FALSE);
+	}
+
+	void GLState::CullFace(GLenum face)
+	{
+		if (Change(m_cullFace, face))
+			glCullFace(face);
+	}
+
+	void GLState::ClearColor(const glm::vec4& color)
+	{
+		if (m_clearColorKnown && m_clearColor == color)
+		{
+			++m_frame.elided;
+			return;
+		}
+
+		m_clearColor = color;
+		m_clearColorKnown = true;
+		++m_frame.issued;
+		glClearColor(color.r, color.g, color.b, color.a);
+	}
+
+	void GLState::ForgetProgram(GLuint program)
+	{
+		//A deleted program stays in use until another one replaces it,
+		//so we can't say what's current.
+		if (program != 0 && m_program == program)
+			m_program = UNKNOWN;
+	}
+
+	void GLState::ForgetVertexArray(GLuint vao)
+	{
+		if (vao != 0 && m_vao == vao)
+		{
+			m_vao = 0;
+			m_buffers[GL_ELEMENT_ARRAY_BUFFER] = UNKNOWN;
+		}
+	}
+
+	void GLState::ForgetBuffer(GLuint buffer)
+	{
+		if (buffer == 0)
+			return;
+
+		for (auto& [target, current] : m_buffers)
+		{
+			if (current == buffer)
+				current = 0;
+		}
+
+		for (auto& [key, current] : m_indexedBuffers)
+		{
+			if (current == buffer)
+				current = 0;
+		}
+	}
+
+	void GLState::ForgetTexture(GLuint texture)
+	{
+		if (texture == 0)
+			return;
+
+		for (GLuint& current : m_textures)
+		{
+			if (current == texture)
+				current = 0;
+		}
+	}
+
+	void GLState::Invalidate()
+	{
+		m_program = UNKNOWN;
+		m_vao = UNKNOWN;
+		m_activeUnit = UNKNOWN;
+		m_buffers.clear();
+		m_indexedBuffers.clear();
+		m_textures.clear();
+		m_caps.clear();
+		m_blendSrc = UNKNOWN;
+		m_blendDst = UNKNOWN;
+		m_depthFunc = UNKNOWN;
+		m_depthMask = UNKNOWN;
+		m_cullFace = UNKNOWN;
+		m_clearColorKnown = false;
+	}
+
+	void GLState::EndFrame()
+	{
+		m_lastFrame = m_frame;
+		m_frame = Stats();
+	}
+
+	const GLState::Stats& GLState::GetFrameStats()
+	{
+		return m_lastFrame;
+	}
+
+	const GLState::Stats& GLState::GetCurrentStats()
+	{
+		return m_frame;
+	}
+}
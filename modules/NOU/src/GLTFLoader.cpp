@@ -10,11 +10,114 @@ Helpful reference: https://www.khronos.org/files/gltf20-reference-guide.pdf
 #include "NOU/GLTFLoader.h"
 
 #include <sstream>
+#include <cstring>
+#include <algorithm>
 
 #include "tiny_gltf.h"
+#include "GLM/gtc/type_ptr.hpp"
 
 namespace nou::GLTF
 {
+	namespace
+	{
+		//Whether we can read an attribute accessor as floats - plain floats,
+		//or the normalized unsigned integers glTF allows for UVs and such.
+		bool IsReadable(const tinygltf::Model& gltf, int accIndex, int type, size_t count)
+		{
+			const tinygltf::Accessor& acc = gltf.accessors[accIndex];
+
+			if (acc.bufferView == -1 || acc.sparse.isSparse || acc.type != type || acc.count != count)
+				return false;
+
+			return acc.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT ||
+				   (acc.normalized && (acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+									   acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT));
+		}
+
+		//Reads element i of an accessor that passed IsReadable into out.
+		void ReadFloats(const tinygltf::Accessor& acc, const DataGetter& getter, size_t i, float* out, int numComponents)
+		{
+			const unsigned char* element = &getter.data[i * getter.stride];
+
+			switch (acc.componentType)
+			{
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+					for (int c = 0; c < numComponents; ++c)
+						out[c] = element[c] / 255.0f;
+					break;
+
+				case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+					for (int c = 0; c < numComponents; ++c)
+					{
+						unsigned short value;
+						memcpy(&value, &element[c * sizeof(unsigned short)], sizeof(unsigned short));
+						out[c] = value / 65535.0f;
+					}
+					break;
+
+				default:
+					memcpy(out, element, numComponents * sizeof(float));
+					break;
+			}
+		}
+
+		//Whether an accessor holds joint indices we can read - four
+		//unsigned bytes or shorts per vertex, as the spec allows.
+		bool IsJointData(const tinygltf::Model& gltf, int accIndex, size_t count)
+		{
+			const tinygltf::Accessor& acc = gltf.accessors[accIndex];
+
+			if (acc.bufferView == -1 || acc.sparse.isSparse || acc.type != TINYGLTF_TYPE_VEC4 || acc.count != count)
+				return false;
+
+			return acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+				   acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+		}
+
+		//Reads the four joint indices of vertex i (as floats, for the vertex buffer).
+		void ReadJoints(const tinygltf::Accessor& acc, const DataGetter& getter, size_t i, float* out)
+		{
+			const unsigned char* element = &getter.data[i * getter.stride];
+
+			for (int c = 0; c < 4; ++c)
+			{
+				if (acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+					out[c] = (float)element[c];
+				else
+				{
+					unsigned short value;
+					memcpy(&value, &element[c * sizeof(unsigned short)], sizeof(unsigned short));
+					out[c] = (float)value;
+				}
+			}
+		}
+	}
+
+	Scene::~Scene()
+	{
+		Clear();
+	}
+
+	void Scene::DoFK()
+	{
+		for (size_t root : roots)
+			nodes[root]->transform.DoFK();
+	}
+
+	void Scene::Clear()
+	{
+		//Unhook the hierarchy first, so no transform is left pointing
+		//at a parent that has already been destroyed.
+		for (auto& node : nodes)
+			node->transform.SetParent(nullptr);
+
+		nodes.clear();
+		roots.clear();
+		meshes.clear();
+		skeletons.clear();
+		animations.clear();
+	}
+
 	void LoadMesh(const std::string& filename, Mesh& mesh, bool flipUVY)
 	{
 		auto gltf = std::make_unique<tinygltf::Model>();
@@ -60,7 +163,8 @@ namespace nou::GLTF
 
 		std::string tinygltfErr, tinygltfWarn;
 
-		size_t extIndex = filename.find('.');
+		//The last dot, so relative paths ("../models/thing.glb") still work.
+		size_t extIndex = filename.rfind('.');
 		
 		if (extIndex == std::string::npos || extIndex >= filename.length() - 1)
 		{
@@ -132,13 +236,10 @@ namespace nou::GLTF
 				return false;
 		}
 
-		mesh.SetVerts(verts);
-
-		if(hasNormals)
-			mesh.SetNormals(normals);
-
-		if(hasUVs)
-			mesh.SetUVs(uvs);
+		//One call, so an interleaved mesh only gets packed and uploaded once.
+		mesh.SetVertexData(verts,
+						   hasNormals ? normals : std::vector<glm::vec3>(),
+						   hasUVs ? uvs : std::vector<glm::vec2>());
 
 		return true;
 	}
@@ -168,15 +269,6 @@ namespace nou::GLTF
 		//data as a set of triangles.
 		DataGetter faceIndexer = BuildGetter(gltf, geom.indices);
 
-		if (faceIndexer.elementSize != sizeof(GLshort))
-		{
-			err = "Primitive indices are in a currently unsupported format. " \
-				"Consider changing your GLTF export settings, or else this loader " \
-				"must be augmented to support the provided format.";
-
-			return false;
-		}
-
 		int vID = FindAccessor(geom, "POSITION");
 
 		if (vID == -1)
@@ -251,10 +343,7 @@ namespace nou::GLTF
 		for (size_t i = startIndex, f = 0; i < startIndex + faceIndexer.len && f < faceIndexer.len; ++i, ++f)
 		{
 			//What vertex do we need to look at?
-			GLshort vertIndex;
-			memcpy(&vertIndex, &faceIndexer.data[f * faceIndexer.stride], sizeof(GLshort));
-
-			size_t vert = vertIndex;
+			size_t vert = ReadIndex(faceIndexer, f);
 
 			//Grab our vertex position.
 			memcpy(&verts[i], &vGetter.data[vert * vGetter.stride], sizeof(glm::vec3));
@@ -278,6 +367,581 @@ namespace nou::GLTF
 		return true;
 	}
 
+	bool LoadScene(const std::string& filename, Scene& scene, bool flipUVY)
+	{
+		scene.Clear();
+
+		auto gltf = std::make_unique<tinygltf::Model>();
+
+		std::string err, warn;
+
+		if (!ParseGLTF(filename, *gltf, err, warn))
+		{
+			DumpErrorsAndWarnings(filename, err, warn);
+			return false;
+		}
+
+		//One nou::Mesh per primitive, since each primitive has its own
+		//attributes and indices (and, usually, its own material).
+		scene.meshes.resize(gltf->meshes.size());
+
+		for (size_t m = 0; m < gltf->meshes.size(); ++m)
+		{
+			const tinygltf::Mesh& meshData = gltf->meshes[m];
+
+			for (size_t p = 0; p < meshData.primitives.size(); ++p)
+			{
+				auto mesh = std::make_unique<Mesh>(Mesh::Layout::INTERLEAVED, false);
+				std::string primErr;
+
+				if (ExtractPrimitive(*gltf, meshData.primitives[p], *mesh, flipUVY, primErr, warn))
+					scene.meshes[m].push_back(std::move(mesh));
+				else
+					warn += "\nSkipped primitive " + std::to_string(p) + " of mesh " +
+							std::to_string(m) + ": " + primErr;
+			}
+		}
+
+		for (const tinygltf::Node& nodeData : gltf->nodes)
+		{
+			auto node = std::make_unique<SceneNode>();
+			node->name = nodeData.name;
+			node->mesh = nodeData.mesh;
+			node->skin = nodeData.skin;
+
+			//Nodes can override their mesh's default weights.
+			if (!nodeData.weights.empty())
+				node->weights.assign(nodeData.weights.begin(), nodeData.weights.end());
+			else if (nodeData.mesh >= 0 && nodeData.mesh < (int)gltf->meshes.size())
+				node->weights.assign(gltf->meshes[nodeData.mesh].weights.begin(),
+									 gltf->meshes[nodeData.mesh].weights.end());
+			ExtractTransform(nodeData, node->transform);
+
+			scene.nodes.push_back(std::move(node));
+		}
+
+		for (size_t n = 0; n < gltf->nodes.size(); ++n)
+		{
+			for (int child : gltf->nodes[n].children)
+			{
+				if (child < 0 || child >= (int)scene.nodes.size())
+					continue;
+
+				//glTF hierarchies are trees, so a node with two parents
+				//means a broken file (and possibly a cycle).
+				if (scene.nodes[child]->parent != -1 || child == (int)n)
+				{
+					err = "Node " + std::to_string(child) + " has more than one parent.";
+					scene.Clear();
+					DumpErrorsAndWarnings(filename, err, warn);
+					return false;
+				}
+
+				scene.nodes[child]->parent = (int)n;
+				scene.nodes[child]->transform.SetParent(&scene.nodes[n]->transform);
+				scene.nodes[n]->children.push_back(child);
+			}
+		}
+
+		//With one parent each, any node we can't reach from a parentless
+		//one is on a cycle - and FK would follow it forever.
+		std::vector<size_t> reachable;
+
+		for (size_t n = 0; n < scene.nodes.size(); ++n)
+		{
+			if (scene.nodes[n]->parent == -1)
+				reachable.push_back(n);
+		}
+
+		for (size_t i = 0; i < reachable.size(); ++i)
+		{
+			for (size_t child : scene.nodes[reachable[i]]->children)
+				reachable.push_back(child);
+		}
+
+		if (reachable.size() < scene.nodes.size())
+		{
+			err = "The node hierarchy has a cycle.";
+			scene.Clear();
+			DumpErrorsAndWarnings(filename, err, warn);
+			return false;
+		}
+
+		//Files without scenes still have nodes - we treat every node
+		//without a parent as a root.
+		int sceneIndex = (gltf->defaultScene >= 0) ? gltf->defaultScene : 0;
+
+		if (sceneIndex < (int)gltf->scenes.size())
+		{
+			for (int root : gltf->scenes[sceneIndex].nodes)
+			{
+				if (root < 0 || root >= (int)scene.nodes.size())
+				{
+					warn += "\nSkipped root node " + std::to_string(root) + ", it doesn't exist.";
+					continue;
+				}
+
+				scene.roots.push_back(root);
+			}
+		}
+		else
+		{
+			for (size_t n = 0; n < scene.nodes.size(); ++n)
+			{
+				if (scene.nodes[n]->parent == -1)
+					scene.roots.push_back(n);
+			}
+		}
+
+		scene.DoFK();
+
+		//Skeletons take their rest pose and root from the nodes, so they
+		//have to wait until the hierarchy's global transforms are worked out.
+		scene.skeletons.resize(gltf->skins.size());
+
+		for (size_t s = 0; s < gltf->skins.size(); ++s)
+		{
+			std::string skinErr;
+
+			if (!ExtractSkeleton(*gltf, s, scene, scene.skeletons[s], skinErr))
+				warn += "\nCouldn't load skin " + std::to_string(s) + ": " + skinErr;
+		}
+
+		for (size_t a = 0; a < gltf->animations.size(); ++a)
+		{
+			AnimationClip clip;
+			std::string animErr;
+
+			if (ExtractAnimation(*gltf, a, clip, animErr, warn))
+				scene.animations.push_back(std::move(clip));
+			else
+				warn += "\nSkipped animation " + std::to_string(a) + ": " + animErr;
+		}
+
+		DumpErrorsAndWarnings(filename, err, warn);
+		printf("Loaded scene from %s.\n", filename.c_str());
+
+		return true;
+	}
+
+	bool ExtractPrimitive(const tinygltf::Model& gltf, const tinygltf::Primitive& geom,
+						  Mesh& mesh, bool flipUVY,
+						  std::string& err, std::string& warn)
+	{
+		if (geom.mode != -1 && geom.mode != TINYGLTF_MODE_TRIANGLES)
+		{
+			err = "Only triangle primitives are currently supported.";
+			return false;
+		}
+
+		int vID = FindAccessor(geom, "POSITION");
+
+		if (vID == -1)
+		{
+			err = "No vertex positions found.";
+			return false;
+		}
+
+		const tinygltf::Accessor& vAcc = gltf.accessors[vID];
+		size_t count = vAcc.count;
+
+		if (vAcc.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || !IsReadable(gltf, vID, TINYGLTF_TYPE_VEC3, count))
+		{
+			err = "Vertex position data is in a currently unsupported format.";
+			return false;
+		}
+
+		int nID = FindAccessor(geom, "NORMAL");
+		bool hasNormals = nID != -1 && IsReadable(gltf, nID, TINYGLTF_TYPE_VEC3, count);
+
+		if (nID != -1 && !hasNormals)
+			warn += "\nNormal data is in a currently unsupported format, leaving it out.";
+
+		int uvID = FindAccessor(geom, "TEXCOORD_0");
+		bool hasUVs = uvID != -1 && IsReadable(gltf, uvID, TINYGLTF_TYPE_VEC2, count);
+
+		if (uvID != -1 && !hasUVs)
+			warn += "\nUV data is in a currently unsupported format, leaving it out.";
+
+		//Skinning needs both joints and weights.
+		int jID = FindAccessor(geom, "JOINTS_0");
+		int wID = FindAccessor(geom, "WEIGHTS_0");
+		bool hasSkin = jID != -1 && wID != -1 &&
+					   IsJointData(gltf, jID, count) &&
+					   IsReadable(gltf, wID, TINYGLTF_TYPE_VEC4, count);
+
+		if ((jID != -1 || wID != -1) && !hasSkin)
+			warn += "\nJoint and weight data is incomplete or in a currently unsupported format, leaving it out.";
+
+		//Indices are checked before anything is uploaded, so a primitive we
+		//can't use doesn't leave the mesh half set up.
+		DataGetter indexer = DataGetter();
+		GLenum indexType = GL_UNSIGNED_INT;
+
+		if (geom.indices != -1)
+		{
+			const tinygltf::Accessor& iAcc = gltf.accessors[geom.indices];
+
+			if (iAcc.bufferView == -1 || iAcc.sparse.isSparse)
+			{
+				err = "Primitive indices are in a currently unsupported format.";
+				return false;
+			}
+
+			//glTF's index component types have the same values as the GL enums.
+			indexType = (GLenum)iAcc.componentType;
+
+			if (indexType != GL_UNSIGNED_BYTE && indexType != GL_UNSIGNED_SHORT && indexType != GL_UNSIGNED_INT)
+			{
+				err = "Primitive indices are in a currently unsupported format.";
+				return false;
+			}
+
+			indexer = BuildGetter(gltf, geom.indices);
+
+			//An index past the last vertex would have the GPU read outside the vertex buffer.
+			for (size_t i = 0; i < indexer.len; ++i)
+			{
+				if (ReadIndex(indexer, i) >= count)
+				{
+					err = "Primitive indices refer to vertices that don't exist.";
+					return false;
+				}
+			}
+		}
+
+		//Work out where each attribute goes within a vertex.
+		GLsizei floatsPerVertex = 0;
+		std::map<Mesh::Attrib, VertexAttribLayout> attribs;
+
+		auto addAttrib = [&](Mesh::Attrib attrib, GLint elementLen)
+		{
+			VertexAttribLayout layout;
+			layout.elementLen = elementLen;
+			layout.offset = floatsPerVertex * sizeof(float);
+			attribs[attrib] = layout;
+			floatsPerVertex += elementLen;
+		};
+
+		addAttrib(Mesh::Attrib::POSITION, 3);
+		if (hasNormals)
+			addAttrib(Mesh::Attrib::NORMAL, 3);
+		if (hasUVs)
+			addAttrib(Mesh::Attrib::UV, 2);
+
+		//Joint indices go in as floats, so every attribute can share the
+		//one float buffer (they're small enough to be exact).
+		if (hasSkin)
+		{
+			addAttrib(Mesh::Attrib::JOINT_INFLUENCE, 4);
+			addAttrib(Mesh::Attrib::SKIN_WEIGHT, 4);
+		}
+
+		GLsizei stride = floatsPerVertex * (GLsizei)sizeof(float);
+
+		for (auto& [attrib, layout] : attribs)
+			layout.stride = stride;
+
+		DataGetter vGetter = BuildGetter(gltf, vID);
+		DataGetter nGetter = hasNormals ? BuildGetter(gltf, nID) : DataGetter();
+		DataGetter uvGetter = hasUVs ? BuildGetter(gltf, uvID) : DataGetter();
+		DataGetter jGetter = hasSkin ? BuildGetter(gltf, jID) : DataGetter();
+		DataGetter wGetter = hasSkin ? BuildGetter(gltf, wID) : DataGetter();
+
+		//Each vertex is packed straight from the glTF buffers into the one
+		//buffer we upload - no per-attribute copies along the way.
+		std::vector<float> data(count * floatsPerVertex);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			float* vertex = &data[i * floatsPerVertex];
+			GLsizei offset = 0;
+
+			ReadFloats(vAcc, vGetter, i, vertex, 3);
+			offset += 3;
+
+			if (hasNormals)
+			{
+				ReadFloats(gltf.accessors[nID], nGetter, i, vertex + offset, 3);
+				offset += 3;
+			}
+
+			if (hasUVs)
+			{
+				ReadFloats(gltf.accessors[uvID], uvGetter, i, vertex + offset, 2);
+
+				//We may need to flip our vertical UV-coordinate.
+				if (flipUVY)
+					vertex[offset + 1] = 1.0f - vertex[offset + 1];
+
+				offset += 2;
+			}
+
+			if (hasSkin)
+			{
+				ReadJoints(gltf.accessors[jID], jGetter, i, vertex + offset);
+				ReadFloats(gltf.accessors[wID], wGetter, i, vertex + offset + 4, 4);
+			}
+		}
+
+		mesh.SetInterleavedData(data.data(), count, stride, attribs);
+
+		if (!geom.targets.empty())
+		{
+			std::vector<Mesh::MorphTarget> targets(geom.targets.size());
+
+			for (size_t t = 0; t < geom.targets.size(); ++t)
+			{
+				auto pos = geom.targets[t].find("POSITION");
+				auto normal = geom.targets[t].find("NORMAL");
+
+				//A target that can't be read is left in (with no deltas),
+				//so the weights still line up with the targets.
+				if (pos != geom.targets[t].end() && !ReadVec3s(gltf, pos->second, targets[t].positions))
+					warn += "\nMorph target position data is in a currently unsupported format, leaving it out.";
+
+				if (normal != geom.targets[t].end() && !ReadVec3s(gltf, normal->second, targets[t].normals))
+					warn += "\nMorph target normal data is in a currently unsupported format, leaving it out.";
+			}
+
+			mesh.SetMorphTargets(targets);
+		}
+
+		//Primitives without indices are drawn as a plain list of triangles.
+		if (geom.indices == -1)
+		{
+			mesh.SetIndices(nullptr, 0, GL_UNSIGNED_INT);
+			return true;
+		}
+
+		//Indices are tightly packed (the spec requires it), so they can go
+		//to the GPU as they are, whatever their size.
+		if (indexer.stride == indexer.elementSize)
+			mesh.SetIndices(indexer.data, indexer.len, indexType);
+		else
+		{
+			std::vector<GLuint> indices(indexer.len);
+
+			for (size_t i = 0; i < indexer.len; ++i)
+				indices[i] = (GLuint)ReadIndex(indexer, i);
+
+			mesh.SetIndices(indices);
+		}
+
+		return true;
+	}
+
+	void ExtractTransform(const tinygltf::Node& node, Transform& transform)
+	{
+		if (node.matrix.size() == 16)
+		{
+			glm::mat4 matrix = glm::mat4(glm::make_mat4(node.matrix.data()));
+
+			//glTF only allows matrices made of a translation, rotation and scale,
+			//so we can pull those back out.
+			transform.m_pos = glm::vec3(matrix[3]);
+
+			glm::vec3 scale = glm::vec3(glm::length(glm::vec3(matrix[0])),
+										glm::length(glm::vec3(matrix[1])),
+										glm::length(glm::vec3(matrix[2])));
+
+			//A mirrored matrix - put the flip in the scale.
+			if (glm::determinant(glm::mat3(matrix)) < 0.0f)
+				scale.x = -scale.x;
+
+			glm::mat3 rotation = glm::mat3(glm::vec3(matrix[0]) / scale.x,
+										   glm::vec3(matrix[1]) / scale.y,
+										   glm::vec3(matrix[2]) / scale.z);
+
+			transform.m_scale = scale;
+			transform.m_rotation = glm::quat_cast(rotation);
+			return;
+		}
+
+		if (node.translation.size() == 3)
+			transform.m_pos = glm::vec3((float)node.translation[0],
+										(float)node.translation[1],
+										(float)node.translation[2]);
+
+		//glTF stores quaternions as (x, y, z, w), GLM takes w first.
+		if (node.rotation.size() == 4)
+			transform.m_rotation = glm::quat((float)node.rotation[3],
+											 (float)node.rotation[0],
+											 (float)node.rotation[1],
+											 (float)node.rotation[2]);
+
+		if (node.scale.size() == 3)
+			transform.m_scale = glm::vec3((float)node.scale[0],
+										  (float)node.scale[1],
+										  (float)node.scale[2]);
+	}
+
+	bool ExtractSkeleton(const tinygltf::Model& gltf, size_t skinIndex,
+						 const Scene& scene, Skeleton& skeleton, std::string& err)
+	{
+		const tinygltf::Skin& skin = gltf.skins[skinIndex];
+		size_t numJoints = skin.joints.size();
+
+		if (numJoints == 0)
+		{
+			err = "Skin has no joints.";
+			return false;
+		}
+
+		skeleton = Skeleton();
+		skeleton.nodes.assign(skin.joints.begin(), skin.joints.end());
+		skeleton.names.resize(numJoints);
+		skeleton.parents.resize(numJoints, -1);
+		skeleton.inverseBind.resize(numJoints, glm::mat4(1.0f));
+		skeleton.restPose.Resize(numJoints);
+
+		for (size_t j = 0; j < numJoints; ++j)
+		{
+			int node = skeleton.nodes[j];
+
+			if (node < 0 || node >= (int)scene.nodes.size())
+			{
+				err = "Skin refers to a node that doesn't exist.";
+				return false;
+			}
+
+			const SceneNode& nodeData = *scene.nodes[node];
+
+			skeleton.names[j] = nodeData.name;
+			skeleton.restPose.pos[j] = nodeData.transform.m_pos;
+			skeleton.restPose.rot[j] = nodeData.transform.m_rotation;
+			skeleton.restPose.scale[j] = nodeData.transform.m_scale;
+
+			//A joint whose parent node isn't a joint is at the top of the skeleton.
+			auto parent = std::find(skeleton.nodes.begin(), skeleton.nodes.end(), nodeData.parent);
+
+			if (nodeData.parent != -1 && parent != skeleton.nodes.end())
+				skeleton.parents[j] = (int)(parent - skeleton.nodes.begin());
+		}
+
+		skeleton.BuildEvalOrder();
+
+		//Whatever sits above the skeleton (usually an armature node) still moves it.
+		//We take that from the first top-level joint, since exporters put
+		//every top-level joint under the same node.
+		int topNode = scene.nodes[skeleton.nodes[skeleton.evalOrder[0]]]->parent;
+
+		if (topNode != -1)
+			skeleton.root = scene.nodes[topNode]->transform.GetGlobal();
+
+		//Without inverse bind matrices, the spec says to use identities.
+		if (skin.inverseBindMatrices == -1)
+			return true;
+
+		const tinygltf::Accessor& acc = gltf.accessors[skin.inverseBindMatrices];
+
+		if (acc.bufferView == -1 || acc.sparse.isSparse || acc.type != TINYGLTF_TYPE_MAT4 ||
+			acc.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || acc.count < numJoints)
+		{
+			err = "Inverse bind matrices are in a currently unsupported format.";
+			return false;
+		}
+
+		DataGetter getter = BuildGetter(gltf, skin.inverseBindMatrices);
+
+		//glTF matrices are column-major, same as GLM.
+		for (size_t j = 0; j < numJoints; ++j)
+			memcpy(&skeleton.inverseBind[j], &getter.data[j * getter.stride], sizeof(glm::mat4));
+
+		return true;
+	}
+
+	bool ExtractAnimation(const tinygltf::Model& gltf, size_t animIndex,
+						  AnimationClip& clip, std::string& err, std::string& warn)
+	{
+		const tinygltf::Animation& anim = gltf.animations[animIndex];
+
+		clip = AnimationClip();
+		clip.name = anim.name;
+
+		for (const tinygltf::AnimationChannel& channelData : anim.channels)
+		{
+			if (channelData.sampler < 0 || channelData.sampler >= (int)anim.samplers.size() ||
+				channelData.target_node < 0)
+			{
+				err = "Animation channel is missing its sampler or target.";
+				return false;
+			}
+
+			const tinygltf::AnimationSampler& sampler = anim.samplers[channelData.sampler];
+
+			if (sampler.input < 0 || sampler.input >= (int)gltf.accessors.size() ||
+				sampler.output < 0 || sampler.output >= (int)gltf.accessors.size())
+			{
+				err = "Animation sampler is missing its keyframes.";
+				return false;
+			}
+
+			AnimationChannel channel;
+			channel.target = channelData.target_node;
+			channel.step = sampler.interpolation == "STEP";
+
+			int numComponents;
+
+			if (channelData.target_path == "translation")
+			{
+				channel.path = AnimationChannel::Path::TRANSLATION;
+				numComponents = 3;
+			}
+			else if (channelData.target_path == "rotation")
+			{
+				channel.path = AnimationChannel::Path::ROTATION;
+				numComponents = 4;
+			}
+			else if (channelData.target_path == "scale")
+			{
+				channel.path = AnimationChannel::Path::SCALE;
+				numComponents = 3;
+			}
+			else
+			{
+				warn += "\nSkipping animation channel for \"" + channelData.target_path +
+						"\", which is currently unsupported.";
+				continue;
+			}
+
+			const tinygltf::Accessor& inAcc = gltf.accessors[sampler.input];
+			const tinygltf::Accessor& outAcc = gltf.accessors[sampler.output];
+
+			//Cubic spline outputs hold an in-tangent, a value and an out-tangent for each keyframe.
+			bool cubic = sampler.interpolation == "CUBICSPLINE";
+			size_t perKey = cubic ? 3 : 1;
+
+			if (inAcc.bufferView == -1 || inAcc.sparse.isSparse || inAcc.type != TINYGLTF_TYPE_SCALAR ||
+				inAcc.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT ||
+				outAcc.bufferView == -1 || outAcc.sparse.isSparse ||
+				outAcc.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT ||
+				outAcc.type != ((numComponents == 4) ? TINYGLTF_TYPE_VEC4 : TINYGLTF_TYPE_VEC3) ||
+				outAcc.count != inAcc.count * perKey || inAcc.count == 0)
+			{
+				warn += "\nSkipping animation channel with keyframes in a currently unsupported format.";
+				continue;
+			}
+
+			DataGetter inGetter = BuildGetter(gltf, sampler.input);
+			DataGetter outGetter = BuildGetter(gltf, sampler.output);
+
+			channel.times.resize(inAcc.count);
+			channel.values.resize(inAcc.count, glm::vec4(0.0f));
+
+			for (size_t k = 0; k < inAcc.count; ++k)
+			{
+				ReadFloats(inAcc, inGetter, k, &channel.times[k], 1);
+				ReadFloats(outAcc, outGetter, k * perKey + (cubic ? 1 : 0), &channel.values[k][0], numComponents);
+			}
+
+			clip.duration = std::max(clip.duration, channel.times.back());
+			clip.channels.push_back(std::move(channel));
+		}
+
+		return true;
+	}
+
 	int FindAccessor(const tinygltf::Primitive& geom, const std::string& name)
 	{
 		auto it = geom.attributes.find(name);
@@ -302,4 +966,83 @@ namespace nou::GLTF
 
 		return { data, len, stride, size };
 	}
-}
\ No newline at end of file
+
+	size_t ReadIndex(const DataGetter& indexer, size_t i)
+	{
+		const unsigned char* index = &indexer.data[i * indexer.stride];
+
+		switch (indexer.elementSize)
+		{
+			case 1:
+				return *index;
+
+			case 2:
+			{
+				unsigned short value;
+				memcpy(&value, index, sizeof(value));
+				return value;
+			}
+
+			default:
+			{
+				unsigned int value;
+				memcpy(&value, index, sizeof(value));
+				return value;
+			}
+		}
+	}
+
+	bool ReadVec3s(const tinygltf::Model& gltf, int accIndex, std::vector<glm::vec3>& out)
+	{
+		out.clear();
+
+		if (accIndex < 0 || accIndex >= (int)gltf.accessors.size())
+			return false;
+
+		const tinygltf::Accessor& acc = gltf.accessors[accIndex];
+
+		if (acc.type != TINYGLTF_TYPE_VEC3 || acc.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+			return false;
+
+		//Without a buffer view, everything that isn't in the sparse values is zero.
+		out.resize(acc.count, glm::vec3(0.0f));
+
+		if (acc.bufferView != -1)
+		{
+			DataGetter getter = BuildGetter(gltf, accIndex);
+
+			for (size_t i = 0; i < acc.count; ++i)
+				memcpy(&out[i], &getter.data[i * getter.stride], sizeof(glm::vec3));
+		}
+
+		if (!acc.sparse.isSparse)
+			return true;
+
+		//Sparse values replace whatever's at their indices.
+		const auto& sparse = acc.sparse;
+
+		if (sparse.indices.bufferView < 0 || sparse.values.bufferView < 0)
+			return false;
+
+		const tinygltf::BufferView& iView = gltf.bufferViews[sparse.indices.bufferView];
+		const tinygltf::BufferView& vView = gltf.bufferViews[sparse.values.bufferView];
+
+		DataGetter indexer;
+		indexer.data = &gltf.buffers[iView.buffer].data[iView.byteOffset + sparse.indices.byteOffset];
+		indexer.len = sparse.count;
+		indexer.elementSize = tinygltf::GetComponentSizeInBytes(sparse.indices.componentType);
+		indexer.stride = indexer.elementSize;
+
+		const unsigned char* values = &gltf.buffers[vView.buffer].data[vView.byteOffset + sparse.values.byteOffset];
+
+		for (int i = 0; i < sparse.count; ++i)
+		{
+			size_t index = ReadIndex(indexer, i);
+
+			if (index < out.size())
+				memcpy(&out[index], &values[i * sizeof(glm::vec3)], sizeof(glm::vec3));
+		}
+
+		return true;
+	}
+}
@@ -3,52 +3,234 @@ NOU Framework - Created for INFR 2310 at Ontario Tech.
 (c) Samantha Stahlke 2020
 
 Input.cpp
-Simple utility class for managing basic keyboard input.
+Simple utility class for managing basic keyboard and mouse input.
 */
 
 #include "NOU/Input.h"
 
-#include <string>
+#include <cstring>
 
 namespace nou
 {
-	bool Input::m_keyStates[Input::MAX_KEYS];
-	Input::KeyFlag Input::m_keyFlags[Input::MAX_KEYS];
+	InputQueue Input::m_queue;
+	Input::State Input::m_frame;
+	Input::State Input::m_tick;
+	Input::State* Input::m_current = &Input::m_frame;
+	std::vector<InputEvent> Input::m_pending;
+	size_t Input::m_pendingStart = 0;
+	bool Input::m_ticking = false;
+	std::vector<uint64_t> Input::m_frameEventTimes;
 
-	//This is registered by the App class as a callback for GLFW to send us keystroke information.
+	//These are registered by the App class as callbacks for GLFW to send us
+	//keystroke and mouse information.
 	void Input::GLFWInputCallback(GLFWwindow* win, int key, int scancode, int action, int mods)
 	{
-		if(key < 0 || key >= Input::MAX_KEYS)
+		if (key < 0 || key >= Input::MAX_KEYS)
 			return;
 
-		switch (action)
+		InputEvent e;
+		e.type = InputEvent::Type::KEY;
+		e.code = key;
+		e.action = action;
+		e.mods = mods;
+		e.ticks = glfwGetTimerValue();
+
+		m_queue.Push(e);
+	}
+
+	void Input::GLFWMouseButtonCallback(GLFWwindow* win, int button, int action, int mods)
+	{
+		if (button < 0 || button >= Input::MAX_BUTTONS)
+			return;
+
+		InputEvent e;
+		e.type = InputEvent::Type::MOUSE_BUTTON;
+		e.code = button;
+		e.action = action;
+		e.mods = mods;
+		e.ticks = glfwGetTimerValue();
+
+		m_queue.Push(e);
+	}
+
+	void Input::GLFWCursorCallback(GLFWwindow* win, double x, double y)
+	{
+		InputEvent e;
+		e.type = InputEvent::Type::CURSOR;
+		e.x = x;
+		e.y = y;
+		e.ticks = glfwGetTimerValue();
+
+		m_queue.Push(e);
+	}
+
+	void Input::GLFWScrollCallback(GLFWwindow* win, double x, double y)
+	{
+		InputEvent e;
+		e.type = InputEvent::Type::SCROLL;
+		e.x = x;
+		e.y = y;
+		e.ticks = glfwGetTimerValue();
+
+		m_queue.Push(e);
+	}
+
+	void Input::State::Reset()
+	{
+		memset(keyStates, 0, sizeof(keyStates));
+		memset(keyFlags, 0, sizeof(keyFlags));
+		memset(keyTimes, 0, sizeof(keyTimes));
+		memset(buttonStates, 0, sizeof(buttonStates));
+		memset(buttonFlags, 0, sizeof(buttonFlags));
+
+		cursor = glm::vec2(0.0f);
+		scroll = glm::vec2(0.0f);
+		flagged.clear();
+	}
+
+	void Input::State::Apply(const InputEvent& e)
+	{
+		bool* states;
+		uint8_t* flags;
+		int index = e.code;
+
+		switch (e.type)
+		{
+			case InputEvent::Type::KEY:
+			states = &keyStates[e.code];
+			flags = &keyFlags[e.code];
+			break;
+
+			case InputEvent::Type::MOUSE_BUTTON:
+			states = &buttonStates[e.code];
+			flags = &buttonFlags[e.code];
+			index += MAX_KEYS;
+			break;
+
+			case InputEvent::Type::CURSOR:
+			cursor = glm::vec2((float)e.x, (float)e.y);
+			return;
+
+			case InputEvent::Type::SCROLL:
+			scroll += glm::vec2((float)e.x, (float)e.y);
+			return;
+
+			default:
+			return;
+		}
+
+		uint8_t flag;
+
+		switch (e.action)
 		{
 			case GLFW_PRESS:
-			m_keyFlags[key] = KeyFlag::PRESSED;
-			m_keyStates[key] = true;
+			flag = PRESSED;
+			*states = true;
 			break;
 
 			case GLFW_RELEASE:
-			m_keyFlags[key] = KeyFlag::RELEASED;
-			m_keyStates[key] = false;
+			flag = RELEASED;
+			*states = false;
 			break;
 
 			default:
-			break;
+			return;
 		}
+
+		if (e.type == InputEvent::Type::KEY)
+			keyTimes[e.code] = e.ticks;
+
+		if (*flags == PASSIVE)
+			flagged.push_back(index);
+
+		*flags |= flag;
+	}
+
+	void Input::State::ClearFlags()
+	{
+		for (int index : flagged)
+		{
+			if (index < MAX_KEYS)
+				keyFlags[index] = PASSIVE;
+			else
+				buttonFlags[index - MAX_KEYS] = PASSIVE;
+		}
+
+		flagged.clear();
+		scroll = glm::vec2(0.0f);
 	}
 
 	void Input::Init()
 	{
-		memset(&m_keyStates, 0, MAX_KEYS * sizeof(bool));
-		memset(&m_keyFlags, 0, MAX_KEYS * sizeof(KeyFlag));
+		m_frame.Reset();
+		m_tick.Reset();
+		m_current = &m_frame;
+
+		m_pending.clear();
+		m_pendingStart = 0;
+		m_ticking = false;
+
+		//Anything still queued from before belongs to an old window.
+		InputEvent e;
+		while (m_queue.Pop(e)) {}
 	}
 
-	//We want to clear our input flags at the beginning of every frame.
-	//(e.g., to wipe any messages for keypresses/releases that happened last frame).
+	//We want to clear our input flags at the beginning of every frame
+	//(e.g., to wipe any messages for keypresses/releases that happened last frame),
+	//then apply whatever happened since.
 	void Input::FrameStart()
 	{
-		memset(&m_keyFlags, 0, MAX_KEYS * sizeof(KeyFlag));
+		m_frame.ClearFlags();
+		m_frameEventTimes.clear();
+
+		//Fixed updates never fall more than a step behind the frame, so events
+		//this old mean they've stopped asking - don't hold on to them forever.
+		uint64_t now = glfwGetTimerValue();
+		uint64_t maxAge = static_cast<uint64_t>(PENDING_SECONDS * glfwGetTimerFrequency());
+
+		while (m_pendingStart < m_pending.size() && m_pending[m_pendingStart].ticks + maxAge < now)
+			++m_pendingStart;
+
+		//Drop what fixed updates have already been through.
+		m_pending.erase(m_pending.begin(), m_pending.begin() + m_pendingStart);
+		m_pendingStart = 0;
+
+		InputEvent e;
+
+		while (m_queue.Pop(e))
+		{
+			m_frame.Apply(e);
+
+			if (e.type == InputEvent::Type::KEY || e.type == InputEvent::Type::MOUSE_BUTTON)
+				m_frameEventTimes.push_back(e.ticks);
+
+			if (m_ticking)
+				m_pending.push_back(e);
+		}
+	}
+
+	void Input::StartTicking()
+	{
+		m_ticking = true;
+	}
+
+	void Input::BeginTick(uint64_t until)
+	{
+		m_ticking = true;
+		m_tick.ClearFlags();
+
+		while (m_pendingStart < m_pending.size() && m_pending[m_pendingStart].ticks <= until)
+		{
+			m_tick.Apply(m_pending[m_pendingStart]);
+			++m_pendingStart;
+		}
+
+		m_current = &m_tick;
+	}
+
+	void Input::EndTick()
+	{
+		m_current = &m_frame;
 	}
 
 	bool Input::GetKey(int keycode)
@@ -56,7 +238,7 @@ namespace nou
 		if (keycode < 0 || keycode >= MAX_KEYS)
 			return false;
 
-		return m_keyStates[keycode];
+		return m_current->keyStates[keycode];
 	}
 
 	bool Input::GetKeyDown(int keycode)
@@ -64,7 +246,7 @@ namespace nou
 		if (keycode < 0 || keycode >= MAX_KEYS)
 			return false;
 
-		return m_keyFlags[keycode] == KeyFlag::PRESSED;
+		return (m_current->keyFlags[keycode] & PRESSED) != 0;
 	}
 
 	bool Input::GetKeyUp(int keycode)
@@ -72,6 +254,58 @@ namespace nou
 		if (keycode < 0 || keycode >= MAX_KEYS)
 			return false;
 
-		return m_keyFlags[keycode] == KeyFlag::RELEASED;
+		return (m_current->keyFlags[keycode] & RELEASED) != 0;
+	}
+
+	uint64_t Input::GetKeyTime(int keycode)
+	{
+		if (keycode < 0 || keycode >= MAX_KEYS)
+			return 0;
+
+		return m_current->keyTimes[keycode];
+	}
+
+	bool Input::GetMouseButton(int button)
+	{
+		if (button < 0 || button >= MAX_BUTTONS)
+			return false;
+
+		return m_current->buttonStates[button];
+	}
+
+	bool Input::GetMouseButtonDown(int button)
+	{
+		if (button < 0 || button >= MAX_BUTTONS)
+			return false;
+
+		return (m_current->buttonFlags[button] & PRESSED) != 0;
+	}
+
+	bool Input::GetMouseButtonUp(int button)
+	{
+		if (button < 0 || button >= MAX_BUTTONS)
+			return false;
+
+		return (m_current->buttonFlags[button] & RELEASED) != 0;
+	}
+
+	glm::vec2 Input::GetCursorPos()
+	{
+		return m_current->cursor;
+	}
+
+	glm::vec2 Input::GetScroll()
+	{
+		return m_current->scroll;
+	}
+
+	const std::vector<uint64_t>& Input::GetFrameEventTimes()
+	{
+		return m_frameEventTimes;
+	}
+
+	size_t Input::GetDroppedEvents()
+	{
+		return m_queue.GetDropped();
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,48 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+InputQueue.cpp
+A queue of timestamped input events, filled by GLFW's callbacks.
+*/
+
+#include "NOU/InputQueue.h"
+
+namespace nou
+{
+	bool InputQueue::Push(const InputEvent& e)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+
+		//Acquire, so the reader is done with the slot before we overwrite it.
+		if (tail - m_head.load(std::memory_order_acquire) >= CAPACITY)
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		m_events[tail % CAPACITY] = e;
+
+		//Release, so the event is written before the reader can see it's there.
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool InputQueue::Pop(InputEvent& e)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+
+		e = m_events[head % CAPACITY];
+
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t InputQueue::GetDropped() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+}
@@ -8,6 +8,7 @@ used by a model.
 */
 
 #include "NOU/Material.h"
+#include "NOU/GLState.h"
 
 namespace nou
 {
@@ -18,6 +19,8 @@ namespace nou
 
 		//Default to white.
 		m_color = glm::vec3(1.0f, 1.0f, 1.0f);
+
+		m_colorLoc = m_program->GetUniformLoc("matColor");
 	}
 
 	bool Material::AddTexture(const std::string& name, const Texture2D& tex)
@@ -39,16 +42,26 @@ namespace nou
 	void Material::Use()
 	{
 		m_program->Bind();
+		Apply();
+	}
 
-		m_program->SetUniform("matColor", m_color);
+	void Material::Apply()
+	{
+		m_program->SetUniform(m_colorLoc, m_color);
 
 		//Bind the textures used by this material.
+		//Samplers (and GLState) take the unit's number (0, 1, 2...),
+		//while our slots are the GL_TEXTUREn enum.
 		for (auto& t : m_tex)
 		{
-			glUniform1i(t.loc, t.slot);
-			glActiveTexture(t.slot - GL_TEXTURE0);
-			glEnable(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, t.id);
+			glUniform1i(t.loc, t.slot - GL_TEXTURE0);
+			GLState::ActiveTexture(t.slot - GL_TEXTURE0);
+			GLState::BindTexture(GL_TEXTURE_2D, t.id);
 		}
 	}
+
+	const ShaderProgram& Material::GetProgram() const
+	{
+		return *m_program;
+	}
 }
\ No newline at end of file
@@ -8,28 +8,261 @@ Very basic class for managing the data associated with a 3D model.
 
 #include "NOU/Mesh.h"
 
+#include <iostream>
+#include <algorithm>
+
 namespace nou
 {
+	Mesh::Mesh(Layout layout, bool keepCPUData)
+	{
+		m_layout = layout;
+		m_keepCPUData = keepCPUData;
+		m_vertexCount = 0;
+		m_morphCount = 0;
+	}
+
 	void Mesh::SetVerts(const std::vector<glm::vec3>& verts)
 	{
 		m_verts = verts;
-		SetVBO(Attrib::POSITION, 3, m_verts);
+		m_vertexCount = m_verts.size();
+
+		if (m_layout == Layout::INTERLEAVED)
+			UploadInterleaved();
+		else
+			SetVBO(Attrib::POSITION, 3, m_verts);
+
+		if (!m_keepCPUData)
+			ReleaseCPUData();
 	}
 
 	void Mesh::SetNormals(const std::vector<glm::vec3>& normals)
 	{
 		m_normals = normals;
-		SetVBO(Attrib::NORMAL, 3, m_normals);			
+
+		if (m_layout == Layout::INTERLEAVED)
+			UploadInterleaved();
+		else
+			SetVBO(Attrib::NORMAL, 3, m_normals);
+
+		if (!m_keepCPUData)
+			ReleaseCPUData();
 	}
 
 	void Mesh::SetUVs(const std::vector<glm::vec2>& uvs)
 	{
 		m_uvs = uvs;
-		SetVBO(Attrib::UV, 2, m_uvs);
+
+		if (m_layout == Layout::INTERLEAVED)
+			UploadInterleaved();
+		else
+			SetVBO(Attrib::UV, 2, m_uvs);
+
+		if (!m_keepCPUData)
+			ReleaseCPUData();
+	}
+
+	void Mesh::SetVertexData(const std::vector<glm::vec3>& verts,
+							 const std::vector<glm::vec3>& normals,
+							 const std::vector<glm::vec2>& uvs)
+	{
+		m_verts = verts;
+		m_normals = normals;
+		m_uvs = uvs;
+		m_vertexCount = m_verts.size();
+
+		if (m_layout == Layout::INTERLEAVED)
+			UploadInterleaved();
+		else
+		{
+			SetVBO(Attrib::POSITION, 3, m_verts);
+			SetVBO(Attrib::NORMAL, 3, m_normals);
+			SetVBO(Attrib::UV, 2, m_uvs);
+		}
+
+		if (!m_keepCPUData)
+			ReleaseCPUData();
+	}
+
+	void Mesh::SetInterleavedData(const void* data, size_t vertexCount, GLsizei stride,
+								  const std::map<Attrib, VertexAttribLayout>& attribs)
+	{
+		m_layout = Layout::INTERLEAVED;
+		m_vertexCount = vertexCount;
+
+		//Anything set before this is replaced.
+		m_vbo.clear();
+		ReleaseCPUData();
+
+		m_interleavedAttribs = attribs;
+
+		//Each "element" of the buffer is a whole vertex.
+		GLint elementLen = stride / (GLsizei)sizeof(float);
+
+		if (m_interleaved == nullptr)
+			m_interleaved = std::make_unique<VertexBuffer>(elementLen, data, (GLsizei)vertexCount, stride);
+		else
+			m_interleaved->UpdateData(data, (GLsizei)vertexCount, stride);
+	}
+
+	void Mesh::SetIndices(const void* data, size_t count, GLenum type)
+	{
+		if (count == 0)
+		{
+			m_ibo = nullptr;
+			return;
+		}
+
+		if (m_ibo == nullptr)
+			m_ibo = std::make_unique<IndexBuffer>(data, (GLsizei)count, type);
+		else
+			m_ibo->UpdateData(data, (GLsizei)count, type);
+	}
+
+	void Mesh::SetIndices(const std::vector<GLuint>& indices)
+	{
+		SetIndices(indices.data(), indices.size(), GL_UNSIGNED_INT);
+	}
+
+	void Mesh::SetMorphTargets(const std::vector<MorphTarget>& targets)
+	{
+		m_sparseMorphs.clear();
+		m_morphCount = std::min(targets.size(), MAX_MORPH_TARGETS);
+
+		if (targets.size() > MAX_MORPH_TARGETS)
+			std::cout << "Mesh has " << targets.size() << " morph targets, only the first "
+					  << MAX_MORPH_TARGETS << " will be used." << std::endl;
+
+		if (m_morphCount == 0 || m_vertexCount == 0)
+		{
+			m_morphCount = 0;
+			m_morphDeltas = nullptr;
+			return;
+		}
+
+		//Position and normal deltas side by side, one target after another.
+		//Missing deltas (e.g., a target without normals) are left at zero.
+		std::vector<glm::vec3> deltas(m_morphCount * m_vertexCount * 2, glm::vec3(0.0f));
+		bool keepSparse = HasCPUData();
+
+		for (size_t t = 0; t < m_morphCount; ++t)
+		{
+			const MorphTarget& target = targets[t];
+			glm::vec3* targetDeltas = &deltas[t * m_vertexCount * 2];
+
+			size_t numPositions = std::min(target.positions.size(), m_vertexCount);
+			size_t numNormals = std::min(target.normals.size(), m_vertexCount);
+
+			for (size_t v = 0; v < numPositions; ++v)
+				targetDeltas[v * 2] = target.positions[v];
+
+			for (size_t v = 0; v < numNormals; ++v)
+				targetDeltas[v * 2 + 1] = target.normals[v];
+
+			if (!keepSparse)
+				continue;
+
+			//Blend shapes tend to move a small part of the mesh (e.g., just the mouth),
+			//so the CPU path only keeps the vertices that actually move.
+			m_sparseMorphs.emplace_back();
+			SparseMorph& sparse = m_sparseMorphs.back();
+
+			for (size_t v = 0; v < m_vertexCount; ++v)
+			{
+				const glm::vec3& pos = targetDeltas[v * 2];
+				const glm::vec3& normal = targetDeltas[v * 2 + 1];
+
+				if (pos == glm::vec3(0.0f) && normal == glm::vec3(0.0f))
+					continue;
+
+				sparse.indices.push_back((GLuint)v);
+				sparse.positions.push_back(pos);
+				sparse.normals.push_back(normal);
+			}
+		}
+
+		GLsizeiptr size = (GLsizeiptr)(deltas.size() * sizeof(glm::vec3));
+
+		if (m_morphDeltas == nullptr)
+			m_morphDeltas = std::make_unique<TextureBuffer>(GL_RGB32F, deltas.data(), size);
+		else
+			m_morphDeltas->UpdateData(deltas.data(), size);
+	}
+
+	size_t Mesh::GetMorphTargetCount() const
+	{
+		return m_morphCount;
+	}
+
+	const TextureBuffer* Mesh::GetMorphDeltas() const
+	{
+		return m_morphDeltas.get();
+	}
+
+	bool Mesh::ApplyMorphWeights(const std::vector<float>& weights,
+								 std::vector<glm::vec3>& verts,
+								 std::vector<glm::vec3>& normals) const
+	{
+		if (!HasCPUData())
+			return false;
+
+		verts = m_verts;
+		normals = m_normals;
+
+		bool hasNormals = normals.size() == verts.size();
+		size_t numTargets = std::min(weights.size(), m_sparseMorphs.size());
+
+		for (size_t t = 0; t < numTargets; ++t)
+		{
+			float weight = weights[t];
+
+			if (weight == 0.0f)
+				continue;
+
+			const SparseMorph& sparse = m_sparseMorphs[t];
+
+			for (size_t i = 0; i < sparse.indices.size(); ++i)
+			{
+				GLuint v = sparse.indices[i];
+				verts[v] += weight * sparse.positions[i];
+
+				if (hasNormals)
+					normals[v] += weight * sparse.normals[i];
+			}
+		}
+
+		return true;
+	}
+
+	void Mesh::ReleaseCPUData()
+	{
+		//Swapping with an empty vector actually gives the memory back,
+		//clear() alone would keep the capacity around.
+		std::vector<glm::vec3>().swap(m_verts);
+		std::vector<glm::vec3>().swap(m_normals);
+		std::vector<glm::vec2>().swap(m_uvs);
+		std::vector<SparseMorph>().swap(m_sparseMorphs);
+	}
+
+	bool Mesh::HasCPUData() const
+	{
+		return m_verts.size() > 0;
+	}
+
+	Mesh::Layout Mesh::GetLayout() const
+	{
+		return m_layout;
+	}
+
+	size_t Mesh::GetVertexCount() const
+	{
+		return m_vertexCount;
 	}
 
 	const VertexBuffer* Mesh::GetVBO(Mesh::Attrib attrib) const
 	{
+		if (m_interleavedAttribs.count(attrib) > 0)
+			return m_interleaved.get();
+
 		auto it = m_vbo.find(attrib);
 
 		if (it == m_vbo.end())
@@ -37,4 +270,94 @@ namespace nou
 
 		return it->second.get();
 	}
-}
\ No newline at end of file
+
+	VertexAttribLayout Mesh::GetAttribLayout(Mesh::Attrib attrib) const
+	{
+		auto interleavedIt = m_interleavedAttribs.find(attrib);
+
+		if (interleavedIt != m_interleavedAttribs.end())
+			return interleavedIt->second;
+
+		//Attributes in their own buffers are tightly packed floats.
+		VertexAttribLayout layout;
+		auto it = m_vbo.find(attrib);
+
+		if (it != m_vbo.end())
+			layout.elementLen = it->second->ElementLength();
+
+		return layout;
+	}
+
+	const IndexBuffer* Mesh::GetIBO() const
+	{
+		return m_ibo.get();
+	}
+
+	void Mesh::UploadInterleaved()
+	{
+		//Nothing to interleave without positions - this happens when setting
+		//attributes one at a time after the CPU data has been released.
+		//Whatever was uploaded before is left as is.
+		if (m_verts.size() == 0)
+		{
+			if (m_normals.size() > 0 || m_uvs.size() > 0)
+				std::cout << "Interleaved mesh has no positions to pack attributes with - "
+							 "use SetVertexData if the CPU data isn't kept." << std::endl;
+
+			return;
+		}
+
+		m_interleavedAttribs.clear();
+
+		size_t count = m_verts.size();
+
+		//Attributes that don't line up with the positions can't be interleaved.
+		bool hasNormals = m_normals.size() == count;
+		bool hasUVs = m_uvs.size() == count;
+
+		if ((m_normals.size() > 0 && !hasNormals) || (m_uvs.size() > 0 && !hasUVs))
+			std::cout << "Interleaved mesh attribute counts don't match the vertex count, "
+						 "leaving them out." << std::endl;
+
+		//The size of a vertex in floats.
+		GLint stride = 3 + (hasNormals ? 3 : 0) + (hasUVs ? 2 : 0);
+		GLsizei strideBytes = stride * (GLsizei)sizeof(float);
+
+		size_t offset = 0;
+		auto addAttrib = [&](Attrib attrib, GLint elementLen)
+		{
+			VertexAttribLayout layout;
+			layout.elementLen = elementLen;
+			layout.stride = strideBytes;
+			layout.offset = offset * sizeof(float);
+			m_interleavedAttribs[attrib] = layout;
+			offset += elementLen;
+		};
+
+		addAttrib(Attrib::POSITION, 3);
+		if (hasNormals)
+			addAttrib(Attrib::NORMAL, 3);
+		if (hasUVs)
+			addAttrib(Attrib::UV, 2);
+
+		std::vector<float> data;
+		data.reserve(count * stride);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			data.insert(data.end(), { m_verts[i].x, m_verts[i].y, m_verts[i].z });
+
+			if (hasNormals)
+				data.insert(data.end(), { m_normals[i].x, m_normals[i].y, m_normals[i].z });
+
+			if (hasUVs)
+				data.insert(data.end(), { m_uvs[i].x, m_uvs[i].y });
+		}
+
+		//Each "element" of the buffer is a whole vertex.
+		if (m_interleaved == nullptr)
+			m_interleaved = std::make_unique<VertexBuffer>(stride, data.data(), (GLsizei)count, strideBytes);
+		else
+			m_interleaved->UpdateData(data.data(), (GLsizei)count, strideBytes);
+	}
+}
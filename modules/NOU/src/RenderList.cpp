@@ -0,0 +1,115 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+RenderList.cpp
+Collects mesh renderers and draws them sorted by shader program and
+material, so each program and material is only bound once per batch.
+*/
+
+#include "NOU/RenderList.h"
+#include "NOU/CCamera.h"
+#include "NOU/CSkinnedMeshRenderer.h"
+#include "NOU/CMorphMeshRenderer.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace nou
+{
+	RenderList::RenderList()
+	{
+		m_programBinds = 0;
+		m_materialBinds = 0;
+	}
+
+	void RenderList::Clear()
+	{
+		m_renderers.clear();
+	}
+
+	void RenderList::Add(CMeshRenderer& renderer)
+	{
+		m_renderers.push_back(&renderer);
+	}
+
+	void RenderList::Gather(World& world)
+	{
+		entt::registry& registry = world.GetRegistry();
+
+		//ENTT stores each component type separately, so derived
+		//renderers don't show up in a view of CMeshRenderer.
+		registry.view<CMeshRenderer>().each([this](CMeshRenderer& renderer) { Add(renderer); });
+		registry.view<CSkinnedMeshRenderer>().each([this](CSkinnedMeshRenderer& renderer) { Add(renderer); });
+		registry.view<CMorphMeshRenderer>().each([this](CMorphMeshRenderer& renderer) { Add(renderer); });
+	}
+
+	void RenderList::Draw()
+	{
+		m_programBinds = 0;
+		m_materialBinds = 0;
+
+		if (m_renderers.empty())
+			return;
+
+		//Program first, since switching programs costs the most, then material.
+		//Stable, so renderers sharing both still draw in the order they were added.
+		std::less<const void*> before;
+
+		std::stable_sort(m_renderers.begin(), m_renderers.end(),
+			[&](const CMeshRenderer* a, const CMeshRenderer* b)
+			{
+				const ShaderProgram* programA = &a->GetMaterial().GetProgram();
+				const ShaderProgram* programB = &b->GetMaterial().GetProgram();
+
+				if (programA != programB)
+					return before(programA, programB);
+
+				return before(&a->GetMaterial(), &b->GetMaterial());
+			});
+
+		const ShaderProgram* program = nullptr;
+		const Material* material = nullptr;
+
+		for (CMeshRenderer* renderer : m_renderers)
+		{
+			Material& mat = renderer->GetMaterial();
+
+			if (&mat != material)
+			{
+				if (&mat.GetProgram() != program)
+				{
+					program = &mat.GetProgram();
+					program->Bind();
+					++m_programBinds;
+
+					//The camera block is shared by every program, but binding it
+					//after the first program is bound keeps the order the same as Draw.
+					if (m_programBinds == 1)
+						CCamera::BindCurrent();
+				}
+
+				mat.Apply();
+				material = &mat;
+				++m_materialBinds;
+			}
+
+			renderer->DrawInBatch();
+		}
+	}
+
+	size_t RenderList::Size() const
+	{
+		return m_renderers.size();
+	}
+
+	int RenderList::GetProgramBinds() const
+	{
+		return m_programBinds;
+	}
+
+	int RenderList::GetMaterialBinds() const
+	{
+		return m_materialBinds;
+	}
+}
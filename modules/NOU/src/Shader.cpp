@@ -7,11 +7,13 @@ Utility classes for managing OpenGL shaders and shader programs.
 */
 
 #include "NOU/Shader.h"
+#include "NOU/GLState.h"
 
 #include "GLM/glm.hpp"
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 namespace nou
 {
@@ -148,7 +150,10 @@ namespace nou
 
 		//Provide feedback on the program's linking.
 		if (result)
+		{
 			printf("Linked shader program successfully.\n");
+			CacheUniformLocs();
+		}
 		else
 		{
 			GLint buflen = 0;
@@ -169,11 +174,12 @@ namespace nou
 	ShaderProgram::~ShaderProgram()
 	{
 		glDeleteProgram(m_id);
+		GLState::ForgetProgram(m_id);
 	}
 
 	void ShaderProgram::Bind() const
 	{
-		glUseProgram(m_id);
+		GLState::UseProgram(m_id);
 		m_current = this;
 	}
 
@@ -184,48 +190,100 @@ namespace nou
 
 	GLint ShaderProgram::GetUniformLoc(const std::string& name) const
 	{
-		return glGetUniformLocation(m_id, name.c_str());
+		auto it = m_uniformLocs.find(name);
+
+		if (it != m_uniformLocs.end())
+			return it->second;
+
+		GLint loc = glGetUniformLocation(m_id, name.c_str());
+		m_uniformLocs[name] = loc;
+
+		return loc;
+	}
+
+	void ShaderProgram::CacheUniformLocs()
+	{
+		m_uniformLocs.clear();
+
+		GLint numUniforms = 0, maxLen = 0;
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &numUniforms);
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+
+		std::vector<GLchar> name(std::max(maxLen, 1));
+
+		for (GLint i = 0; i < numUniforms; ++i)
+		{
+			GLsizei len = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(m_id, (GLuint)i, (GLsizei)name.size(), &len, &size, &type, name.data());
+
+			std::string uniformName(name.data(), len);
+			GLint loc = glGetUniformLocation(m_id, uniformName.c_str());
+
+			//Uniforms inside a uniform block don't have locations.
+			if (loc == -1)
+				continue;
+
+			m_uniformLocs[uniformName] = loc;
+
+			//Arrays are listed as "name[0]", but are usually set by plain name.
+			if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+				m_uniformLocs[uniformName.substr(0, uniformName.size() - 3)] = loc;
+		}
+	}
+
+	template<>
+	void ShaderProgram::SetUniform<int>(GLint loc, const int& value) const
+	{
+		glUniform1i(loc, value);
+	}
+
+	template<>
+	void ShaderProgram::SetUniform<float>(GLint loc, const float& value) const
+	{
+		glUniform1f(loc, value);
 	}
 
 	template<>
-	void ShaderProgram::SetUniform<int>(const std::string& name, const int& value) const
+	void ShaderProgram::SetUniform<glm::mat4>(GLint loc, const glm::mat4& value) const
 	{
-		glUniform1i(GetUniformLoc(name), value);
+		glUniformMatrix4fv(loc, 1, GL_FALSE, &value[0][0]);
 	}
 
 	template<>
-	void ShaderProgram::SetUniform<float>(const std::string& name, const float& value) const
+	void ShaderProgram::SetUniform<glm::mat3>(GLint loc, const glm::mat3& value) const
 	{
-		glUniform1f(GetUniformLoc(name), value);
+		glUniformMatrix3fv(loc, 1, GL_FALSE, &value[0][0]);
 	}
 
 	template<>
-	void ShaderProgram::SetUniform<glm::mat4>(const std::string& name, const glm::mat4& value) const
+	void ShaderProgram::SetUniform<glm::vec4>(GLint loc, const glm::vec4& value) const
 	{
-		glUniformMatrix4fv(GetUniformLoc(name), 1, GL_FALSE, &value[0][0]);
+		glUniform4fv(loc, 1, &(value.x));
 	}
 
 	template<>
-	void ShaderProgram::SetUniform<glm::mat3>(const std::string& name, const glm::mat3& value) const
+	void ShaderProgram::SetUniform<glm::vec3>(GLint loc, const glm::vec3& value) const
 	{
-		glUniformMatrix3fv(GetUniformLoc(name), 1, GL_FALSE, &value[0][0]);
+		glUniform3fv(loc, 1, &(value.x));
 	}
 
 	template<>
-	void ShaderProgram::SetUniform<glm::vec4>(const std::string& name, const glm::vec4& value) const
+	void ShaderProgram::SetUniformArray<int>(GLint loc, int* data, int len) const
 	{
-		glUniform4fv(GetUniformLoc(name), 1, &(value.x));
+		glUniform1iv(loc, len, data);
 	}
 
 	template<>
-	void ShaderProgram::SetUniform<glm::vec3>(const std::string& name, const glm::vec3& value) const
+	void ShaderProgram::SetUniformArray<float>(GLint loc, float* data, int len) const
 	{
-		glUniform3fv(GetUniformLoc(name), 1, &(value.x));
+		glUniform1fv(loc, len, data);
 	}
 
 	template<>
-	void ShaderProgram::SetUniformArray<glm::mat4>(const std::string& name, glm::mat4* data, int len) const
+	void ShaderProgram::SetUniformArray<glm::mat4>(GLint loc, glm::mat4* data, int len) const
 	{
-		glUniformMatrix4fv(GetUniformLoc(name), len, GL_FALSE, (GLfloat*)data);
+		glUniformMatrix4fv(loc, len, GL_FALSE, (GLfloat*)data);
 	}
 }
@@ -0,0 +1,265 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+SystemScheduler.cpp
+Runs systems in parallel when the components they touch don't overlap.
+*/
+
+#include "NOU/SystemScheduler.h"
+
+#include <algorithm>
+
+namespace nou
+{
+	SystemAccess& SystemAccess::Exclusive()
+	{
+		m_exclusive = true;
+		return *this;
+	}
+
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		if (m_exclusive || other.m_exclusive)
+			return true;
+
+		auto overlaps = [](const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b)
+		{
+			for (entt::id_type id : a)
+			{
+				if (std::find(b.begin(), b.end(), id) != b.end())
+					return true;
+			}
+			return false;
+		};
+
+		//Reading the same components at the same time is fine.
+		return overlaps(m_writes, other.m_writes) ||
+			   overlaps(m_writes, other.m_reads) ||
+			   overlaps(m_reads, other.m_writes);
+	}
+
+	void SystemAccess::Prepare(entt::registry& registry) const
+	{
+		for (auto prepare : m_prepare)
+			prepare(registry);
+	}
+
+	SystemScheduler::SystemScheduler(int numThreads)
+	{
+		m_stagesDirty = false;
+		m_deltaTime = 0.0f;
+		m_job = nullptr;
+		m_jobCount = 0;
+		m_generation = 0;
+		m_activeWorkers = 0;
+		m_nextJob = 0;
+		m_remainingJobs = 0;
+		m_quit = false;
+
+		if (numThreads <= 0)
+			numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+
+		//The thread calling Run does its share of the work too.
+		for (int i = 1; i < numThreads; ++i)
+			m_workers.emplace_back(&SystemScheduler::WorkerLoop, this);
+	}
+
+	SystemScheduler::~SystemScheduler()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wake.notify_all();
+
+		for (std::thread& worker : m_workers)
+			worker.join();
+	}
+
+	void SystemScheduler::AddSystem(const std::string& name, World& world, const SystemAccess& access, SystemFunc func)
+	{
+		m_systems.push_back({ name, &world, access, func });
+		m_stagesDirty = true;
+	}
+
+	void SystemScheduler::ClearSystems()
+	{
+		m_systems.clear();
+		m_stages.clear();
+		m_stagesDirty = false;
+	}
+
+	void SystemScheduler::Run(float deltaTime)
+	{
+		if (m_stagesDirty)
+			BuildStages();
+
+		m_deltaTime = deltaTime;
+
+		for (const System& system : m_systems)
+			system.access.Prepare(system.world->GetRegistry());
+
+		for (const std::vector<size_t>& stage : m_stages)
+			RunStage(stage);
+	}
+
+	void SystemScheduler::ParallelFor(size_t count, const std::function<void(size_t, size_t)>& func)
+	{
+		if (count == 0)
+			return;
+
+		//A few chunks per thread, so a thread that gets held up
+		//doesn't leave the others waiting on it.
+		size_t chunks = std::min(count, (size_t)GetNumThreads() * 4);
+		size_t chunkSize = (count + chunks - 1) / chunks;
+		chunks = (count + chunkSize - 1) / chunkSize;
+
+		Job job = [&](size_t chunk)
+		{
+			size_t begin = chunk * chunkSize;
+			func(begin, std::min(begin + chunkSize, count));
+		};
+
+		RunParallel(job, chunks);
+	}
+
+	int SystemScheduler::GetNumThreads() const
+	{
+		return (int)m_workers.size() + 1;
+	}
+
+	std::vector<std::vector<std::string>> SystemScheduler::GetStages()
+	{
+		if (m_stagesDirty)
+			BuildStages();
+
+		std::vector<std::vector<std::string>> names;
+
+		for (const std::vector<size_t>& stage : m_stages)
+		{
+			names.emplace_back();
+			for (size_t index : stage)
+				names.back().push_back(m_systems[index].name);
+		}
+
+		return names;
+	}
+
+	void SystemScheduler::BuildStages()
+	{
+		m_stages.clear();
+		std::vector<size_t> stageOf(m_systems.size());
+
+		//Each system goes in the stage after the last one holding something
+		//it conflicts with, which keeps conflicting systems in the order they were added.
+		for (size_t i = 0; i < m_systems.size(); ++i)
+		{
+			size_t stage = 0;
+
+			for (size_t j = 0; j < i; ++j)
+			{
+				if (m_systems[i].world == m_systems[j].world &&
+					m_systems[i].access.ConflictsWith(m_systems[j].access))
+					stage = std::max(stage, stageOf[j] + 1);
+			}
+
+			stageOf[i] = stage;
+			if (stage >= m_stages.size())
+				m_stages.resize(stage + 1);
+			m_stages[stage].push_back(i);
+		}
+
+		m_stagesDirty = false;
+	}
+
+	void SystemScheduler::RunStage(const std::vector<size_t>& stage)
+	{
+		Job job = [&](size_t i)
+		{
+			const System& system = m_systems[stage[i]];
+			system.func(*system.world, m_deltaTime);
+		};
+
+		RunParallel(job, stage.size());
+	}
+
+	void SystemScheduler::RunParallel(const Job& job, size_t count)
+	{
+		//Not worth waking anyone up for.
+		if (count == 1 || m_workers.empty())
+		{
+			for (size_t i = 0; i < count; ++i)
+				job(i);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_job = &job;
+			m_jobCount = count;
+			m_nextJob = 0;
+			m_remainingJobs = count;
+			++m_generation;
+		}
+		m_wake.notify_all();
+
+		RunJobs(job, count);
+
+		//Waiting on the workers (not just the jobs) means none of them can
+		//still be looking at this job once the next one starts.
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]() { return m_remainingJobs == 0 && m_activeWorkers == 0; });
+		m_job = nullptr;
+	}
+
+	void SystemScheduler::RunJobs(const Job& job, size_t count)
+	{
+		while (true)
+		{
+			size_t i = m_nextJob.fetch_add(1);
+			if (i >= count)
+				return;
+
+			job(i);
+
+			if (m_remainingJobs.fetch_sub(1) == 1)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_done.notify_all();
+			}
+		}
+	}
+
+	void SystemScheduler::WorkerLoop()
+	{
+		size_t seenGeneration = 0;
+
+		while (true)
+		{
+			const Job* job;
+			size_t count;
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&]() { return m_quit || (m_job != nullptr && m_generation != seenGeneration); });
+
+				if (m_quit)
+					return;
+
+				seenGeneration = m_generation;
+				job = m_job;
+				count = m_jobCount;
+				++m_activeWorkers;
+			}
+
+			RunJobs(*job, count);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				--m_activeWorkers;
+			}
+			m_done.notify_all();
+		}
+	}
+}
@@ -7,6 +7,7 @@ Simple wrapper for STB image loading into 2D textures.
 */
 
 #include "NOU/Texture.h"
+#include "NOU/GLState.h"
 
 #include "stb_image.h"
 
@@ -32,7 +33,7 @@ namespace nou
 		//Generate a new OpenGL texture.
 		glGenTextures(1, &m_id);
 		//Bind the texture to specify we want to change its properties/data.
-		glBindTexture(GL_TEXTURE_2D, m_id);
+		GLState::BindTexture(GL_TEXTURE_2D, m_id);
 
 		//Sets our texture to repeat if accessed outside the (0, 1) texture
 		//coordinate interval.
@@ -63,6 +64,7 @@ namespace nou
 	Texture2D::~Texture2D()
 	{
 		glDeleteTextures(1, &m_id);
+		GLState::ForgetTexture(m_id);
 	}
 
 	GLuint Texture2D::GetID() const
@@ -0,0 +1,30 @@
+/*
+NOU Framework - Created for INFR 2310 at Ontario Tech.
+(c) Samantha Stahlke 2020
+
+World.cpp
+An independent ECS world, each with its own registry.
+*/
+
+#include "NOU/World.h"
+
+namespace nou
+{
+	entt::registry& World::GetRegistry()
+	{
+		return m_registry;
+	}
+
+	const entt::registry& World::GetRegistry() const
+	{
+		return m_registry;
+	}
+
+	World& World::Default()
+	{
+		//Created on first use, so it's never touched before it exists
+		//(even from other static objects).
+		static World world;
+		return world;
+	}
+}
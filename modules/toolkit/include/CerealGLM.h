@@ -4,7 +4,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <cereal/cereal.hpp>
-#include <glm/glm.hpp>
+#include <GLM/glm.hpp>
 
 namespace glm
 {
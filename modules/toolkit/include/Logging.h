@@ -43,5 +43,12 @@ private:
 #define LOG_WARN(...)  ::Logger::GetLogger()->warn(__VA_ARGS__)
 #define LOG_ERROR(...) { ::Logger::GetLogger()->error(__VA_ARGS__); ::Logger::GetLogger()->error("Location: \n{}", ::Logger::DumpStackTrace()); }
 
+// Breaks into the debugger (or stops the program if there isn't one)
+#ifdef _MSC_VER
+#define LOG_DEBUG_BREAK() __debugbreak()
+#else
+#define LOG_DEBUG_BREAK() __builtin_trap()
+#endif
+
 // Allows us to assert if a value is true, and automagically debug break if it is false
-#define LOG_ASSERT(x, ...) { if (!(x)) { ::Logger::GetLogger()->error(__VA_ARGS__); __debugbreak(); } }
\ No newline at end of file
+#define LOG_ASSERT(x, ...) { if (!(x)) { ::Logger::GetLogger()->error(__VA_ARGS__); LOG_DEBUG_BREAK(); } }
\ No newline at end of file
@@ -12,7 +12,7 @@
 
 #pragma once
 
-#include <glm/vec3.hpp>
+#include <GLM/vec3.hpp>
 #include <GLM/gtc/matrix_transform.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <GLM/gtx/rotate_vector.hpp>
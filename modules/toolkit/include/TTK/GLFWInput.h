@@ -6,23 +6,50 @@
 #include "GLFW/glfw3.h"
 
 namespace TTK {
+	/*
+	 * Keys, mouse buttons and the scroll wheel are all event driven: GLFW's callbacks push timestamped events onto
+	 * a queue, and they are applied the next time the input state is read. A key that is pressed and released
+	 * between two polls still reads as Pressed for a frame, and Released the frame after
+	 */
 	class GlfwInput : public Input {
 	public:
 		GlfwInput();
 		virtual ~GlfwInput();
-		
+
 	protected:
 		ButtonState __GetKeyState(KeyCode key) override;
 		ButtonState __GetMouseState(MouseButton button) override;
+		uint64_t __GetKeyTime(KeyCode key) override;
+		const std::vector<uint64_t>& __GetFrameEventTimes() override;
 		glm::vec2 __GetMousePos() override;
 		glm::vec2 __GetMouseScroll() override;
 		glm::vec2 __GetMouseScrollDelta() override;
 		void __Poll() override;
 		void __Init(void* windowPtr) override;
 
+		/*
+		 * Applies any events that have been queued since the last call
+		 */
+		void __ApplyEvents();
+		/*
+		 * Applies a press or release to a key or mouse button
+		 * @param index The key code, or TTK_KEY_LAST + 1 + the mouse button
+		 */
+		void __ApplyButton(size_t index, int action);
+
+		static constexpr size_t NUM_BUTTONS = (size_t)TTK_KEY_LAST + 1 + (size_t)TTK_MOUSEBUTTON_LAST + 1;
+
 		GLFWwindow* m_Window;
-		char m_PrevKeys[(size_t)TTK_KEY_LAST + 1];
-		char m_PrevMouse[(size_t)TTK_MOUSEBUTTON_LAST + 1];
+		// Keys first, then mouse buttons
+		char m_Buttons[NUM_BUTTONS];
+		char m_PrevButtons[NUM_BUTTONS];
+		// Set for buttons that went down since the last poll
+		char m_PressedSincePoll[NUM_BUTTONS];
+		// Set for buttons released in the same frame they were pressed, we hold on to the release until the next poll
+		char m_DeferredRelease[NUM_BUTTONS];
+		uint64_t m_KeyTimes[(size_t)TTK_KEY_LAST + 1];
+		// When each key and mouse button event applied since the last poll happened
+		std::vector<uint64_t> m_FrameEventTimes;
 	};
 }
 #endif
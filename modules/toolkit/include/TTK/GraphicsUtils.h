@@ -14,7 +14,7 @@
 #define GRAPHICS_UTILS_H
 
 #include <string>
-#include <glm/glm.hpp>
+#include <GLM/glm.hpp>
 
 struct GLFWwindow;
 
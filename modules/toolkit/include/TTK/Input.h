@@ -1,6 +1,8 @@
 ﻿#pragma once
 #include <GLM/detail/type_vec2.hpp>
 #include "../EnumToString.h"
+#include <cstdint>
+#include <vector>
 
 namespace TTK {
 
@@ -182,6 +184,18 @@ namespace TTK {
 		 * @returns A ButtonState that represents the key's current state
 		 */
 		static ButtonState GetKeyState(KeyCode key);
+		/*
+		 * Gets when the given key was last pressed or released, for anything that cares how late in a frame it happened
+		 * @param key The key to get the time for
+		 * @returns The glfwGetTimerValue ticks of the key's last event, or 0 if it has never been pressed
+		 */
+		static uint64_t GetKeyTime(KeyCode key);
+		/*
+		 * Gets when each key and mouse button event applied since the last Poll happened, for measuring how long
+		 * input takes to make it to the screen
+		 * @returns The glfwGetTimerValue ticks of each event, oldest first
+		 */
+		static const std::vector<uint64_t>& GetFrameEventTimes();
 
 		/*
 		 * Gets the current x position on the mouse on the screen, in screen-space
@@ -242,7 +256,8 @@ namespace TTK {
 		static void Uninitialize();
 		/*
 		 * Allows the TTK input system to check for changes in input devices, this should be called at the end of a
-		 * frame, before glfwPollEvents
+		 * frame, before glfwPollEvents. Input events that arrive during glfwPollEvents are applied the next time any
+		 * input state is read
 		 */
 		static void Poll();
 
@@ -254,6 +269,8 @@ namespace TTK {
 		
 		virtual ButtonState  __GetKeyState(KeyCode key) = 0;
 		virtual ButtonState __GetMouseState(MouseButton button) = 0;
+		virtual uint64_t __GetKeyTime(KeyCode key) = 0;
+		virtual const std::vector<uint64_t>& __GetFrameEventTimes() = 0;
 		
 		virtual glm::vec2 __GetMousePos() = 0;
 		virtual glm::vec2 __GetMouseScroll() = 0;
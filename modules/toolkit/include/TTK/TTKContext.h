@@ -14,6 +14,8 @@
 #pragma once
 
 #include <GLM/glm.hpp>
+#include <vector>
+#include <cstdint>
 #include "FontRenderer.h"
 
 namespace TTK
@@ -35,6 +37,16 @@ namespace TTK
 			glm::vec4 Color;
 			float     Size;
 		};
+
+		/*
+		 * Vertex used by the debug batch, the color is packed into RGBA8 so a vertex
+		 * is 16 bytes instead of 28
+		 */
+		struct DebugVert
+		{
+			glm::vec3 Position;
+			uint32_t  Color;
+		};
 		
 		inline static Context& Instance() {
 			if (m_Instance == nullptr)
@@ -74,6 +86,44 @@ namespace TTK
 		void AddTri(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec4& color = { 0, 0, 0, 1 });
 		void AddQuad(const glm::vec3& min, const glm::vec3& max, const glm::vec4& color = { 0, 0, 0, 1 });
 		void AddPoint(const glm::vec3& pos, float size, const glm::vec4& color = { 0, 0, 0, 1 });
+
+		/*
+		 * The debug batch is meant for very large amounts of geometry (ex: physics debug drawing).
+		 * Unlike AddLine and AddTri, nothing is drawn until FlushDebug or Flush is called, the
+		 * CPU side storage grows as needed, and everything is uploaded and drawn in chunks of
+		 * DebugChunkVerts vertices, so a few hundred thousand lines is only a handful of draw calls
+		 */
+		void AddDebugLine(const glm::vec3& a, const glm::vec3& b, uint32_t color) {
+			m_DebugLineVerts.push_back({ a, color });
+			m_DebugLineVerts.push_back({ b, color });
+		}
+		void AddDebugLine(const glm::vec3& a, const glm::vec3& b, uint32_t colorA, uint32_t colorB) {
+			m_DebugLineVerts.push_back({ a, colorA });
+			m_DebugLineVerts.push_back({ b, colorB });
+		}
+		void AddDebugTri(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, uint32_t color) {
+			m_DebugTriVerts.push_back({ a, color });
+			m_DebugTriVerts.push_back({ b, color });
+			m_DebugTriVerts.push_back({ c, color });
+		}
+		/*
+		 * Reserves room in the debug batch so that a frame of the expected size never reallocates
+		 * @param lines The number of lines to reserve room for
+		 * @param tris The number of triangles to reserve room for
+		 */
+		void ReserveDebug(size_t lines, size_t tris);
+		void FlushDebug();
+
+		size_t GetDebugLineCount() const { return m_DebugLineVerts.size() / 2; }
+		size_t GetDebugTriCount() const { return m_DebugTriVerts.size() / 3; }
+		// Gets the number of draw calls the last FlushDebug used
+		size_t GetDebugDrawCalls() const { return m_DebugDrawCalls; }
+
+		// Packs a 0-1 color into the RGBA8 format used by DebugVert
+		static uint32_t PackColor(const glm::vec4& color) {
+			glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+			return (uint32_t)c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16) | ((uint32_t)c.a << 24);
+		}
 		
 		void Flush();
 
@@ -96,20 +146,28 @@ namespace TTK
 			GLuint Shader;
 		};
 		GLBuff m_Tris, m_Lines, m_Points;
+		GLBuff m_DebugTris, m_DebugLines;
 
 		int m_WindowWidth, m_WindowHeight;
 		int m_viewportX, m_viewportY;
 
 		GLBuff __InitBuff(GLenum mode, GLuint shader, void* dataSource, size_t elemSize, size_t maxElems);
 		void __Flush(GLBuff& buff);
+		void __FlushDebug(GLBuff& buff, std::vector<DebugVert>& verts, size_t vertsPerPrim);
 		GLuint __CompileShader(const char* vsSource, const char* fsSource);
 
 		static const size_t MaxPointVerts = 512;
 		static const size_t MaxLineVerts = 512 * 2;
 		static const size_t MaxTriVerts = 512 * 3;
+		// Vertices uploaded per debug draw call (4MB of DebugVerts)
+		static const size_t DebugChunkVerts = 1 << 18;
 
 		PointVert  m_PointVerts[MaxPointVerts];
 		SimpleVert m_LineVerts[MaxLineVerts];
 		SimpleVert m_TriVerts[MaxTriVerts];
+
+		std::vector<DebugVert> m_DebugLineVerts;
+		std::vector<DebugVert> m_DebugTriVerts;
+		size_t m_DebugDrawCalls;
 	};
 }
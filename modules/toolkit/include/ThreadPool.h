@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+	A fixed set of worker threads that split the range of a loop between them.
+	The calling thread also works on the loop, so a pool of N threads has N - 1 workers.
+	Any thread can call ParallelFor, loops from different threads take turns on the pool.
+*/
+class ThreadPool
+{
+public:
+	/*
+		Creates a pool with the given number of threads (including the caller), 0 uses every hardware thread
+	*/
+	ThreadPool(int numThreads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool& other) = delete;
+	ThreadPool& operator=(const ThreadPool& other) = delete;
+
+	/*
+		Gets the number of threads that work on a loop, including the calling thread
+	*/
+	int GetNumThreads() const { return static_cast<int>(myWorkers.size()) + 1; }
+	/*
+		Restarts the pool with a new number of threads, waits for a running loop to finish first.
+		Must not be called from inside a loop.
+	*/
+	void SetNumThreads(int numThreads);
+
+	/*
+		Runs func(chunkBegin, chunkEnd) over [begin, end) in chunks of grainSize, blocking until every chunk is done.
+		Nested calls from inside a loop run on the calling thread. If another thread's loop is running, this
+		waits for it to finish before starting.
+	*/
+	void ParallelFor(int begin, int end, int grainSize, const std::function<void(int, int)>& func);
+
+	/*
+		Gets the number of hardware threads on this machine (at least 1)
+	*/
+	static int GetHardwareThreads();
+
+private:
+	void StartWorkers(int numWorkers);
+	void StopWorkers();
+	void WorkerLoop();
+	// Takes chunks of the current loop until there are none left
+	void RunChunks();
+
+	std::vector<std::thread> myWorkers;
+
+	// Held by the thread whose loop is running, the loop state below only holds one loop at a time
+	std::mutex myCallerMutex;
+
+	// The loop being run
+	const std::function<void(int, int)>* myFunc;
+	int myEnd;
+	int myGrainSize;
+	std::atomic<int> myNextIndex;
+	std::atomic<int> myChunksLeft;
+
+	// Wakes workers when a new loop starts (myGeneration changes), and the caller when it ends
+	std::mutex myMutex;
+	std::condition_variable myStartCondition;
+	std::condition_variable myDoneCondition;
+	int myActiveWorkers;
+	uint64_t myGeneration;
+	bool myIsStopping;
+	bool myIsRunning;
+};
@@ -18,8 +18,7 @@ project "toolkit"
         "Glad",
         "GLFW",
         "stbs",
-        "spdlog",
-        "opengl32.lib"
+        "spdlog"
     }
 
     includedirs {
@@ -46,6 +45,15 @@ project "toolkit"
             "TTK_GLFW"
         }
 
+        links {
+            "opengl32.lib"
+        }
+
+    filter "system:linux"
+        defines {
+            "TTK_GLFW"
+        }
+
         
     filter "configurations:Debug"
         runtime "Debug"
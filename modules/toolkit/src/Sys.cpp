@@ -10,6 +10,8 @@ size_t System::GetMemoryUsageBytes() {
 	static PROCESS_MEMORY_COUNTERS pmc;
 	GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
 	return pmc.WorkingSetSize;
+	#else
+	return 0;
 	#endif
 }
 
@@ -19,6 +21,8 @@ size_t System::GetPageUsageBytes()
 	static PROCESS_MEMORY_COUNTERS pmc;
 	GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
 	return pmc.QuotaPagedPoolUsage;
+	#else
+	return 0;
 	#endif
 }
 
@@ -27,6 +31,8 @@ size_t System::GetPeakMemoryUsageBytes() {
 	static PROCESS_MEMORY_COUNTERS pmc;
 	GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
 	return pmc.PeakWorkingSetSize;
+	#else
+	return 0;
 	#endif
 }
 
@@ -52,10 +58,13 @@ double System::GetCpuUsage()
 	lastSysCPU = sys;
 
 	return percent * 100.0;
+	#else
+	return 0.0;
 	#endif
 }
 
 void System::__Init() {
+	#ifdef WINDOWS
 	static bool isInit = false;
 	if (!isInit) {
 		SYSTEM_INFO sysInfo;
@@ -74,6 +83,7 @@ void System::__Init() {
 
 		isInit = true;
 	}
+	#endif
 }
 
 int System::numProcessors;
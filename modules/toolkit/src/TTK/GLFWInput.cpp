@@ -2,26 +2,98 @@
 #include "GLFW/glfw3.h"
 #include "Logging.h"
 
-struct NativeWindowProxy {
-	void* spacer0;
-	int   spacer1[6];
-	void* userPointer;
-	GLFWvidmode videoMode;
-	void* spacer2[2];
-	int   spacer3[10];
-	char  mouseButtons[GLFW_MOUSE_BUTTON_LAST + 1];
-	char  keys[GLFW_KEY_LAST + 1];
+#include <atomic>
+
+/*
+ * A key, mouse button or scroll wheel event, as GLFW handed it to us
+ */
+struct InputEvent {
+	enum Kind : uint8_t {
+		Key,
+		Mouse,
+		Scroll
+	};
+	Kind       Type;
+	int        Code;
+	int        Action;
+	glm::dvec2 Offset;
+	// When GLFW handed us the event (from glfwGetTimerValue), GLFW doesn't pass on the OS timestamps
+	uint64_t   Ticks;
 };
 
-GLFWscrollfun g_PrevScrollCallback = nullptr;
-glm::dvec2    g_CurrentMouseScroll = glm::dvec2(0.0);
-glm::dvec2    g_CurrentMouseScrollDelta = glm::dvec2(0.0);
+/*
+ * A ring buffer of input events. The GLFW callbacks are the only thing that pushes and the input system is
+ * the only thing that pops, so neither side needs a lock
+ */
+struct InputEventQueue {
+	static constexpr size_t Capacity = 1024;
+
+	InputEvent          Events[Capacity];
+	// Both only ever count up, the slot is the count modulo Capacity
+	std::atomic<size_t> Head = 0;
+	std::atomic<size_t> Tail = 0;
+
+	bool Push(const InputEvent& e) {
+		size_t tail = Tail.load(std::memory_order_relaxed);
+		if (tail - Head.load(std::memory_order_acquire) >= Capacity)
+			return false;
+		Events[tail % Capacity] = e;
+		Tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool Pop(InputEvent& e) {
+		size_t head = Head.load(std::memory_order_relaxed);
+		if (head == Tail.load(std::memory_order_acquire))
+			return false;
+		e = Events[head % Capacity];
+		Head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+};
+
+InputEventQueue      g_EventQueue;
+GLFWkeyfun           g_PrevKeyCallback = nullptr;
+GLFWmousebuttonfun   g_PrevMouseButtonCallback = nullptr;
+GLFWscrollfun        g_PrevScrollCallback = nullptr;
+glm::dvec2           g_CurrentMouseScroll = glm::dvec2(0.0);
+glm::dvec2           g_CurrentMouseScrollDelta = glm::dvec2(0.0);
+
+void __PushInputEvent(InputEvent::Kind type, int code, int action, const glm::dvec2& offset) {
+	InputEvent e;
+	e.Type = type;
+	e.Code = code;
+	e.Action = action;
+	e.Offset = offset;
+	e.Ticks = glfwGetTimerValue();
+	// The queue only fills up if nothing reads input for a long while, so once is enough to say so
+	static bool warned = false;
+	if (!g_EventQueue.Push(e) && !warned) {
+		LOG_WARN("Input event queue is full, dropping input events");
+		warned = true;
+	}
+}
+
+void __HandleKey(GLFWwindow* window, int key, int scancode, int action, int mods) {
+	if (key >= (int)TTK_KEY_FIRST && key <= (int)TTK_KEY_LAST)
+		__PushInputEvent(InputEvent::Key, key, action, glm::dvec2(0.0));
+
+	// Callback chaining
+	if (g_PrevKeyCallback)
+		g_PrevKeyCallback(window, key, scancode, action, mods);
+}
+
+void __HandleMouseButton(GLFWwindow* window, int button, int action, int mods) {
+	if (button >= 0 && button <= (int)TTK_MOUSEBUTTON_LAST)
+		__PushInputEvent(InputEvent::Mouse, button, action, glm::dvec2(0.0));
+
+	// Callback chaining
+	if (g_PrevMouseButtonCallback)
+		g_PrevMouseButtonCallback(window, button, action, mods);
+}
 
 void __HandleMouseScroll(GLFWwindow* window, double xDiff, double yDiff) {
-	g_CurrentMouseScrollDelta.x += xDiff;
-	g_CurrentMouseScrollDelta.y += yDiff;
-	g_CurrentMouseScroll.x += xDiff;
-	g_CurrentMouseScroll.y += yDiff;
+	__PushInputEvent(InputEvent::Scroll, 0, 0, glm::dvec2(xDiff, yDiff));
 
 	// Callback chaining
 	if (g_PrevScrollCallback)
@@ -29,47 +101,130 @@ void __HandleMouseScroll(GLFWwindow* window, double xDiff, double yDiff) {
 }
 
 TTK::GlfwInput::GlfwInput() : TTK::Input() {
-	memset(m_PrevKeys, 0, sizeof(m_PrevKeys));
-	memset(m_PrevMouse, 0, sizeof(m_PrevMouse));
+	m_Window = nullptr;
+	memset(m_Buttons, 0, sizeof(m_Buttons));
+	memset(m_PrevButtons, 0, sizeof(m_PrevButtons));
+	memset(m_PressedSincePoll, 0, sizeof(m_PressedSincePoll));
+	memset(m_DeferredRelease, 0, sizeof(m_DeferredRelease));
+	memset(m_KeyTimes, 0, sizeof(m_KeyTimes));
 }
 
 TTK::GlfwInput::~GlfwInput() = default;
 
 TTK::ButtonState TTK::GlfwInput::__GetKeyState(KeyCode key) {
-	return (TTK::ButtonState)(!!glfwGetKey(m_Window, (size_t)key) | (!!m_PrevKeys[(size_t)key] << 1));
+	__ApplyEvents();
+	return (TTK::ButtonState)(!!m_Buttons[*key] | (!!m_PrevButtons[*key] << 1));
 }
 
 TTK::ButtonState TTK::GlfwInput::__GetMouseState(MouseButton button) {
-	return (TTK::ButtonState)(!!glfwGetMouseButton(m_Window, *button) | (!!m_PrevMouse[*button] << 1));
+	__ApplyEvents();
+	size_t index = (size_t)TTK_KEY_LAST + 1 + *button;
+	return (TTK::ButtonState)(!!m_Buttons[index] | (!!m_PrevButtons[index] << 1));
+}
+
+uint64_t TTK::GlfwInput::__GetKeyTime(KeyCode key) {
+	__ApplyEvents();
+	return m_KeyTimes[*key];
+}
+
+const std::vector<uint64_t>& TTK::GlfwInput::__GetFrameEventTimes() {
+	__ApplyEvents();
+	return m_FrameEventTimes;
 }
 
 glm::vec2 TTK::GlfwInput::__GetMousePos() {
+	// The cursor is read straight from GLFW, so it is always as fresh as it can be
 	glm::dvec2 pos;
 	glfwGetCursorPos(m_Window, &pos.x, &pos.y);
 	return pos;
 }
 
 glm::vec2 TTK::GlfwInput::__GetMouseScroll() {
+	__ApplyEvents();
 	return g_CurrentMouseScroll;
 }
 
 glm::vec2 TTK::GlfwInput::__GetMouseScrollDelta() {
+	__ApplyEvents();
 	return g_CurrentMouseScrollDelta;
 }
 
 void TTK::GlfwInput::__Poll() {
-	NativeWindowProxy* proxy = (NativeWindowProxy*)m_Window;
-	// Copy our mouse state and key state from our GLFW window proxy struct
-	memcpy(m_PrevKeys, proxy->keys, sizeof(m_PrevKeys));
-	memcpy(m_PrevMouse, proxy->mouseButtons, sizeof(m_PrevMouse));
+	// Anything that came in since the last read belongs to the frame that just ended
+	__ApplyEvents();
+	// This frame's state becomes the previous state
+	memcpy(m_PrevButtons, m_Buttons, sizeof(m_PrevButtons));
+	memset(m_PressedSincePoll, 0, sizeof(m_PressedSincePoll));
+	m_FrameEventTimes.clear();
+	// Quick taps were held down for a frame, now they can be let go
+	for (size_t ix = 0; ix < NUM_BUTTONS; ix++) {
+		if (m_DeferredRelease[ix]) {
+			m_Buttons[ix] = 0;
+			m_DeferredRelease[ix] = 0;
+		}
+	}
 	// Reset the scroll wheel delta
 	g_CurrentMouseScrollDelta = { 0, 0 };
-	// We will assume that glfwPollEvents has been called
+	// We will assume that glfwPollEvents gets called next
 }
+
 void TTK::GlfwInput::__Init(void* windowPtr) {
 	m_Window = (GLFWwindow*)windowPtr;
-	memset(m_PrevKeys, 0, sizeof(m_PrevKeys));
-	memset(m_PrevMouse, 0, sizeof(m_PrevMouse));
+	memset(m_Buttons, 0, sizeof(m_Buttons));
+	memset(m_PrevButtons, 0, sizeof(m_PrevButtons));
+	memset(m_PressedSincePoll, 0, sizeof(m_PressedSincePoll));
+	memset(m_DeferredRelease, 0, sizeof(m_DeferredRelease));
+	memset(m_KeyTimes, 0, sizeof(m_KeyTimes));
+
+	// Initializing again on the same window would hand back our own handlers, and chaining to those would recurse
+	// forever, so we keep whatever we were chaining to before
+	GLFWkeyfun prevKey = glfwSetKeyCallback(m_Window, __HandleKey);
+	if (prevKey != __HandleKey)
+		g_PrevKeyCallback = prevKey;
+	GLFWmousebuttonfun prevMouse = glfwSetMouseButtonCallback(m_Window, __HandleMouseButton);
+	if (prevMouse != __HandleMouseButton)
+		g_PrevMouseButtonCallback = prevMouse;
+	GLFWscrollfun prevScroll = glfwSetScrollCallback(m_Window, __HandleMouseScroll);
+	if (prevScroll != __HandleMouseScroll)
+		g_PrevScrollCallback = prevScroll;
+}
+
+void TTK::GlfwInput::__ApplyEvents() {
+	InputEvent e;
+	while (g_EventQueue.Pop(e)) {
+		switch (e.Type) {
+			case InputEvent::Key:
+				if (e.Action != GLFW_REPEAT) {
+					m_KeyTimes[e.Code] = e.Ticks;
+					m_FrameEventTimes.push_back(e.Ticks);
+				}
+				__ApplyButton(e.Code, e.Action);
+				break;
+			case InputEvent::Mouse:
+				m_FrameEventTimes.push_back(e.Ticks);
+				__ApplyButton((size_t)TTK_KEY_LAST + 1 + e.Code, e.Action);
+				break;
+			case InputEvent::Scroll:
+				g_CurrentMouseScrollDelta += e.Offset;
+				g_CurrentMouseScroll += e.Offset;
+				break;
+		}
+	}
+}
 
-	g_PrevScrollCallback = glfwSetScrollCallback(m_Window, __HandleMouseScroll);
+void TTK::GlfwInput::__ApplyButton(size_t index, int action) {
+	if (action == GLFW_PRESS) {
+		m_Buttons[index] = 1;
+		m_PressedSincePoll[index] = 1;
+		// Pressed again before the tap was let go, so it's held now
+		m_DeferredRelease[index] = 0;
+	}
+	else if (action == GLFW_RELEASE) {
+		// If the button went down since the last poll, releasing it now would mean the game never sees it pressed,
+		// so we hold on to the release until the next poll
+		if (m_PressedSincePoll[index] && !m_PrevButtons[index])
+			m_DeferredRelease[index] = 1;
+		else
+			m_Buttons[index] = 0;
+	}
 }
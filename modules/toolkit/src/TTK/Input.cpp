@@ -28,6 +28,8 @@ bool TTK::Input::GetKeyReleased(KeyCode key) {
 	return m_Instance->__GetKeyState(key) == TTK::ButtonState::Released;
 }
 TTK::ButtonState TTK::Input::GetKeyState(KeyCode key) { PROXY(__GetKeyState, key); }
+uint64_t TTK::Input::GetKeyTime(KeyCode key) { PROXY(__GetKeyTime, key); }
+const std::vector<uint64_t>& TTK::Input::GetFrameEventTimes() { PROXY(__GetFrameEventTimes); }
 
 bool TTK::Input::GetMouseDown(MouseButton button) {
 	LOG_ASSERT(m_Instance != nullptr, "TTK Input has not been initialized!");
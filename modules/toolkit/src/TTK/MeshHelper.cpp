@@ -30,7 +30,7 @@ TTK::Impl::MeshHelper::~MeshHelper() {
 void TTK::Impl::MeshHelper::RenderTeapot(const glm::mat4& transform, const glm::vec4& color) const {
 	glUseProgram(m_Shader);
 	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
+	glProgramUniformMatrix4fv(m_Shader, 0, 1, GL_FALSE, &t[0][0]);
 	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
 	glBindVertexArray(m_Teapot.VAO);
 	glDrawArrays(GL_TRIANGLES, 0, sizeof(TeapotData) / (sizeof(float) * 6));
@@ -39,7 +39,7 @@ void TTK::Impl::MeshHelper::RenderTeapot(const glm::mat4& transform, const glm::
 void TTK::Impl::MeshHelper::RenderSphere(const glm::mat4& transform, const glm::vec4& color) const {
 	glUseProgram(m_Shader);
 	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
+	glProgramUniformMatrix4fv(m_Shader, 0, 1, GL_FALSE, &t[0][0]);
 	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
 	glBindVertexArray(m_Sphere.VAO);
 	glDrawArrays(GL_TRIANGLES, 0, sizeof(SphereData) / (sizeof(float) * 6));
@@ -49,7 +49,7 @@ void TTK::Impl::MeshHelper::RenderCube(const glm::mat4& transform, const glm::ve
 {
 	glUseProgram(m_Shader);
 	glm::mat4 t = Context::Instance().GetViewProjection() * transform;
-	glProgramUniformMatrix4fv(m_Shader, 0, 1, FALSE, &t[0][0]);
+	glProgramUniformMatrix4fv(m_Shader, 0, 1, GL_FALSE, &t[0][0]);
 	glProgramUniform4fv(m_Shader, 1, 1, &color[0]);
 	glBindVertexArray(m_Cube.VAO);
 	glDrawArrays(GL_TRIANGLES, 0, sizeof(CubeData) / (sizeof(float) * 6));
@@ -13,6 +13,7 @@
 #include "TTK/TTKContext.h"
 #include <GLM/gtc/matrix_transform.hpp>
 #include <string>
+#include <algorithm>
 #include "Logging.h"
 #include "TTK/MeshHelper.h"
 
@@ -24,9 +25,13 @@ TTK::Context::~Context() {
 	glDeleteBuffers(1, &m_Tris.VBO);
 	glDeleteBuffers(1, &m_Lines.VBO);
 	glDeleteBuffers(1, &m_Points.VBO);
+	glDeleteBuffers(1, &m_DebugTris.VBO);
+	glDeleteBuffers(1, &m_DebugLines.VBO);
 	glDeleteVertexArrays(1, &m_Tris.VAO);
 	glDeleteVertexArrays(1, &m_Lines.VAO);
 	glDeleteVertexArrays(1, &m_Points.VAO);
+	glDeleteVertexArrays(1, &m_DebugTris.VAO);
+	glDeleteVertexArrays(1, &m_DebugLines.VAO);
 	glDeleteProgram(m_ShaderHandle);
 }
 
@@ -110,10 +115,22 @@ void TTK::Context::AddPoint(const glm::vec3& pos, float size, const glm::vec4& c
 	}
 }
 
+void TTK::Context::ReserveDebug(size_t lines, size_t tris) {
+	m_DebugLineVerts.reserve(lines * 2);
+	m_DebugTriVerts.reserve(tris * 3);
+}
+
+void TTK::Context::FlushDebug() {
+	m_DebugDrawCalls = 0;
+	__FlushDebug(m_DebugTris, m_DebugTriVerts, 3);
+	__FlushDebug(m_DebugLines, m_DebugLineVerts, 2);
+}
+
 void TTK::Context::Flush() {
 	__Flush(m_Tris);
 	__Flush(m_Lines);
 	__Flush(m_Points);
+	FlushDebug();
 }
 
 TTK::Context::Context() {
@@ -179,6 +196,20 @@ TTK::Context::Context() {
 	glVertexAttribPointer(1, 4, GL_FLOAT, false, sizeof(PointVert), (void*)offsetof(PointVert, Color));
 	glVertexAttribPointer(2, 1, GL_FLOAT, false, sizeof(PointVert), (void*)offsetof(PointVert, Size));
 
+	// The debug batches share the simple shader, the packed color gets normalized back to a vec4
+	m_DebugTris = __InitBuff(GL_TRIANGLES, m_ShaderHandle, nullptr, sizeof(DebugVert), DebugChunkVerts);
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(DebugVert), (void*)offsetof(DebugVert, Position));
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, true, sizeof(DebugVert), (void*)offsetof(DebugVert, Color));
+
+	m_DebugLines = __InitBuff(GL_LINES, m_ShaderHandle, nullptr, sizeof(DebugVert), DebugChunkVerts);
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(DebugVert), (void*)offsetof(DebugVert, Position));
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, true, sizeof(DebugVert), (void*)offsetof(DebugVert, Color));
+	m_DebugDrawCalls = 0;
+
 	glBindVertexArray(0);
 
 	// Make sure that the mesh helper has a context
@@ -217,6 +248,29 @@ void TTK::Context::__Flush(GLBuff& buff) {
 	}
 }
 
+void TTK::Context::__FlushDebug(GLBuff& buff, std::vector<DebugVert>& verts, size_t vertsPerPrim) {
+	if (verts.empty())
+		return;
+
+	glUseProgram(buff.Shader);
+	glUniformMatrix4fv(0, 1, false, &m_ViewProjection[0][0]);
+	glBindVertexArray(buff.VAO);
+
+	// Chunks always end on a whole primitive
+	const size_t chunkVerts = (DebugChunkVerts / vertsPerPrim) * vertsPerPrim;
+	for (size_t offset = 0; offset < verts.size(); offset += chunkVerts) {
+		size_t count = std::min(chunkVerts, verts.size() - offset);
+		// Orphan the buffer first so the driver doesn't stall waiting on the last chunk's draw
+		glNamedBufferData(buff.VBO, DebugChunkVerts * buff.ElemSize, nullptr, GL_STREAM_DRAW);
+		glNamedBufferSubData(buff.VBO, 0, count * buff.ElemSize, verts.data() + offset);
+		glDrawArrays(buff.Mode, 0, static_cast<GLsizei>(count));
+		m_DebugDrawCalls++;
+	}
+
+	// Keep the capacity around so the next frame doesn't reallocate
+	verts.clear();
+}
+
 GLuint TTK::Context::__CompileShader(const char* vsSource, const char* fsSource)
 {
 	GLuint result = glCreateProgram();
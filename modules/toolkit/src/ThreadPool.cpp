@@ -0,0 +1,147 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+// Set on pool workers (and the caller while a loop runs) so nested loops run inline
+static thread_local bool g_InParallelLoop = false;
+
+ThreadPool::ThreadPool(int numThreads) :
+	myFunc(nullptr),
+	myEnd(0),
+	myGrainSize(1),
+	myNextIndex(0),
+	myChunksLeft(0),
+	myActiveWorkers(0),
+	myGeneration(0),
+	myIsStopping(false),
+	myIsRunning(false)
+{
+	SetNumThreads(numThreads);
+}
+
+ThreadPool::~ThreadPool() {
+	StopWorkers();
+}
+
+void ThreadPool::SetNumThreads(int numThreads) {
+	if (numThreads <= 0)
+		numThreads = GetHardwareThreads();
+
+	std::lock_guard<std::mutex> callerLock(myCallerMutex);
+	if (numThreads == GetNumThreads() && !myWorkers.empty())
+		return;
+
+	StopWorkers();
+	StartWorkers(numThreads - 1);
+}
+
+void ThreadPool::ParallelFor(int begin, int end, int grainSize, const std::function<void(int, int)>& func) {
+	if (end <= begin)
+		return;
+
+	grainSize = std::max(grainSize, 1);
+	int chunks = (end - begin + grainSize - 1) / grainSize;
+
+	// Small loops and nested loops just run here
+	if (chunks == 1 || g_InParallelLoop) {
+		func(begin, end);
+		return;
+	}
+
+	// Loops from other threads wait their turn
+	std::lock_guard<std::mutex> callerLock(myCallerMutex);
+
+	// So do single threaded pools, anything the loop runs in turn runs inline too
+	if (myWorkers.empty()) {
+		g_InParallelLoop = true;
+		func(begin, end);
+		g_InParallelLoop = false;
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myFunc = &func;
+		myEnd = end;
+		myGrainSize = grainSize;
+		myNextIndex.store(begin);
+		myChunksLeft.store(chunks);
+		myIsRunning = true;
+		myGeneration++;
+	}
+	myStartCondition.notify_all();
+
+	// The caller helps out instead of sitting idle
+	g_InParallelLoop = true;
+	RunChunks();
+	g_InParallelLoop = false;
+
+	std::unique_lock<std::mutex> lock(myMutex);
+	// Wait for the workers to leave too, so none of them can touch the next loop's state early
+	myDoneCondition.wait(lock, [this]() { return myChunksLeft.load() == 0 && myActiveWorkers == 0; });
+	myIsRunning = false;
+	myFunc = nullptr;
+}
+
+int ThreadPool::GetHardwareThreads() {
+	return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
+
+void ThreadPool::StartWorkers(int numWorkers) {
+	myIsStopping = false;
+	myWorkers.reserve(numWorkers);
+	for (int ix = 0; ix < numWorkers; ix++) {
+		myWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+void ThreadPool::StopWorkers() {
+	{
+		std::lock_guard<std::mutex> lock(myMutex);
+		myIsStopping = true;
+	}
+	myStartCondition.notify_all();
+
+	for (std::thread& worker : myWorkers) {
+		worker.join();
+	}
+	myWorkers.clear();
+}
+
+void ThreadPool::WorkerLoop() {
+	g_InParallelLoop = true;
+	uint64_t lastGeneration = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(myMutex);
+			myStartCondition.wait(lock, [&]() { return myIsStopping || (myIsRunning && myGeneration != lastGeneration); });
+			if (myIsStopping)
+				return;
+			lastGeneration = myGeneration;
+			myActiveWorkers++;
+		}
+
+		RunChunks();
+
+		std::lock_guard<std::mutex> lock(myMutex);
+		myActiveWorkers--;
+		if (myActiveWorkers == 0)
+			myDoneCondition.notify_all();
+	}
+}
+
+void ThreadPool::RunChunks() {
+	while (true) {
+		int chunkBegin = myNextIndex.fetch_add(myGrainSize);
+		if (chunkBegin >= myEnd)
+			return;
+
+		(*myFunc)(chunkBegin, std::min(chunkBegin + myGrainSize, myEnd));
+
+		// The last chunk to finish wakes the caller
+		if (myChunksLeft.fetch_sub(1) == 1) {
+			std::lock_guard<std::mutex> lock(myMutex);
+			myDoneCondition.notify_all();
+		}
+	}
+}
@@ -0,0 +1,151 @@
+#include "CollisionEvents.h"
+#include <algorithm>
+
+SMI_CollisionPairSet::SMI_CollisionPairSet(size_t capacity)
+{
+    //round the capacity up to a power of two so we can mask instead of mod
+    size_t size = 16;
+    while (size < capacity)
+        size <<= 1;
+
+    Keys = std::vector<uint64_t>(size, EMPTY);
+    Count = 0;
+}
+
+bool SMI_CollisionPairSet::Insert(uint64_t key)
+{
+    //keep the load factor under a half so probes stay short
+    if ((Count + 1) * 2 > Keys.size())
+        Grow();
+
+    size_t mask = Keys.size() - 1;
+    for (size_t i = Slot(key);; i = (i + 1) & mask)
+    {
+        if (Keys[i] == key)
+            return false;
+
+        if (Keys[i] == EMPTY)
+        {
+            Keys[i] = key;
+            Count++;
+            return true;
+        }
+    }
+}
+
+bool SMI_CollisionPairSet::Contains(uint64_t key) const
+{
+    size_t mask = Keys.size() - 1;
+    for (size_t i = Slot(key);; i = (i + 1) & mask)
+    {
+        if (Keys[i] == key)
+            return true;
+
+        if (Keys[i] == EMPTY)
+            return false;
+    }
+}
+
+void SMI_CollisionPairSet::Clear()
+{
+    if (Count > 0)
+    {
+        std::fill(Keys.begin(), Keys.end(), EMPTY);
+        Count = 0;
+    }
+}
+
+uint64_t SMI_CollisionPairSet::MakeKey(entt::entity a, entt::entity b)
+{
+    uint32_t first = static_cast<uint32_t>(a);
+    uint32_t second = static_cast<uint32_t>(b);
+    if (first > second)
+        std::swap(first, second);
+
+    return (static_cast<uint64_t>(first) << 32) | second;
+}
+
+size_t SMI_CollisionPairSet::Slot(uint64_t key) const
+{
+    //mix the bits so nearby entity ids don't cluster
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+
+    return static_cast<size_t>(key) & (Keys.size() - 1);
+}
+
+void SMI_CollisionPairSet::Grow()
+{
+    std::vector<uint64_t> oldKeys = std::move(Keys);
+    Keys = std::vector<uint64_t>(oldKeys.size() * 2, EMPTY);
+    Count = 0;
+
+    for (uint64_t key : oldKeys)
+    {
+        if (key != EMPTY)
+            Insert(key);
+    }
+}
+
+SMI_CollisionTracker::SMI_CollisionTracker(size_t capacity) :
+    Current(capacity),
+    Previous(capacity)
+{
+    Events.reserve(capacity);
+}
+
+void SMI_CollisionTracker::BeginFrame()
+{
+    //last frame's pairs become the previous set, and the old previous set is reused
+    std::swap(Current, Previous);
+    Current.Clear();
+    Events.clear();
+}
+
+void SMI_CollisionTracker::AddContact(entt::entity a, entt::entity b)
+{
+    //bodies that aren't bound to an entity can't report collisions
+    if (a == entt::null || b == entt::null || a == b)
+        return;
+
+    uint64_t key = SMI_CollisionPairSet::MakeKey(a, b);
+    if (!Current.Insert(key))
+        return;
+
+    SMI_CollisionEvent event;
+    event.b1 = SMI_CollisionPairSet::KeyFirst(key);
+    event.b2 = SMI_CollisionPairSet::KeySecond(key);
+    event.type = Previous.Contains(key) ? SMI_CollisionEventType::STAY : SMI_CollisionEventType::BEGIN;
+    Events.push_back(event);
+}
+
+void SMI_CollisionTracker::KeepContact(entt::entity a, entt::entity b)
+{
+    if (Previous.Contains(SMI_CollisionPairSet::MakeKey(a, b)))
+        AddContact(a, b);
+}
+
+void SMI_CollisionTracker::EndFrame()
+{
+    //anything touching last frame that isn't touching now has ended
+    if (Previous.getCount() == 0)
+        return;
+
+    for (uint64_t key : Previous.getKeys())
+    {
+        if (key != SMI_CollisionPairSet::EMPTY && !Current.Contains(key))
+        {
+            SMI_CollisionEvent event;
+            event.b1 = SMI_CollisionPairSet::KeyFirst(key);
+            event.b2 = SMI_CollisionPairSet::KeySecond(key);
+            event.type = SMI_CollisionEventType::END;
+            Events.push_back(event);
+        }
+    }
+}
+
+bool SMI_CollisionTracker::IsColliding(entt::entity a, entt::entity b) const
+{
+    return Current.Contains(SMI_CollisionPairSet::MakeKey(a, b));
+}
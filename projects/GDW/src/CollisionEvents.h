@@ -0,0 +1,117 @@
+#pragma once
+#include "entt.hpp"
+#include <cstdint>
+#include <vector>
+
+//the stage of a collision between two entities
+enum class SMI_CollisionEventType
+{
+	BEGIN = 0,
+	STAY = 1,
+	END = 2
+};
+
+//a single collision event between two entities, b1 is always the lower entity id
+struct SMI_CollisionEvent
+{
+	entt::entity b1;
+	entt::entity b2;
+	SMI_CollisionEventType type;
+
+	//checks if the entity is part of this collision
+	bool Involves(entt::entity target) const { return b1 == target || b2 == target; }
+	//gets the entity on the other side of the collision
+	entt::entity Other(entt::entity target) const { return b1 == target ? b2 : b1; }
+};
+
+//flat open addressing set of entity pairs, reused every frame so it doesn't allocate once warmed up
+class SMI_CollisionPairSet
+{
+public:
+	SMI_CollisionPairSet(size_t capacity = 256);
+
+	//inserts the pair key, returns false if it was already in the set
+	bool Insert(uint64_t key);
+	//checks if the pair key is in the set
+	bool Contains(uint64_t key) const;
+	//empties the set, keeping the storage
+	void Clear();
+
+	size_t getCount() const { return Count; }
+	size_t getCapacity() const { return Keys.size(); }
+
+	//raw slot access, empty slots hold EMPTY
+	const std::vector<uint64_t>& getKeys() const { return Keys; }
+
+	static constexpr uint64_t EMPTY = ~0ull;
+
+	//builds the key for an entity pair, order of the entities doesn't matter
+	static uint64_t MakeKey(entt::entity a, entt::entity b);
+	static entt::entity KeyFirst(uint64_t key) { return static_cast<entt::entity>(static_cast<uint32_t>(key >> 32)); }
+	static entt::entity KeySecond(uint64_t key) { return static_cast<entt::entity>(static_cast<uint32_t>(key)); }
+
+private:
+	//slots of the set, capacity is always a power of two
+	std::vector<uint64_t> Keys;
+	size_t Count;
+
+	size_t Slot(uint64_t key) const;
+	void Grow();
+};
+
+//turns the contacts found each step into begin/stay/end events
+class SMI_CollisionTracker
+{
+public:
+	SMI_CollisionTracker(size_t capacity = 256);
+
+	//starts a new frame of contacts, clearing last frame's events
+	void BeginFrame();
+	//adds a contact between two entities, duplicates in the same frame are ignored
+	void AddContact(entt::entity a, entt::entity b);
+	//carries last frame's contact between two entities over, used for sleeping pairs whose contacts can't have changed
+	void KeepContact(entt::entity a, entt::entity b);
+	//finishes the frame, adding end events for pairs that stopped touching
+	void EndFrame();
+
+	//all the events for this frame
+	const std::vector<SMI_CollisionEvent>& getEvents() const { return Events; }
+
+	//checks if two entities are touching this frame
+	bool IsColliding(entt::entity a, entt::entity b) const;
+
+	//calls func(const SMI_CollisionEvent&) for every event involving the entity
+	template <typename Func>
+	void ForEach(entt::entity target, Func func) const;
+	//calls func(const SMI_CollisionEvent&) for every event of the given type involving the entity
+	template <typename Func>
+	void ForEach(entt::entity target, SMI_CollisionEventType type, Func func) const;
+
+private:
+	//pairs touching this frame and last frame
+	SMI_CollisionPairSet Current;
+	SMI_CollisionPairSet Previous;
+
+	//events for this frame, cleared but never shrunk
+	std::vector<SMI_CollisionEvent> Events;
+};
+
+template <typename Func>
+inline void SMI_CollisionTracker::ForEach(entt::entity target, Func func) const
+{
+	for (const SMI_CollisionEvent& event : Events)
+	{
+		if (event.Involves(target))
+			func(event);
+	}
+}
+
+template <typename Func>
+inline void SMI_CollisionTracker::ForEach(entt::entity target, SMI_CollisionEventType type, Func func) const
+{
+	for (const SMI_CollisionEvent& event : Events)
+	{
+		if (event.type == type && event.Involves(target))
+			func(event);
+	}
+}
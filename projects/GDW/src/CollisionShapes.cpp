@@ -0,0 +1,270 @@
+#define GLM_ENABLE_EXPERIMENTAL
+#include "GLM/gtx/quaternion.hpp"
+#include "CollisionShapes.h"
+#include "BulletCollision/CollisionShapes/btShapeHull.h"
+#include "Logging.h"
+#include <cmath>
+
+//triangle data that a bvh shape points into, it has to outlive the shape
+struct SMI_TriangleData
+{
+    std::vector<btVector3> Vertices;
+    std::vector<int> Indices;
+    std::unique_ptr<btTriangleIndexVertexArray> Array;
+};
+
+SMI_ShapeSptr SMI_ShapeCache::GetBox(const glm::vec3& halfExtents)
+{
+    std::string key = KeyFor("box", halfExtents);
+
+    auto it = Shapes.find(key);
+    if (it != Shapes.end())
+        return it->second;
+
+    SMI_ShapeSptr shape = std::make_shared<btBoxShape>(btVector3(halfExtents.x, halfExtents.y, halfExtents.z));
+    Shapes[key] = shape;
+    return shape;
+}
+
+SMI_ShapeSptr SMI_ShapeCache::GetSphere(float radius)
+{
+    std::string key = KeyFor("sphere", glm::vec3(radius));
+
+    auto it = Shapes.find(key);
+    if (it != Shapes.end())
+        return it->second;
+
+    SMI_ShapeSptr shape = std::make_shared<btSphereShape>(radius);
+    Shapes[key] = shape;
+    return shape;
+}
+
+SMI_ShapeSptr SMI_ShapeCache::GetConvexHull(const std::string& filename, const glm::vec3& scale)
+{
+    std::string key = KeyFor("hull:" + filename, scale);
+
+    auto it = Shapes.find(key);
+    if (it != Shapes.end())
+        return it->second;
+
+    SMI_ShapeSptr shape = SMI_ShapeBuilder::ConvexHull(ObjLoader::LoadMeshDataFromFile(filename), scale);
+    if (shape == nullptr)
+    {
+        LOG_WARN("\"{}\" has no vertices to build a convex hull from, using a box", filename);
+        shape = GetBox(scale / 2.f);
+    }
+    Shapes[key] = shape;
+    return shape;
+}
+
+SMI_ShapeSptr SMI_ShapeCache::GetTriangleMesh(const std::string& filename, const glm::vec3& scale)
+{
+    std::string key = KeyFor("mesh:" + filename, scale);
+
+    auto it = Shapes.find(key);
+    if (it != Shapes.end())
+        return it->second;
+
+    //the bvh is only built once per file, other scales just wrap it
+    std::shared_ptr<btBvhTriangleMeshShape> base;
+    auto baseIt = BaseMeshes.find(filename);
+    if (baseIt != BaseMeshes.end())
+    {
+        base = baseIt->second;
+    }
+    else
+    {
+        base = SMI_ShapeBuilder::TriangleMesh(ObjLoader::LoadMeshDataFromFile(filename));
+        if (base == nullptr)
+        {
+            LOG_WARN("\"{}\" has no usable triangles to build a triangle mesh from, using a box", filename);
+            SMI_ShapeSptr box = GetBox(scale / 2.f);
+            Shapes[key] = box;
+            return box;
+        }
+        BaseMeshes[filename] = base;
+    }
+
+    SMI_ShapeSptr shape;
+    if (scale == glm::vec3(1.f))
+    {
+        shape = base;
+    }
+    else
+    {
+        //the scaled shape doesn't own its child, so the deleter keeps the base alive
+        btScaledBvhTriangleMeshShape* scaled = new btScaledBvhTriangleMeshShape(base.get(), btVector3(scale.x, scale.y, scale.z));
+        shape = SMI_ShapeSptr(scaled, [base](btCollisionShape* ptr) { delete ptr; });
+    }
+
+    Shapes[key] = shape;
+    return shape;
+}
+
+void SMI_ShapeCache::ReleaseUnused()
+{
+    for (auto it = Shapes.begin(); it != Shapes.end();)
+    {
+        if (it->second.use_count() == 1)
+            it = Shapes.erase(it);
+        else
+            it++;
+    }
+
+    for (auto it = BaseMeshes.begin(); it != BaseMeshes.end();)
+    {
+        if (it->second.use_count() == 1)
+            it = BaseMeshes.erase(it);
+        else
+            it++;
+    }
+}
+
+void SMI_ShapeCache::Clear()
+{
+    Shapes.clear();
+    BaseMeshes.clear();
+}
+
+std::string SMI_ShapeCache::KeyFor(const std::string& prefix, const glm::vec3& value)
+{
+    //round to a thousandth of a unit
+    glm::ivec3 rounded = glm::ivec3(glm::round(value * 1000.f));
+
+    return prefix + ":" + std::to_string(rounded.x) + "," + std::to_string(rounded.y) + "," + std::to_string(rounded.z);
+}
+
+SMI_ShapeSptr SMI_ShapeBuilder::ConvexHull(const ObjMeshData& mesh, const glm::vec3& scale)
+{
+    if (mesh.Positions.empty())
+        return nullptr;
+
+    std::vector<btVector3> points;
+    points.reserve(mesh.Positions.size());
+    for (const glm::vec3& pos : mesh.Positions)
+    {
+        points.push_back(btVector3(pos.x * scale.x, pos.y * scale.y, pos.z * scale.z));
+    }
+
+    //full hull of every point, only used to build the simplified one
+    btConvexHullShape fullHull(reinterpret_cast<const btScalar*>(points.data()), static_cast<int>(points.size()), sizeof(btVector3));
+
+    btShapeHull simplified(&fullHull);
+    simplified.buildHull(fullHull.getMargin());
+
+    btConvexHullShape* hull = new btConvexHullShape(reinterpret_cast<const btScalar*>(simplified.getVertexPointer()), simplified.numVertices(), sizeof(btVector3));
+    hull->optimizeConvexHull();
+
+    return SMI_ShapeSptr(hull);
+}
+
+std::shared_ptr<btBvhTriangleMeshShape> SMI_ShapeBuilder::TriangleMesh(const ObjMeshData& mesh, const glm::vec3& scale)
+{
+    if (!IsValidTriangleMesh(mesh))
+        return nullptr;
+
+    std::shared_ptr<SMI_TriangleData> data = std::make_shared<SMI_TriangleData>();
+
+    data->Vertices.reserve(mesh.Positions.size());
+    for (const glm::vec3& pos : mesh.Positions)
+    {
+        data->Vertices.push_back(btVector3(pos.x * scale.x, pos.y * scale.y, pos.z * scale.z));
+    }
+    data->Indices.assign(mesh.Indices.begin(), mesh.Indices.end());
+
+    data->Array = std::make_unique<btTriangleIndexVertexArray>(static_cast<int>(data->Indices.size() / 3), data->Indices.data(), 3 * sizeof(int),
+        static_cast<int>(data->Vertices.size()), reinterpret_cast<btScalar*>(data->Vertices.data()), sizeof(btVector3));
+
+    //the triangle data is released together with the shape
+    btBvhTriangleMeshShape* shape = new btBvhTriangleMeshShape(data->Array.get(), true);
+    return std::shared_ptr<btBvhTriangleMeshShape>(shape, [data](btBvhTriangleMeshShape* ptr) { delete ptr; });
+}
+
+bool SMI_ShapeBuilder::IsValidTriangleMesh(const ObjMeshData& mesh)
+{
+    if (mesh.Positions.empty() || mesh.Indices.size() < 3)
+        return false;
+
+    for (uint32_t index : mesh.Indices)
+    {
+        if (index >= mesh.Positions.size())
+            return false;
+    }
+
+    return true;
+}
+
+SMI_StaticGeometryBuilder::SMI_StaticGeometryBuilder()
+{
+}
+
+bool SMI_StaticGeometryBuilder::AddMesh(const ObjMeshData& mesh, const glm::mat4& transform)
+{
+    if (!SMI_ShapeBuilder::IsValidTriangleMesh(mesh))
+        return false;
+
+    uint32_t offset = static_cast<uint32_t>(Positions.size());
+
+    Positions.reserve(Positions.size() + mesh.Positions.size());
+    for (const glm::vec3& pos : mesh.Positions)
+    {
+        Positions.push_back(glm::vec3(transform * glm::vec4(pos, 1.f)));
+    }
+
+    //a trailing partial triangle would shift every triangle after it
+    size_t count = mesh.Indices.size() - mesh.Indices.size() % 3;
+    Indices.reserve(Indices.size() + count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Indices.push_back(offset + mesh.Indices[i]);
+    }
+
+    return true;
+}
+
+void SMI_StaticGeometryBuilder::AddShape(const SMI_ShapeSptr& shape, const glm::vec3& position, const glm::vec3& rotation)
+{
+    btTransform trans;
+    trans.setIdentity();
+    trans.setOrigin(btVector3(position.x, position.y, position.z));
+    glm::quat rot = glm::quat(glm::radians(rotation));
+    trans.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
+
+    Children.push_back(std::make_pair(shape, trans));
+}
+
+SMI_ShapeSptr SMI_StaticGeometryBuilder::Bake()
+{
+    SMI_ShapeSptr mesh = nullptr;
+    if (Indices.size() > 0)
+    {
+        ObjMeshData merged;
+        merged.Positions = std::move(Positions);
+        merged.Indices = std::move(Indices);
+        mesh = SMI_ShapeBuilder::TriangleMesh(merged);
+    }
+
+    if (Children.empty())
+        return mesh;
+
+    //a compound doesn't own its children, so the deleter holds on to them
+    btCompoundShape* compound = new btCompoundShape(true, static_cast<int>(Children.size()) + 1);
+    std::vector<SMI_ShapeSptr> owned;
+    owned.reserve(Children.size() + 1);
+
+    for (auto& child : Children)
+    {
+        compound->addChildShape(child.second, child.first.get());
+        owned.push_back(child.first);
+    }
+
+    if (mesh != nullptr)
+    {
+        compound->addChildShape(btTransform::getIdentity(), mesh.get());
+        owned.push_back(mesh);
+    }
+
+    Children.clear();
+
+    return SMI_ShapeSptr(compound, [owned](btCollisionShape* ptr) { delete ptr; });
+}
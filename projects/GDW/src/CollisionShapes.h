@@ -0,0 +1,93 @@
+#pragma once
+#include "GLM/glm.hpp"
+#include "btBulletDynamicsCommon.h"
+#include "Utils/ObjLoader.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//shared handle to a collision shape, anything the shape depends on (triangle data, child shapes)
+//is released together with the last handle
+typedef std::shared_ptr<btCollisionShape> SMI_ShapeSptr;
+
+//cache that shares identical collision shapes between physics bodies
+class SMI_ShapeCache
+{
+public:
+	//gets a box shape with the given half extents
+	static SMI_ShapeSptr GetBox(const glm::vec3& halfExtents);
+	//gets a sphere shape with the given radius
+	static SMI_ShapeSptr GetSphere(float radius);
+
+	//gets a simplified convex hull built from an obj model, scaled by scale
+	//a model with nothing to build from gets a box of the same scale instead
+	static SMI_ShapeSptr GetConvexHull(const std::string& filename, const glm::vec3& scale = glm::vec3(1.f));
+	//gets a triangle mesh (static only) built from an obj model, scaled by scale
+	//a model with no usable triangles gets a box of the same scale instead
+	static SMI_ShapeSptr GetTriangleMesh(const std::string& filename, const glm::vec3& scale = glm::vec3(1.f));
+
+	//releases cached shapes that aren't used by any body anymore
+	static void ReleaseUnused();
+	//releases every cached shape (bodies still using them keep them alive)
+	static void Clear();
+
+	//number of shapes currently in the cache
+	static size_t getCount() { return Shapes.size(); }
+
+protected:
+	SMI_ShapeCache() = default;
+	~SMI_ShapeCache() = default;
+
+	//builds the cache key for a scale or extent, rounded so float noise doesn't split entries
+	static std::string KeyFor(const std::string& prefix, const glm::vec3& value);
+
+	//all shapes by key, and the unscaled triangle meshes that scaled copies are made from
+	inline static std::unordered_map<std::string, SMI_ShapeSptr> Shapes;
+	inline static std::unordered_map<std::string, std::shared_ptr<btBvhTriangleMeshShape>> BaseMeshes;
+};
+
+//functions that build collision shapes out of mesh data
+class SMI_ShapeBuilder
+{
+public:
+	//builds a convex hull of the mesh, reduced to a small number of vertices, nullptr if the mesh has no vertices
+	static SMI_ShapeSptr ConvexHull(const ObjMeshData& mesh, const glm::vec3& scale = glm::vec3(1.f));
+	//builds a bvh triangle mesh shape of the mesh, only meant for static bodies
+	//nullptr if the mesh has no triangles or an index past its vertices, bullet asserts on those
+	static std::shared_ptr<btBvhTriangleMeshShape> TriangleMesh(const ObjMeshData& mesh, const glm::vec3& scale = glm::vec3(1.f));
+
+	//true if the mesh has at least one triangle and all of its indices are in range
+	static bool IsValidTriangleMesh(const ObjMeshData& mesh);
+
+protected:
+	SMI_ShapeBuilder() = default;
+	~SMI_ShapeBuilder() = default;
+};
+
+//merges static level geometry into a single collision shape, so the whole level is one body
+class SMI_StaticGeometryBuilder
+{
+public:
+	SMI_StaticGeometryBuilder();
+
+	//adds a model's triangles, baked into world space with the transform
+	//returns false and skips the mesh if it isn't a valid triangle mesh
+	bool AddMesh(const ObjMeshData& mesh, const glm::mat4& transform);
+	//adds a primitive shape (ex. a box from the cache) at the transform
+	void AddShape(const SMI_ShapeSptr& shape, const glm::vec3& position, const glm::vec3& rotation = glm::vec3(0.f));
+
+	//builds the merged shape, a triangle mesh if only meshes were added, otherwise a compound
+	//nullptr if nothing was added
+	SMI_ShapeSptr Bake();
+
+	size_t getTriangleCount() const { return Indices.size() / 3; }
+
+private:
+	//the merged triangles in world space
+	std::vector<glm::vec3> Positions;
+	std::vector<uint32_t> Indices;
+
+	//the primitive shapes and where they are
+	std::vector<std::pair<SMI_ShapeSptr, btTransform>> Children;
+};
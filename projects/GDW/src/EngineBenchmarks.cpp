@@ -0,0 +1,515 @@
+#include "EngineBenchmarks.h"
+#include "Scene.h"
+#include "Material.h"
+#include "Shader.h"
+#include "Logging.h"
+#include "Utils/MeshBuilder.h"
+#include "Utils/MeshFactory.h"
+#include "Utils/ObjLoader.h"
+#include "VertexTypes.h"
+#include "NOU/GLTFLoader.h"
+#include "NOU/CAnimator.h"
+#include "NOU/GLState.h"
+#include "GLFW/glfw3.h"
+#include <GLM/gtc/quaternion.hpp>
+#include <cfloat>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    //scene that fills its dispatcher with hand made contact manifolds, so CollisionManage can be timed without stepping
+    class SMI_CollisionBenchScene : public SMI_Scene
+    {
+    public:
+        SMI_CollisionBenchScene(int pairCount) : SMI_Scene(BenchSettings(pairCount))
+        {
+            SMI_Prefab ball = SMI_Prefab();
+            ball.setPhysics(SMI_ShapeCache::GetSphere(0.5f), SMI_PhysicsBodyType::DYNAMIC, 1.f, false);
+
+            //spread out so nothing would touch if the world did step
+            std::vector<SMI_Transform> transforms = std::vector<SMI_Transform>(pairCount * 2);
+            for (size_t i = 0; i < transforms.size(); i++)
+                transforms[i].setPos(glm::vec3((float)(i % 100) * 2.f, (float)(i / 100) * 2.f, 0.f));
+
+            std::vector<entt::entity> balls = Instantiate(ball, transforms.size(), transforms.data());
+
+            btDispatcher* dispatcher = getPhysicsWorld()->getDispatcher();
+            for (int i = 0; i < pairCount; i++)
+            {
+                btRigidBody* first = GetComponent<SMI_Physics>(balls[i * 2]).getRigidBody();
+                btRigidBody* second = GetComponent<SMI_Physics>(balls[i * 2 + 1]).getRigidBody();
+
+                //a mix of what a real frame has: half the pairs asleep, a quarter touching without penetrating
+                if (i % 2 == 0)
+                {
+                    first->setActivationState(ISLAND_SLEEPING);
+                    second->setActivationState(ISLAND_SLEEPING);
+                }
+                float distance = i % 4 == 1 ? 0.01f : -0.01f;
+
+                btPersistentManifold* manifold = dispatcher->getNewManifold(first, second);
+                for (int j = 0; j < 4; j++)
+                {
+                    btVector3 point = btVector3(0.1f * j, 0.f, 0.f);
+                    manifold->addManifoldPoint(btManifoldPoint(point, point, btVector3(0.f, 1.f, 0.f), distance));
+                }
+                Manifolds.push_back(manifold);
+            }
+        }
+
+        ~SMI_CollisionBenchScene()
+        {
+            for (btPersistentManifold* manifold : Manifolds)
+                getPhysicsWorld()->getDispatcher()->releaseManifold(manifold);
+        }
+
+        void ManageCollisions() { CollisionManage(); }
+
+    private:
+        static SMI_PhysicsSettings BenchSettings(int pairCount)
+        {
+            SMI_PhysicsSettings settings;
+            settings.MaxPersistentManifolds = std::max(4096, pairCount * 2);
+            return settings;
+        }
+
+        std::vector<btPersistentManifold*> Manifolds;
+    };
+
+    //writes a uv sphere out as a single primitive glb, the tree has no gltf models to load
+    bool WriteSphereGlb(const std::string& filename, int tessellation)
+    {
+        MeshBuilder<VertexPosNormTexCol> builder;
+        MeshFactory::AddUvSphere(builder, glm::vec3(0.f), 1.f, tessellation);
+
+        size_t vertCount = builder.GetVertexCount();
+        size_t indexCount = builder.GetIndexCount();
+
+        std::vector<glm::vec3> positions, normals;
+        std::vector<glm::vec2> uvs;
+        glm::vec3 minPos = glm::vec3(FLT_MAX), maxPos = glm::vec3(-FLT_MAX);
+        const VertexPosNormTexCol* verts = builder.GetVertexDataPtr();
+        for (size_t i = 0; i < vertCount; i++)
+        {
+            positions.push_back(verts[i].Position);
+            normals.push_back(verts[i].Normal);
+            uvs.push_back(verts[i].UV);
+            minPos = glm::min(minPos, verts[i].Position);
+            maxPos = glm::max(maxPos, verts[i].Position);
+        }
+
+        const uint32_t* source = builder.GetIndexDataPtr();
+        std::vector<uint32_t> indices = std::vector<uint32_t>(source, source + indexCount);
+
+        std::vector<uint8_t> bin;
+        auto append = [&bin](const void* data, size_t size) {
+            size_t offset = bin.size();
+            bin.insert(bin.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+            bin.resize((bin.size() + 3) & ~size_t(3), 0);
+            return offset;
+        };
+        size_t posOffset = append(positions.data(), positions.size() * sizeof(glm::vec3));
+        size_t normOffset = append(normals.data(), normals.size() * sizeof(glm::vec3));
+        size_t uvOffset = append(uvs.data(), uvs.size() * sizeof(glm::vec2));
+        size_t indexOffset = append(indices.data(), indices.size() * sizeof(uint32_t));
+
+        nlohmann::json gltf = {
+            {"asset", {{"version", "2.0"}}},
+            {"buffers", {{{"byteLength", bin.size()}}}},
+            {"bufferViews", {
+                {{"buffer", 0}, {"byteOffset", posOffset}, {"byteLength", positions.size() * sizeof(glm::vec3)}, {"target", 34962}},
+                {{"buffer", 0}, {"byteOffset", normOffset}, {"byteLength", normals.size() * sizeof(glm::vec3)}, {"target", 34962}},
+                {{"buffer", 0}, {"byteOffset", uvOffset}, {"byteLength", uvs.size() * sizeof(glm::vec2)}, {"target", 34962}},
+                {{"buffer", 0}, {"byteOffset", indexOffset}, {"byteLength", indices.size() * sizeof(uint32_t)}, {"target", 34963}}
+            }},
+            {"accessors", {
+                {{"bufferView", 0}, {"componentType", 5126}, {"count", vertCount}, {"type", "VEC3"},
+                    {"min", {minPos.x, minPos.y, minPos.z}}, {"max", {maxPos.x, maxPos.y, maxPos.z}}},
+                {{"bufferView", 1}, {"componentType", 5126}, {"count", vertCount}, {"type", "VEC3"}},
+                {{"bufferView", 2}, {"componentType", 5126}, {"count", vertCount}, {"type", "VEC2"}},
+                {{"bufferView", 3}, {"componentType", 5125}, {"count", indexCount}, {"type", "SCALAR"}}
+            }},
+            {"meshes", {{{"primitives", {{
+                {"attributes", {{"POSITION", 0}, {"NORMAL", 1}, {"TEXCOORD_0", 2}}},
+                {"indices", 3}
+            }}}}}},
+            {"nodes", {{{"mesh", 0}}}},
+            {"scenes", {{{"nodes", {0}}}}},
+            {"scene", 0}
+        };
+
+        //json chunk is padded with spaces, the binary chunk was padded as it was built
+        std::string json = gltf.dump();
+        json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+        std::ofstream file = std::ofstream(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            LOG_ERROR("Could not write {}", filename);
+            return false;
+        }
+
+        auto writeWord = [&file](uint32_t word) { file.write((const char*)&word, sizeof(word)); };
+        writeWord(0x46546C67); //"glTF"
+        writeWord(2);
+        writeWord((uint32_t)(12 + 8 + json.size() + 8 + bin.size()));
+        writeWord((uint32_t)json.size());
+        writeWord(0x4E4F534A); //"JSON"
+        file.write(json.data(), json.size());
+        writeWord((uint32_t)bin.size());
+        writeWord(0x004E4942); //"BIN"
+        file.write((const char*)bin.data(), bin.size());
+        return file.good();
+    }
+
+    void TransformBenchmarks(SMI_MicroBench& bench)
+    {
+        SMI_Transform single = SMI_Transform();
+        single.setPos(glm::vec3(1.f, 2.f, 3.f));
+        bench.Run("Transform/RecomputeGlobal root", [&]() {
+            SMI_DoNotOptimize(single.RecomputeGlobal());
+        });
+
+        //RecomputeGlobal walks up to the root, so the leaf of a chain pays for the whole chain
+        std::vector<SMI_Transform> chain = std::vector<SMI_Transform>(8);
+        for (size_t i = 0; i < chain.size(); i++)
+        {
+            chain[i].setPos(glm::vec3(0.f, 1.f, 0.f));
+            chain[i].setRot(glm::quat(glm::radians(glm::vec3(0.f, 15.f, 0.f))));
+            if (i > 0)
+                chain[i].SetParent(&chain[i - 1]);
+        }
+        bench.Run("Transform/RecomputeGlobal depth 8", [&]() {
+            SMI_DoNotOptimize(chain.back().RecomputeGlobal());
+        });
+
+        //a scene's worth of flat transforms, like the ones the physics sync updates every frame
+        std::vector<SMI_Transform> flat = std::vector<SMI_Transform>(1000);
+        for (size_t i = 0; i < flat.size(); i++)
+            flat[i].setPos(glm::vec3((float)i, 0.f, 0.f));
+        bench.Run("Transform/RecomputeGlobal 1000 flat", [&]() {
+            for (SMI_Transform& trans : flat)
+                SMI_DoNotOptimize(trans.RecomputeGlobal());
+        });
+
+        //every transform in a 3 level tree (10 roots, 10 children each, 10 grandchildren each)
+        std::vector<SMI_Transform> tree = std::vector<SMI_Transform>(1110);
+        for (size_t i = 0; i < tree.size(); i++)
+        {
+            tree[i].setPos(glm::vec3(0.f, 0.f, 1.f));
+            if (i >= 110)
+                tree[i].SetParent(&tree[10 + (i - 110) / 10]);
+            else if (i >= 10)
+                tree[i].SetParent(&tree[(i - 10) / 10]);
+        }
+        bench.Run("Transform/RecomputeGlobal 1110 tree", [&]() {
+            for (SMI_Transform& trans : tree)
+                SMI_DoNotOptimize(trans.RecomputeGlobal());
+        });
+
+        //children unhook from their parents when destroyed, so unparent before the vectors free them in whatever order
+        for (SMI_Transform& trans : chain)
+            trans.SetParent(nullptr);
+        for (SMI_Transform& trans : tree)
+            trans.SetParent(nullptr);
+    }
+
+    void ObjLoaderBenchmarks(SMI_MicroBench& bench)
+    {
+        for (const std::string model : { "character", "car", "barrel1", "chair2" })
+        {
+            std::string name = "ObjLoader/LoadFromFile " + model;
+            std::string filename = "Models/" + model + ".obj";
+            if (!bench.isSelected(name))
+                continue;
+            if (!std::filesystem::exists(filename))
+            {
+                LOG_WARN("Skipping {}, could not find {}", name, filename);
+                continue;
+            }
+
+            bench.Run(name, [&]() {
+                SMI_DoNotOptimize(ObjLoader::LoadFromFile(filename));
+            });
+        }
+    }
+
+    void MeshFactoryBenchmarks(SMI_MicroBench& bench)
+    {
+        for (int tess : { 4, 5, 6 })
+        {
+            bench.Run("MeshFactory/AddIcoSphere tess " + std::to_string(tess), [&]() {
+                MeshBuilder<VertexPosNormTexCol> builder;
+                MeshFactory::AddIcoSphere(builder, glm::vec3(0.f), 1.f, tess);
+                SMI_DoNotOptimize(builder.GetVertexCount());
+            });
+        }
+
+        for (int tess : { 5, 6, 7 })
+        {
+            bench.Run("MeshFactory/AddUvSphere tess " + std::to_string(tess), [&]() {
+                MeshBuilder<VertexPosNormTexCol> builder;
+                MeshFactory::AddUvSphere(builder, glm::vec3(0.f), 1.f, tess);
+                SMI_DoNotOptimize(builder.GetVertexCount());
+            });
+        }
+    }
+
+    void CollisionBenchmarks(SMI_MicroBench& bench)
+    {
+        for (int pairs : { 100, 2000 })
+        {
+            std::string name = "Scene/CollisionManage " + std::to_string(pairs) + " pairs";
+            if (!bench.isSelected(name))
+                continue;
+
+            SMI_CollisionBenchScene scene(pairs);
+            bench.Run(name, [&]() {
+                scene.ManageCollisions();
+                SMI_DoNotOptimize(scene.getCollisions());
+            });
+        }
+    }
+
+    void MaterialBenchmarks(SMI_MicroBench& bench)
+    {
+        const std::string name = "Material/BindAllUniform 8 uniforms";
+        if (!bench.isSelected(name))
+            return;
+
+        //small inline program, so the case doesn't depend on the working directory
+        const char* vertSource = R"(
+            #version 410
+            layout(location = 0) in vec3 inPosition;
+            uniform mat4 u_ModelViewProjection;
+            uniform mat4 u_Model;
+            uniform mat3 u_NormalMatrix;
+            out vec3 outNormal;
+            void main() {
+                outNormal = u_NormalMatrix * inPosition;
+                gl_Position = u_ModelViewProjection * u_Model * vec4(inPosition, 1.0);
+            })";
+        const char* fragSource = R"(
+            #version 410
+            in vec3 outNormal;
+            uniform vec3 u_LightPos;
+            uniform vec3 u_LightCol;
+            uniform float u_AmbientStrength;
+            uniform float u_Shininess;
+            uniform int u_Mode;
+            out vec4 frag_color;
+            void main() {
+                float light = max(dot(normalize(outNormal), normalize(u_LightPos)), 0.0) + u_AmbientStrength;
+                frag_color = vec4(u_LightCol * light * u_Shininess * float(u_Mode), 1.0);
+            })";
+
+        Shader::Sptr shader = Shader::Create();
+        shader->LoadShaderPart(vertSource, ShaderPartType::Vertex);
+        shader->LoadShaderPart(fragSource, ShaderPartType::Fragment);
+        shader->Link();
+
+        SMI_Material::Sptr material = SMI_Material::Create();
+        material->setShader(shader);
+
+        auto addUniform = [&](auto uniform, const std::string& uniformName, const auto& data) {
+            uniform->setName(uniformName);
+            uniform->setData(data);
+            material->setUniform(uniform);
+        };
+        addUniform(UniformMatrixObject<glm::mat4>::Create(), "u_ModelViewProjection", glm::mat4(1.f));
+        addUniform(UniformMatrixObject<glm::mat4>::Create(), "u_Model", glm::mat4(1.f));
+        addUniform(UniformMatrixObject<glm::mat3>::Create(), "u_NormalMatrix", glm::mat3(1.f));
+        addUniform(UniformObject<glm::vec3>::Create(), "u_LightPos", glm::vec3(0.f, 10.f, 0.f));
+        addUniform(UniformObject<glm::vec3>::Create(), "u_LightCol", glm::vec3(1.f));
+        addUniform(UniformObject<float>::Create(), "u_AmbientStrength", 0.1f);
+        addUniform(UniformObject<float>::Create(), "u_Shininess", 16.f);
+        addUniform(UniformObject<int>::Create(), "u_Mode", 1);
+
+        shader->Bind();
+        bench.Run(name, [&]() {
+            material->BindAllUniform();
+        });
+        Shader::Unbind();
+    }
+
+    void GltfBenchmarks(SMI_MicroBench& bench)
+    {
+        const std::string name = "GLTF/LoadScene sphere";
+        if (!bench.isSelected(name))
+            return;
+
+        const std::string filename = "microbench_sphere.glb";
+        if (!WriteSphereGlb(filename, 6))
+            return;
+
+        //nou::Mesh uploads straight to GL rather than through the render device, so this case gets a hidden
+        //window of its own for the context
+        if (glfwInit() == GLFW_FALSE)
+        {
+            LOG_WARN("Skipping {}, GLFW couldn't be initialized", name);
+            return;
+        }
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow* context = glfwCreateWindow(64, 64, "microbench", nullptr, nullptr);
+        if (context == nullptr)
+        {
+            LOG_WARN("Skipping {}, no GL context could be made", name);
+            return;
+        }
+        glfwMakeContextCurrent(context);
+
+        if (gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) != 0)
+        {
+            //the parse, the packing of each primitive and the upload, the same path the game's models take
+            bench.Run(name, [&]() {
+                nou::GLTF::Scene scene;
+                nou::GLTF::LoadScene(filename, scene);
+                SMI_DoNotOptimize(scene.meshes.size());
+            });
+        }
+        else
+            LOG_WARN("Skipping {}, GL functions couldn't be loaded", name);
+
+        glfwDestroyWindow(context);
+        //the GL state cache was tracking that context
+        nou::GLState::Invalidate();
+
+        std::error_code error;
+        std::filesystem::remove(filename, error);
+    }
+
+    //a 53 joint biped: hips, a 6 joint spine into the neck and head, and 4 limbs of 11 joints (hands and feet with digits)
+    nou::Skeleton BuildBenchSkeleton()
+    {
+        nou::Skeleton skeleton;
+        auto addJoint = [&skeleton](int parent, const glm::vec3& offset) {
+            skeleton.parents.push_back(parent);
+            skeleton.names.push_back("joint" + std::to_string(skeleton.parents.size()));
+            skeleton.restPose.pos.push_back(offset);
+            skeleton.restPose.rot.push_back(glm::quat(1.f, 0.f, 0.f, 0.f));
+            skeleton.restPose.scale.push_back(glm::vec3(1.f));
+            return (int)skeleton.parents.size() - 1;
+        };
+
+        int hips = addJoint(-1, glm::vec3(0.f, 1.f, 0.f));
+        int spine = hips;
+        for (int i = 0; i < 6; i++)
+            spine = addJoint(spine, glm::vec3(0.f, 0.1f, 0.f));
+        for (int limb = 0; limb < 4; limb++)
+        {
+            float side = limb % 2 == 0 ? 1.f : -1.f;
+            int joint = addJoint(limb < 2 ? spine : hips, glm::vec3(side * 0.2f, 0.f, 0.f));
+            for (int i = 0; i < 3; i++)
+                joint = addJoint(joint, glm::vec3(0.f, -0.3f, 0.f));
+            for (int i = 0; i < 7; i++)
+                addJoint(joint, glm::vec3(0.02f * i, -0.05f, 0.f));
+        }
+
+        //inverse bind matrices from the rest pose, so the rest pose skins to the bind pose
+        std::vector<glm::mat4> globals, palette;
+        skeleton.inverseBind.assign(skeleton.parents.size(), glm::mat4(1.f));
+        skeleton.BuildEvalOrder();
+        nou::ComputePalette(skeleton, skeleton.restPose, globals, palette);
+        for (size_t i = 0; i < globals.size(); i++)
+            skeleton.inverseBind[i] = glm::inverse(globals[i]);
+        return skeleton;
+    }
+
+    //a one second loop at 30 keys per second, rotating every joint and moving the hips, like an exported walk cycle
+    nou::AnimationClip BuildBenchClip(const nou::Skeleton& skeleton)
+    {
+        const int keys = 31;
+        nou::AnimationClip clip;
+        clip.name = "walk";
+        clip.duration = 1.f;
+
+        for (size_t joint = 0; joint < skeleton.NumJoints(); joint++)
+        {
+            nou::AnimationChannel channel;
+            channel.target = (int)joint;
+            channel.path = nou::AnimationChannel::Path::ROTATION;
+            for (int k = 0; k < keys; k++)
+            {
+                float phase = (float)k / (keys - 1) * glm::two_pi<float>();
+                glm::quat rot = glm::angleAxis(0.4f * glm::sin(phase + joint * 0.3f), glm::vec3(1.f, 0.f, 0.f));
+                channel.times.push_back((float)k / (keys - 1));
+                channel.values.push_back(glm::vec4(rot.x, rot.y, rot.z, rot.w));
+            }
+            clip.channels.push_back(channel);
+        }
+
+        nou::AnimationChannel hips;
+        hips.target = 0;
+        hips.path = nou::AnimationChannel::Path::TRANSLATION;
+        for (int k = 0; k < keys; k++)
+        {
+            float phase = (float)k / (keys - 1) * glm::two_pi<float>();
+            hips.times.push_back((float)k / (keys - 1));
+            hips.values.push_back(glm::vec4(0.f, 1.f + 0.05f * glm::sin(phase * 2.f), 0.f, 0.f));
+        }
+        clip.channels.push_back(hips);
+
+        return clip;
+    }
+
+    void AnimationBenchmarks(SMI_MicroBench& bench)
+    {
+        const int characterCount = 1000;
+        const std::string single = "Animation/Sample and palette 1 character";
+        const std::string serial = "Animation/1000 characters 1 thread";
+        const std::string parallel = "Animation/1000 characters all threads";
+        if (!bench.isSelected(single) && !bench.isSelected(serial) && !bench.isSelected(parallel))
+            return;
+
+        nou::Skeleton skeleton = BuildBenchSkeleton();
+        nou::AnimationClip clip = BuildBenchClip(skeleton);
+
+        //its own world, so the characters don't end up in anything else's registry
+        nou::World world;
+        std::vector<std::unique_ptr<nou::Entity>> characters;
+        for (int i = 0; i < characterCount; i++)
+        {
+            characters.push_back(nou::Entity::Allocate(world));
+            nou::CAnimator& animator = characters.back()->Add<nou::CAnimator>(*characters.back(), skeleton);
+            animator.Play(clip);
+            //staggered so every character samples different keys
+            animator.SetTime((float)i / characterCount);
+        }
+
+        nou::CAnimator& first = characters[0]->Get<nou::CAnimator>();
+        bench.Run(single, [&]() {
+            first.Update(1.f / 60.f);
+            SMI_DoNotOptimize(first.GetPalette().data());
+        });
+
+        //the same work either way, so the two show how well it scales across the worker threads
+        {
+            nou::SystemScheduler scheduler = nou::SystemScheduler(1);
+            bench.Run(serial, [&]() {
+                nou::CAnimator::UpdateAll(world, 1.f / 60.f, scheduler);
+            });
+        }
+        {
+            nou::SystemScheduler scheduler;
+            bench.Run(parallel, [&]() {
+                nou::CAnimator::UpdateAll(world, 1.f / 60.f, scheduler);
+            });
+        }
+
+        characters.clear();
+    }
+}
+
+void SMI_RunEngineBenchmarks(SMI_MicroBench& bench)
+{
+    TransformBenchmarks(bench);
+    ObjLoaderBenchmarks(bench);
+    MeshFactoryBenchmarks(bench);
+    CollisionBenchmarks(bench);
+    MaterialBenchmarks(bench);
+    GltfBenchmarks(bench);
+    AnimationBenchmarks(bench);
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "MicroBench.h"
+
+//runs the engine's micro benchmarks: transform hierarchies, obj loading, procedural meshes, collision bookkeeping,
+//material uniform binding, glTF loading and skeletal animation
+//rendering calls go to whatever IRenderDevice is set, the null device keeps the driver out of the numbers
+//(glTF loading uploads through NOU, so that case makes a hidden window for a GL context, and is skipped without one)
+void SMI_RunEngineBenchmarks(SMI_MicroBench& bench);
@@ -0,0 +1,430 @@
+#include "FrameCapture.h"
+#include "Logging.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// Identifies a capture file, followed by the version of the layout
+static const char CaptureMagic[4] = { 'S', 'M', 'I', 'C' };
+static const uint32_t CaptureVersion = 1;
+// Commands are written as their type, arguments, result, data offset and data size, all as uint32s
+static const size_t CommandWords = 1 + 10 + 3;
+
+RecordedCommand& RecordedStream::Add(RenderCommand type, std::initializer_list<uint32_t> args) {
+	LOG_ASSERT(args.size() <= 10, "Render commands can have at most 10 arguments!");
+	RecordedCommand command = RecordedCommand();
+	command.Type = type;
+	size_t ix = 0;
+	for (uint32_t arg : args) {
+		command.Args[ix++] = arg;
+	}
+	Commands.push_back(command);
+	return Commands.back();
+}
+
+void RecordedStream::AttachData(RecordedCommand& command, const void* data, size_t size) {
+	if (data == nullptr || size == 0) {
+		return;
+	}
+	command.DataOffset = (uint32_t)Data.size();
+	command.DataSize = (uint32_t)size;
+	Data.insert(Data.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+}
+
+void RecordedStream::Append(const RecordedStream& other) {
+	uint32_t offset = (uint32_t)Data.size();
+	Data.insert(Data.end(), other.Data.begin(), other.Data.end());
+	for (RecordedCommand command : other.Commands) {
+		if (command.DataSize > 0) {
+			command.DataOffset += offset;
+		}
+		Commands.push_back(command);
+	}
+}
+
+float RecordedStream::ArgAsFloat(uint32_t arg) {
+	float result;
+	memcpy(&result, &arg, sizeof(float));
+	return result;
+}
+
+uint32_t RecordedStream::FloatArg(float value) {
+	uint32_t result;
+	memcpy(&result, &value, sizeof(float));
+	return result;
+}
+
+size_t RecordedStream::GetByteSize() const {
+	return Commands.size() * CommandWords * sizeof(uint32_t) + Data.size();
+}
+
+void RecordedStream::Clear() {
+	Commands.clear();
+	Data.clear();
+}
+
+static void WriteStream(std::ofstream& file, const RecordedStream& stream) {
+	uint32_t counts[2] = { (uint32_t)stream.Commands.size(), (uint32_t)stream.Data.size() };
+	file.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+
+	uint32_t words[CommandWords];
+	for (const RecordedCommand& command : stream.Commands) {
+		words[0] = (uint32_t)command.Type;
+		memcpy(&words[1], command.Args, sizeof(command.Args));
+		words[11] = command.Result;
+		words[12] = command.DataOffset;
+		words[13] = command.DataSize;
+		file.write(reinterpret_cast<const char*>(words), sizeof(words));
+	}
+	file.write(reinterpret_cast<const char*>(stream.Data.data()), stream.Data.size());
+}
+
+static bool ReadStream(std::ifstream& file, uint64_t fileSize, RecordedStream& stream) {
+	uint32_t counts[2] = { 0, 0 };
+	if (!file.read(reinterpret_cast<char*>(counts), sizeof(counts))) {
+		return false;
+	}
+	// The counts come from the file, so a corrupt one could ask for gigabytes, they have to fit in what's left of it
+	uint64_t remaining = fileSize - (uint64_t)file.tellg();
+	if ((uint64_t)counts[0] * CommandWords * sizeof(uint32_t) + counts[1] > remaining) {
+		return false;
+	}
+
+	stream.Commands.resize(counts[0]);
+	uint32_t words[CommandWords];
+	for (RecordedCommand& command : stream.Commands) {
+		if (!file.read(reinterpret_cast<char*>(words), sizeof(words)) || words[0] >= (uint32_t)RenderCommand::Count) {
+			return false;
+		}
+		command.Type = (RenderCommand)words[0];
+		memcpy(command.Args, &words[1], sizeof(command.Args));
+		command.Result = words[11];
+		command.DataOffset = words[12];
+		command.DataSize = words[13];
+		// Data has to be in the block, or replaying would read past it
+		if ((uint64_t)command.DataOffset + command.DataSize > counts[1]) {
+			return false;
+		}
+	}
+
+	stream.Data.resize(counts[1]);
+	return counts[1] == 0 || (bool)file.read(reinterpret_cast<char*>(stream.Data.data()), counts[1]);
+}
+
+bool FrameCapture::Save(const std::string& filename) const {
+	std::ofstream file = std::ofstream(filename, std::ios::binary);
+	if (!file.is_open()) {
+		LOG_ERROR("Could not open {} to write the frame capture", filename);
+		return false;
+	}
+
+	uint32_t header[3] = { CaptureVersion, Width, Height };
+	file.write(CaptureMagic, sizeof(CaptureMagic));
+	file.write(reinterpret_cast<const char*>(header), sizeof(header));
+	WriteStream(file, Setup);
+	WriteStream(file, Frame);
+	return file.good();
+}
+
+bool FrameCapture::Load(const std::string& filename) {
+	std::ifstream file = std::ifstream(filename, std::ios::binary);
+	if (!file.is_open()) {
+		LOG_ERROR("Could not open frame capture {}", filename);
+		return false;
+	}
+
+	char magic[4];
+	uint32_t header[3] = { 0, 0, 0 };
+	if (!file.read(magic, sizeof(magic)) || memcmp(magic, CaptureMagic, sizeof(magic)) != 0 ||
+		!file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+		LOG_ERROR("{} is not a frame capture", filename);
+		return false;
+	}
+	if (header[0] != CaptureVersion) {
+		LOG_ERROR("{} is a version {} frame capture, expected version {}", filename, header[0], CaptureVersion);
+		return false;
+	}
+	Width = header[1];
+	Height = header[2];
+
+	std::streampos start = file.tellg();
+	file.seekg(0, std::ios::end);
+	uint64_t fileSize = (uint64_t)file.tellg();
+	file.seekg(start);
+
+	if (!ReadStream(file, fileSize, Setup) || !ReadStream(file, fileSize, Frame)) {
+		LOG_ERROR("Frame capture {} is truncated or corrupt", filename);
+		Setup.Clear();
+		Frame.Clear();
+		return false;
+	}
+	return true;
+}
+
+FrameReplayer::FrameReplayer(const FrameCapture& capture, IRenderDevice* device) :
+	_capture(capture),
+	_device(device),
+	_isSetup(false),
+	_skipped(0)
+{
+	LOG_ASSERT(_device != nullptr, "A frame replayer needs a device to replay to!");
+}
+
+FrameReplayer::~FrameReplayer() {
+	Teardown();
+}
+
+void FrameReplayer::Setup() {
+	LOG_ASSERT(!_isSetup, "Frame replayer has already been set up!");
+	for (const RecordedCommand& command : _capture.Setup.Commands) {
+		_Execute(_capture.Setup, command, false);
+	}
+	_isSetup = true;
+}
+
+void FrameReplayer::ReplayFrame() {
+	LOG_ASSERT(_isSetup, "Frame replayer must be set up before replaying!");
+	for (const RecordedCommand& command : _capture.Frame.Commands) {
+		_Execute(_capture.Frame, command, true);
+	}
+
+	// Anything the frame made and didn't clean up itself would pile up over the iterations
+	for (const std::pair<RenderCommand, GLuint>& object : _frameObjects) {
+		_Destroy(object.first, object.second);
+	}
+	_frameObjects.clear();
+}
+
+void FrameReplayer::Teardown() {
+	if (!_isSetup) {
+		return;
+	}
+	for (const auto& pair : _vertexArrays) { _device->DeleteVertexArray(pair.second); }
+	for (const auto& pair : _buffers) { _device->DeleteBuffer(pair.second); }
+	for (const auto& pair : _textures) { _device->DeleteTexture(pair.second); }
+	for (const auto& pair : _programs) { _device->DeleteProgram(pair.second); }
+	_vertexArrays.clear();
+	_buffers.clear();
+	_textures.clear();
+	_programs.clear();
+	_shaders.clear();
+	_locations.clear();
+	_isSetup = false;
+}
+
+std::unordered_map<GLuint, GLuint>& FrameReplayer::_Handles(RenderCommand deleteCommand) {
+	// Objects are identified by the command that deletes them, shader parts (which linking deletes) by CompileShader
+	switch (deleteCommand) {
+		case RenderCommand::DeleteBuffer:      return _buffers;
+		case RenderCommand::DeleteVertexArray: return _vertexArrays;
+		case RenderCommand::DeleteProgram:     return _programs;
+		case RenderCommand::DeleteTexture:     return _textures;
+		default:                               return _shaders;
+	}
+}
+
+void FrameReplayer::_Destroy(RenderCommand deleteCommand, GLuint captured) {
+	std::unordered_map<GLuint, GLuint>& handles = _Handles(deleteCommand);
+	auto it = handles.find(captured);
+	if (it == handles.end()) {
+		return;
+	}
+	switch (deleteCommand) {
+		case RenderCommand::DeleteBuffer:      _device->DeleteBuffer(it->second); break;
+		case RenderCommand::DeleteVertexArray: _device->DeleteVertexArray(it->second); break;
+		case RenderCommand::DeleteProgram:     _device->DeleteProgram(it->second); break;
+		case RenderCommand::DeleteTexture:     _device->DeleteTexture(it->second); break;
+		// Shader parts are only deleted by linking
+		default: break;
+	}
+	handles.erase(it);
+}
+
+GLuint FrameReplayer::_Map(RenderCommand deleteCommand, GLuint captured) {
+	if (captured == 0) {
+		return 0;
+	}
+	const std::unordered_map<GLuint, GLuint>& handles = _Handles(deleteCommand);
+	auto it = handles.find(captured);
+	if (it == handles.end()) {
+		_skipped++;
+		return 0;
+	}
+	return it->second;
+}
+
+void FrameReplayer::_Created(RenderCommand deleteCommand, GLuint captured, GLuint handle, bool inFrame) {
+	_Handles(deleteCommand)[captured] = handle;
+	if (inFrame) {
+		_frameObjects.push_back({ deleteCommand, captured });
+	}
+}
+
+void FrameReplayer::_Deleted(RenderCommand deleteCommand, GLuint captured, bool inFrame) {
+	// Objects from the setup have to live on for the next iteration, they're deleted in Teardown
+	if (inFrame) {
+		auto it = std::find(_frameObjects.begin(), _frameObjects.end(), std::make_pair(deleteCommand, captured));
+		if (it == _frameObjects.end()) {
+			return;
+		}
+		_frameObjects.erase(it);
+	}
+	_Destroy(deleteCommand, captured);
+}
+
+void FrameReplayer::_Execute(const RecordedStream& stream, const RecordedCommand& command, bool inFrame) {
+	const uint32_t* args = command.Args;
+	const void* data = stream.GetData(command);
+	std::string log;
+
+	switch (command.Type) {
+		case RenderCommand::CreateBuffer:
+			_Created(RenderCommand::DeleteBuffer, command.Result, _device->CreateBuffer(), inFrame);
+			break;
+		case RenderCommand::DeleteBuffer:
+			_Deleted(RenderCommand::DeleteBuffer, args[0], inFrame);
+			break;
+		case RenderCommand::BufferData:
+			// Without a payload the buffer is still allocated, just with undefined contents
+			_device->BufferData(_Map(RenderCommand::DeleteBuffer, args[0]), args[1], data, args[2]);
+			break;
+		case RenderCommand::BindBuffer:
+			_device->BindBuffer(args[0], _Map(RenderCommand::DeleteBuffer, args[1]));
+			break;
+
+		case RenderCommand::CreateVertexArray:
+			_Created(RenderCommand::DeleteVertexArray, command.Result, _device->CreateVertexArray(), inFrame);
+			break;
+		case RenderCommand::DeleteVertexArray:
+			_Deleted(RenderCommand::DeleteVertexArray, args[0], inFrame);
+			break;
+		case RenderCommand::VertexAttribute:
+			_device->VertexAttribute(_Map(RenderCommand::DeleteVertexArray, args[0]), args[1], (GLint)args[2], args[3], args[4] != 0,
+									 (GLsizei)args[5], args[6]);
+			break;
+		case RenderCommand::BindVertexArray:
+			_device->BindVertexArray(_Map(RenderCommand::DeleteVertexArray, args[0]));
+			break;
+		case RenderCommand::DrawArrays:
+			_device->DrawArrays(args[0], (GLint)args[1], (GLsizei)args[2]);
+			break;
+		case RenderCommand::DrawElements:
+			_device->DrawElements(args[0], (GLsizei)args[1], args[2], args[3]);
+			break;
+
+		case RenderCommand::CreateProgram:
+			_Created(RenderCommand::DeleteProgram, command.Result, _device->CreateProgram(), inFrame);
+			break;
+		case RenderCommand::DeleteProgram:
+			_Deleted(RenderCommand::DeleteProgram, args[0], inFrame);
+			break;
+		case RenderCommand::CompileShader: {
+			if (data == nullptr) {
+				_skipped++;
+				break;
+			}
+			GLuint handle = _device->CompileShader(args[0], static_cast<const char*>(data), log);
+			if (handle == 0) {
+				LOG_WARN("Captured shader failed to compile on replay:\n{}", log);
+			}
+			_shaders[command.Result] = handle;
+		} break;
+		case RenderCommand::LinkProgram: {
+			GLuint vs = _Map(RenderCommand::CompileShader, args[1]);
+			GLuint fs = _Map(RenderCommand::CompileShader, args[2]);
+			if (!_device->LinkProgram(_Map(RenderCommand::DeleteProgram, args[0]), vs, fs, log)) {
+				LOG_WARN("Captured program failed to link on replay:\n{}", log);
+			}
+			_shaders.erase(args[1]);
+			_shaders.erase(args[2]);
+		} break;
+		case RenderCommand::UseProgram:
+			_device->UseProgram(_Map(RenderCommand::DeleteProgram, args[0]));
+			break;
+		case RenderCommand::GetUniformLocation:
+			if (data != nullptr) {
+				GLint location = _device->GetUniformLocation(_Map(RenderCommand::DeleteProgram, args[0]), static_cast<const char*>(data));
+				_locations[{ args[0], (GLint)command.Result }] = location;
+			}
+			break;
+		case RenderCommand::SetUniform: {
+			// Locations usually match on the same driver, so ones we never looked up are used as is
+			GLint location = (GLint)args[1];
+			auto it = _locations.find({ args[0], location });
+			if (it != _locations.end()) {
+				location = it->second;
+			}
+			if (data == nullptr) {
+				_skipped++;
+				break;
+			}
+			_device->SetUniform(_Map(RenderCommand::DeleteProgram, args[0]), location, (UniformType)args[2], (GLsizei)args[3], data, args[4] != 0);
+		} break;
+
+		case RenderCommand::CreateTexture:
+			_Created(RenderCommand::DeleteTexture, command.Result, _device->CreateTexture(args[0]), inFrame);
+			break;
+		case RenderCommand::DeleteTexture:
+			_Deleted(RenderCommand::DeleteTexture, args[0], inFrame);
+			break;
+		case RenderCommand::BindTextureUnit:
+			_device->BindTextureUnit(args[0], _Map(RenderCommand::DeleteTexture, args[1]));
+			break;
+		case RenderCommand::ClearTexture:
+			_device->ClearTexture(_Map(RenderCommand::DeleteTexture, args[0]), glm::vec4(
+				RecordedStream::ArgAsFloat(args[1]), RecordedStream::ArgAsFloat(args[2]),
+				RecordedStream::ArgAsFloat(args[3]), RecordedStream::ArgAsFloat(args[4])));
+			break;
+		case RenderCommand::TextureStorage2D:
+			_device->TextureStorage2D(_Map(RenderCommand::DeleteTexture, args[0]), (GLsizei)args[1], args[2], (GLsizei)args[3], (GLsizei)args[4]);
+			break;
+		case RenderCommand::TextureParameteri:
+			_device->TextureParameteri(_Map(RenderCommand::DeleteTexture, args[0]), args[1], (GLint)args[2]);
+			break;
+		case RenderCommand::TextureParameterf:
+			_device->TextureParameterf(_Map(RenderCommand::DeleteTexture, args[0]), args[1], RecordedStream::ArgAsFloat(args[2]));
+			break;
+		case RenderCommand::TextureSubImage2D:
+			// With no pixels GL would read from a null pointer, so uploads captured without payloads are skipped
+			if (data == nullptr) {
+				_skipped++;
+				break;
+			}
+			_device->TextureSubImage2D(_Map(RenderCommand::DeleteTexture, args[0]), (GLint)args[1], (GLint)args[2], (GLint)args[3],
+									   (GLsizei)args[4], (GLsizei)args[5], args[6], args[7], data);
+			break;
+		case RenderCommand::TextureSubImage3D:
+			if (data == nullptr) {
+				_skipped++;
+				break;
+			}
+			_device->TextureSubImage3D(_Map(RenderCommand::DeleteTexture, args[0]), (GLint)args[1], (GLint)args[2], (GLint)args[3], (GLint)args[4],
+									   (GLsizei)args[5], (GLsizei)args[6], (GLsizei)args[7], args[8], args[9], data);
+			break;
+		case RenderCommand::GenerateMipmap:
+			_device->GenerateMipmap(_Map(RenderCommand::DeleteTexture, args[0]));
+			break;
+
+		case RenderCommand::PixelStore:
+			_device->PixelStore(args[0], (GLint)args[1]);
+			break;
+		case RenderCommand::Enable:
+			_device->Enable(args[0]);
+			break;
+		case RenderCommand::CullFace:
+			_device->CullFace(args[0]);
+			break;
+		case RenderCommand::ClearColor:
+			_device->ClearColor(glm::vec4(
+				RecordedStream::ArgAsFloat(args[0]), RecordedStream::ArgAsFloat(args[1]),
+				RecordedStream::ArgAsFloat(args[2]), RecordedStream::ArgAsFloat(args[3])));
+			break;
+		case RenderCommand::Clear:
+			_device->Clear(args[0]);
+			break;
+
+		default:
+			_skipped++;
+			break;
+	}
+}
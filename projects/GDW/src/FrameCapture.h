@@ -0,0 +1,146 @@
+#pragma once
+#include "RenderDevice.h"
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// One call captured by a RecordingRenderDevice
+/// </summary>
+struct RecordedCommand {
+	RenderCommand Type;
+	// The call's arguments in order, handles, enums and ints as is, floats and bools bit for bit
+	uint32_t Args[10];
+	// The handle, location or status the device returned, 0 for calls without a result
+	uint32_t Result;
+	// Where the call's data (buffer contents, pixels, uniform values, shader source or names) is in the stream's data block
+	uint32_t DataOffset;
+	uint32_t DataSize;
+};
+
+/// <summary>
+/// A list of recorded commands, along with the block of data they point into
+/// </summary>
+struct RecordedStream {
+	std::vector<RecordedCommand> Commands;
+	std::vector<uint8_t> Data;
+
+	/// <summary>
+	/// Adds a command with up to 10 arguments, and returns it so the caller can fill in data and results
+	/// </summary>
+	RecordedCommand& Add(RenderCommand type, std::initializer_list<uint32_t> args);
+	/// <summary>
+	/// Copies data into the data block for the given command, which must be in this stream
+	/// </summary>
+	void AttachData(RecordedCommand& command, const void* data, size_t size);
+	/// <summary>
+	/// Adds all of the other stream's commands (and their data) to the end of this one
+	/// </summary>
+	void Append(const RecordedStream& other);
+	/// <summary>
+	/// Gets the data for a command in this stream, or nullptr if it doesn't have any
+	/// </summary>
+	const void* GetData(const RecordedCommand& command) const { return command.DataSize > 0 ? &Data[command.DataOffset] : nullptr; }
+	/// <summary>
+	/// Gets the size of the stream in bytes, as it would be written to a capture file
+	/// </summary>
+	size_t GetByteSize() const;
+	void Clear();
+
+	/// <summary>
+	/// Converts between floats and the arguments they're stored as
+	/// </summary>
+	static float ArgAsFloat(uint32_t arg);
+	static uint32_t FloatArg(float value);
+};
+
+/// <summary>
+/// A single captured frame, everything needed to render it again without the game running.
+/// Setup rebuilds the objects that were alive when the frame started (buffers, textures, programs, VAOs and global state),
+/// Frame is every call the frame made, in order
+/// </summary>
+struct FrameCapture {
+	RecordedStream Setup;
+	RecordedStream Frame;
+	// The size of the window the frame was rendered to
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+
+	/// <summary>
+	/// Writes the capture out to a binary file, returns false if the file could not be written
+	/// </summary>
+	bool Save(const std::string& filename) const;
+	/// <summary>
+	/// Reads a capture written by Save, returns false (and logs why) if the file is missing or isn't a valid capture
+	/// </summary>
+	bool Load(const std::string& filename);
+};
+
+/// <summary>
+/// Re-issues a captured frame to a render device. The handles and uniform locations in the capture are from the
+/// device it was recorded on, the replayer maps them to the objects it creates on its own device
+/// </summary>
+class FrameReplayer
+{
+public:
+	/// <summary>
+	/// Creates a replayer for a capture, the capture must outlive it
+	/// </summary>
+	/// <param name="capture">The frame to replay</param>
+	/// <param name="device">The device to replay to, usually the GL device</param>
+	FrameReplayer(const FrameCapture& capture, IRenderDevice* device);
+	~FrameReplayer();
+
+	FrameReplayer(const FrameReplayer& other) = delete;
+	FrameReplayer& operator=(const FrameReplayer& other) = delete;
+
+	/// <summary>
+	/// Creates all the objects the frame uses, has to be called once before ReplayFrame
+	/// </summary>
+	void Setup();
+	/// <summary>
+	/// Renders the frame once. Objects the frame creates are deleted at the end, and objects from the setup it deletes are kept,
+	/// so every call does the same work
+	/// </summary>
+	void ReplayFrame();
+	/// <summary>
+	/// Deletes everything the replayer created, called by the destructor if it hasn't been already
+	/// </summary>
+	void Teardown();
+
+	/// <summary>
+	/// Gets the number of commands that referenced a handle the capture never created, or had no data to upload
+	/// </summary>
+	size_t GetSkippedCount() const { return _skipped; }
+
+protected:
+	void _Execute(const RecordedStream& stream, const RecordedCommand& command, bool inFrame);
+	// Gets the handle map for a type of object, by the command that deletes it
+	std::unordered_map<GLuint, GLuint>& _Handles(RenderCommand deleteCommand);
+	// Maps a captured handle to the one made on our device, 0 stays 0
+	GLuint _Map(RenderCommand deleteCommand, GLuint captured);
+	// Maps a new object, objects made by the frame are remembered so they can be cleaned up at the end of it
+	void _Created(RenderCommand deleteCommand, GLuint captured, GLuint handle, bool inFrame);
+	// Deletes a captured object, unless it came from the setup and we're in the frame
+	void _Deleted(RenderCommand deleteCommand, GLuint captured, bool inFrame);
+	// Deletes the object on our device and forgets it
+	void _Destroy(RenderCommand deleteCommand, GLuint captured);
+
+	const FrameCapture& _capture;
+	IRenderDevice* _device;
+	bool _isSetup;
+
+	std::unordered_map<GLuint, GLuint> _buffers;
+	std::unordered_map<GLuint, GLuint> _vertexArrays;
+	std::unordered_map<GLuint, GLuint> _shaders;
+	std::unordered_map<GLuint, GLuint> _programs;
+	std::unordered_map<GLuint, GLuint> _textures;
+	// Uniform locations, by the captured program and the captured location
+	std::map<std::pair<GLuint, GLint>, GLint> _locations;
+	// Objects created by the frame that's being replayed, with the command that deletes them
+	std::vector<std::pair<RenderCommand, GLuint>> _frameObjects;
+
+	size_t _skipped;
+};
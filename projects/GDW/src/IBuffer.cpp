@@ -1,4 +1,5 @@
 #include "IBuffer.h"
+#include "RenderDevice.h"
 
 IBuffer::IBuffer(BufferType type, BufferUsage usage) :
 	_elementCount(0),
@@ -7,28 +8,28 @@ IBuffer::IBuffer(BufferType type, BufferUsage usage) :
 {
 	_type = type;
 	_usage = usage;
-	glCreateBuffers(1, &_handle);
+	_handle = IRenderDevice::Get()->CreateBuffer();
 }
 
 IBuffer::~IBuffer() {
 	if (_handle != 0) {
-		glDeleteBuffers(1, &_handle);
+		IRenderDevice::Get()->DeleteBuffer(_handle);
 		_handle = 0;
 	}
 }
 
 void IBuffer::LoadData(const void* data, size_t elementSize, size_t elementCount) {
 	// Note, this is part of the bindless state access stuff added in 4.5
-	glNamedBufferData(_handle, elementSize * elementCount, data, (GLenum)_usage);
+	IRenderDevice::Get()->BufferData(_handle, elementSize * elementCount, data, (GLenum)_usage);
 
 	_elementCount = elementCount;
 	_elementSize = elementSize;
 }
 
 void IBuffer::Bind() {
-	glBindBuffer((GLenum)_type, _handle);
+	IRenderDevice::Get()->BindBuffer((GLenum)_type, _handle);
 }
 
 void IBuffer::UnBind(BufferType type) {
-	glBindBuffer((GLenum)type, 0);
+	IRenderDevice::Get()->BindBuffer((GLenum)type, 0);
 }
@@ -1,4 +1,5 @@
 #include "ITexture.h"
+#include "RenderDevice.h"
 
 ITexture::Limits ITexture::__limits = ITexture::Limits();
 bool ITexture::__isStaticInit = false;
@@ -13,15 +14,15 @@ ITexture::ITexture(TextureType type) :
 
 void ITexture::_Recreate()
 {
-	if (_handle == 0) {
-		glDeleteTextures(1, &_handle);
+	if (_handle != 0) {
+		IRenderDevice::Get()->DeleteTexture(_handle);
 	}
-	glCreateTextures((GLenum)_type, 1, &_handle);
+	_handle = IRenderDevice::Get()->CreateTexture((GLenum)_type);
 }
 
 ITexture::~ITexture() {
-	if (glIsTexture(_handle)) {
-		glDeleteTextures(1, &_handle);
+	if (_handle != 0) {
+		IRenderDevice::Get()->DeleteTexture(_handle);
 		_handle = 0;
 	}
 }
@@ -29,17 +30,17 @@ ITexture::~ITexture() {
 void ITexture::Bind(int slot) {
 	if (_handle != 0) {
 		// Instead of glActiveTexture + glBindTexture, we can one line it now :D
-		glBindTextureUnit(slot, _handle); 
+		IRenderDevice::Get()->BindTextureUnit(slot, _handle);
 	}
 }
 
 void ITexture::Unbind(int slot) {
-	glBindTextureUnit(slot, 0);
+	IRenderDevice::Get()->BindTextureUnit(slot, 0);
 }
 
 void ITexture::Clear(const glm::vec4& color) {
 	if (_handle != 0) {
-		glClearTexImage(_handle, 0, GL_RGBA, GL_FLOAT, &color.x);
+		IRenderDevice::Get()->ClearTexture(_handle, color);
 	}
 }
 
@@ -49,14 +50,15 @@ void ITexture::__StaticInit()
 	if (__isStaticInit) return;
 
 	// Example of reading limits from the OpenGL renderer
-	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &__limits.MAX_TEXTURE_SIZE);
-	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &__limits.MAX_TEXTURE_UNITS);
-	glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE, &__limits.MAX_3D_TEXTURE_SIZE);
-	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &__limits.MAX_TEXTURE_IMAGE_UNITS);
-	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &__limits.MAX_ANISOTROPY);
+	IRenderDevice* device = IRenderDevice::Get();
+	__limits.MAX_TEXTURE_SIZE = device->GetInteger(GL_MAX_TEXTURE_SIZE);
+	__limits.MAX_TEXTURE_UNITS = device->GetInteger(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
+	__limits.MAX_3D_TEXTURE_SIZE = device->GetInteger(GL_MAX_3D_TEXTURE_SIZE);
+	__limits.MAX_TEXTURE_IMAGE_UNITS = device->GetInteger(GL_MAX_TEXTURE_IMAGE_UNITS);
+	__limits.MAX_ANISOTROPY = device->GetFloat(GL_MAX_TEXTURE_MAX_ANISOTROPY);
 
 	// Enable seamless cube maps (we'll need this later!)
-	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+	device->Enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 
 	// Let's write all our info into the console so we know what's up
 	LOG_INFO("==== Texture Limits =====");
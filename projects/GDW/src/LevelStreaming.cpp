@@ -0,0 +1,437 @@
+#include "LevelStreaming.h"
+#include "Logging.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+SMI_LevelStreamer::SMI_LevelStreamer(SMI_Scene& scene, const Shader::Sptr& shader, float chunkSize) :
+    Scene(scene)
+{
+    LevelShader = shader;
+    ChunkSize = chunkSize;
+    LoadDistance = chunkSize * 1.5f;
+    UnloadDistance = chunkSize * 2.5f;
+    UploadBudget = 1;
+    Synchronous = false;
+    StopLoader = false;
+
+    Loader = std::thread(&SMI_LevelStreamer::LoaderThread, this);
+}
+
+SMI_LevelStreamer::~SMI_LevelStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(QueueMutex);
+        StopLoader = true;
+    }
+    QueueSignal.notify_all();
+    Loader.join();
+
+    UnloadAll();
+}
+
+void SMI_LevelStreamer::AddObject(const SMI_ChunkObject& object)
+{
+    int key = static_cast<int>(std::floor(object.Pos.x / ChunkSize));
+
+    //new chunks start out covering their slice, and grow to fit props that stick out of it
+    auto it = Chunks.find(key);
+    if (it == Chunks.end())
+    {
+        it = Chunks.emplace(key, SMI_LevelChunk()).first;
+        it->second.MinX = key * ChunkSize;
+        it->second.MaxX = (key + 1) * ChunkSize;
+    }
+
+    SMI_LevelChunk& chunk = it->second;
+    chunk.MinX = std::min(chunk.MinX, object.Pos.x);
+    chunk.MaxX = std::max(chunk.MaxX, object.Pos.x);
+    chunk.Objects.push_back(object);
+}
+
+float SMI_LevelStreamer::Distance(const SMI_LevelChunk& chunk, float cameraX)
+{
+    return std::max(0.f, std::max(chunk.MinX - cameraX, cameraX - chunk.MaxX));
+}
+
+void SMI_LevelStreamer::LoadNow(float cameraX)
+{
+    for (auto& pair : Chunks)
+    {
+        SMI_LevelChunk& chunk = pair.second;
+        if (chunk.State == SMI_ChunkState::LOADED || Distance(chunk, cameraX) > LoadDistance)
+            continue;
+
+        //anything the loader thread is working on for this chunk gets thrown out
+        chunk.Generation++;
+        chunk.State = SMI_ChunkState::LOADING;
+
+        LoadJob job;
+        job.Chunk = pair.first;
+        job.Generation = chunk.Generation;
+        for (const SMI_ChunkObject& object : chunk.Objects)
+        {
+            job.Models.push_back(object.Model);
+            if (!object.Texture.empty())
+                job.Textures.push_back(object.Texture);
+        }
+        AddSolids(chunk, job);
+
+        LoadResult result;
+        RunJob(job, result);
+        FinishLoad(result);
+    }
+}
+
+void SMI_LevelStreamer::Update(float cameraX)
+{
+    //nothing in range is left to queue after this
+    if (Synchronous)
+        LoadNow(cameraX);
+
+    for (auto& pair : Chunks)
+    {
+        SMI_LevelChunk& chunk = pair.second;
+        float distance = Distance(chunk, cameraX);
+
+        if (chunk.State == SMI_ChunkState::UNLOADED && distance <= LoadDistance)
+        {
+            QueueLoad(pair.first, chunk);
+        }
+        else if (chunk.State != SMI_ChunkState::UNLOADED && distance > UnloadDistance)
+        {
+            Unload(chunk);
+        }
+    }
+
+    //finish a few of the chunks the loader thread is done with, cancelled loads don't count
+    int finished = 0;
+    while (finished < UploadBudget)
+    {
+        LoadResult result;
+        {
+            std::lock_guard<std::mutex> lock(QueueMutex);
+            if (Results.empty())
+                break;
+
+            result = std::move(Results.front());
+            Results.pop_front();
+        }
+
+        if (FinishLoad(result))
+            finished++;
+    }
+}
+
+void SMI_LevelStreamer::UnloadAll()
+{
+    for (auto& pair : Chunks)
+    {
+        if (pair.second.State != SMI_ChunkState::UNLOADED)
+            Unload(pair.second);
+    }
+}
+
+int SMI_LevelStreamer::getLoadedChunkCount() const
+{
+    int count = 0;
+    for (const auto& pair : Chunks)
+    {
+        if (pair.second.State == SMI_ChunkState::LOADED)
+            count++;
+    }
+    return count;
+}
+
+size_t SMI_LevelStreamer::getEntityCount() const
+{
+    size_t count = 0;
+    for (const auto& pair : Chunks)
+        count += pair.second.Entities.size();
+    return count;
+}
+
+size_t SMI_LevelStreamer::getResidentMeshCount() const
+{
+    return std::count_if(MeshCache.begin(), MeshCache.end(), [](const auto& pair) { return !pair.second.expired(); });
+}
+
+size_t SMI_LevelStreamer::getResidentTextureCount() const
+{
+    return std::count_if(TextureCache.begin(), TextureCache.end(), [](const auto& pair) { return !pair.second.expired(); });
+}
+
+void SMI_LevelStreamer::QueueLoad(int key, SMI_LevelChunk& chunk)
+{
+    chunk.State = SMI_ChunkState::LOADING;
+
+    LoadJob job;
+    job.Chunk = key;
+    job.Generation = chunk.Generation;
+
+    //only read files that aren't already resident for another chunk
+    for (const SMI_ChunkObject& object : chunk.Objects)
+    {
+        auto mesh = MeshCache.find(object.Model);
+        if ((mesh == MeshCache.end() || mesh->second.expired()) &&
+            std::find(job.Models.begin(), job.Models.end(), object.Model) == job.Models.end())
+            job.Models.push_back(object.Model);
+
+        if (object.Texture.empty())
+            continue;
+
+        auto tex = TextureCache.find(object.Texture);
+        if ((tex == TextureCache.end() || tex->second.expired()) && FailedTextures.count(object.Texture) == 0 &&
+            std::find(job.Textures.begin(), job.Textures.end(), object.Texture) == job.Textures.end())
+            job.Textures.push_back(object.Texture);
+    }
+    AddSolids(chunk, job);
+
+    {
+        std::lock_guard<std::mutex> lock(QueueMutex);
+        Jobs.push_back(std::move(job));
+    }
+    QueueSignal.notify_one();
+}
+
+void SMI_LevelStreamer::AddSolids(const SMI_LevelChunk& chunk, LoadJob& job)
+{
+    for (const SMI_ChunkObject& object : chunk.Objects)
+    {
+        if (!object.Solid)
+            continue;
+
+        //same transform the prop renders with
+        SMI_Transform trans = SMI_Transform();
+        trans.setPos(object.Pos);
+        trans.SetDegree(object.Rot);
+        trans.setScale(object.Scale);
+        job.Solids.push_back(std::make_pair(object.Model, trans.getGlobal()));
+    }
+}
+
+bool SMI_LevelStreamer::FinishLoad(LoadResult& result)
+{
+    SMI_PROFILE_CPU("Upload chunk");
+
+    auto it = Chunks.find(result.Chunk);
+    //the chunk was unloaded (or reloaded) while this was loading
+    if (it == Chunks.end() || it->second.Generation != result.Generation || it->second.State != SMI_ChunkState::LOADING)
+        return false;
+
+    SMI_LevelChunk& chunk = it->second;
+    chunk.Entities.reserve(chunk.Objects.size());
+
+    for (const SMI_ChunkObject& object : chunk.Objects)
+    {
+        //props whose model failed to load are left out
+        VertexArrayObject::Sptr mesh = GetMesh(object.Model, result);
+        if (mesh == nullptr)
+            continue;
+        chunk.Meshes.push_back(mesh);
+
+        SMI_Material::Sptr mat = SMI_Material::Create();
+        mat->setShader(LevelShader);
+        if (!object.Texture.empty())
+        {
+            //textures that failed to load leave the prop untextured
+            Texture2D::Sptr tex = GetTexture(object.Texture, result);
+            if (tex != nullptr)
+            {
+                chunk.Textures.push_back(tex);
+                mat->setTexture(tex, 0);
+            }
+        }
+
+        entt::entity entity = Scene.CreateEntity();
+        Scene.AttachCopy(entity, Renderer(mat, mesh));
+
+        SMI_Transform trans = SMI_Transform();
+        trans.setPos(object.Pos);
+        trans.SetDegree(object.Rot);
+        trans.setScale(object.Scale);
+        Scene.AttachCopy(entity, trans);
+
+        chunk.Entities.push_back(entity);
+    }
+
+    //one static body for all of the chunk's solid props, it goes away with the chunk's other entities
+    if (result.Collision != nullptr)
+    {
+        entt::entity entity = Scene.CreateEntity();
+        Scene.AttachCopy(entity, SMI_Physics(result.Collision, glm::vec3(0.f), glm::vec3(0.f), entity, SMI_PhysicsBodyType::STATIC, 0.f));
+        chunk.Entities.push_back(entity);
+    }
+
+    chunk.State = SMI_ChunkState::LOADED;
+    return true;
+}
+
+void SMI_LevelStreamer::Unload(SMI_LevelChunk& chunk)
+{
+    for (entt::entity entity : chunk.Entities)
+        Scene.DeleteEntity(entity);
+
+    //drops this chunk's hold on its assets, anything no other chunk uses gets freed
+    chunk.Entities.clear();
+    chunk.Meshes.clear();
+    chunk.Textures.clear();
+
+    chunk.Generation++;
+    chunk.State = SMI_ChunkState::UNLOADED;
+}
+
+VertexArrayObject::Sptr SMI_LevelStreamer::GetMesh(const std::string& path, LoadResult& result)
+{
+    VertexArrayObject::Sptr mesh = MeshCache[path].lock();
+    if (mesh != nullptr)
+        return mesh;
+
+    auto data = result.Models.find(path);
+    if (data != result.Models.end())
+    {
+        //the loader thread already failed to read it, not cached so a later load can try again
+        if (data->second.empty())
+            return nullptr;
+        mesh = ObjLoader::CreateVAO(data->second);
+    }
+    else
+    {
+        //it was resident when the job was queued but got freed since, rare enough to just load it here
+        try
+        {
+            mesh = ObjLoader::LoadFromFile(path);
+        }
+        catch (const std::exception& e)
+        {
+            LOG_WARN("Failed to load model \"{}\": {}", path, e.what());
+            return nullptr;
+        }
+    }
+
+    MeshCache[path] = mesh;
+    return mesh;
+}
+
+Texture2D::Sptr SMI_LevelStreamer::GetTexture(const std::string& path, LoadResult& result)
+{
+    Texture2D::Sptr tex = TextureCache[path].lock();
+    if (tex != nullptr)
+        return tex;
+    if (FailedTextures.count(path) > 0)
+        return nullptr;
+
+    auto data = result.Textures.find(path);
+    if (data != result.Textures.end())
+    {
+        //the loader thread already warned about it
+        if (data->second.Pixels.empty())
+        {
+            FailedTextures.insert(path);
+            return nullptr;
+        }
+        tex = Texture2D::CreateFromImage(data->second);
+    }
+    else
+    {
+        //same as meshes, it got freed after the job was queued
+        Texture2DImage image;
+        if (!Texture2D::LoadImageFromFile(path, image))
+        {
+            FailedTextures.insert(path);
+            return nullptr;
+        }
+        tex = Texture2D::CreateFromImage(image);
+    }
+
+    TextureCache[path] = tex;
+    return tex;
+}
+
+void SMI_LevelStreamer::LoaderThread()
+{
+    while (true)
+    {
+        LoadJob job;
+        {
+            std::unique_lock<std::mutex> lock(QueueMutex);
+            QueueSignal.wait(lock, [this]() { return StopLoader || !Jobs.empty(); });
+            if (StopLoader)
+                return;
+
+            job = std::move(Jobs.front());
+            Jobs.pop_front();
+        }
+
+        LoadResult result;
+        RunJob(job, result);
+
+        std::lock_guard<std::mutex> lock(QueueMutex);
+        Results.push_back(std::move(result));
+    }
+}
+
+void SMI_LevelStreamer::RunJob(const LoadJob& job, LoadResult& result)
+{
+    SMI_PROFILE_CPU("Load chunk");
+
+    result.Chunk = job.Chunk;
+    result.Generation = job.Generation;
+
+    for (const std::string& path : job.Models)
+    {
+        if (result.Models.count(path) > 0)
+            continue;
+
+        try
+        {
+            result.Models[path] = ObjLoader::LoadVertexDataFromFile(path);
+        }
+        catch (const std::exception& e)
+        {
+            LOG_WARN("Failed to load model \"{}\": {}", path, e.what());
+            result.Models[path] = std::vector<VertexPosNormTexCol>();
+        }
+    }
+
+    for (const std::string& path : job.Textures)
+    {
+        if (result.Textures.count(path) > 0)
+            continue;
+
+        //left empty if it failed, so the main thread knows not to try again
+        Texture2DImage image;
+        Texture2D::LoadImageFromFile(path, image);
+        result.Textures[path] = std::move(image);
+    }
+
+    //merging the solid props (and building the bvh) happens here too, so it stays off the main thread
+    if (!job.Solids.empty())
+    {
+        SMI_StaticGeometryBuilder builder;
+        std::unordered_map<std::string, ObjMeshData> meshes;
+
+        for (const auto& solid : job.Solids)
+        {
+            auto it = meshes.find(solid.first);
+            if (it == meshes.end())
+            {
+                ObjMeshData data;
+                try
+                {
+                    data = ObjLoader::LoadMeshDataFromFile(solid.first);
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_WARN("Failed to load collision for \"{}\": {}", solid.first, e.what());
+                }
+                it = meshes.emplace(solid.first, std::move(data)).first;
+            }
+
+            //meshes that failed to load or have no triangles are skipped
+            builder.AddMesh(it->second, solid.second);
+        }
+
+        result.Collision = builder.Bake();
+    }
+}
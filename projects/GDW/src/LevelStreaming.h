@@ -0,0 +1,158 @@
+#pragma once
+#include "Scene.h"
+#include "CollisionShapes.h"
+#include "Shader.h"
+#include "Texture2D.h"
+#include "Utils/ObjLoader.h"
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+//one static prop in a streamed level
+struct SMI_ChunkObject
+{
+	std::string Model;
+	//empty for no texture
+	std::string Texture;
+	glm::vec3 Pos = glm::vec3(0.f);
+	//rotation in degrees
+	glm::vec3 Rot = glm::vec3(0.f);
+	glm::vec3 Scale = glm::vec3(1.f);
+	//solid props in a chunk are merged into one static collision body
+	bool Solid = false;
+};
+
+enum class SMI_ChunkState
+{
+	UNLOADED = 0,
+	LOADING = 1,
+	LOADED = 2
+};
+
+//a slice of the level along the scroll (x) axis, with its own entities and the assets they use
+struct SMI_LevelChunk
+{
+	float MinX = 0.f;
+	float MaxX = 0.f;
+	std::vector<SMI_ChunkObject> Objects;
+
+	SMI_ChunkState State = SMI_ChunkState::UNLOADED;
+	//bumped whenever a load is cancelled, so late results from the loader thread are thrown out
+	uint32_t Generation = 0;
+
+	//only filled while loaded, the asset references keep shared meshes and textures alive
+	std::vector<entt::entity> Entities;
+	std::vector<VertexArrayObject::Sptr> Meshes;
+	std::vector<Texture2D::Sptr> Textures;
+};
+
+//streams level chunks in as the camera gets close and out once it's far away
+//files are read and decoded on a loader thread, only the GL uploads and entity creation happen in Update
+class SMI_LevelStreamer
+{
+public:
+	SMI_LevelStreamer(SMI_Scene& scene, const Shader::Sptr& shader, float chunkSize = 20.f);
+	~SMI_LevelStreamer();
+
+	SMI_LevelStreamer(const SMI_LevelStreamer&) = delete;
+	SMI_LevelStreamer& operator=(const SMI_LevelStreamer&) = delete;
+
+	//adds a prop to the chunk covering its x position, only call this before streaming starts
+	void AddObject(const SMI_ChunkObject& object);
+
+	//chunks start loading when the camera is within load distance, and unload past unload distance
+	//unload distance should be bigger so chunks at the edge don't load and unload every frame
+	void setLoadDistance(float distance) { LoadDistance = distance; }
+	void setUnloadDistance(float distance) { UnloadDistance = distance; }
+	//how many loaded chunks get uploaded and spawned per frame
+	void setUploadBudget(int chunksPerFrame) { UploadBudget = chunksPerFrame; }
+	//loads chunks in range during Update instead of on the loader thread, so every run streams the same way
+	void setSynchronous(bool synchronous) { Synchronous = synchronous; }
+
+	//loads everything in range right away, used before the first frame so nothing pops in
+	void LoadNow(float cameraX);
+	//queues and unloads chunks around the camera, and finishes chunks the loader thread is done with
+	void Update(float cameraX);
+	//unloads every chunk
+	void UnloadAll();
+
+	//stats
+	int getChunkCount() const { return static_cast<int>(Chunks.size()); }
+	int getLoadedChunkCount() const;
+	size_t getEntityCount() const;
+	//meshes and textures that are still alive in the asset cache
+	size_t getResidentMeshCount() const;
+	size_t getResidentTextureCount() const;
+
+private:
+	//files read by the loader thread for one chunk
+	struct LoadJob
+	{
+		int Chunk;
+		uint32_t Generation;
+		std::vector<std::string> Models;
+		std::vector<std::string> Textures;
+		//the chunk's solid props, by model and where they are
+		std::vector<std::pair<std::string, glm::mat4>> Solids;
+	};
+	struct LoadResult
+	{
+		int Chunk;
+		uint32_t Generation;
+		//models and textures that failed to load are left empty
+		std::unordered_map<std::string, std::vector<VertexPosNormTexCol>> Models;
+		std::unordered_map<std::string, Texture2DImage> Textures;
+		//the solid props merged together, nullptr if the chunk has none
+		SMI_ShapeSptr Collision;
+	};
+
+	//distance from the camera to a chunk along x, 0 if the camera is inside it
+	static float Distance(const SMI_LevelChunk& chunk, float cameraX);
+
+	void QueueLoad(int key, SMI_LevelChunk& chunk);
+	//adds the chunk's solid props to a job so their collision gets baked with the load
+	static void AddSolids(const SMI_LevelChunk& chunk, LoadJob& job);
+	//runs on the main thread, uploads the assets and creates the chunk's entities
+	//returns false if the result was for a load that got cancelled
+	bool FinishLoad(LoadResult& result);
+	void Unload(SMI_LevelChunk& chunk);
+
+	//nullptr if the model or texture couldn't be loaded
+	VertexArrayObject::Sptr GetMesh(const std::string& path, LoadResult& result);
+	Texture2D::Sptr GetTexture(const std::string& path, LoadResult& result);
+
+	void LoaderThread();
+	static void RunJob(const LoadJob& job, LoadResult& result);
+
+	SMI_Scene& Scene;
+	Shader::Sptr LevelShader;
+
+	float ChunkSize;
+	float LoadDistance;
+	float UnloadDistance;
+	int UploadBudget;
+	bool Synchronous;
+
+	//keyed by floor(x / ChunkSize)
+	std::map<int, SMI_LevelChunk> Chunks;
+
+	//assets shared between chunks, they're freed once no loaded chunk uses them
+	std::unordered_map<std::string, std::weak_ptr<VertexArrayObject>> MeshCache;
+	std::unordered_map<std::string, std::weak_ptr<Texture2D>> TextureCache;
+	//textures that failed to decode, so they aren't read again every time a chunk needs them
+	std::unordered_set<std::string> FailedTextures;
+
+	//loader thread and the queues it shares with the main thread
+	std::thread Loader;
+	std::mutex QueueMutex;
+	std::condition_variable QueueSignal;
+	std::deque<LoadJob> Jobs;
+	std::deque<LoadResult> Results;
+	bool StopLoader;
+};
@@ -1,4 +1,7 @@
 #include "Material.h"
+#include "RenderDevice.h"
+
+std::vector<int> SMI_Material::m_LastBoundSlots;
 
 SMI_Material::SMI_Material()
 {
@@ -18,11 +21,20 @@ void SMI_Material::BindAllUniform()
 
 void SMI_Material::BindAllTextures()
 {
+	//clear anything the last material bound that this one doesn't replace
+	for (int slot : m_LastBoundSlots)
+	{
+		if (m_TextureMap.find(slot) == m_TextureMap.end())
+			IRenderDevice::Get()->BindTextureUnit(slot, 0);
+	}
+	m_LastBoundSlots.clear();
+
 	std::unordered_map<int, ITexture::Sptr>::iterator it = m_TextureMap.begin();
 
 	while (it != m_TextureMap.end())
 	{
 		it->second->Bind(it->first);
+		m_LastBoundSlots.push_back(it->first);
 		it++;
 	}
 }
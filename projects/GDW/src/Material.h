@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include "Uniform.h"
 #include "ITexture.h"
 
@@ -47,5 +48,8 @@ private:
 	std::unordered_map<std::string, Uniform::Sptr> m_UniformMap;
 	//holds an unordered map of all textures
 	std::unordered_map<int, ITexture::Sptr> m_TextureMap;
+	//the slots the last material to bind its textures left bound, textures are left bound between draws
+	//so a material has to clear the slots it doesn't use or it samples the last material's textures
+	static std::vector<int> m_LastBoundSlots;
 
 };
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "MicroBench.h"
+#include "Logging.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+    double Median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        size_t middle = values.size() / 2;
+        return values.size() % 2 == 0 ? (values[middle - 1] + values[middle]) / 2.0 : values[middle];
+    }
+
+    //runs body iterations times and returns the time per call in nanoseconds
+    //with a setup, it runs before every call and the timer is paused for it, so each call is timed on its own
+    double TimeSample(const std::function<void()>& body, const std::function<void()>& setup, int iterations)
+    {
+        if (!setup)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+                body();
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+        }
+
+        double total = 0.0;
+        for (int i = 0; i < iterations; i++)
+        {
+            setup();
+            auto start = std::chrono::high_resolution_clock::now();
+            body();
+            auto end = std::chrono::high_resolution_clock::now();
+            total += std::chrono::duration<double, std::nano>(end - start).count();
+        }
+        return total / iterations;
+    }
+}
+
+SMI_MicroBench::SMI_MicroBench(const SMI_BenchSettings& settings)
+    : Settings(settings)
+{
+}
+
+bool SMI_MicroBench::isSelected(const std::string& name) const
+{
+    return Settings.Filter.empty() || name.find(Settings.Filter) != std::string::npos;
+}
+
+bool SMI_MicroBench::Run(const std::string& name, const std::function<void()>& body, const std::function<void()>& setup)
+{
+    if (!isSelected(name))
+        return false;
+
+    SMI_BenchResult result;
+    result.Name = name;
+
+    //one call to see how many fit in a sample, it doubles as the first warmup
+    double single = TimeSample(body, setup, 1);
+    result.Iterations = std::max(1, (int)std::ceil(Settings.MinSampleMs * 1e6 / std::max(single, 1.0)));
+
+    for (int i = 0; i < Settings.Warmup; i++)
+        TimeSample(body, setup, result.Iterations);
+
+    std::vector<double> samples;
+    samples.reserve(Settings.Repetitions);
+    for (int i = 0; i < std::max(Settings.Repetitions, 1); i++)
+        samples.push_back(TimeSample(body, setup, result.Iterations));
+
+    //median absolute deviation is barely moved by the outliers themselves, unlike the standard deviation
+    //(1.4826 scales it to match the standard deviation of normally distributed samples)
+    double median = Median(samples);
+    std::vector<double> deviations;
+    for (double sample : samples)
+        deviations.push_back(std::abs(sample - median));
+    double mad = Median(deviations) * 1.4826;
+
+    std::vector<double> kept;
+    for (double sample : samples)
+    {
+        if (mad == 0.0 || std::abs(sample - median) <= Settings.OutlierCutoff * mad)
+            kept.push_back(sample);
+    }
+    result.Samples = (int)kept.size();
+    result.Rejected = (int)(samples.size() - kept.size());
+
+    double total = 0.0;
+    for (double sample : kept)
+        total += sample;
+    result.Mean = total / kept.size();
+    result.Median = Median(kept);
+    result.Min = *std::min_element(kept.begin(), kept.end());
+    result.Max = *std::max_element(kept.begin(), kept.end());
+
+    double variance = 0.0;
+    for (double sample : kept)
+        variance += (sample - result.Mean) * (sample - result.Mean);
+    result.StdDev = kept.size() > 1 ? std::sqrt(variance / (kept.size() - 1)) : 0.0;
+
+    LOG_INFO("{:<40} {:>12.1f} ns (median {:.1f}, sd {:.1f}, {} x {} calls, {} outliers)",
+        name, result.Mean, result.Median, result.StdDev, result.Samples, result.Iterations, result.Rejected);
+
+    Results.push_back(result);
+    return true;
+}
+
+nlohmann::json SMI_MicroBench::ToJson() const
+{
+    nlohmann::json cases = nlohmann::json::object();
+    for (const SMI_BenchResult& result : Results)
+    {
+        cases[result.Name] = {
+            {"mean_ns", result.Mean},
+            {"median_ns", result.Median},
+            {"stddev_ns", result.StdDev},
+            {"min_ns", result.Min},
+            {"max_ns", result.Max},
+            {"iterations", result.Iterations},
+            {"samples", result.Samples},
+            {"rejected", result.Rejected}
+        };
+    }
+
+    return {
+        {"warmup", Settings.Warmup},
+        {"repetitions", Settings.Repetitions},
+        {"min_sample_ms", Settings.MinSampleMs},
+        {"outlier_cutoff", Settings.OutlierCutoff},
+        {"cases", cases}
+    };
+}
+
+bool SMI_MicroBench::CompareBaseline(const std::string& filename, float threshold) const
+{
+    std::ifstream file = std::ifstream(filename);
+    if (!file.is_open())
+    {
+        LOG_ERROR("Could not open benchmark baseline {}", filename);
+        return false;
+    }
+
+    nlohmann::json baseline = nlohmann::json::parse(file, nullptr, false);
+    if (baseline.is_discarded() || !baseline.contains("cases"))
+    {
+        LOG_ERROR("{} is not a benchmark baseline", filename);
+        return false;
+    }
+
+    bool passed = true;
+    const nlohmann::json& cases = baseline["cases"];
+    for (const SMI_BenchResult& result : Results)
+    {
+        if (!cases.contains(result.Name))
+        {
+            LOG_INFO("{:<40} new, not in the baseline", result.Name);
+            continue;
+        }
+
+        //medians are compared, they're steadier than means
+        double before = cases[result.Name].value("median_ns", 0.0);
+        double change = before > 0.0 ? (result.Median - before) / before : 0.0;
+        if (change > threshold)
+        {
+            LOG_WARN("{:<40} {:+.1f}% ({:.1f} ns -> {:.1f} ns) REGRESSED", result.Name, change * 100.0, before, result.Median);
+            passed = false;
+        }
+        else
+            LOG_INFO("{:<40} {:+.1f}% ({:.1f} ns -> {:.1f} ns)", result.Name, change * 100.0, before, result.Median);
+    }
+
+    return passed;
+}
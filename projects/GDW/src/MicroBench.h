@@ -0,0 +1,86 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include <json.hpp>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//settings shared by every case in a run
+struct SMI_BenchSettings
+{
+	//untimed samples run before measuring, to warm up caches and the allocator
+	int Warmup = 3;
+	//timed samples per case
+	int Repetitions = 30;
+	//each sample repeats the case until it takes at least this long, so quick cases aren't lost in timer noise
+	float MinSampleMs = 2.f;
+	//samples further than this many (scaled) median absolute deviations from the median are thrown out
+	float OutlierCutoff = 3.5f;
+	//only cases whose name contains this run, empty runs them all
+	std::string Filter;
+};
+
+//timing of one case, per call of the case (not per sample)
+struct SMI_BenchResult
+{
+	std::string Name;
+	//calls per sample, picked so a sample lasts MinSampleMs
+	int Iterations = 0;
+	//samples kept and samples thrown out as outliers
+	int Samples = 0;
+	int Rejected = 0;
+	//in nanoseconds per call
+	double Mean = 0.0;
+	double Median = 0.0;
+	double StdDev = 0.0;
+	double Min = 0.0;
+	double Max = 0.0;
+};
+
+//stops the compiler from optimizing away a result the benchmark never uses
+//the value's address escapes into something the compiler can't see through, so it has to be computed and kept in memory
+template <typename T>
+inline void SMI_DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+	//the pointer itself is volatile, so the store can't be dropped, and the barrier keeps it where it is
+	static const void* volatile Sink;
+	Sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
+
+//small benchmark harness for engine hot paths
+//every case is warmed up, sampled Repetitions times and has its outliers rejected, and a run can be saved as a json
+//baseline and compared against later ones
+class SMI_MicroBench
+{
+public:
+	SMI_MicroBench(const SMI_BenchSettings& settings = SMI_BenchSettings());
+
+	//times one case, body runs the operation once
+	//setup (optional) runs before every call of body and isn't timed, for putting state back between calls
+	//(calls are timed one at a time then, so keep it for cases well above the clock's resolution)
+	//returns false if the case was skipped by the filter
+	bool Run(const std::string& name, const std::function<void()>& body, const std::function<void()>& setup = nullptr);
+
+	//whether a case would run with the current filter, for skipping expensive preparation
+	bool isSelected(const std::string& name) const;
+
+	const std::vector<SMI_BenchResult>& getResults() const { return Results; }
+	const SMI_BenchSettings& getSettings() const { return Settings; }
+
+	//the run as json, can be read back by CompareBaseline
+	nlohmann::json ToJson() const;
+	//compares against a baseline saved from ToJson, logs each case's change and returns false if any case's median
+	//got slower by more than threshold (0.1 is 10%), or the baseline couldn't be read
+	bool CompareBaseline(const std::string& filename, float threshold) const;
+
+private:
+	SMI_BenchSettings Settings;
+	std::vector<SMI_BenchResult> Results;
+};
@@ -0,0 +1,45 @@
+#include "MotionState.h"
+#include "Transform.h"
+
+SMI_MotionState::SMI_MotionState(const btTransform& startTrans)
+{
+    m_WorldTrans = startTrans;
+    m_Store = nullptr;
+    m_Entity = entt::null;
+}
+
+void SMI_MotionState::Bind(entt::registry* store, entt::entity entity)
+{
+    m_Store = store;
+    m_Entity = entity;
+
+    //make sure the transform starts where the body is
+    SyncTransform();
+}
+
+void SMI_MotionState::getWorldTransform(btTransform& worldTrans) const
+{
+    worldTrans = m_WorldTrans;
+}
+
+void SMI_MotionState::setWorldTransform(const btTransform& worldTrans)
+{
+    m_WorldTrans = worldTrans;
+    SyncTransform();
+}
+
+void SMI_MotionState::SyncTransform()
+{
+    //not bound to anything yet
+    if (m_Store == nullptr || m_Entity == entt::null || !m_Store->valid(m_Entity))
+        return;
+
+    SMI_Transform* trans = m_Store->try_get<SMI_Transform>(m_Entity);
+    if (trans != nullptr)
+    {
+        const btVector3& pos = m_WorldTrans.getOrigin();
+        btQuaternion rot = m_WorldTrans.getRotation();
+
+        trans->setPosRot(glm::vec3(pos.getX(), pos.getY(), pos.getZ()), glm::quat(rot.getW(), rot.getX(), rot.getY(), rot.getZ()));
+    }
+}
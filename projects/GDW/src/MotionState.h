@@ -0,0 +1,39 @@
+#pragma once
+#include "entt.hpp"
+#include "btBulletDynamicsCommon.h"
+
+//motion state bound to an entity. Bullet only calls setWorldTransform for bodies that
+//actually moved during a step, so the transform system is updated without walking every body
+ATTRIBUTE_ALIGNED16(class) SMI_MotionState : public btMotionState
+{
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	//constructors
+	SMI_MotionState(const btTransform& startTrans = btTransform::getIdentity());
+
+	//destructor
+	virtual ~SMI_MotionState() = default;
+
+	//binds the motion state to an entity, the entity's SMI_Transform (if any) will be written to on every move
+	void Bind(entt::registry* store, entt::entity entity);
+
+	//called by bullet to get the starting transform (and every step for kinematic bodies)
+	void getWorldTransform(btTransform& worldTrans) const override;
+	//called by bullet for each body that moved during the step
+	void setWorldTransform(const btTransform& worldTrans) override;
+
+	//getter for the last transform given by bullet, no virtual call needed
+	const btTransform& getTransform() const { return m_WorldTrans; }
+
+private:
+	//last known world transform of the body
+	btTransform m_WorldTrans;
+
+	//registry and entity that the motion state writes into
+	entt::registry* m_Store;
+	entt::entity m_Entity;
+
+	//pushes the stored world transform into the bound entity's transform
+	void SyncTransform();
+};
@@ -0,0 +1,328 @@
+#include "NullRenderDevice.h"
+
+GLuint NullRenderDevice::CreateBuffer() {
+	_Count(RenderCommand::CreateBuffer);
+	GLuint handle = _nextHandle++;
+	_buffers.insert(handle);
+	return handle;
+}
+
+void NullRenderDevice::DeleteBuffer(GLuint handle) {
+	_Count(RenderCommand::DeleteBuffer);
+	if (_buffers.erase(handle) == 0) {
+		_Error("DeleteBuffer on unknown buffer {}", handle);
+	}
+}
+
+void NullRenderDevice::BufferData(GLuint handle, size_t size, const void* data, GLenum usage) {
+	_Count(RenderCommand::BufferData);
+	if (_buffers.count(handle) == 0) {
+		_Error("BufferData on unknown buffer {}", handle);
+	}
+}
+
+void NullRenderDevice::BindBuffer(GLenum target, GLuint handle) {
+	_Count(RenderCommand::BindBuffer);
+	if (handle != 0 && _buffers.count(handle) == 0) {
+		_Error("BindBuffer of unknown buffer {}", handle);
+		return;
+	}
+
+	if (target == GL_ARRAY_BUFFER) {
+		_boundArrayBuffer = handle;
+	}
+	// Like GL, the index buffer binding is part of the VAO's state
+	else if (target == GL_ELEMENT_ARRAY_BUFFER && _boundVao != 0) {
+		_vaoIndexBuffers[_boundVao] = handle;
+	}
+}
+
+GLuint NullRenderDevice::CreateVertexArray() {
+	_Count(RenderCommand::CreateVertexArray);
+	GLuint handle = _nextHandle++;
+	_vertexArrays.insert(handle);
+	return handle;
+}
+
+void NullRenderDevice::DeleteVertexArray(GLuint handle) {
+	_Count(RenderCommand::DeleteVertexArray);
+	if (_vertexArrays.erase(handle) == 0) {
+		_Error("DeleteVertexArray on unknown VAO {}", handle);
+	}
+	_vaoIndexBuffers.erase(handle);
+	if (_boundVao == handle) {
+		_boundVao = 0;
+	}
+}
+
+void NullRenderDevice::VertexAttribute(GLuint vao, GLuint slot, GLint size, GLenum type, bool normalized, GLsizei stride, size_t offset) {
+	_Count(RenderCommand::VertexAttribute);
+	if (_vertexArrays.count(vao) == 0) {
+		_Error("VertexAttribute on unknown VAO {}", vao);
+	} else if (_boundArrayBuffer == 0) {
+		_Error("VertexAttribute {} on VAO {} with no array buffer bound", slot, vao);
+	} else if (size < 1 || size > 4) {
+		_Error("VertexAttribute {} on VAO {} has {} components", slot, vao, size);
+	}
+}
+
+void NullRenderDevice::BindVertexArray(GLuint handle) {
+	_Count(RenderCommand::BindVertexArray);
+	if (handle != 0 && _vertexArrays.count(handle) == 0) {
+		_Error("BindVertexArray of unknown VAO {}", handle);
+		return;
+	}
+	_boundVao = handle;
+}
+
+void NullRenderDevice::DrawArrays(GLenum mode, GLint first, GLsizei count) {
+	_Count(RenderCommand::DrawArrays);
+	if (_boundVao == 0) {
+		_Error("DrawArrays with no VAO bound");
+	} else if (_boundProgram == 0) {
+		_Error("DrawArrays with no program in use");
+	}
+	_vertices += count;
+}
+
+void NullRenderDevice::DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset) {
+	_Count(RenderCommand::DrawElements);
+	if (_boundVao == 0) {
+		_Error("DrawElements with no VAO bound");
+	} else if (_vaoIndexBuffers[_boundVao] == 0) {
+		_Error("DrawElements with VAO {} that has no index buffer", _boundVao);
+	} else if (_boundProgram == 0) {
+		_Error("DrawElements with no program in use");
+	}
+	_vertices += count;
+}
+
+GLuint NullRenderDevice::CreateProgram() {
+	_Count(RenderCommand::CreateProgram);
+	GLuint handle = _nextHandle++;
+	_programs.insert(handle);
+	return handle;
+}
+
+void NullRenderDevice::DeleteProgram(GLuint handle) {
+	_Count(RenderCommand::DeleteProgram);
+	if (_programs.erase(handle) == 0) {
+		_Error("DeleteProgram on unknown program {}", handle);
+	}
+	_uniforms.erase(handle);
+	if (_boundProgram == handle) {
+		_boundProgram = 0;
+	}
+}
+
+GLuint NullRenderDevice::CompileShader(GLenum type, const char* source, std::string& log) {
+	_Count(RenderCommand::CompileShader);
+	// Nothing is compiled, an empty source is the only thing we can catch
+	if (source == nullptr || source[0] == '\0') {
+		log = "Empty shader source";
+		return 0;
+	}
+	GLuint handle = _nextHandle++;
+	_shaders.insert(handle);
+	return handle;
+}
+
+bool NullRenderDevice::LinkProgram(GLuint program, GLuint vs, GLuint fs, std::string& log) {
+	_Count(RenderCommand::LinkProgram);
+	bool valid = _programs.count(program) > 0 && _shaders.count(vs) > 0 && _shaders.count(fs) > 0;
+	_shaders.erase(vs);
+	_shaders.erase(fs);
+
+	if (!valid) {
+		log = "Unknown program or shader parts";
+		_Error("LinkProgram of program {} with unknown handles", program);
+	}
+	return valid;
+}
+
+void NullRenderDevice::UseProgram(GLuint handle) {
+	_Count(RenderCommand::UseProgram);
+	if (handle != 0 && _programs.count(handle) == 0) {
+		_Error("UseProgram of unknown program {}", handle);
+		return;
+	}
+	_boundProgram = handle;
+}
+
+GLint NullRenderDevice::GetUniformLocation(GLuint program, const char* name) {
+	_Count(RenderCommand::GetUniformLocation);
+	if (_programs.count(program) == 0) {
+		_Error("GetUniformLocation on unknown program {}", program);
+		return -1;
+	}
+
+	// Every name gets its own location, since we can't know which uniforms the shader really has
+	std::unordered_map<std::string, GLint>& locations = _uniforms[program];
+	auto it = locations.find(name);
+	if (it == locations.end()) {
+		it = locations.emplace(name, (GLint)locations.size()).first;
+	}
+	return it->second;
+}
+
+void NullRenderDevice::SetUniform(GLuint program, GLint location, UniformType type, GLsizei count, const void* data, bool transposed) {
+	_Count(RenderCommand::SetUniform);
+	// GL ignores location -1, so we do too
+	if (location == -1) {
+		return;
+	}
+	if (_programs.count(program) == 0) {
+		_Error("SetUniform on unknown program {}", program);
+	} else if (location < 0 || location >= (GLint)_uniforms[program].size()) {
+		_Error("SetUniform on program {} with location {} that was never looked up", program, location);
+	} else if (data == nullptr || count < 1) {
+		_Error("SetUniform on program {} location {} with no data", program, location);
+	}
+}
+
+GLuint NullRenderDevice::CreateTexture(GLenum target) {
+	_Count(RenderCommand::CreateTexture);
+	GLuint handle = _nextHandle++;
+	_textures[handle] = false;
+	return handle;
+}
+
+void NullRenderDevice::DeleteTexture(GLuint handle) {
+	_Count(RenderCommand::DeleteTexture);
+	if (_textures.erase(handle) == 0) {
+		_Error("DeleteTexture on unknown texture {}", handle);
+	}
+}
+
+void NullRenderDevice::BindTextureUnit(GLuint slot, GLuint handle) {
+	_Count(RenderCommand::BindTextureUnit);
+	if (slot >= (GLuint)GetInteger(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS)) {
+		_Error("BindTextureUnit to slot {} is past the texture unit limit", slot);
+	} else if (handle != 0 && _textures.count(handle) == 0) {
+		_Error("BindTextureUnit of unknown texture {}", handle);
+	}
+}
+
+void NullRenderDevice::ClearTexture(GLuint handle, const glm::vec4& color) {
+	_Count(RenderCommand::ClearTexture);
+	auto it = _textures.find(handle);
+	if (it == _textures.end() || !it->second) {
+		_Error("ClearTexture on texture {} with no storage", handle);
+	}
+}
+
+void NullRenderDevice::TextureStorage2D(GLuint handle, GLsizei levels, GLenum format, GLsizei width, GLsizei height) {
+	_Count(RenderCommand::TextureStorage2D);
+	auto it = _textures.find(handle);
+	if (it == _textures.end()) {
+		_Error("TextureStorage2D on unknown texture {}", handle);
+	} else if (it->second) {
+		_Error("TextureStorage2D on texture {} that already has storage", handle);
+	} else if (width <= 0 || height <= 0 || levels <= 0) {
+		_Error("TextureStorage2D on texture {} with size {}x{} and {} levels", handle, width, height, levels);
+	} else {
+		it->second = true;
+	}
+}
+
+void NullRenderDevice::TextureParameteri(GLuint handle, GLenum param, GLint value) {
+	_Count(RenderCommand::TextureParameteri);
+	if (_textures.count(handle) == 0) {
+		_Error("TextureParameteri on unknown texture {}", handle);
+	}
+}
+
+void NullRenderDevice::TextureParameterf(GLuint handle, GLenum param, GLfloat value) {
+	_Count(RenderCommand::TextureParameterf);
+	if (_textures.count(handle) == 0) {
+		_Error("TextureParameterf on unknown texture {}", handle);
+	}
+}
+
+void NullRenderDevice::TextureSubImage2D(GLuint handle, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+										 GLenum format, GLenum type, const void* data) {
+	_Count(RenderCommand::TextureSubImage2D);
+	auto it = _textures.find(handle);
+	if (it == _textures.end() || !it->second) {
+		_Error("TextureSubImage2D on texture {} with no storage", handle);
+	}
+}
+
+void NullRenderDevice::TextureSubImage3D(GLuint handle, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth,
+										 GLenum format, GLenum type, const void* data) {
+	_Count(RenderCommand::TextureSubImage3D);
+	auto it = _textures.find(handle);
+	if (it == _textures.end() || !it->second) {
+		_Error("TextureSubImage3D on texture {} with no storage", handle);
+	}
+}
+
+void NullRenderDevice::GenerateMipmap(GLuint handle) {
+	_Count(RenderCommand::GenerateMipmap);
+	auto it = _textures.find(handle);
+	if (it == _textures.end() || !it->second) {
+		_Error("GenerateMipmap on texture {} with no storage", handle);
+	}
+}
+
+void NullRenderDevice::PixelStore(GLenum param, GLint value) {
+	_Count(RenderCommand::PixelStore);
+}
+
+void NullRenderDevice::Enable(GLenum capability) {
+	_Count(RenderCommand::Enable);
+}
+
+void NullRenderDevice::CullFace(GLenum face) {
+	_Count(RenderCommand::CullFace);
+}
+
+void NullRenderDevice::ClearColor(const glm::vec4& color) {
+	_Count(RenderCommand::ClearColor);
+}
+
+void NullRenderDevice::Clear(GLbitfield mask) {
+	_Count(RenderCommand::Clear);
+}
+
+GLint NullRenderDevice::GetInteger(GLenum param) {
+	// Reasonable limits for a desktop GPU, so code that sizes things off of them still works
+	switch (param) {
+		case GL_MAX_TEXTURE_SIZE: return 16384;
+		case GL_MAX_3D_TEXTURE_SIZE: return 2048;
+		case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: return 192;
+		case GL_MAX_TEXTURE_IMAGE_UNITS: return 32;
+		default: return 0;
+	}
+}
+
+GLfloat NullRenderDevice::GetFloat(GLenum param) {
+	switch (param) {
+		case GL_MAX_TEXTURE_MAX_ANISOTROPY: return 16.0f;
+		default: return 0.0f;
+	}
+}
+
+uint64_t NullRenderDevice::GetTotalCallCount() const {
+	uint64_t total = 0;
+	for (uint64_t count : _calls) {
+		total += count;
+	}
+	return total;
+}
+
+void NullRenderDevice::ResetCounters() {
+	_calls.fill(0);
+	_vertices = 0;
+	_errors = 0;
+}
+
+void NullRenderDevice::LogStats() const {
+	LOG_INFO("Null device: {} calls, {} draws, {} vertices, {} errors, {} live objects",
+		GetTotalCallCount(), GetDrawCount(), _vertices, _errors, GetLiveObjectCount());
+	for (size_t ix = 0; ix < _calls.size(); ix++) {
+		if (_calls[ix] > 0) {
+			LOG_INFO("\t{:<20} {}", GetRenderCommandName((RenderCommand)ix), _calls[ix]);
+		}
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "RenderDevice.h"
+#include "Logging.h"
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/// <summary>
+/// A render device that does no rendering, it hands out fake handles, checks that every call
+/// is valid (known handles, something bound to draw with, storage before uploads) and counts the calls.
+/// With it the scene can be built and rendered on a machine without a GL driver, to time the CPU side of rendering
+/// </summary>
+class NullRenderDevice : public IRenderDevice
+{
+public:
+	typedef std::shared_ptr<NullRenderDevice> Sptr;
+
+	NullRenderDevice() = default;
+	virtual ~NullRenderDevice() = default;
+
+	static inline Sptr Create() {
+		return std::make_shared<NullRenderDevice>();
+	}
+
+	GLuint CreateBuffer() override;
+	void DeleteBuffer(GLuint handle) override;
+	void BufferData(GLuint handle, size_t size, const void* data, GLenum usage) override;
+	void BindBuffer(GLenum target, GLuint handle) override;
+
+	GLuint CreateVertexArray() override;
+	void DeleteVertexArray(GLuint handle) override;
+	void VertexAttribute(GLuint vao, GLuint slot, GLint size, GLenum type, bool normalized, GLsizei stride, size_t offset) override;
+	void BindVertexArray(GLuint handle) override;
+	void DrawArrays(GLenum mode, GLint first, GLsizei count) override;
+	void DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset) override;
+
+	GLuint CreateProgram() override;
+	void DeleteProgram(GLuint handle) override;
+	GLuint CompileShader(GLenum type, const char* source, std::string& log) override;
+	bool LinkProgram(GLuint program, GLuint vs, GLuint fs, std::string& log) override;
+	void UseProgram(GLuint handle) override;
+	GLint GetUniformLocation(GLuint program, const char* name) override;
+	void SetUniform(GLuint program, GLint location, UniformType type, GLsizei count, const void* data, bool transposed = false) override;
+
+	GLuint CreateTexture(GLenum target) override;
+	void DeleteTexture(GLuint handle) override;
+	void BindTextureUnit(GLuint slot, GLuint handle) override;
+	void ClearTexture(GLuint handle, const glm::vec4& color) override;
+	void TextureStorage2D(GLuint handle, GLsizei levels, GLenum format, GLsizei width, GLsizei height) override;
+	void TextureParameteri(GLuint handle, GLenum param, GLint value) override;
+	void TextureParameterf(GLuint handle, GLenum param, GLfloat value) override;
+	void TextureSubImage2D(GLuint handle, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+						   GLenum format, GLenum type, const void* data) override;
+	void TextureSubImage3D(GLuint handle, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth,
+						   GLenum format, GLenum type, const void* data) override;
+	void GenerateMipmap(GLuint handle) override;
+
+	void PixelStore(GLenum param, GLint value) override;
+	void Enable(GLenum capability) override;
+	void CullFace(GLenum face) override;
+	void ClearColor(const glm::vec4& color) override;
+	void Clear(GLbitfield mask) override;
+	GLint GetInteger(GLenum param) override;
+	GLfloat GetFloat(GLenum param) override;
+
+	/// <summary>
+	/// Gets how many times a command was called since the last ResetCounters
+	/// </summary>
+	uint64_t GetCallCount(RenderCommand command) const { return _calls[(size_t)command]; }
+	/// <summary>
+	/// Gets the total number of calls of every type since the last ResetCounters
+	/// </summary>
+	uint64_t GetTotalCallCount() const;
+	uint64_t GetDrawCount() const { return GetCallCount(RenderCommand::DrawArrays) + GetCallCount(RenderCommand::DrawElements); }
+	uint64_t GetVertexCount() const { return _vertices; }
+	/// <summary>
+	/// Gets the number of invalid calls, only the first few are logged
+	/// </summary>
+	uint64_t GetErrorCount() const { return _errors; }
+	/// <summary>
+	/// Gets the number of buffers, VAOs, programs and textures that are still alive
+	/// </summary>
+	size_t GetLiveObjectCount() const { return _buffers.size() + _vertexArrays.size() + _programs.size() + _textures.size(); }
+
+	void ResetCounters();
+	/// <summary>
+	/// Logs the call counts, errors and live objects
+	/// </summary>
+	void LogStats() const;
+
+protected:
+	// Invalid calls past this many are counted but not logged
+	static constexpr uint64_t MaxLoggedErrors = 16;
+
+	template <typename... Args>
+	void _Error(const char* format, const Args&... args) {
+		_errors++;
+		if (_errors <= MaxLoggedErrors) {
+			LOG_WARN(std::string("[Null Device] ") + format, args...);
+		}
+	}
+	void _Count(RenderCommand command) { _calls[(size_t)command]++; }
+
+	GLuint _nextHandle = 1;
+
+	std::unordered_set<GLuint> _buffers;
+	std::unordered_set<GLuint> _vertexArrays;
+	std::unordered_set<GLuint> _shaders;
+	std::unordered_set<GLuint> _programs;
+	// Textures, and whether their storage has been allocated
+	std::unordered_map<GLuint, bool> _textures;
+	// Uniform locations handed out for each program, by name
+	std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> _uniforms;
+	// The index buffer each VAO had bound to it
+	std::unordered_map<GLuint, GLuint> _vaoIndexBuffers;
+
+	GLuint _boundVao = 0;
+	GLuint _boundProgram = 0;
+	GLuint _boundArrayBuffer = 0;
+
+	std::array<uint64_t, (size_t)RenderCommand::Count> _calls = {};
+	uint64_t _vertices = 0;
+	uint64_t _errors = 0;
+};
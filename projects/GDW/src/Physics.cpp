@@ -4,47 +4,32 @@
 
 SMI_Physics::SMI_Physics()
 {
-    //set up bullet collision shape
-    objShape = new btBoxShape(btVector3(0.5, 0.5, 0.5));
-    //set up bullet transform
-    objPos.setIdentity();
-    objPos.setOrigin(btVector3(0.f, 0.f, 0.f));
-    objPos.setRotation(btQuaternion());
-    //setup up bullet motion state
-    objMotionState = new btDefaultMotionState(objPos);
-
-    //setup mass, static v dynmaic status, and local internia
-    btVector3 localIntertia(0, 0, 0);
-    objMass = 1.0f;
-
-    BodyType = SMI_PhysicsBodyType::DYNAMIC;
-
-    //create the rigidbody
-    btRigidBody::btRigidBodyConstructionInfo rbInfo(objMass, objMotionState, objShape, localIntertia);
-    objRigidBody = new btRigidBody(rbInfo);
-
-    objRigidBody->setActivationState(DISABLE_DEACTIVATION);
-
-    hasGravity = true;
-
-    inWorld = false;
-
-    Entity = static_cast<entt::entity>(-1);
-
-    objRigidBody->setUserPointer(reinterpret_cast<void*>(static_cast<uint32_t>(Entity)));
+    //default is a 1x1x1 dynamic box at the origin
+    CreateBody(SMI_ShapeCache::GetBox(glm::vec3(0.5f)), glm::vec3(0.f), glm::vec3(0.f), entt::null, SMI_PhysicsBodyType::DYNAMIC, 1.0f);
 }
 
 SMI_Physics::SMI_Physics(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale, entt::entity _Entity, SMI_PhysicsBodyType _BodyType, float _objMass)
 { 
+    //identical boxes share one shape through the cache
+    CreateBody(SMI_ShapeCache::GetBox(scale / 2.f), position, rotation, _Entity, _BodyType, _objMass);
+}
+
+SMI_Physics::SMI_Physics(const SMI_ShapeSptr& shape, glm::vec3 position, glm::vec3 rotation, entt::entity _Entity, SMI_PhysicsBodyType _BodyType, float _objMass)
+{
+    CreateBody(shape, position, rotation, _Entity, _BodyType, _objMass);
+}
+
+void SMI_Physics::CreateBody(const SMI_ShapeSptr& shape, glm::vec3 position, glm::vec3 rotation, entt::entity _Entity, SMI_PhysicsBodyType _BodyType, float _objMass)
+{
     //set up bullet collision shape
-    objShape = new btBoxShape(btVector3(scale.x /2, scale.y / 2, scale.z / 2));
+    objShape = shape;
     //set up bullet transform
     objPos.setIdentity();
     objPos.setOrigin(btVector3(position.x, position.y, position.z));
     glm::quat rot = glm::quat(glm::radians(rotation));
     objPos.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
     //setup up bullet motion state
-    objMotionState = new btDefaultMotionState(objPos);
+    objMotionState = new SMI_MotionState(objPos);
 
     //setup mass, static v dynmaic status, and local internia
     btVector3 localIntertia(0, 0, 0);
@@ -53,12 +38,15 @@ SMI_Physics::SMI_Physics(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale
     BodyType = _BodyType;
     if (BodyType == SMI_PhysicsBodyType::STATIC || BodyType == SMI_PhysicsBodyType::KINEMATIC)
     {
-        _objMass = 0;
+        objMass = 0;
     }
 
-    //create the rigidbody
-    btRigidBody::btRigidBodyConstructionInfo rbInfo(objMass, objMotionState, objShape, localIntertia);
-    objRigidBody = new btRigidBody(rbInfo);
+    //create the rigidbody, it owns the motion state and is shared between copies of this component
+    btRigidBody::btRigidBodyConstructionInfo rbInfo(objMass, objMotionState, objShape.get(), localIntertia);
+    objRigidBody = std::shared_ptr<btRigidBody>(new btRigidBody(rbInfo), [](btRigidBody* body) {
+        delete body->getMotionState();
+        delete body;
+    });
 
     //if it's kinematic, set the kinematic flag
     if (BodyType == SMI_PhysicsBodyType::KINEMATIC) {
@@ -68,15 +56,13 @@ SMI_Physics::SMI_Physics(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale
         objRigidBody->setCollisionFlags(objRigidBody->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT);
     }
 
-    objRigidBody->setActivationState(DISABLE_DEACTIVATION);
+    setSleepSettings(getTypeSleepSettings(BodyType));
 
     hasGravity = true;
 
-    inWorld = false;
-
-    Entity = _Entity;
+    World = nullptr;
 
-    objRigidBody->setUserPointer(reinterpret_cast<void*>(static_cast<uint32_t>(Entity)));
+    setEntity(_Entity);
 }
 
 SMI_Physics::~SMI_Physics()
@@ -87,6 +73,71 @@ void SMI_Physics::Update(float deltaTime)
 {
 }
 
+void SMI_Physics::setHasGravity(const bool& _hasGravity)
+{
+    hasGravity = _hasGravity;
+
+    //bodies flagged this way are skipped when the world pushes its gravity out
+    if (hasGravity)
+    {
+        objRigidBody->setFlags(objRigidBody->getFlags() & ~BT_DISABLE_WORLD_GRAVITY);
+        //the world only hands out its gravity when a body is added or the gravity changes, so one that's
+        //already in the world needs it put back here (one that isn't gets it when it's added)
+        if (World != nullptr)
+            objRigidBody->setGravity(World->getGravity());
+    }
+    else
+    {
+        objRigidBody->setFlags(objRigidBody->getFlags() | BT_DISABLE_WORLD_GRAVITY);
+        objRigidBody->setGravity(btVector3(0.f, 0.f, 0.f));
+    }
+}
+
+void SMI_Physics::setEntity(const entt::entity& _Entity)
+{
+    Entity = _Entity;
+
+    //keep the user pointer in sync so collisions report the right entity
+    objRigidBody->setUserPointer(reinterpret_cast<void*>(static_cast<uintptr_t>(static_cast<uint32_t>(Entity))));
+}
+
+entt::entity SMI_Physics::getEntity(const btCollisionObject* object)
+{
+    return static_cast<entt::entity>(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(object->getUserPointer())));
+}
+
+void SMI_Physics::BindMotionState(entt::registry& store)
+{
+    objMotionState->Bind(&store, Entity);
+}
+
+void SMI_Physics::setSleepSettings(const SMI_SleepSettings& _sleep)
+{
+    Sleep = _sleep;
+
+    objRigidBody->setSleepingThresholds(Sleep.LinearThreshold, Sleep.AngularThreshold);
+    if (Sleep.CanSleep)
+    {
+        //clear the disable flag, forceActivationState is needed since setActivationState won't change it
+        if (objRigidBody->getActivationState() == DISABLE_DEACTIVATION)
+            objRigidBody->forceActivationState(ACTIVE_TAG);
+    }
+    else
+    {
+        objRigidBody->forceActivationState(DISABLE_DEACTIVATION);
+    }
+}
+
+bool SMI_Physics::IsSleeping() const
+{
+    return objRigidBody->getActivationState() == ISLAND_SLEEPING;
+}
+
+void SMI_Physics::Wake()
+{
+    objRigidBody->activate();
+}
+
 void SMI_Physics::SetPosition(glm::vec3 pos)
 {
     btVector3 newPos = btVector3(pos.x, pos.y, pos.z);
@@ -94,13 +145,14 @@ void SMI_Physics::SetPosition(glm::vec3 pos)
     objRigidBody->getMotionState()->getWorldTransform(TransPos);
     TransPos.setOrigin(newPos);
     objRigidBody->getMotionState()->setWorldTransform(TransPos);
+
+    if (Sleep.WakeOnForce)
+        objRigidBody->activate();
 }
 
 glm::vec3 SMI_Physics::GetPosition()
 {
-    btTransform TransPos;
-    objRigidBody->getMotionState()->getWorldTransform(TransPos);
-    btVector3 pos = TransPos.getOrigin();
+    const btVector3& pos = objMotionState->getTransform().getOrigin();
 
     return glm::vec3((float)pos.getX(), (float)pos.getY(), (float)pos.getZ());
 }
@@ -116,11 +168,17 @@ glm::vec3 SMI_Physics::GetRotation()
 
 void SMI_Physics::AddForce(glm::vec3 force)
 {
+    if (Sleep.WakeOnForce)
+        objRigidBody->activate();
+
     objRigidBody->applyCentralForce(btVector3(force.x, force.y, force.z));
 }
 
 void SMI_Physics::AddImpulse(glm::vec3 impulse)
 {
+    if (Sleep.WakeOnForce)
+        objRigidBody->activate();
+
     objRigidBody->applyCentralImpulse(btVector3(impulse.x, impulse.y, impulse.z));
 }
 
@@ -129,8 +187,20 @@ void SMI_Physics::ClearForces()
     objRigidBody->clearForces();
 }
 
-SMI_Collision::SMI_Collision()
+void SMI_Physics::Teleport(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& velocity)
 {
-    b1 = entt::null;
-    b2 = entt::null;
+    btTransform trans;
+    trans.setIdentity();
+    trans.setOrigin(btVector3(pos.x, pos.y, pos.z));
+    trans.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
+
+    //the interpolation transform has to move too or the next step lerps from the old spot
+    objRigidBody->setWorldTransform(trans);
+    objRigidBody->setInterpolationWorldTransform(trans);
+    objRigidBody->setLinearVelocity(btVector3(velocity.x, velocity.y, velocity.z));
+    objRigidBody->setInterpolationLinearVelocity(btVector3(velocity.x, velocity.y, velocity.z));
+    objRigidBody->setAngularVelocity(btVector3(0.f, 0.f, 0.f));
+    objRigidBody->setInterpolationAngularVelocity(btVector3(0.f, 0.f, 0.f));
+    objRigidBody->clearForces();
+    objMotionState->setWorldTransform(trans);
 }
@@ -2,6 +2,8 @@
 #include "GLM/glm.hpp"
 #include "entt.hpp"
 #include "btBulletDynamicsCommon.h"
+#include "MotionState.h"
+#include "CollisionShapes.h"
 
 enum class SMI_PhysicsBodyType
 {
@@ -10,17 +12,34 @@ enum class SMI_PhysicsBodyType
 	DYNAMIC = 2
 };
 
+//how and when a body is allowed to go to sleep
+struct SMI_SleepSettings
+{
+	//bodies that can't sleep are simulated every step
+	bool CanSleep = true;
+	//the body sleeps once it stays under both of these speeds (units/s and rad/s) for the scene's sleep time
+	float LinearThreshold = 0.8f;
+	float AngularThreshold = 1.0f;
+	//wakes the body when a force, impulse or new position is applied to it
+	bool WakeOnForce = true;
+};
+
 class SMI_Physics
 {
 public:
 	SMI_Physics();
 	SMI_Physics(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale, entt::entity _Entity, 
 									SMI_PhysicsBodyType _BodyType = SMI_PhysicsBodyType::DYNAMIC, float _objMass = 1.f);
+	//creates a body from any shape (ex. from SMI_ShapeCache or SMI_StaticGeometryBuilder)
+	SMI_Physics(const SMI_ShapeSptr& shape, glm::vec3 position, glm::vec3 rotation, entt::entity _Entity,
+									SMI_PhysicsBodyType _BodyType = SMI_PhysicsBodyType::DYNAMIC, float _objMass = 1.f);
 
 	//copy, move, and assingment constructors for entt
+	//copies share the same rigid body and shape, which are freed with the last copy
 	SMI_Physics(const SMI_Physics&) = default;
 	SMI_Physics(SMI_Physics&&) = default;
-	SMI_Physics& operator=(SMI_Physics&) = default;
+	SMI_Physics& operator=(const SMI_Physics&) = default;
+	SMI_Physics& operator=(SMI_Physics&&) = default;
 
 	~SMI_Physics();
 
@@ -31,16 +50,38 @@ public:
 
 	float getmass() const { return objMass; }
 
-	void setInWorld(const bool& _inWorld) { inWorld = _inWorld; }
-	bool getInWorld() const { return inWorld; }
+	//the world the body was added to, nullptr if it isn't in one
+	void setInWorld(btDynamicsWorld* _world) { World = _world; }
+	bool getInWorld() const { return World != nullptr; }
 
-	void setHasGravity(const bool& _hasGravity) { hasGravity = _hasGravity; }
+	//gravity is applied once here and by the world, not every frame
+	void setHasGravity(const bool& _hasGravity);
 	bool getHasGravity() const { return hasGravity; }
 
-	void setEntity(const entt::entity& _Entity) { Entity = _Entity; }
+	void setEntity(const entt::entity& _Entity);
 	entt::entity getEntity() const { return Entity; }
 
-	btRigidBody* getRigidBody() const { return objRigidBody; }
+	//gets the entity stored in a bullet collision object's user pointer
+	static entt::entity getEntity(const btCollisionObject* object);
+
+	btRigidBody* getRigidBody() const { return objRigidBody.get(); }
+	const SMI_ShapeSptr& getShape() const { return objShape; }
+	SMI_MotionState* getMotionState() const { return objMotionState; }
+
+	//binds the motion state to this body's entity so bullet writes moves into its transform
+	void BindMotionState(entt::registry& store);
+
+	//sleep settings for this body, overriding the ones for its body type
+	void setSleepSettings(const SMI_SleepSettings& _sleep);
+	const SMI_SleepSettings& getSleepSettings() const { return Sleep; }
+	//checks if bullet has put the body to sleep
+	bool IsSleeping() const;
+	//wakes the body up if it's sleeping
+	void Wake();
+
+	//default sleep settings for every new body of a type
+	static void setTypeSleepSettings(SMI_PhysicsBodyType type, const SMI_SleepSettings& _sleep) { TypeSleep[static_cast<int>(type)] = _sleep; }
+	static const SMI_SleepSettings& getTypeSleepSettings(SMI_PhysicsBodyType type) { return TypeSleep[static_cast<int>(type)]; }
 
 	//Functions to interface with Bullet
 	void SetPosition(glm::vec3 pos);
@@ -52,54 +93,29 @@ public:
 	void AddImpulse(glm::vec3 impulse);
 	void ClearForces();
 
+	//moves the body (not just its motion state) and resets its velocities, ex: when reusing a pooled body
+	void Teleport(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& velocity = glm::vec3(0.f));
+
 private:
 	//variables used for physics collision and motion
 	float objMass;
-	btCollisionShape* objShape;
+	SMI_ShapeSptr objShape;
 	btTransform objPos;
-	btMotionState* objMotionState;
-	btRigidBody* objRigidBody;
+	SMI_MotionState* objMotionState;
+	std::shared_ptr<btRigidBody> objRigidBody;
 
-	bool inWorld;
+	btDynamicsWorld* World;
 	bool hasGravity;
 
 	entt::entity Entity;
 
 	SMI_PhysicsBodyType BodyType;
-};
-
-class SMI_Collision
-{
-public:
-	typedef std::shared_ptr<SMI_Collision>sptr;
-
-	static inline sptr Create()
-	{
-		return std::make_shared<SMI_Collision>();
-	}
 
-	//Removing implicit constructors
-	SMI_Collision(const SMI_Collision& other) = delete;
-	SMI_Collision(SMI_Collision& other) = delete;
-	SMI_Collision& operator=(const SMI_Collision& other) = delete;
-	SMI_Collision& operator=(SMI_Collision&& other) = delete;
+	SMI_SleepSettings Sleep;
 
+	//defaults by body type (static, kinematic, dynamic), kinematic bodies are moved by us so they never sleep
+	inline static SMI_SleepSettings TypeSleep[3] = { SMI_SleepSettings(), { false, 0.8f, 1.0f, true }, SMI_SleepSettings() };
 
-	//constructors and destructors
-	SMI_Collision();
-	~SMI_Collision() = default;
-
-	//getters and setters
-	void setB1(const entt::entity& _b1) { b1 = _b1; }
-	entt::entity getB1() const { return b1; }
-	void setB2(const entt::entity& _b2) { b2 = _b2; }
-	entt::entity getB2() const { return b2; }
-
-	//Checks collisions to see if they're caused by the same two objects (no repeats collisions)
-	static bool Same(sptr C1, sptr C2) { return ((C1->b1 == C2->b1 && C1->b2 == C2->b2) || (C1->b1 == C2->b2 && C1->b2 == C2->b1)); }
-
-private:
-	//used to define the space and two objects involved in a collision
-	entt::entity b1;
-	entt::entity b2;
+	//sets up the motion state and rigid body around the shape
+	void CreateBody(const SMI_ShapeSptr& shape, glm::vec3 position, glm::vec3 rotation, entt::entity _Entity, SMI_PhysicsBodyType _BodyType, float _objMass);
 };
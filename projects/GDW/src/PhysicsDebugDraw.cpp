@@ -0,0 +1,115 @@
+#include "PhysicsDebugDraw.h"
+#include "TTK/TTKContext.h"
+#include "Logging.h"
+#include "LinearMath/btAabbUtil2.h"
+
+namespace
+{
+    //bullet's debug mode bit for each category
+    int CategoryMode(SMI_DebugCategory category)
+    {
+        switch (category)
+        {
+        case SMI_DebugCategory::SHAPES:
+            return btIDebugDraw::DBG_DrawWireframe;
+        case SMI_DebugCategory::AABBS:
+            return btIDebugDraw::DBG_DrawAabb;
+        case SMI_DebugCategory::CONTACTS:
+            return btIDebugDraw::DBG_DrawContactPoints;
+        case SMI_DebugCategory::CONSTRAINTS:
+            return btIDebugDraw::DBG_DrawConstraints;
+        case SMI_DebugCategory::CONSTRAINT_LIMITS:
+            return btIDebugDraw::DBG_DrawConstraintLimits;
+        case SMI_DebugCategory::NORMALS:
+            return btIDebugDraw::DBG_DrawNormals;
+        case SMI_DebugCategory::FRAMES:
+            return btIDebugDraw::DBG_DrawFrames;
+        }
+        return btIDebugDraw::DBG_NoDebug;
+    }
+
+    uint32_t PackColor(const btVector3& color)
+    {
+        return TTK::Context::PackColor(glm::vec4(color.getX(), color.getY(), color.getZ(), 1.f));
+    }
+
+    glm::vec3 ToGlm(const btVector3& vec)
+    {
+        return glm::vec3(vec.getX(), vec.getY(), vec.getZ());
+    }
+}
+
+SMI_PhysicsDebugDraw::SMI_PhysicsDebugDraw()
+{
+    //shapes and contacts are on by default
+    DebugMode = DBG_DrawWireframe | DBG_DrawContactPoints;
+    enabled = false;
+    drawSleeping = true;
+    hasRegion = false;
+    lineCount = 0;
+}
+
+void SMI_PhysicsDebugDraw::setCategory(SMI_DebugCategory category, bool on)
+{
+    if (on)
+        DebugMode |= CategoryMode(category);
+    else
+        DebugMode &= ~CategoryMode(category);
+}
+
+bool SMI_PhysicsDebugDraw::getCategory(SMI_DebugCategory category) const
+{
+    return (DebugMode & CategoryMode(category)) != 0;
+}
+
+void SMI_PhysicsDebugDraw::setRegion(const glm::vec3& min, const glm::vec3& max)
+{
+    hasRegion = true;
+    RegionMin = btVector3(min.x, min.y, min.z);
+    RegionMax = btVector3(max.x, max.y, max.z);
+}
+
+bool SMI_PhysicsDebugDraw::InRegion(const btVector3& min, const btVector3& max) const
+{
+    if (!hasRegion)
+        return true;
+
+    return TestAabbAgainstAabb2(min, max, RegionMin, RegionMax);
+}
+
+void SMI_PhysicsDebugDraw::Flush(const glm::mat4& view, const glm::mat4& projection)
+{
+    TTK::Context& context = TTK::Context::Instance();
+    lineCount = context.GetDebugLineCount();
+
+    context.SetView(view);
+    context.SetProjection(projection);
+    context.FlushDebug();
+}
+
+void SMI_PhysicsDebugDraw::drawLine(const btVector3& from, const btVector3& to, const btVector3& color)
+{
+    TTK::Context::Instance().AddDebugLine(ToGlm(from), ToGlm(to), PackColor(color));
+}
+
+void SMI_PhysicsDebugDraw::drawLine(const btVector3& from, const btVector3& to, const btVector3& fromColor, const btVector3& toColor)
+{
+    TTK::Context::Instance().AddDebugLine(ToGlm(from), ToGlm(to), PackColor(fromColor), PackColor(toColor));
+}
+
+void SMI_PhysicsDebugDraw::drawTriangle(const btVector3& v0, const btVector3& v1, const btVector3& v2, const btVector3& color, btScalar alpha)
+{
+    TTK::Context::Instance().AddDebugTri(ToGlm(v0), ToGlm(v1), ToGlm(v2),
+        TTK::Context::PackColor(glm::vec4(color.getX(), color.getY(), color.getZ(), alpha)));
+}
+
+void SMI_PhysicsDebugDraw::drawContactPoint(const btVector3& PointOnB, const btVector3& normalOnB, btScalar distance, int lifeTime, const btVector3& color)
+{
+    //short line along the contact normal
+    drawLine(PointOnB, PointOnB + normalOnB * 0.25f, color);
+}
+
+void SMI_PhysicsDebugDraw::reportErrorWarning(const char* warningString)
+{
+    LOG_WARN("Bullet: {}", warningString);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "GLM/glm.hpp"
+#include "btBulletDynamicsCommon.h"
+
+//things the physics debug drawer can show, each one can be turned on and off by itself
+enum class SMI_DebugCategory
+{
+	SHAPES = 0,
+	AABBS = 1,
+	CONTACTS = 2,
+	CONSTRAINTS = 3,
+	CONSTRAINT_LIMITS = 4,
+	NORMALS = 5,
+	FRAMES = 6
+};
+
+//bullet debug drawer that feeds TTK::Context's debug batch, so the whole world can be drawn in a few draw calls
+class SMI_PhysicsDebugDraw : public btIDebugDraw
+{
+public:
+	SMI_PhysicsDebugDraw();
+	virtual ~SMI_PhysicsDebugDraw() = default;
+
+	//turns the whole drawer on or off, nothing is walked or drawn while it's off
+	void setEnabled(bool _enabled) { enabled = _enabled; }
+	bool getEnabled() const { return enabled; }
+
+	//per category toggles, these map onto bullet's debug modes
+	void setCategory(SMI_DebugCategory category, bool on);
+	bool getCategory(SMI_DebugCategory category) const;
+
+	//sleeping bodies don't change, hiding them cuts down on lines in busy scenes
+	void setDrawSleeping(bool _drawSleeping) { drawSleeping = _drawSleeping; }
+	bool getDrawSleeping() const { return drawSleeping; }
+
+	//only draws objects whose aabb touches this box, ex: the area around the camera
+	void setRegion(const glm::vec3& min, const glm::vec3& max);
+	void clearRegion() { hasRegion = false; }
+	bool InRegion(const btVector3& min, const btVector3& max) const;
+
+	//sends everything drawn this frame to the gpu
+	void Flush(const glm::mat4& view, const glm::mat4& projection);
+
+	//number of lines sent by the last flush
+	size_t getLineCount() const { return lineCount; }
+
+	//btIDebugDraw interface
+	void drawLine(const btVector3& from, const btVector3& to, const btVector3& color) override;
+	void drawLine(const btVector3& from, const btVector3& to, const btVector3& fromColor, const btVector3& toColor) override;
+	void drawTriangle(const btVector3& v0, const btVector3& v1, const btVector3& v2, const btVector3& color, btScalar alpha) override;
+	void drawContactPoint(const btVector3& PointOnB, const btVector3& normalOnB, btScalar distance, int lifeTime, const btVector3& color) override;
+	void reportErrorWarning(const char* warningString) override;
+	void draw3dText(const btVector3& location, const char* textString) override {}
+	void setDebugMode(int debugMode) override { DebugMode = debugMode; }
+	int getDebugMode() const override { return DebugMode; }
+
+private:
+	int DebugMode;
+	bool enabled;
+	bool drawSleeping;
+
+	bool hasRegion;
+	btVector3 RegionMin;
+	btVector3 RegionMax;
+
+	size_t lineCount;
+};
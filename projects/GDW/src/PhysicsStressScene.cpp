@@ -0,0 +1,108 @@
+#include "PhysicsStressScene.h"
+#include "Logging.h"
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+//the settings for a multithreaded world with room for a contact per crate pair
+static SMI_PhysicsSettings StressSettings(int crateCount)
+{
+    SMI_PhysicsSettings settings;
+    settings.Multithreaded = true;
+    settings.MaxPersistentManifolds = std::max(4096, crateCount * 8);
+    settings.MaxCollisionAlgorithms = std::max(4096, crateCount * 8);
+    return settings;
+}
+
+SMI_PhysicsStressScene::SMI_PhysicsStressScene(int crateCount) : SMI_Scene(StressSettings(crateCount))
+{
+    CrateCount = crateCount;
+}
+
+void SMI_PhysicsStressScene::InitScene()
+{
+    SMI_Scene::InitScene();
+
+    setGravity(glm::vec3(0.f, 0.f, -9.81f));
+
+    //floor for the crates to land on
+    {
+        entt::entity floor = CreateEntity();
+        AttachCopy(floor, SMI_Transform());
+        SMI_Physics FloorPhys = SMI_Physics(glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f), glm::vec3(200.f, 200.f, 2.f), floor, SMI_PhysicsBodyType::STATIC, 0.f);
+        AttachCopy(floor, FloorPhys);
+    }
+
+    //stack the crates in columns on a square grid
+    int side = static_cast<int>(std::ceil(std::sqrt(CrateCount / 10.f)));
+    Crates.reserve(CrateCount);
+    StartPositions.reserve(CrateCount);
+
+    for (int i = 0; i < CrateCount; i++)
+    {
+        int column = i % (side * side);
+        int layer = i / (side * side);
+        glm::vec3 pos = glm::vec3((column % side - side / 2) * 1.1f, (column / side - side / 2) * 1.1f, 0.5f + layer * 1.05f);
+
+        entt::entity crate = CreateEntity();
+        SMI_Transform CrateTrans = SMI_Transform();
+        CrateTrans.setPos(pos);
+        AttachCopy(crate, CrateTrans);
+
+        //every crate shares the same cached box shape
+        SMI_Physics CratePhys = SMI_Physics(pos, glm::vec3(0.f), glm::vec3(1.f), crate, SMI_PhysicsBodyType::DYNAMIC, 1.f);
+        AttachCopy(crate, CratePhys);
+
+        Crates.push_back(crate);
+        StartPositions.push_back(pos);
+    }
+}
+
+std::vector<float> SMI_PhysicsStressScene::MeasureStepTimes(const std::vector<int>& threadCounts, int frameCount, float deltaTime)
+{
+    std::vector<float> results;
+    results.reserve(threadCounts.size());
+
+    for (int threads : threadCounts)
+    {
+        setPhysicsThreads(threads);
+        ResetCrates();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            Update(deltaTime);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        float meanMs = std::chrono::duration<float, std::milli>(end - start).count() / frameCount;
+        results.push_back(meanMs);
+
+        SMI_PhysicsStats stats = getPhysicsStats();
+        LOG_INFO("Physics stress: {} crates, {} threads, {:.3f} ms per step ({} active, {} sleeping)",
+            CrateCount, threads, meanMs, stats.ActiveBodies, stats.SleepingBodies);
+    }
+
+    return results;
+}
+
+void SMI_PhysicsStressScene::ResetCrates()
+{
+    for (size_t i = 0; i < Crates.size(); i++)
+    {
+        SMI_Physics& phys = GetComponent<SMI_Physics>(Crates[i]);
+        btRigidBody* body = phys.getRigidBody();
+
+        btTransform start;
+        start.setIdentity();
+        start.setOrigin(btVector3(StartPositions[i].x, StartPositions[i].y, StartPositions[i].z));
+
+        body->setWorldTransform(start);
+        body->setInterpolationWorldTransform(start);
+        body->setLinearVelocity(btVector3(0.f, 0.f, 0.f));
+        body->setAngularVelocity(btVector3(0.f, 0.f, 0.f));
+        body->clearForces();
+        body->getMotionState()->setWorldTransform(start);
+        phys.Wake();
+    }
+}
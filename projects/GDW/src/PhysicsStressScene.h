@@ -0,0 +1,26 @@
+#pragma once
+#include "Scene.h"
+#include <vector>
+
+//scene with thousands of dynamic crates falling onto a floor, used to measure
+//how physics step time scales with the number of threads
+class SMI_PhysicsStressScene : public SMI_Scene
+{
+public:
+	SMI_PhysicsStressScene(int crateCount = 4000);
+	~SMI_PhysicsStressScene() = default;
+
+	void InitScene() override;
+
+	//runs the scene for frameCount fixed steps at each thread count, logs and returns the mean step time (ms) of each
+	std::vector<float> MeasureStepTimes(const std::vector<int>& threadCounts, int frameCount = 300, float deltaTime = 1.f / 60.f);
+
+private:
+	//puts every crate back in its starting spot so each run simulates the same thing
+	void ResetCrates();
+
+	int CrateCount;
+
+	std::vector<entt::entity> Crates;
+	std::vector<glm::vec3> StartPositions;
+};
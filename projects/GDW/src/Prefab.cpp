@@ -0,0 +1,30 @@
+#include "Prefab.h"
+
+SMI_Prefab::SMI_Prefab()
+{
+    HasRenderer = false;
+    HasPhysics = false;
+    Shape = nullptr;
+    BodyType = SMI_PhysicsBodyType::DYNAMIC;
+    Mass = 1.f;
+    HasGravity = true;
+}
+
+void SMI_Prefab::setPhysics(const SMI_ShapeSptr& shape, SMI_PhysicsBodyType bodyType, float mass, bool hasGravity)
+{
+    Shape = shape;
+    BodyType = bodyType;
+    Mass = mass;
+    HasGravity = hasGravity;
+    HasPhysics = true;
+}
+
+SMI_Physics SMI_Prefab::MakePhysics(const SMI_Transform& trans, entt::entity entity) const
+{
+    //physics takes its rotation in degrees
+    SMI_Physics phys = SMI_Physics(Shape, trans.getPos(), glm::degrees(glm::eulerAngles(trans.getRot())), entity, BodyType, Mass);
+    if (!HasGravity)
+        phys.setHasGravity(false);
+
+    return phys;
+}
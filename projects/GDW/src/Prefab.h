@@ -0,0 +1,45 @@
+#pragma once
+#include "Render.h"
+#include "Transform.h"
+#include "Physics.h"
+#include <memory>
+
+//component template used by SMI_Scene::Instantiate to spawn many copies of the same object
+//every instance shares the prefab's material and mesh
+class SMI_Prefab
+{
+public:
+	typedef std::shared_ptr<SMI_Prefab> Sptr;
+	static inline Sptr Create() { return std::make_shared<SMI_Prefab>(); }
+
+	SMI_Prefab();
+
+	//renderer every instance gets a copy of
+	void setRenderer(const Renderer& _rend) { Rend = _rend; HasRenderer = true; }
+	void clearRenderer() { Rend = Renderer(); HasRenderer = false; }
+	const Renderer& getRenderer() const { return Rend; }
+	bool hasRenderer() const { return HasRenderer; }
+
+	//transform used when Instantiate isn't given one per instance
+	void setTransform(const SMI_Transform& _trans) { Trans = _trans; }
+	const SMI_Transform& getTransform() const { return Trans; }
+
+	//rigid bodies can't be shared, so the prefab keeps what's needed to build one per instance
+	void setPhysics(const SMI_ShapeSptr& shape, SMI_PhysicsBodyType bodyType, float mass, bool hasGravity = true);
+	void clearPhysics() { Shape = nullptr; HasPhysics = false; }
+	bool hasPhysics() const { return HasPhysics; }
+	//builds the body for one instance
+	SMI_Physics MakePhysics(const SMI_Transform& trans, entt::entity entity) const;
+
+private:
+	bool HasRenderer;
+	Renderer Rend;
+
+	SMI_Transform Trans;
+
+	bool HasPhysics;
+	SMI_ShapeSptr Shape;
+	SMI_PhysicsBodyType BodyType;
+	float Mass;
+	bool HasGravity;
+};
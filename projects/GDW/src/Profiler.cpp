@@ -0,0 +1,298 @@
+#include "Profiler.h"
+#include "Logging.h"
+#include "imgui.h"
+#include "NOU/GLState.h"
+#include <json.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+//markers that are open on this thread, with their start times
+struct SMI_OpenMarker
+{
+    const char* Name;
+    uint64_t Start;
+};
+static thread_local std::vector<SMI_OpenMarker> OpenMarkers;
+
+//gpu events go on their own row in the trace
+static constexpr uint32_t GpuThread = 1000;
+
+float SMI_ProfileTrack::getLast() const
+{
+    return History[(Next + History.size() - 1) % History.size()];
+}
+
+float SMI_ProfileTrack::getAverage() const
+{
+    float total = 0.f;
+    for (float ms : History)
+        total += ms;
+    return total / History.size();
+}
+
+float SMI_ProfileTrack::getMax() const
+{
+    return *std::max_element(History.begin(), History.end());
+}
+
+void SMI_Profiler::setEnabled(bool enabled)
+{
+    Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t SMI_Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Epoch).count();
+}
+
+uint32_t SMI_Profiler::ThreadId()
+{
+    static thread_local uint32_t Id = ThreadCount.fetch_add(1);
+    return Id;
+}
+
+void SMI_Profiler::BeginFrame()
+{
+    //claims the main thread as thread 0 before any worker does
+    ThreadId();
+    FrameStart = Now();
+}
+
+void SMI_Profiler::EndFrame()
+{
+    //gpu markers from GpuLatency frames ago are done by now, so reading them doesn't wait on the gpu
+    //(their results land in this frame's history, a few frames behind the cpu)
+    Frame++;
+    std::vector<GpuMarker>& Ready = GpuFrames[Frame % GpuLatency];
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        for (GpuMarker& marker : Ready)
+        {
+            GLuint64 elapsed = 0;
+            if (getEnabled())
+            {
+                glGetQueryObjectui64v(marker.Query, GL_QUERY_RESULT, &elapsed);
+                Record(marker.Name, true, marker.Start, elapsed / 1000, GpuThread);
+            }
+            FreeQueries.push_back(marker.Query);
+        }
+        Ready.clear();
+
+        //move this frame's totals into the history, markers that didn't run this frame get a 0
+        if (getEnabled())
+        {
+            FrameTrack.Current = (Now() - FrameStart) / 1000.f;
+            PushHistory(FrameTrack);
+            for (SMI_ProfileTrack& track : Tracks)
+                PushHistory(track);
+        }
+    }
+}
+
+void SMI_Profiler::BeginCpu(const char* name)
+{
+    OpenMarkers.push_back({ name, Now() });
+}
+
+void SMI_Profiler::EndCpu()
+{
+    uint64_t end = Now();
+    SMI_OpenMarker marker = OpenMarkers.back();
+    OpenMarkers.pop_back();
+
+    std::lock_guard<std::mutex> guard(Lock);
+    Record(marker.Name, false, marker.Start, end - marker.Start, ThreadId());
+}
+
+bool SMI_Profiler::BeginGpu(const char* name)
+{
+    //GL_TIME_ELAPSED queries can't overlap, so only the outer marker is timed
+    if (GpuOpen)
+        return false;
+
+    GLuint query;
+    if (FreeQueries.empty())
+    {
+        glGenQueries(1, &query);
+    }
+    else
+    {
+        query = FreeQueries.back();
+        FreeQueries.pop_back();
+    }
+
+    GpuFrames[Frame % GpuLatency].push_back({ name, query, Now() });
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    GpuOpen = true;
+    return true;
+}
+
+void SMI_Profiler::EndGpu()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    GpuOpen = false;
+}
+
+void SMI_Profiler::Record(const char* name, bool isGpu, uint64_t start, uint64_t duration, uint32_t thread)
+{
+    FindTrack(name, isGpu).Current += duration / 1000.f;
+
+    if (Recording)
+    {
+        if (Trace.size() < MaxTraceEvents)
+            Trace.push_back({ name, start, duration, thread, isGpu });
+        else if (Trace.size() == MaxTraceEvents)
+        {
+            LOG_WARN("Profiler trace is full ({} events), later events are dropped", MaxTraceEvents);
+            Trace.push_back({ "Trace full", start, 0, thread, isGpu });
+        }
+    }
+}
+
+SMI_ProfileTrack& SMI_Profiler::FindTrack(const char* name, bool isGpu)
+{
+    //names are literals, so the pointer nearly always matches, strcmp catches the same name from another file
+    for (SMI_ProfileTrack& track : Tracks)
+    {
+        if (track.IsGpu == isGpu && (track.Name == name || std::strcmp(track.Name, name) == 0))
+            return track;
+    }
+
+    Tracks.push_back({ name, isGpu, std::vector<float>(HistorySize, 0.f) });
+    return Tracks.back();
+}
+
+void SMI_Profiler::PushHistory(SMI_ProfileTrack& track)
+{
+    track.History[track.Next] = track.Current;
+    track.Next = (track.Next + 1) % track.History.size();
+    track.Current = 0.f;
+}
+
+void SMI_Profiler::setRecording(bool recording)
+{
+    std::lock_guard<std::mutex> guard(Lock);
+    Recording = recording;
+    if (recording)
+        Trace.reserve(MaxTraceEvents + 1);
+}
+
+void SMI_Profiler::ClearTrace()
+{
+    std::lock_guard<std::mutex> guard(Lock);
+    Trace.clear();
+}
+
+bool SMI_Profiler::ExportTrace(const std::string& filename)
+{
+    std::lock_guard<std::mutex> guard(Lock);
+
+    //complete ("X") events with microsecond times, plus a name for every thread row
+    nlohmann::json events = nlohmann::json::array();
+    uint32_t threads = ThreadCount.load();
+    for (uint32_t thread = 0; thread < threads; thread++)
+    {
+        events.push_back({ {"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", thread},
+            {"args", { {"name", thread == 0 ? std::string("Main") : "Worker " + std::to_string(thread)} }} });
+    }
+    events.push_back({ {"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", GpuThread}, {"args", { {"name", "GPU"} }} });
+
+    //gpu events start where the cpu issued them, the gpu runs them some time after
+    for (const SMI_ProfileEvent& event : Trace)
+    {
+        events.push_back({ {"name", event.Name}, {"cat", event.IsGpu ? "gpu" : "cpu"}, {"ph", "X"},
+            {"ts", event.Start}, {"dur", event.Duration}, {"pid", 0}, {"tid", event.Thread} });
+    }
+
+    std::ofstream file = std::ofstream(filename);
+    if (!file)
+    {
+        LOG_ERROR("Could not open {} to write the profiler trace", filename);
+        return false;
+    }
+
+    nlohmann::json root = { {"traceEvents", events}, {"displayTimeUnit", "ms"} };
+    file << root.dump();
+    LOG_INFO("Wrote {} profiler events to {}", Trace.size(), filename);
+    return true;
+}
+
+SMI_ProfileTrack SMI_Profiler::getFrameTrack()
+{
+    std::lock_guard<std::mutex> guard(Lock);
+    return FrameTrack;
+}
+
+std::vector<SMI_ProfileTrack> SMI_Profiler::getTracks()
+{
+    std::lock_guard<std::mutex> guard(Lock);
+    return Tracks;
+}
+
+void SMI_Profiler::RecordInputLatency(float ms)
+{
+    if (!getEnabled())
+        return;
+
+    std::lock_guard<std::mutex> guard(Lock);
+    InputLatencyTrack.Current = ms;
+    PushHistory(InputLatencyTrack);
+}
+
+SMI_ProfileTrack SMI_Profiler::getInputLatencyTrack()
+{
+    std::lock_guard<std::mutex> guard(Lock);
+    return InputLatencyTrack;
+}
+
+void SMI_Profiler::DrawOverlay()
+{
+    std::lock_guard<std::mutex> guard(Lock);
+
+    ImGui::Begin("Profiler");
+
+    ImGui::Text("Frame: %.2f ms (avg %.2f, max %.2f)", FrameTrack.getLast(), FrameTrack.getAverage(), FrameTrack.getMax());
+    ImGui::PlotLines("##Frame", FrameTrack.History.data(), (int)FrameTrack.History.size(), (int)FrameTrack.Next,
+        nullptr, 0.f, std::max(FrameTrack.getMax(), 16.7f), ImVec2(0, 60));
+
+    ImGui::Text("Input to present: %.2f ms (avg %.2f, max %.2f)", InputLatencyTrack.getLast(), InputLatencyTrack.getAverage(),
+        InputLatencyTrack.getMax());
+
+    const nou::GLState::Stats& glStats = nou::GLState::GetFrameStats();
+    ImGui::Text("GL state: %u calls, %u redundant skipped", glStats.issued, glStats.elided);
+
+    ImGui::Text(Recording ? "Recording trace (%d events)" : "Trace: %d events", (int)Trace.size());
+    ImGui::Separator();
+
+    ImGui::Columns(4);
+    ImGui::Text("Marker"); ImGui::NextColumn();
+    ImGui::Text("Last ms"); ImGui::NextColumn();
+    ImGui::Text("Avg ms"); ImGui::NextColumn();
+    ImGui::Text("Max ms"); ImGui::NextColumn();
+    ImGui::Separator();
+    for (const SMI_ProfileTrack& track : Tracks)
+    {
+        ImGui::Text("%s%s", track.IsGpu ? "[GPU] " : "", track.Name); ImGui::NextColumn();
+        ImGui::Text("%.3f", track.getLast()); ImGui::NextColumn();
+        ImGui::Text("%.3f", track.getAverage()); ImGui::NextColumn();
+        ImGui::Text("%.3f", track.getMax()); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+
+    ImGui::End();
+}
+
+void SMI_Profiler::Shutdown()
+{
+    for (std::vector<GpuMarker>& frame : GpuFrames)
+    {
+        for (GpuMarker& marker : frame)
+            FreeQueries.push_back(marker.Query);
+        frame.clear();
+    }
+
+    if (!FreeQueries.empty())
+        glDeleteQueries((GLsizei)FreeQueries.size(), FreeQueries.data());
+    FreeQueries.clear();
+}
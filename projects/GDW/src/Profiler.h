@@ -0,0 +1,171 @@
+#pragma once
+#include <glad/glad.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//set to 0 to compile every profiler marker out of the game
+#ifndef SMI_PROFILER_ENABLED
+#define SMI_PROFILER_ENABLED 1
+#endif
+
+//one finished marker, times are in microseconds since the profiler started
+struct SMI_ProfileEvent
+{
+	const char* Name;
+	uint64_t Start;
+	uint64_t Duration;
+	uint32_t Thread;
+	bool IsGpu;
+};
+
+//rolling per frame times of one marker, for the overlay
+struct SMI_ProfileTrack
+{
+	const char* Name;
+	bool IsGpu;
+	//ms spent in the marker for the last HistorySize frames, Next is the oldest
+	std::vector<float> History;
+	size_t Next = 0;
+	//ms added up during the frame that's being recorded
+	float Current = 0.f;
+
+	float getLast() const;
+	float getAverage() const;
+	float getMax() const;
+};
+
+//frame profiler, with scoped cpu markers from any thread and GL_TIME_ELAPSED queries for gpu passes
+//everything is static like the shape cache, marker names must be string literals (they're kept by pointer)
+class SMI_Profiler
+{
+public:
+	//frames kept for the overlay graphs
+	static constexpr size_t HistorySize = 240;
+	//frames a gpu query is left in flight before its result is read, so reading never stalls
+	static constexpr size_t GpuLatency = 4;
+	//events kept while recording a trace, anything past this is dropped
+	static constexpr size_t MaxTraceEvents = 1 << 20;
+
+	//markers do nothing (past one branch) while the profiler is disabled
+	static void setEnabled(bool enabled);
+	static bool getEnabled() { return Enabled.load(std::memory_order_relaxed); }
+	//gpu markers need a gl context, turn them off when rendering through the null device
+	static void setGpuTiming(bool gpuTiming) { GpuTiming = gpuTiming; }
+	static bool getGpuTiming() { return GpuTiming; }
+
+	//marks the frame edges, EndFrame reads back old gpu queries and moves this frame's totals into the history
+	static void BeginFrame();
+	static void EndFrame();
+
+	//use SMI_PROFILE_CPU and SMI_PROFILE_GPU instead of these
+	static void BeginCpu(const char* name);
+	static void EndCpu();
+	//gpu markers are main thread only and can't nest, nested ones are skipped
+	static bool BeginGpu(const char* name);
+	static void EndGpu();
+
+	//starts or stops keeping every event for ExportTrace
+	static void setRecording(bool recording);
+	static bool getRecording() { return Recording; }
+	//writes the recorded events as chrome trace event json (chrome://tracing or ui.perfetto.dev)
+	static bool ExportTrace(const std::string& filename);
+	static void ClearTrace();
+
+	//history of whole frames and of every marker seen so far, copied under the lock since worker threads add to them
+	static SMI_ProfileTrack getFrameTrack();
+	static std::vector<SMI_ProfileTrack> getTracks();
+
+	//ms from a key or mouse button event to the present of the first frame that saw it, one entry per event
+	static void RecordInputLatency(float ms);
+	static SMI_ProfileTrack getInputLatencyTrack();
+
+	//draws the history in an imgui window, needs to be between ImGui::NewFrame and ImGui::Render
+	static void DrawOverlay();
+
+	//frees the gpu queries, needs the gl context
+	static void Shutdown();
+
+protected:
+	SMI_Profiler() = default;
+	~SMI_Profiler() = default;
+
+	//a gpu marker waiting on its query
+	struct GpuMarker
+	{
+		const char* Name;
+		GLuint Query;
+		uint64_t Start;
+	};
+
+	//microseconds since the profiler started
+	static uint64_t Now();
+	//small id for the calling thread, the first thread to ask (the main thread) is 0
+	static uint32_t ThreadId();
+	//adds a finished marker to its track and the trace, needs Lock held
+	static void Record(const char* name, bool isGpu, uint64_t start, uint64_t duration, uint32_t thread);
+	static SMI_ProfileTrack& FindTrack(const char* name, bool isGpu);
+	static void PushHistory(SMI_ProfileTrack& track);
+
+	inline static std::atomic<bool> Enabled = false;
+	inline static bool Recording = false;
+	inline static bool GpuTiming = true;
+	inline static std::chrono::steady_clock::time_point Epoch = std::chrono::steady_clock::now();
+	inline static uint64_t FrameStart = 0;
+
+	//tracks and trace are written by every thread that ends a marker
+	inline static std::mutex Lock;
+	inline static SMI_ProfileTrack FrameTrack = { "Frame", false, std::vector<float>(HistorySize, 0.f) };
+	inline static SMI_ProfileTrack InputLatencyTrack = { "Input to present", false, std::vector<float>(HistorySize, 0.f) };
+	inline static std::vector<SMI_ProfileTrack> Tracks;
+	inline static std::vector<SMI_ProfileEvent> Trace;
+	inline static std::atomic<uint32_t> ThreadCount = 0;
+
+	//gpu markers per frame in a ring, the slot being recorded is Frame % GpuLatency
+	inline static std::vector<GpuMarker> GpuFrames[GpuLatency];
+	inline static std::vector<GLuint> FreeQueries;
+	inline static size_t Frame = 0;
+	inline static bool GpuOpen = false;
+};
+
+//times the rest of the scope on the cpu
+class SMI_CpuScope
+{
+public:
+	SMI_CpuScope(const char* name) : Active(SMI_Profiler::getEnabled()) { if (Active) SMI_Profiler::BeginCpu(name); }
+	~SMI_CpuScope() { if (Active) SMI_Profiler::EndCpu(); }
+
+	SMI_CpuScope(const SMI_CpuScope& other) = delete;
+	SMI_CpuScope& operator=(const SMI_CpuScope& other) = delete;
+
+private:
+	bool Active;
+};
+
+//times the gl commands issued in the rest of the scope on the gpu
+class SMI_GpuScope
+{
+public:
+	SMI_GpuScope(const char* name) : Active(SMI_Profiler::getEnabled() && SMI_Profiler::getGpuTiming() && SMI_Profiler::BeginGpu(name)) {}
+	~SMI_GpuScope() { if (Active) SMI_Profiler::EndGpu(); }
+
+	SMI_GpuScope(const SMI_GpuScope& other) = delete;
+	SMI_GpuScope& operator=(const SMI_GpuScope& other) = delete;
+
+private:
+	bool Active;
+};
+
+#define SMI_PROFILE_JOIN2(a, b) a##b
+#define SMI_PROFILE_JOIN(a, b) SMI_PROFILE_JOIN2(a, b)
+
+#if SMI_PROFILER_ENABLED
+#define SMI_PROFILE_CPU(name) SMI_CpuScope SMI_PROFILE_JOIN(ProfileCpu, __LINE__)(name)
+#define SMI_PROFILE_GPU(name) SMI_GpuScope SMI_PROFILE_JOIN(ProfileGpu, __LINE__)(name)
+#else
+#define SMI_PROFILE_CPU(name) ((void)0)
+#define SMI_PROFILE_GPU(name) ((void)0)
+#endif
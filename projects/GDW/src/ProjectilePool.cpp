@@ -0,0 +1,102 @@
+#include "ProjectilePool.h"
+#include "Logging.h"
+#include <algorithm>
+
+SMI_ProjectilePool::SMI_ProjectilePool(SMI_Scene& scene, const SMI_Prefab& prefab, size_t capacity, float lifetime) :
+    Scene(scene)
+{
+    Lifetime = lifetime;
+    HighWaterMark = 0;
+    FailedSpawns = 0;
+
+    //every list is sized up front so spawning never grows them
+    All = Scene.Instantiate(prefab, capacity);
+    Free.reserve(capacity);
+    Active.reserve(capacity);
+
+    //reversed so the first spawn gets the first entity
+    for (auto it = All.rbegin(); it != All.rend(); it++)
+    {
+        Scene.GetRegistry().emplace<SMI_PooledProjectile>(*it).Pool = this;
+        Scene.setEntityActive(*it, false);
+        Free.push_back(*it);
+    }
+}
+
+entt::entity SMI_ProjectilePool::Spawn(const glm::vec3& pos, const glm::vec3& velocity, const glm::quat& rot)
+{
+    if (Free.empty())
+    {
+        FailedSpawns++;
+        return entt::null;
+    }
+
+    entt::entity projectile = Free.back();
+    Free.pop_back();
+
+    SMI_PooledProjectile& pooled = Scene.GetComponent<SMI_PooledProjectile>(projectile);
+    pooled.ActiveIndex = Active.size();
+    pooled.Life = Lifetime;
+    Active.push_back(projectile);
+    HighWaterMark = std::max(HighWaterMark, Active.size());
+
+    //move it before waking it so it doesn't collide where it was parked
+    if (Scene.HasComponent<SMI_Physics>(projectile))
+        Scene.GetComponent<SMI_Physics>(projectile).Teleport(pos, rot, velocity);
+    else
+        Scene.GetComponent<SMI_Transform>(projectile).setPosRot(pos, rot);
+
+    Scene.setEntityActive(projectile, true);
+
+    return projectile;
+}
+
+void SMI_ProjectilePool::Despawn(entt::entity projectile)
+{
+    if (!Owns(projectile) || !Scene.getEntityActive(projectile))
+        return;
+
+    //swap remove from the active list
+    size_t index = Scene.GetComponent<SMI_PooledProjectile>(projectile).ActiveIndex;
+    Active[index] = Active.back();
+    Scene.GetComponent<SMI_PooledProjectile>(Active[index]).ActiveIndex = index;
+    Active.pop_back();
+
+    Scene.setEntityActive(projectile, false);
+    Free.push_back(projectile);
+}
+
+void SMI_ProjectilePool::DespawnAll()
+{
+    while (!Active.empty())
+        Despawn(Active.back());
+}
+
+void SMI_ProjectilePool::Update(float deltaTime)
+{
+    //backwards since despawning swaps the last one into this spot
+    for (size_t i = Active.size(); i > 0; i--)
+    {
+        entt::entity projectile = Active[i - 1];
+        SMI_PooledProjectile& pooled = Scene.GetComponent<SMI_PooledProjectile>(projectile);
+
+        pooled.Life -= deltaTime;
+        if (pooled.Life <= 0.f)
+            Despawn(projectile);
+    }
+}
+
+bool SMI_ProjectilePool::Owns(entt::entity entity) const
+{
+    if (!Scene.GetRegistry().valid(entity))
+        return false;
+
+    const SMI_PooledProjectile* pooled = Scene.GetRegistry().try_get<SMI_PooledProjectile>(entity);
+    return pooled != nullptr && pooled->Pool == this;
+}
+
+void SMI_ProjectilePool::LogStats(const char* name) const
+{
+    LOG_INFO("Pool {}: {} capacity, {} active, {} high water mark, {} failed spawns",
+        name, getCapacity(), getActiveCount(), HighWaterMark, FailedSpawns);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "Scene.h"
+#include "Prefab.h"
+#include <vector>
+
+class SMI_ProjectilePool;
+
+//component on every pooled entity, tracks where it is in the pool
+struct SMI_PooledProjectile
+{
+	//pool the entity belongs to
+	SMI_ProjectilePool* Pool = nullptr;
+	//index into the pool's active list, only valid while spawned
+	size_t ActiveIndex = 0;
+	//seconds left before the pool despawns it
+	float Life = 0.f;
+};
+
+//preallocates projectile entities (with rigid bodies) from a prefab and recycles them,
+//spawning and despawning just park and unpark entities so neither one allocates
+class SMI_ProjectilePool
+{
+public:
+	//the prefab should have physics, every body is created here and stays in the world
+	SMI_ProjectilePool(SMI_Scene& scene, const SMI_Prefab& prefab, size_t capacity, float lifetime = 2.f);
+	~SMI_ProjectilePool() = default;
+
+	//entities point back at their pool, so it can't be copied
+	SMI_ProjectilePool(const SMI_ProjectilePool&) = delete;
+	SMI_ProjectilePool& operator=(const SMI_ProjectilePool&) = delete;
+
+	//takes a free projectile and fires it, returns entt::null if the pool is empty
+	entt::entity Spawn(const glm::vec3& pos, const glm::vec3& velocity, const glm::quat& rot = glm::quat(1.f, 0.f, 0.f, 0.f));
+	//puts a projectile back in the pool, does nothing if it isn't spawned
+	void Despawn(entt::entity projectile);
+	void DespawnAll();
+
+	//despawns projectiles whose lifetime ran out
+	void Update(float deltaTime);
+
+	//checks if an entity came from this pool
+	bool Owns(entt::entity entity) const;
+
+	//stats
+	size_t getCapacity() const { return All.size(); }
+	size_t getActiveCount() const { return Active.size(); }
+	size_t getFreeCount() const { return Free.size(); }
+	//most projectiles that have been out at once
+	size_t getHighWaterMark() const { return HighWaterMark; }
+	//spawns that failed because the pool was empty
+	size_t getFailedSpawns() const { return FailedSpawns; }
+	void LogStats(const char* name) const;
+
+	void setLifetime(float _lifetime) { Lifetime = _lifetime; }
+	float getLifetime() const { return Lifetime; }
+
+private:
+	SMI_Scene& Scene;
+
+	std::vector<entt::entity> All;
+	std::vector<entt::entity> Free;
+	std::vector<entt::entity> Active;
+
+	float Lifetime;
+	size_t HighWaterMark;
+	size_t FailedSpawns;
+};
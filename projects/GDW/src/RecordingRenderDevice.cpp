@@ -0,0 +1,437 @@
+#include "RecordingRenderDevice.h"
+#include "TextureEnums.h"
+#include "Logging.h"
+#include <cstring>
+
+// Keys for a program's tracked state, lookups sort before the values so locations are known before they're set
+static constexpr uint64_t LocationKey = 0ull << 32;
+static constexpr uint64_t UniformKey = 1ull << 32;
+// Key for a VAO's index buffer, attributes are keyed by their slot
+static constexpr uint64_t IndexBufferKey = 1ull << 32;
+
+static inline uint64_t GlobalKey(RenderCommand type, GLenum param) {
+	return ((uint64_t)type << 32) | param;
+}
+
+RecordingRenderDevice::RecordingRenderDevice(const IRenderDevice::Sptr& target) :
+	_target(target)
+{
+	LOG_ASSERT(_target != nullptr, "A recording device needs a device to forward to!");
+}
+
+void RecordingRenderDevice::BeginFrame() {
+	if (_capturing) {
+		FinishCapture();
+	}
+	_frame.Clear();
+
+	// The setup is everything alive right now, so the frame's commands replay on top of it as they ran
+	if (_captureRequested) {
+		_captureRequested = false;
+		_captureReady = false;
+		_capture = FrameCapture();
+		_capture.Setup = _Snapshot();
+		_capturing = true;
+	}
+}
+
+void RecordingRenderDevice::FinishCapture() {
+	if (!_capturing) {
+		return;
+	}
+	_capture.Frame = _frame;
+	_capturing = false;
+	_captureReady = true;
+}
+
+FrameCapture RecordingRenderDevice::TakeCapture() {
+	_captureReady = false;
+	return std::move(_capture);
+}
+
+RecordedCommand* RecordingRenderDevice::_Record(RenderCommand type, std::initializer_list<uint32_t> args) {
+	if (!_recording && !_capturing) {
+		return nullptr;
+	}
+	return &_frame.Add(type, args);
+}
+
+void RecordingRenderDevice::_AttachData(RecordedCommand* command, const void* data, size_t size) {
+	if (command != nullptr) {
+		_frame.AttachData(*command, data, size);
+	}
+}
+
+RecordedCommand& RecordingRenderDevice::_SetState(TrackedObject& object, uint64_t key, RenderCommand type, std::initializer_list<uint32_t> args) {
+	RecordedStream& state = object.State[key];
+	state.Clear();
+	return state.Add(type, args);
+}
+
+RecordedStream RecordingRenderDevice::_Snapshot() const {
+	RecordedStream result;
+	auto append = [&result](const TrackedObject& object) {
+		result.Append(object.Build);
+		for (const auto& pair : object.State) {
+			result.Append(pair.second);
+		}
+	};
+
+	// VAOs point at buffers, so they go last
+	append(_global);
+	for (const auto& pair : _buffers) { append(pair.second); }
+	for (const auto& pair : _textures) { append(pair.second); }
+	for (const auto& pair : _programs) { append(pair.second); }
+	for (const auto& pair : _vertexArrays) {
+		// Attributes and the index buffer are set on whatever VAO is bound
+		result.Append(pair.second.Build);
+		result.Add(RenderCommand::BindVertexArray, { pair.first });
+		for (const auto& state : pair.second.State) {
+			result.Append(state.second);
+		}
+		result.Add(RenderCommand::BindVertexArray, { 0 });
+	}
+
+	// Leave the bindings how the frame found them
+	result.Add(RenderCommand::BindBuffer, { GL_ARRAY_BUFFER, _boundArrayBuffer });
+	result.Add(RenderCommand::BindVertexArray, { _boundVao });
+	result.Add(RenderCommand::UseProgram, { _boundProgram });
+	for (const auto& pair : _boundTextures) {
+		result.Add(RenderCommand::BindTextureUnit, { pair.first, pair.second });
+	}
+	return result;
+}
+
+GLuint RecordingRenderDevice::CreateBuffer() {
+	GLuint handle = _target->CreateBuffer();
+	if (RecordedCommand* command = _Record(RenderCommand::CreateBuffer, {})) {
+		command->Result = handle;
+	}
+	_buffers[handle].Build.Add(RenderCommand::CreateBuffer, {}).Result = handle;
+	return handle;
+}
+
+void RecordingRenderDevice::DeleteBuffer(GLuint handle) {
+	_Record(RenderCommand::DeleteBuffer, { handle });
+	_buffers.erase(handle);
+	_target->DeleteBuffer(handle);
+}
+
+void RecordingRenderDevice::BufferData(GLuint handle, size_t size, const void* data, GLenum usage) {
+	RecordedCommand* command = _Record(RenderCommand::BufferData, { handle, (uint32_t)size, usage });
+	if (_capturePayloads) {
+		_AttachData(command, data, size);
+	}
+
+	// Only the latest contents matter to a capture
+	auto it = _buffers.find(handle);
+	if (it != _buffers.end()) {
+		RecordedCommand& upload = _SetState(it->second, 0, RenderCommand::BufferData, { handle, (uint32_t)size, usage });
+		if (_capturePayloads) {
+			it->second.State[0].AttachData(upload, data, size);
+		}
+	}
+	_target->BufferData(handle, size, data, usage);
+}
+
+void RecordingRenderDevice::BindBuffer(GLenum target, GLuint handle) {
+	_Record(RenderCommand::BindBuffer, { target, handle });
+	if (target == GL_ARRAY_BUFFER) {
+		_boundArrayBuffer = handle;
+	}
+	// The index buffer binding is part of the VAO
+	else if (target == GL_ELEMENT_ARRAY_BUFFER && _boundVao != 0) {
+		auto it = _vertexArrays.find(_boundVao);
+		if (it != _vertexArrays.end()) {
+			_SetState(it->second, IndexBufferKey, RenderCommand::BindBuffer, { target, handle });
+		}
+	}
+	_target->BindBuffer(target, handle);
+}
+
+GLuint RecordingRenderDevice::CreateVertexArray() {
+	GLuint handle = _target->CreateVertexArray();
+	if (RecordedCommand* command = _Record(RenderCommand::CreateVertexArray, {})) {
+		command->Result = handle;
+	}
+	_vertexArrays[handle].Build.Add(RenderCommand::CreateVertexArray, {}).Result = handle;
+	return handle;
+}
+
+void RecordingRenderDevice::DeleteVertexArray(GLuint handle) {
+	_Record(RenderCommand::DeleteVertexArray, { handle });
+	_vertexArrays.erase(handle);
+	if (_boundVao == handle) {
+		_boundVao = 0;
+	}
+	_target->DeleteVertexArray(handle);
+}
+
+void RecordingRenderDevice::VertexAttribute(GLuint vao, GLuint slot, GLint size, GLenum type, bool normalized, GLsizei stride, size_t offset) {
+	_Record(RenderCommand::VertexAttribute, { vao, slot, (uint32_t)size, type, normalized, (uint32_t)stride, (uint32_t)offset });
+
+	// The attribute reads from the array buffer bound right now, so that binding is part of its state
+	auto it = _vertexArrays.find(vao);
+	if (it != _vertexArrays.end()) {
+		RecordedStream& attribute = it->second.State[slot];
+		attribute.Clear();
+		attribute.Add(RenderCommand::BindBuffer, { GL_ARRAY_BUFFER, _boundArrayBuffer });
+		attribute.Add(RenderCommand::VertexAttribute, { vao, slot, (uint32_t)size, type, normalized, (uint32_t)stride, (uint32_t)offset });
+	}
+	_target->VertexAttribute(vao, slot, size, type, normalized, stride, offset);
+}
+
+void RecordingRenderDevice::BindVertexArray(GLuint handle) {
+	_Record(RenderCommand::BindVertexArray, { handle });
+	_boundVao = handle;
+	_target->BindVertexArray(handle);
+}
+
+void RecordingRenderDevice::DrawArrays(GLenum mode, GLint first, GLsizei count) {
+	_Record(RenderCommand::DrawArrays, { mode, (uint32_t)first, (uint32_t)count });
+	_target->DrawArrays(mode, first, count);
+}
+
+void RecordingRenderDevice::DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset) {
+	_Record(RenderCommand::DrawElements, { mode, (uint32_t)count, type, (uint32_t)offset });
+	_target->DrawElements(mode, count, type, offset);
+}
+
+GLuint RecordingRenderDevice::CreateProgram() {
+	GLuint handle = _target->CreateProgram();
+	if (RecordedCommand* command = _Record(RenderCommand::CreateProgram, {})) {
+		command->Result = handle;
+	}
+	_programs[handle].Build.Add(RenderCommand::CreateProgram, {}).Result = handle;
+	return handle;
+}
+
+void RecordingRenderDevice::DeleteProgram(GLuint handle) {
+	_Record(RenderCommand::DeleteProgram, { handle });
+	_programs.erase(handle);
+	if (_boundProgram == handle) {
+		_boundProgram = 0;
+	}
+	_target->DeleteProgram(handle);
+}
+
+GLuint RecordingRenderDevice::CompileShader(GLenum type, const char* source, std::string& log) {
+	GLuint handle = _target->CompileShader(type, source, log);
+	// Sources are always kept (with their null terminator), a replay can't compile without them
+	size_t length = source != nullptr ? strlen(source) + 1 : 0;
+	if (RecordedCommand* command = _Record(RenderCommand::CompileShader, { type })) {
+		command->Result = handle;
+		_AttachData(command, source, length);
+	}
+	if (handle != 0) {
+		RecordedStream& build = _shaders[handle].Build;
+		RecordedCommand& compile = build.Add(RenderCommand::CompileShader, { type });
+		compile.Result = handle;
+		build.AttachData(compile, source, length);
+	}
+	return handle;
+}
+
+bool RecordingRenderDevice::LinkProgram(GLuint program, GLuint vs, GLuint fs, std::string& log) {
+	bool result = _target->LinkProgram(program, vs, fs, log);
+	if (RecordedCommand* command = _Record(RenderCommand::LinkProgram, { program, vs, fs })) {
+		command->Result = result;
+	}
+
+	// Linking deletes the parts, so they move into the program
+	auto it = _programs.find(program);
+	if (it != _programs.end()) {
+		RecordedStream& build = it->second.Build;
+		build.Append(_shaders[vs].Build);
+		build.Append(_shaders[fs].Build);
+		build.Add(RenderCommand::LinkProgram, { program, vs, fs }).Result = result;
+	}
+	_shaders.erase(vs);
+	_shaders.erase(fs);
+	return result;
+}
+
+void RecordingRenderDevice::UseProgram(GLuint handle) {
+	_Record(RenderCommand::UseProgram, { handle });
+	_boundProgram = handle;
+	_target->UseProgram(handle);
+}
+
+GLint RecordingRenderDevice::GetUniformLocation(GLuint program, const char* name) {
+	GLint location = _target->GetUniformLocation(program, name);
+	if (RecordedCommand* command = _Record(RenderCommand::GetUniformLocation, { program })) {
+		command->Result = (uint32_t)location;
+		_AttachData(command, name, strlen(name) + 1);
+	}
+
+	// Lookups happen every frame, so each location is only kept once
+	auto it = _programs.find(program);
+	if (location != -1 && it != _programs.end()) {
+		uint64_t key = LocationKey | (uint32_t)location;
+		RecordedCommand& lookup = _SetState(it->second, key, RenderCommand::GetUniformLocation, { program });
+		lookup.Result = (uint32_t)location;
+		it->second.State[key].AttachData(lookup, name, strlen(name) + 1);
+	}
+	return location;
+}
+
+void RecordingRenderDevice::SetUniform(GLuint program, GLint location, UniformType type, GLsizei count, const void* data, bool transposed) {
+	// Uniform values are small, so they're always captured
+	RecordedCommand* command = _Record(RenderCommand::SetUniform, { program, (uint32_t)location, (uint32_t)type, (uint32_t)count, transposed });
+	_AttachData(command, data, GetUniformTypeSize(type) * count);
+
+	// Programs keep their uniforms between frames, a capture needs the ones that aren't set every frame
+	auto it = _programs.find(program);
+	if (location != -1 && it != _programs.end()) {
+		uint64_t key = UniformKey | (uint32_t)location;
+		RecordedCommand& value = _SetState(it->second, key, RenderCommand::SetUniform,
+			{ program, (uint32_t)location, (uint32_t)type, (uint32_t)count, transposed });
+		it->second.State[key].AttachData(value, data, GetUniformTypeSize(type) * count);
+	}
+	_target->SetUniform(program, location, type, count, data, transposed);
+}
+
+GLuint RecordingRenderDevice::CreateTexture(GLenum target) {
+	GLuint handle = _target->CreateTexture(target);
+	if (RecordedCommand* command = _Record(RenderCommand::CreateTexture, { target })) {
+		command->Result = handle;
+	}
+	_textures[handle].Build.Add(RenderCommand::CreateTexture, { target }).Result = handle;
+	return handle;
+}
+
+void RecordingRenderDevice::DeleteTexture(GLuint handle) {
+	_Record(RenderCommand::DeleteTexture, { handle });
+	_textures.erase(handle);
+	// Deleting a texture unbinds it from every unit
+	for (auto it = _boundTextures.begin(); it != _boundTextures.end();) {
+		it = it->second == handle ? _boundTextures.erase(it) : std::next(it);
+	}
+	_target->DeleteTexture(handle);
+}
+
+void RecordingRenderDevice::BindTextureUnit(GLuint slot, GLuint handle) {
+	_Record(RenderCommand::BindTextureUnit, { slot, handle });
+	if (handle != 0) {
+		_boundTextures[slot] = handle;
+	}
+	else {
+		_boundTextures.erase(slot);
+	}
+	_target->BindTextureUnit(slot, handle);
+}
+
+void RecordingRenderDevice::ClearTexture(GLuint handle, const glm::vec4& color) {
+	std::initializer_list<uint32_t> args = { handle,
+		RecordedStream::FloatArg(color.r), RecordedStream::FloatArg(color.g), RecordedStream::FloatArg(color.b), RecordedStream::FloatArg(color.a) };
+	_Record(RenderCommand::ClearTexture, args);
+	auto it = _textures.find(handle);
+	if (it != _textures.end()) {
+		it->second.Build.Add(RenderCommand::ClearTexture, args);
+	}
+	_target->ClearTexture(handle, color);
+}
+
+void RecordingRenderDevice::TextureStorage2D(GLuint handle, GLsizei levels, GLenum format, GLsizei width, GLsizei height) {
+	std::initializer_list<uint32_t> args = { handle, (uint32_t)levels, format, (uint32_t)width, (uint32_t)height };
+	_Record(RenderCommand::TextureStorage2D, args);
+	auto it = _textures.find(handle);
+	if (it != _textures.end()) {
+		it->second.Build.Add(RenderCommand::TextureStorage2D, args);
+	}
+	_target->TextureStorage2D(handle, levels, format, width, height);
+}
+
+void RecordingRenderDevice::TextureParameteri(GLuint handle, GLenum param, GLint value) {
+	_Record(RenderCommand::TextureParameteri, { handle, param, (uint32_t)value });
+	auto it = _textures.find(handle);
+	if (it != _textures.end()) {
+		_SetState(it->second, param, RenderCommand::TextureParameteri, { handle, param, (uint32_t)value });
+	}
+	_target->TextureParameteri(handle, param, value);
+}
+
+void RecordingRenderDevice::TextureParameterf(GLuint handle, GLenum param, GLfloat value) {
+	_Record(RenderCommand::TextureParameterf, { handle, param, RecordedStream::FloatArg(value) });
+	auto it = _textures.find(handle);
+	if (it != _textures.end()) {
+		_SetState(it->second, param, RenderCommand::TextureParameterf, { handle, param, RecordedStream::FloatArg(value) });
+	}
+	_target->TextureParameterf(handle, param, value);
+}
+
+void RecordingRenderDevice::TextureSubImage2D(GLuint handle, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+											  GLenum format, GLenum type, const void* data) {
+	std::initializer_list<uint32_t> args = { handle, (uint32_t)level, (uint32_t)x, (uint32_t)y, (uint32_t)width, (uint32_t)height, format, type };
+	size_t size = GetTexelSize((PixelFormat)format, (PixelType)type) * width * height;
+	RecordedCommand* command = _Record(RenderCommand::TextureSubImage2D, args);
+
+	// Uploads can cover part of the texture, so they're all kept in order
+	auto it = _textures.find(handle);
+	if (_capturePayloads) {
+		_AttachData(command, data, size);
+		if (it != _textures.end()) {
+			RecordedCommand& upload = it->second.Build.Add(RenderCommand::TextureSubImage2D, args);
+			it->second.Build.AttachData(upload, data, size);
+		}
+	}
+	_target->TextureSubImage2D(handle, level, x, y, width, height, format, type, data);
+}
+
+void RecordingRenderDevice::TextureSubImage3D(GLuint handle, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth,
+											  GLenum format, GLenum type, const void* data) {
+	std::initializer_list<uint32_t> args =
+		{ handle, (uint32_t)level, (uint32_t)x, (uint32_t)y, (uint32_t)z, (uint32_t)width, (uint32_t)height, (uint32_t)depth, format, type };
+	size_t size = GetTexelSize((PixelFormat)format, (PixelType)type) * width * height * depth;
+	RecordedCommand* command = _Record(RenderCommand::TextureSubImage3D, args);
+
+	auto it = _textures.find(handle);
+	if (_capturePayloads) {
+		_AttachData(command, data, size);
+		if (it != _textures.end()) {
+			RecordedCommand& upload = it->second.Build.Add(RenderCommand::TextureSubImage3D, args);
+			it->second.Build.AttachData(upload, data, size);
+		}
+	}
+	_target->TextureSubImage3D(handle, level, x, y, z, width, height, depth, format, type, data);
+}
+
+void RecordingRenderDevice::GenerateMipmap(GLuint handle) {
+	_Record(RenderCommand::GenerateMipmap, { handle });
+	auto it = _textures.find(handle);
+	if (it != _textures.end()) {
+		it->second.Build.Add(RenderCommand::GenerateMipmap, { handle });
+	}
+	_target->GenerateMipmap(handle);
+}
+
+void RecordingRenderDevice::PixelStore(GLenum param, GLint value) {
+	_Record(RenderCommand::PixelStore, { param, (uint32_t)value });
+	_SetState(_global, GlobalKey(RenderCommand::PixelStore, param), RenderCommand::PixelStore, { param, (uint32_t)value });
+	_target->PixelStore(param, value);
+}
+
+void RecordingRenderDevice::Enable(GLenum capability) {
+	_Record(RenderCommand::Enable, { capability });
+	_SetState(_global, GlobalKey(RenderCommand::Enable, capability), RenderCommand::Enable, { capability });
+	_target->Enable(capability);
+}
+
+void RecordingRenderDevice::CullFace(GLenum face) {
+	_Record(RenderCommand::CullFace, { face });
+	_SetState(_global, GlobalKey(RenderCommand::CullFace, 0), RenderCommand::CullFace, { face });
+	_target->CullFace(face);
+}
+
+void RecordingRenderDevice::ClearColor(const glm::vec4& color) {
+	std::initializer_list<uint32_t> args =
+		{ RecordedStream::FloatArg(color.r), RecordedStream::FloatArg(color.g), RecordedStream::FloatArg(color.b), RecordedStream::FloatArg(color.a) };
+	_Record(RenderCommand::ClearColor, args);
+	_SetState(_global, GlobalKey(RenderCommand::ClearColor, 0), RenderCommand::ClearColor, args);
+	_target->ClearColor(color);
+}
+
+void RecordingRenderDevice::Clear(GLbitfield mask) {
+	_Record(RenderCommand::Clear, { mask });
+	_target->Clear(mask);
+}
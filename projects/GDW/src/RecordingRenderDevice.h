@@ -0,0 +1,153 @@
+#pragma once
+#include "RenderDevice.h"
+#include "FrameCapture.h"
+#include <map>
+
+/// <summary>
+/// A render device that captures the command stream of every call it gets, then forwards the calls to another device.
+/// Forwarding to a NullRenderDevice captures without a GL driver, forwarding to a GLRenderDevice captures while rendering normally.
+/// It also keeps the calls that built every live object, so a single frame can be captured with everything it needs to be replayed
+/// </summary>
+class RecordingRenderDevice : public IRenderDevice
+{
+public:
+	typedef std::shared_ptr<RecordingRenderDevice> Sptr;
+
+	/// <summary>
+	/// Creates a recorder in front of the given device
+	/// </summary>
+	/// <param name="target">The device that actually handles the calls</param>
+	RecordingRenderDevice(const IRenderDevice::Sptr& target);
+	virtual ~RecordingRenderDevice() = default;
+
+	static inline Sptr Create(const IRenderDevice::Sptr& target) {
+		return std::make_shared<RecordingRenderDevice>(target);
+	}
+
+	GLuint CreateBuffer() override;
+	void DeleteBuffer(GLuint handle) override;
+	void BufferData(GLuint handle, size_t size, const void* data, GLenum usage) override;
+	void BindBuffer(GLenum target, GLuint handle) override;
+
+	GLuint CreateVertexArray() override;
+	void DeleteVertexArray(GLuint handle) override;
+	void VertexAttribute(GLuint vao, GLuint slot, GLint size, GLenum type, bool normalized, GLsizei stride, size_t offset) override;
+	void BindVertexArray(GLuint handle) override;
+	void DrawArrays(GLenum mode, GLint first, GLsizei count) override;
+	void DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset) override;
+
+	GLuint CreateProgram() override;
+	void DeleteProgram(GLuint handle) override;
+	GLuint CompileShader(GLenum type, const char* source, std::string& log) override;
+	bool LinkProgram(GLuint program, GLuint vs, GLuint fs, std::string& log) override;
+	void UseProgram(GLuint handle) override;
+	GLint GetUniformLocation(GLuint program, const char* name) override;
+	void SetUniform(GLuint program, GLint location, UniformType type, GLsizei count, const void* data, bool transposed = false) override;
+
+	GLuint CreateTexture(GLenum target) override;
+	void DeleteTexture(GLuint handle) override;
+	void BindTextureUnit(GLuint slot, GLuint handle) override;
+	void ClearTexture(GLuint handle, const glm::vec4& color) override;
+	void TextureStorage2D(GLuint handle, GLsizei levels, GLenum format, GLsizei width, GLsizei height) override;
+	void TextureParameteri(GLuint handle, GLenum param, GLint value) override;
+	void TextureParameterf(GLuint handle, GLenum param, GLfloat value) override;
+	void TextureSubImage2D(GLuint handle, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+						   GLenum format, GLenum type, const void* data) override;
+	void TextureSubImage3D(GLuint handle, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth,
+						   GLenum format, GLenum type, const void* data) override;
+	void GenerateMipmap(GLuint handle) override;
+
+	void PixelStore(GLenum param, GLint value) override;
+	void Enable(GLenum capability) override;
+	void CullFace(GLenum face) override;
+	void ClearColor(const glm::vec4& color) override;
+	void Clear(GLbitfield mask) override;
+	// Queries aren't part of the command stream, they're only forwarded
+	GLint GetInteger(GLenum param) override { return _target->GetInteger(param); }
+	GLfloat GetFloat(GLenum param) override { return _target->GetFloat(param); }
+
+	/// <summary>
+	/// Turns recording of the command stream on or off, calls are always forwarded and live objects are always tracked
+	/// </summary>
+	void SetRecording(bool recording) { _recording = recording; }
+	bool IsRecording() const { return _recording; }
+	/// <summary>
+	/// Sets whether buffer contents and pixels are copied into the stream and the tracked objects (on by default).
+	/// Without them captures are much smaller, but their uploads can't be replayed
+	/// </summary>
+	void SetCapturePayloads(bool capture) { _capturePayloads = capture; }
+
+	/// <summary>
+	/// Starts a new frame, throwing out the last frame's commands. Has to be called at the start of every frame for captures to work
+	/// </summary>
+	void BeginFrame();
+	/// <summary>
+	/// Captures the next frame, from the next BeginFrame to the one after it
+	/// </summary>
+	void RequestCapture() { _captureRequested = true; }
+	/// <summary>
+	/// Ends a capture early, the commands recorded since the last BeginFrame become the captured frame
+	/// </summary>
+	void FinishCapture();
+	bool IsCapturing() const { return _capturing; }
+	/// <summary>
+	/// Gets whether a capture has finished and can be taken
+	/// </summary>
+	bool HasCapture() const { return _captureReady; }
+	/// <summary>
+	/// Hands over the finished capture
+	/// </summary>
+	FrameCapture TakeCapture();
+
+	/// <summary>
+	/// Gets the commands recorded since the last BeginFrame
+	/// </summary>
+	const RecordedStream& GetFrame() const { return _frame; }
+	const IRenderDevice::Sptr& GetTarget() const { return _target; }
+
+protected:
+	/// <summary>
+	/// The calls that rebuild one live object, kept so a capture can start from any frame
+	/// </summary>
+	struct TrackedObject {
+		// Creation and uploads, in the order they happened
+		RecordedStream Build;
+		// State where only the latest value matters (parameters, uniforms, attributes), by key, replayed after Build
+		std::map<uint64_t, RecordedStream> State;
+	};
+
+	// Adds a command to this frame's stream, or returns nullptr if we aren't recording
+	RecordedCommand* _Record(RenderCommand type, std::initializer_list<uint32_t> args);
+	// Copies data into this frame's stream for the given command
+	void _AttachData(RecordedCommand* command, const void* data, size_t size);
+	// Replaces one bit of an object's state with a single command, and returns it
+	static RecordedCommand& _SetState(TrackedObject& object, uint64_t key, RenderCommand type, std::initializer_list<uint32_t> args);
+	// Builds the stream that recreates every live object, as they are right now
+	RecordedStream _Snapshot() const;
+
+	IRenderDevice::Sptr _target;
+	bool _recording = true;
+	bool _capturePayloads = true;
+
+	RecordedStream _frame;
+
+	// Live objects, by handle
+	std::map<GLuint, TrackedObject> _buffers;
+	std::map<GLuint, TrackedObject> _vertexArrays;
+	std::map<GLuint, TrackedObject> _shaders;
+	std::map<GLuint, TrackedObject> _programs;
+	std::map<GLuint, TrackedObject> _textures;
+	// Enables, pixel store modes, culling and the clear color
+	TrackedObject _global;
+	// Bindings the tracked state depends on
+	GLuint _boundVao = 0;
+	GLuint _boundArrayBuffer = 0;
+	GLuint _boundProgram = 0;
+	// Texture handles by the unit they're bound to
+	std::map<GLuint, GLuint> _boundTextures;
+
+	bool _captureRequested = false;
+	bool _capturing = false;
+	bool _captureReady = false;
+	FrameCapture _capture;
+};
@@ -20,11 +20,9 @@ void Renderer::Render()
 		m_Material->getShader()->Bind();
 		m_Material->BindAllUniform();
 		m_Material->BindAllTextures();
-		//draw and unbind
+		//draw, leaving everything bound - the next renderer binds over it,
+		//and binds that match what's already there are skipped
 		m_VAO->Draw();
-		m_Material->UnbindAllTextures();
-		m_Material->getShader()->Unbind();
-		m_VAO->Unbind();
 	}
 }
 
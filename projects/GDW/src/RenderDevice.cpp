@@ -0,0 +1,271 @@
+#include "RenderDevice.h"
+#include "Logging.h"
+#include "NOU/GLState.h"
+#include <vector>
+
+IRenderDevice::Sptr IRenderDevice::__default = std::make_shared<GLRenderDevice>();
+IRenderDevice::Sptr IRenderDevice::__active = nullptr;
+IRenderDevice* IRenderDevice::__current = IRenderDevice::__default.get();
+
+const char* GetRenderCommandName(RenderCommand command) {
+	switch (command) {
+		case RenderCommand::CreateBuffer:       return "CreateBuffer";
+		case RenderCommand::DeleteBuffer:       return "DeleteBuffer";
+		case RenderCommand::BufferData:         return "BufferData";
+		case RenderCommand::BindBuffer:         return "BindBuffer";
+		case RenderCommand::CreateVertexArray:  return "CreateVertexArray";
+		case RenderCommand::DeleteVertexArray:  return "DeleteVertexArray";
+		case RenderCommand::VertexAttribute:    return "VertexAttribute";
+		case RenderCommand::BindVertexArray:    return "BindVertexArray";
+		case RenderCommand::DrawArrays:         return "DrawArrays";
+		case RenderCommand::DrawElements:       return "DrawElements";
+		case RenderCommand::CreateProgram:      return "CreateProgram";
+		case RenderCommand::DeleteProgram:      return "DeleteProgram";
+		case RenderCommand::CompileShader:      return "CompileShader";
+		case RenderCommand::LinkProgram:        return "LinkProgram";
+		case RenderCommand::UseProgram:         return "UseProgram";
+		case RenderCommand::GetUniformLocation: return "GetUniformLocation";
+		case RenderCommand::SetUniform:         return "SetUniform";
+		case RenderCommand::CreateTexture:      return "CreateTexture";
+		case RenderCommand::DeleteTexture:      return "DeleteTexture";
+		case RenderCommand::BindTextureUnit:    return "BindTextureUnit";
+		case RenderCommand::ClearTexture:       return "ClearTexture";
+		case RenderCommand::TextureStorage2D:   return "TextureStorage2D";
+		case RenderCommand::TextureParameteri:  return "TextureParameteri";
+		case RenderCommand::TextureParameterf:  return "TextureParameterf";
+		case RenderCommand::TextureSubImage2D:  return "TextureSubImage2D";
+		case RenderCommand::TextureSubImage3D:  return "TextureSubImage3D";
+		case RenderCommand::GenerateMipmap:     return "GenerateMipmap";
+		case RenderCommand::PixelStore:         return "PixelStore";
+		case RenderCommand::Enable:             return "Enable";
+		case RenderCommand::CullFace:           return "CullFace";
+		case RenderCommand::ClearColor:         return "ClearColor";
+		case RenderCommand::Clear:              return "Clear";
+		default: return "Unknown";
+	}
+}
+
+void IRenderDevice::Set(const Sptr& device) {
+	__active = device;
+	__current = device != nullptr ? device.get() : __default.get();
+}
+
+GLuint GLRenderDevice::CreateBuffer() {
+	GLuint handle = 0;
+	glCreateBuffers(1, &handle);
+	return handle;
+}
+
+void GLRenderDevice::DeleteBuffer(GLuint handle) {
+	glDeleteBuffers(1, &handle);
+	nou::GLState::ForgetBuffer(handle);
+}
+
+void GLRenderDevice::BufferData(GLuint handle, size_t size, const void* data, GLenum usage) {
+	// Note, this is part of the bindless state access stuff added in 4.5
+	glNamedBufferData(handle, size, data, usage);
+}
+
+void GLRenderDevice::BindBuffer(GLenum target, GLuint handle) {
+	nou::GLState::BindBuffer(target, handle);
+}
+
+GLuint GLRenderDevice::CreateVertexArray() {
+	GLuint handle = 0;
+	glCreateVertexArrays(1, &handle);
+	return handle;
+}
+
+void GLRenderDevice::DeleteVertexArray(GLuint handle) {
+	glDeleteVertexArrays(1, &handle);
+	nou::GLState::ForgetVertexArray(handle);
+}
+
+void GLRenderDevice::VertexAttribute(GLuint vao, GLuint slot, GLint size, GLenum type, bool normalized, GLsizei stride, size_t offset) {
+	glEnableVertexArrayAttrib(vao, slot);
+	glVertexAttribPointer(slot, size, type, normalized, stride, (void*)offset);
+}
+
+void GLRenderDevice::BindVertexArray(GLuint handle) {
+	nou::GLState::BindVertexArray(handle);
+}
+
+void GLRenderDevice::DrawArrays(GLenum mode, GLint first, GLsizei count) {
+	glDrawArrays(mode, first, count);
+}
+
+void GLRenderDevice::DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset) {
+	glDrawElements(mode, count, type, (void*)offset);
+}
+
+GLuint GLRenderDevice::CreateProgram() {
+	return glCreateProgram();
+}
+
+void GLRenderDevice::DeleteProgram(GLuint handle) {
+	glDeleteProgram(handle);
+	nou::GLState::ForgetProgram(handle);
+}
+
+GLuint GLRenderDevice::CompileShader(GLenum type, const char* source, std::string& log) {
+	// Creates a new shader part (VS, FS, GS, etc...)
+	GLuint handle = glCreateShader(type);
+
+	// Load the GLSL source and compile it
+	glShaderSource(handle, 1, &source, nullptr);
+	glCompileShader(handle);
+
+	// Get the compilation status for the shader part
+	GLint status = 0;
+	glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
+
+	if (status == GL_FALSE) {
+		// Read the error log
+		GLint logSize = 0;
+		glGetShaderiv(handle, GL_INFO_LOG_LENGTH, &logSize);
+		std::vector<char> buffer = std::vector<char>(glm::max(logSize, 1), '\0');
+		glGetShaderInfoLog(handle, logSize, &logSize, buffer.data());
+		log = buffer.data();
+
+		// Delete the broken shader result
+		glDeleteShader(handle);
+		return 0;
+	}
+
+	return handle;
+}
+
+bool GLRenderDevice::LinkProgram(GLuint program, GLuint vs, GLuint fs, std::string& log) {
+	// Attach our two shaders
+	glAttachShader(program, vs);
+	glAttachShader(program, fs);
+
+	// Perform linking
+	glLinkProgram(program);
+
+	// Remove shader parts to save space (we can do this since we only needed the shader parts to compile an actual shader program)
+	glDetachShader(program, vs);
+	glDeleteShader(vs);
+	glDetachShader(program, fs);
+	glDeleteShader(fs);
+
+	GLint status = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+	if (status == GL_FALSE) {
+		// Read the log from openGL
+		GLint length = 0;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+		if (length > 0) {
+			std::vector<char> buffer = std::vector<char>(length, '\0');
+			glGetProgramInfoLog(program, length, &length, buffer.data());
+			log = buffer.data();
+		}
+	}
+	return status != GL_FALSE;
+}
+
+void GLRenderDevice::UseProgram(GLuint handle) {
+	nou::GLState::UseProgram(handle);
+}
+
+GLint GLRenderDevice::GetUniformLocation(GLuint program, const char* name) {
+	return glGetUniformLocation(program, name);
+}
+
+void GLRenderDevice::SetUniform(GLuint program, GLint location, UniformType type, GLsizei count, const void* data, bool transposed) {
+	const GLfloat* floats = static_cast<const GLfloat*>(data);
+	const GLint* ints = static_cast<const GLint*>(data);
+
+	switch (type) {
+		case UniformType::Float: glProgramUniform1fv(program, location, count, floats); break;
+		case UniformType::Vec2:  glProgramUniform2fv(program, location, count, floats); break;
+		case UniformType::Vec3:  glProgramUniform3fv(program, location, count, floats); break;
+		case UniformType::Vec4:  glProgramUniform4fv(program, location, count, floats); break;
+		case UniformType::Int:   glProgramUniform1iv(program, location, count, ints); break;
+		case UniformType::IVec2: glProgramUniform2iv(program, location, count, ints); break;
+		case UniformType::IVec3: glProgramUniform3iv(program, location, count, ints); break;
+		case UniformType::IVec4: glProgramUniform4iv(program, location, count, ints); break;
+		case UniformType::Mat3:  glProgramUniformMatrix3fv(program, location, count, transposed, floats); break;
+		case UniformType::Mat4:  glProgramUniformMatrix4fv(program, location, count, transposed, floats); break;
+		default: break;
+	}
+}
+
+GLuint GLRenderDevice::CreateTexture(GLenum target) {
+	GLuint handle = 0;
+	glCreateTextures(target, 1, &handle);
+	return handle;
+}
+
+void GLRenderDevice::DeleteTexture(GLuint handle) {
+	glDeleteTextures(1, &handle);
+	nou::GLState::ForgetTexture(handle);
+}
+
+void GLRenderDevice::BindTextureUnit(GLuint slot, GLuint handle) {
+	// Instead of glActiveTexture + glBindTexture, we can one line it now :D
+	nou::GLState::BindTextureUnit(slot, handle);
+}
+
+void GLRenderDevice::ClearTexture(GLuint handle, const glm::vec4& color) {
+	glClearTexImage(handle, 0, GL_RGBA, GL_FLOAT, &color.x);
+}
+
+void GLRenderDevice::TextureStorage2D(GLuint handle, GLsizei levels, GLenum format, GLsizei width, GLsizei height) {
+	glTextureStorage2D(handle, levels, format, width, height);
+}
+
+void GLRenderDevice::TextureParameteri(GLuint handle, GLenum param, GLint value) {
+	glTextureParameteri(handle, param, value);
+}
+
+void GLRenderDevice::TextureParameterf(GLuint handle, GLenum param, GLfloat value) {
+	glTextureParameterf(handle, param, value);
+}
+
+void GLRenderDevice::TextureSubImage2D(GLuint handle, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+									   GLenum format, GLenum type, const void* data) {
+	glTextureSubImage2D(handle, level, x, y, width, height, format, type, data);
+}
+
+void GLRenderDevice::TextureSubImage3D(GLuint handle, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth,
+									   GLenum format, GLenum type, const void* data) {
+	glTextureSubImage3D(handle, level, x, y, z, width, height, depth, format, type, data);
+}
+
+void GLRenderDevice::GenerateMipmap(GLuint handle) {
+	glGenerateTextureMipmap(handle);
+}
+
+void GLRenderDevice::PixelStore(GLenum param, GLint value) {
+	glPixelStorei(param, value);
+}
+
+void GLRenderDevice::Enable(GLenum capability) {
+	nou::GLState::Enable(capability);
+}
+
+void GLRenderDevice::CullFace(GLenum face) {
+	nou::GLState::CullFace(face);
+}
+
+void GLRenderDevice::ClearColor(const glm::vec4& color) {
+	nou::GLState::ClearColor(color);
+}
+
+void GLRenderDevice::Clear(GLbitfield mask) {
+	glClear(mask);
+}
+
+GLint GLRenderDevice::GetInteger(GLenum param) {
+	GLint result = 0;
+	glGetIntegerv(param, &result);
+	return result;
+}
+
+GLfloat GLRenderDevice::GetFloat(GLenum param) {
+	GLfloat result = 0.0f;
+	glGetFloatv(param, &result);
+	return result;
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include <glad/glad.h>
+#include <GLM/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// <summary>
+/// The data types a uniform can be uploaded as
+/// </summary>
+enum class UniformType : uint8_t {
+	Float,
+	Vec2,
+	Vec3,
+	Vec4,
+	Int,
+	IVec2,
+	IVec3,
+	IVec4,
+	Mat3,
+	Mat4
+};
+
+/// <summary>
+/// Gets the size in bytes of a single uniform of the given type
+/// </summary>
+constexpr size_t GetUniformTypeSize(UniformType type) {
+	switch (type) {
+		case UniformType::Float: return sizeof(float);
+		case UniformType::Vec2:  return sizeof(float) * 2;
+		case UniformType::Vec3:  return sizeof(float) * 3;
+		case UniformType::Vec4:  return sizeof(float) * 4;
+		case UniformType::Int:   return sizeof(int);
+		case UniformType::IVec2: return sizeof(int) * 2;
+		case UniformType::IVec3: return sizeof(int) * 3;
+		case UniformType::IVec4: return sizeof(int) * 4;
+		case UniformType::Mat3:  return sizeof(float) * 9;
+		case UniformType::Mat4:  return sizeof(float) * 16;
+		default: return 0;
+	}
+}
+
+/// <summary>
+/// Every call a render device can take, used by the null device's counters and the recording device's command stream
+/// </summary>
+enum class RenderCommand : uint8_t {
+	CreateBuffer,
+	DeleteBuffer,
+	BufferData,
+	BindBuffer,
+	CreateVertexArray,
+	DeleteVertexArray,
+	VertexAttribute,
+	BindVertexArray,
+	DrawArrays,
+	DrawElements,
+	CreateProgram,
+	DeleteProgram,
+	CompileShader,
+	LinkProgram,
+	UseProgram,
+	GetUniformLocation,
+	SetUniform,
+	CreateTexture,
+	DeleteTexture,
+	BindTextureUnit,
+	ClearTexture,
+	TextureStorage2D,
+	TextureParameteri,
+	TextureParameterf,
+	TextureSubImage2D,
+	TextureSubImage3D,
+	GenerateMipmap,
+	PixelStore,
+	Enable,
+	CullFace,
+	ClearColor,
+	Clear,
+	Count
+};
+
+/// <summary>
+/// Gets a readable name for a render command
+/// </summary>
+const char* GetRenderCommandName(RenderCommand command);
+
+/// <summary>
+/// The interface that the graphics classes (buffers, VAOs, shaders and textures) talk to instead of calling OpenGL directly.
+/// The default device forwards straight to OpenGL, swapping it out lets the CPU side of rendering run without a GL driver
+/// </summary>
+class IRenderDevice
+{
+public:
+	typedef std::shared_ptr<IRenderDevice> Sptr;
+
+	IRenderDevice(const IRenderDevice& other) = delete;
+	IRenderDevice(IRenderDevice&& other) = delete;
+	IRenderDevice& operator=(const IRenderDevice& other) = delete;
+	IRenderDevice& operator=(IRenderDevice&& other) = delete;
+
+	virtual ~IRenderDevice() = default;
+
+	// Buffers
+	virtual GLuint CreateBuffer() = 0;
+	virtual void DeleteBuffer(GLuint handle) = 0;
+	virtual void BufferData(GLuint handle, size_t size, const void* data, GLenum usage) = 0;
+	virtual void BindBuffer(GLenum target, GLuint handle) = 0;
+
+	// Vertex arrays and drawing
+	virtual GLuint CreateVertexArray() = 0;
+	virtual void DeleteVertexArray(GLuint handle) = 0;
+	/// <summary>
+	/// Enables and sets up an attribute of the VAO, reading from the buffer bound to GL_ARRAY_BUFFER
+	/// </summary>
+	virtual void VertexAttribute(GLuint vao, GLuint slot, GLint size, GLenum type, bool normalized, GLsizei stride, size_t offset) = 0;
+	virtual void BindVertexArray(GLuint handle) = 0;
+	virtual void DrawArrays(GLenum mode, GLint first, GLsizei count) = 0;
+	virtual void DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset) = 0;
+
+	// Shaders
+	virtual GLuint CreateProgram() = 0;
+	virtual void DeleteProgram(GLuint handle) = 0;
+	/// <summary>
+	/// Compiles a shader part, returning its handle or 0 (and filling log) if it failed
+	/// </summary>
+	virtual GLuint CompileShader(GLenum type, const char* source, std::string& log) = 0;
+	/// <summary>
+	/// Links a program from two compiled parts, the parts are deleted afterwards.
+	/// Returns false (and fills log) if linking failed
+	/// </summary>
+	virtual bool LinkProgram(GLuint program, GLuint vs, GLuint fs, std::string& log) = 0;
+	virtual void UseProgram(GLuint handle) = 0;
+	virtual GLint GetUniformLocation(GLuint program, const char* name) = 0;
+	/// <summary>
+	/// Uploads count uniforms of the given type, transposed only applies to matrices
+	/// </summary>
+	virtual void SetUniform(GLuint program, GLint location, UniformType type, GLsizei count, const void* data, bool transposed = false) = 0;
+
+	// Textures
+	virtual GLuint CreateTexture(GLenum target) = 0;
+	virtual void DeleteTexture(GLuint handle) = 0;
+	virtual void BindTextureUnit(GLuint slot, GLuint handle) = 0;
+	virtual void ClearTexture(GLuint handle, const glm::vec4& color) = 0;
+	virtual void TextureStorage2D(GLuint handle, GLsizei levels, GLenum format, GLsizei width, GLsizei height) = 0;
+	virtual void TextureParameteri(GLuint handle, GLenum param, GLint value) = 0;
+	virtual void TextureParameterf(GLuint handle, GLenum param, GLfloat value) = 0;
+	virtual void TextureSubImage2D(GLuint handle, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+								   GLenum format, GLenum type, const void* data) = 0;
+	virtual void TextureSubImage3D(GLuint handle, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth,
+								   GLenum format, GLenum type, const void* data) = 0;
+	virtual void GenerateMipmap(GLuint handle) = 0;
+
+	// Global state
+	virtual void PixelStore(GLenum param, GLint value) = 0;
+	virtual void Enable(GLenum capability) = 0;
+	virtual void CullFace(GLenum face) = 0;
+	virtual void ClearColor(const glm::vec4& color) = 0;
+	/// <summary>
+	/// Clears the buffers in mask (GL_COLOR_BUFFER_BIT and so on) of the framebuffer that's bound
+	/// </summary>
+	virtual void Clear(GLbitfield mask) = 0;
+	virtual GLint GetInteger(GLenum param) = 0;
+	virtual GLfloat GetFloat(GLenum param) = 0;
+
+	/// <summary>
+	/// Gets the device that the graphics classes are currently using (OpenGL unless Set was called)
+	/// </summary>
+	static IRenderDevice* Get() { return __current; }
+	/// <summary>
+	/// Switches the device used by the graphics classes, nullptr goes back to OpenGL.
+	/// Objects keep the handles they got from the old device, so switch before creating any of them
+	/// </summary>
+	static void Set(const Sptr& device);
+
+protected:
+	IRenderDevice() = default;
+
+private:
+	static Sptr __default;
+	static Sptr __active;
+	static IRenderDevice* __current;
+};
+
+/// <summary>
+/// The render device that calls straight through to OpenGL. Binds and state changes go through
+/// nou::GLState, which skips the ones that wouldn't change anything
+/// </summary>
+class GLRenderDevice : public IRenderDevice
+{
+public:
+	GLRenderDevice() = default;
+	virtual ~GLRenderDevice() = default;
+
+	GLuint CreateBuffer() override;
+	void DeleteBuffer(GLuint handle) override;
+	void BufferData(GLuint handle, size_t size, const void* data, GLenum usage) override;
+	void BindBuffer(GLenum target, GLuint handle) override;
+
+	GLuint CreateVertexArray() override;
+	void DeleteVertexArray(GLuint handle) override;
+	void VertexAttribute(GLuint vao, GLuint slot, GLint size, GLenum type, bool normalized, GLsizei stride, size_t offset) override;
+	void BindVertexArray(GLuint handle) override;
+	void DrawArrays(GLenum mode, GLint first, GLsizei count) override;
+	void DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset) override;
+
+	GLuint CreateProgram() override;
+	void DeleteProgram(GLuint handle) override;
+	GLuint CompileShader(GLenum type, const char* source, std::string& log) override;
+	bool LinkProgram(GLuint program, GLuint vs, GLuint fs, std::string& log) override;
+	void UseProgram(GLuint handle) override;
+	GLint GetUniformLocation(GLuint program, const char* name) override;
+	void SetUniform(GLuint program, GLint location, UniformType type, GLsizei count, const void* data, bool transposed = false) override;
+
+	GLuint CreateTexture(GLenum target) override;
+	void DeleteTexture(GLuint handle) override;
+	void BindTextureUnit(GLuint slot, GLuint handle) override;
+	void ClearTexture(GLuint handle, const glm::vec4& color) override;
+	void TextureStorage2D(GLuint handle, GLsizei levels, GLenum format, GLsizei width, GLsizei height) override;
+	void TextureParameteri(GLuint handle, GLenum param, GLint value) override;
+	void TextureParameterf(GLuint handle, GLenum param, GLfloat value) override;
+	void TextureSubImage2D(GLuint handle, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+						   GLenum format, GLenum type, const void* data) override;
+	void TextureSubImage3D(GLuint handle, GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth,
+						   GLenum format, GLenum type, const void* data) override;
+	void GenerateMipmap(GLuint handle) override;
+
+	void PixelStore(GLenum param, GLint value) override;
+	void Enable(GLenum capability) override;
+	void CullFace(GLenum face) override;
+	void ClearColor(const glm::vec4& color) override;
+	void Clear(GLbitfield mask) override;
+	GLint GetInteger(GLenum param) override;
+	GLfloat GetFloat(GLenum param) override;
+};
@@ -1,44 +1,63 @@
 #include "Scene.h"
+#include "Profiler.h"
+#include "NOU/GLState.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
 
-SMI_Scene::SMI_Scene()
+SMI_Scene::SMI_Scene(const SMI_PhysicsSettings& settings)
 {
     //scene is active and not paused
 	isActive = true;
 	isPaused = false;
 
     //setting up physics world
-    CollisionConfig = new btDefaultCollisionConfiguration(); //default collision config
-    Dispatcher = new btCollisionDispatcher(CollisionConfig); //default collision dispatcher
+    PhysicsSettings = settings;
+    btDefaultCollisionConstructionInfo ConfigInfo;
+    ConfigInfo.m_defaultMaxPersistentManifoldPoolSize = settings.MaxPersistentManifolds;
+    ConfigInfo.m_defaultMaxCollisionAlgorithmPoolSize = settings.MaxCollisionAlgorithms;
+    CollisionConfig = new btDefaultCollisionConfiguration(ConfigInfo); //default collision config
     OverlappingPairCache = new btDbvtBroadphase();//basic board phase
-    Solver = new btSequentialImpulseConstraintSolver;//default collision solver
-    Collisions = std::vector<SMI_Collision::sptr>();
 
-    //create the physics world
-    physicsWorld = new btDiscreteDynamicsWorld(Dispatcher, OverlappingPairCache, Solver, CollisionConfig);
-    physicsWorld->setGravity(btVector3(0.f, 0.f, 0.f));
+    if (settings.Multithreaded)
+    {
+        //the scheduler has to be handed to bullet before any of the Mt classes are made
+        SMI_TaskScheduler* Scheduler = SMI_TaskScheduler::Get();
+        Scheduler->setNumThreads(settings.NumThreads);
+
+        Dispatcher = new btCollisionDispatcherMt(CollisionConfig); //dispatcher that finds pairs in parallel
+        btConstraintSolverPoolMt* SolverPool = new btConstraintSolverPoolMt(Scheduler->getMaxNumThreads()); //one solver per thread
+        Solver = SolverPool;
+
+        //create the physics world
+        physicsWorld = new btDiscreteDynamicsWorldMt(Dispatcher, OverlappingPairCache, SolverPool, nullptr, CollisionConfig);
+    }
+    else
+    {
+        Dispatcher = new btCollisionDispatcher(CollisionConfig); //default collision dispatcher
+        Solver = new btSequentialImpulseConstraintSolver;//default collision solver
+
+        //create the physics world
+        physicsWorld = new btDiscreteDynamicsWorld(Dispatcher, OverlappingPairCache, Solver, CollisionConfig);
+    }
+
+    gravity = glm::vec3(0.f, 0.f, 0.f);
+    physicsWorld->setGravity(btVector3(gravity.x, gravity.y, gravity.z));
 
     //create registry
     Store = entt::registry();
     camera = nullptr;
+    DebugDrawer = nullptr;
+    Queries.setWorld(physicsWorld);
 }
 
 SMI_Scene::~SMI_Scene()
 {
-    //delete all the physics world stuff
-        //delete the physics objects
+    //take every object out of the world, the physics components own the bodies
     for (auto i = physicsWorld->getNumCollisionObjects() - 1; i >= 0; i--) {
-        //get the object and it's rigid body
-        btCollisionObject* PhyObject = physicsWorld->getCollisionObjectArray()[i];
-        btRigidBody* PhysRigidBod = btRigidBody::upcast(PhyObject);
-        //if it has a motion state, remove that
-        if (PhysRigidBod != nullptr && PhysRigidBod->getMotionState() != nullptr) {
-            delete PhysRigidBod->getMotionState();
-        }
-        //remove the object from the physics world
-        physicsWorld->removeCollisionObject(PhyObject);
-        //and delete it
-        delete PhyObject;
+        physicsWorld->removeCollisionObject(physicsWorld->getCollisionObjectArray()[i]);
     }
+    //release the components (and their bodies) before the world goes away
+    Store.clear();
 
     //delete the physics world and it's attributes
     delete physicsWorld;
@@ -53,15 +72,92 @@ entt::entity SMI_Scene::CreateEntity()
     return Store.create();
 }
 
+std::vector<entt::entity> SMI_Scene::Instantiate(const SMI_Prefab& prefab, size_t count, const SMI_Transform* transforms)
+{
+    std::vector<entt::entity> entities = std::vector<entt::entity>(count);
+    Store.create(entities.begin(), entities.end());
+
+    //each component pool grows once for the whole range instead of once per entity
+    if (prefab.hasRenderer())
+        Store.insert<Renderer>(entities.begin(), entities.end(), prefab.getRenderer());
+
+    if (transforms != nullptr)
+        Store.insert<SMI_Transform>(entities.begin(), entities.end(), transforms, transforms + count);
+    else
+        Store.insert<SMI_Transform>(entities.begin(), entities.end(), prefab.getTransform());
+
+    if (prefab.hasPhysics())
+    {
+        std::vector<SMI_Physics> bodies;
+        bodies.reserve(count);
+        for (size_t i = 0; i < count; i++)
+            bodies.push_back(prefab.MakePhysics(transforms != nullptr ? transforms[i] : prefab.getTransform(), entities[i]));
+
+        Store.insert<SMI_Physics>(entities.begin(), entities.end(), bodies.begin(), bodies.end());
+
+        //same as AttachCopy<SMI_Physics>
+        for (entt::entity entity : entities)
+        {
+            SMI_Physics& phys = Store.get<SMI_Physics>(entity);
+            phys.BindMotionState(Store);
+            physicsWorld->addRigidBody(phys.getRigidBody());
+            phys.setInWorld(physicsWorld);
+        }
+    }
+
+    return entities;
+}
+
+void SMI_Scene::setEntityActive(entt::entity target, bool active)
+{
+    if (active == getEntityActive(target))
+        return;
+
+    if (active)
+        Store.remove<SMI_Inactive>(target);
+    else
+        Store.emplace<SMI_Inactive>(target);
+
+    SMI_Physics* phys = Store.try_get<SMI_Physics>(target);
+    if (phys == nullptr || !phys->getInWorld())
+        return;
+
+    //the body keeps its broadphase proxy either way, so parking never allocates
+    btRigidBody* body = phys->getRigidBody();
+    btBroadphaseProxy* proxy = body->getBroadphaseHandle();
+    if (active)
+    {
+        //same filters addRigidBody gives a body
+        bool isStatic = body->isStaticOrKinematicObject();
+        proxy->m_collisionFilterGroup = isStatic ? btBroadphaseProxy::StaticFilter : btBroadphaseProxy::DefaultFilter;
+        proxy->m_collisionFilterMask = isStatic ? btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter : btBroadphaseProxy::AllFilter;
+
+        //puts the activation state back to what its sleep settings want
+        body->forceActivationState(ACTIVE_TAG);
+        phys->setSleepSettings(phys->getSleepSettings());
+        body->activate(true);
+    }
+    else
+    {
+        body->setLinearVelocity(btVector3(0.f, 0.f, 0.f));
+        body->setAngularVelocity(btVector3(0.f, 0.f, 0.f));
+        body->clearForces();
+        body->forceActivationState(DISABLE_SIMULATION);
+
+        //no new pairs, and drop the ones it has along with their manifolds, cleaning them would leave the pairs
+        //in the cache and they'd keep getting contacts
+        proxy->m_collisionFilterGroup = 0;
+        proxy->m_collisionFilterMask = 0;
+        physicsWorld->getBroadphase()->getOverlappingPairCache()->removeOverlappingPairsContainingProxy(proxy, physicsWorld->getDispatcher());
+    }
+}
+
 void SMI_Scene::DeleteEntity(entt::entity target)
 {
+    //the body is freed along with the component, it just needs to leave the world
     if (Store.has<SMI_Physics>(target))
     {
-        btRigidBody* TargetBody = Store.get<SMI_Physics>(target).getRigidBody();
-        delete TargetBody->getMotionState();
-        delete TargetBody->getCollisionShape();
-        physicsWorld->removeRigidBody(TargetBody);
-        delete TargetBody;
+        RemoveBody(Store.get<SMI_Physics>(target).getRigidBody());
     }
 
     Store.destroy(target);
@@ -75,44 +171,84 @@ void SMI_Scene::Update(float deltaTime)
 {
     if (!isPaused)
     {
-        physicsWorld->stepSimulation(deltaTime);
-        
-        //creating view for physics
-        auto PhysicsView = Store.view<SMI_Physics>();
-        for (auto entity : PhysicsView)
+        //bodies that move write themselves into their transforms through SMI_MotionState
         {
-            SMI_Physics& phys = GetComponent<SMI_Physics>(entity);
-            phys.getRigidBody()->setActivationState(true);
-
-            //set gravity value
-            if (phys.getHasGravity())
-            {
-                phys.getRigidBody()->setGravity(btVector3(gravity.x, gravity.y, gravity.z));
-            }
-            else
-            {
-                phys.getRigidBody()->setGravity(btVector3(0.f, 0.f, 0.f));
-            }
-
-            phys.Update(deltaTime);
+            SMI_PROFILE_CPU("Physics step");
+            physicsWorld->stepSimulation(deltaTime);
         }
 
+        SMI_PROFILE_CPU("CollisionManage");
         CollisionManage();
+    }
+}
 
-        auto TransPhysView = Store.view<SMI_Physics, SMI_Transform>();
-        for (auto entity : TransPhysView)
-        {
-            SMI_Transform& trans = GetComponent<SMI_Transform>(entity);
-            SMI_Physics& phys = GetComponent<SMI_Physics>(entity);
+void SMI_Scene::setGravity(const glm::vec3& _gravity)
+{
+    gravity = _gravity;
 
-            trans.setPos(phys.GetPosition());
-        }
+    //pushes the gravity to every awake body in the world that doesn't have it disabled
+    btVector3 btGravity = btVector3(gravity.x, gravity.y, gravity.z);
+    physicsWorld->setGravity(btGravity);
+
+    //the world skips sleeping bodies, so they need it set here or they'd wake up with the old gravity
+    auto PhysicsView = Store.view<SMI_Physics>();
+    for (auto entity : PhysicsView)
+    {
+        btRigidBody* body = PhysicsView.get<SMI_Physics>(entity).getRigidBody();
+        if (!body->isStaticOrKinematicObject() && !(body->getFlags() & BT_DISABLE_WORLD_GRAVITY))
+            body->setGravity(btGravity);
+    }
+}
+
+SMI_PhysicsStats SMI_Scene::getPhysicsStats() const
+{
+    SMI_PhysicsStats stats;
+
+    const btCollisionObjectArray& objects = physicsWorld->getCollisionObjectArray();
+    for (int i = 0; i < objects.size(); i++)
+    {
+        if (objects[i]->isStaticOrKinematicObject())
+            stats.StaticBodies++;
+        else if (objects[i]->isActive())
+            stats.ActiveBodies++;
+        else
+            stats.SleepingBodies++;
+    }
+
+    return stats;
+}
+
+void SMI_Scene::RemoveBody(btRigidBody* body)
+{
+    //bodies resting on this one would stay asleep in mid air otherwise
+    btDispatcher* dispatcher = physicsWorld->getDispatcher();
+    for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+    {
+        btPersistentManifold* Contact = dispatcher->getManifoldByIndexInternal(i);
+        if (Contact->getBody0() == body)
+            Contact->getBody1()->activate();
+        else if (Contact->getBody1() == body)
+            Contact->getBody0()->activate();
+    }
+
+    physicsWorld->removeRigidBody(body);
+}
+
+void SMI_Scene::setPhysicsThreads(int numThreads)
+{
+    if (PhysicsSettings.Multithreaded)
+    {
+        PhysicsSettings.NumThreads = numThreads;
+        SMI_TaskScheduler::Get()->setNumThreads(numThreads);
     }
 }
 
 void SMI_Scene::Render()
 {
-    auto RenderView = Store.view<Renderer, SMI_Transform>();
+    SMI_PROFILE_CPU("Render");
+    SMI_PROFILE_GPU("Scene");
+
+    auto RenderView = Store.view<Renderer, SMI_Transform>(entt::exclude<SMI_Inactive>);
     for (auto entity : RenderView)
     {
         SMI_Transform& trans = GetComponent<SMI_Transform>(entity);
@@ -151,50 +287,141 @@ void SMI_Scene::Render()
 
 void SMI_Scene::PostRender()
 {
+    DrawPhysicsDebug();
+}
+
+void SMI_Scene::setDebugDrawer(SMI_PhysicsDebugDraw* drawer)
+{
+    DebugDrawer = drawer;
+    physicsWorld->setDebugDrawer(drawer);
+}
+
+void SMI_Scene::DrawPhysicsDebug()
+{
+    if (DebugDrawer == nullptr || !DebugDrawer->getEnabled() || camera == nullptr)
+        return;
+
+    SMI_PROFILE_CPU("Physics debug draw");
+    SMI_PROFILE_GPU("Physics debug draw");
+
+    //same as btCollisionWorld::debugDrawWorld, but it culls by the drawer's region and can skip sleeping bodies
+    int mode = DebugDrawer->getDebugMode();
+    btIDebugDraw::DefaultColors colors = DebugDrawer->getDefaultColors();
+
+    if (mode & (btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawAabb | btIDebugDraw::DBG_DrawFrames))
+    {
+        const btCollisionObjectArray& objects = physicsWorld->getCollisionObjectArray();
+        for (int i = 0; i < objects.size(); i++)
+        {
+            btCollisionObject* obj = objects[i];
+            if (obj->getCollisionFlags() & btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT)
+                continue;
+            if (!DebugDrawer->getDrawSleeping() && obj->getActivationState() == ISLAND_SLEEPING)
+                continue;
+
+            btVector3 minAabb, maxAabb;
+            obj->getCollisionShape()->getAabb(obj->getWorldTransform(), minAabb, maxAabb);
+            if (!DebugDrawer->InRegion(minAabb, maxAabb))
+                continue;
+
+            if (mode & btIDebugDraw::DBG_DrawFrames)
+                DebugDrawer->drawTransform(obj->getWorldTransform(), 0.5f);
+
+            if (mode & btIDebugDraw::DBG_DrawWireframe)
+            {
+                //colored by activation state like bullet does
+                btVector3 color;
+                switch (obj->getActivationState())
+                {
+                case ACTIVE_TAG:
+                    color = colors.m_activeObject;
+                    break;
+                case ISLAND_SLEEPING:
+                    color = colors.m_deactivatedObject;
+                    break;
+                case WANTS_DEACTIVATION:
+                    color = colors.m_wantsDeactivationObject;
+                    break;
+                case DISABLE_DEACTIVATION:
+                    color = colors.m_disabledDeactivationObject;
+                    break;
+                default:
+                    color = colors.m_disabledSimulationObject;
+                    break;
+                }
+                physicsWorld->debugDrawObject(obj->getWorldTransform(), obj->getCollisionShape(), color);
+            }
+
+            if (mode & btIDebugDraw::DBG_DrawAabb)
+                DebugDrawer->drawAabb(minAabb, maxAabb, colors.m_aabb);
+        }
+    }
+
+    if (mode & btIDebugDraw::DBG_DrawContactPoints)
+    {
+        btDispatcher* dispatcher = physicsWorld->getDispatcher();
+        for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+        {
+            btPersistentManifold* Contact = dispatcher->getManifoldByIndexInternal(i);
+            for (int j = 0; j < Contact->getNumContacts(); j++)
+            {
+                btManifoldPoint& point = Contact->getContactPoint(j);
+                if (!DebugDrawer->InRegion(point.getPositionWorldOnB(), point.getPositionWorldOnB()))
+                    continue;
+
+                DebugDrawer->drawContactPoint(point.getPositionWorldOnB(), point.m_normalWorldOnB,
+                    point.getDistance(), point.getLifeTime(), colors.m_contactPoint);
+            }
+        }
+    }
+
+    if (mode & (btIDebugDraw::DBG_DrawConstraints | btIDebugDraw::DBG_DrawConstraintLimits))
+    {
+        for (int i = 0; i < physicsWorld->getNumConstraints(); i++)
+            physicsWorld->debugDrawConstraint(physicsWorld->getConstraint(i));
+    }
+
+    DebugDrawer->Flush(camera->GetView(), camera->GetProjection());
+    //TTK binds its own program, VAO and buffers straight through GL, so the cache no longer knows what is bound
+    nou::GLState::Invalidate();
 }
 
 void SMI_Scene::CollisionManage()
 {
     //based on code from https://andysomogyi.github.io/mechanica/bullet.html
-    Collisions.clear();
+    Collisions.BeginFrame();
 
-    int manifolds = physicsWorld->getDispatcher()->getNumManifolds();
+    btDispatcher* dispatcher = physicsWorld->getDispatcher();
+    int manifolds = dispatcher->getNumManifolds();
     for (int i = 0; i < manifolds; i++)
     {
-        btPersistentManifold* Contact = physicsWorld->getDispatcher()->getManifoldByIndexInternal(i);
-        //collision body 1 and 2
-        const btCollisionObject* obj1 = Contact->getBody0();
-        const btCollisionObject* obj2 = Contact->getBody1();
+        btPersistentManifold* Contact = dispatcher->getManifoldByIndexInternal(i);
+        entt::entity first = SMI_Physics::getEntity(Contact->getBody0());
+        entt::entity second = SMI_Physics::getEntity(Contact->getBody1());
+
+        //parked entities are out of the game, whatever bullet still has for them
+        if ((Store.valid(first) && !getEntityActive(first)) || (Store.valid(second) && !getEntityActive(second)))
+            continue;
+
+        //bullet doesn't update contacts between sleeping bodies, so the pair is the same as last frame
+        if (!Contact->getBody0()->isActive() && !Contact->getBody1()->isActive())
+        {
+            Collisions.KeepContact(first, second);
+            continue;
+        }
 
         //int for number of contacts
         int numcon = Contact->getNumContacts();
         for (int j = 0; j < numcon; j++)
         {
-            btManifoldPoint& point = Contact->getContactPoint(j);
-            if (point.getDistance() < 0.f)
+            if (Contact->getContactPoint(j).getDistance() < 0.f)
             {
-                const btRigidBody* FirstBody = btRigidBody::upcast(obj1);
-                const btRigidBody* SecondBody = btRigidBody::upcast(obj2);
-
-                SMI_Collision::sptr NewCollide = SMI_Collision::Create();
-                NewCollide->setB1(static_cast<entt::entity>(reinterpret_cast<uint32_t>(FirstBody->getUserPointer())));
-                NewCollide->setB2(static_cast<entt::entity>(reinterpret_cast<uint32_t>(SecondBody->getUserPointer())));
-
-                bool Add = true;
-                for (int k = 0; k < Collisions.size(); k++)
-                {
-                    if (SMI_Collision::Same(NewCollide, Collisions[k]))
-                    {
-                        Add = false;
-                        break;
-                    }
-                }
-
-                if (Add)
-                {
-                    Collisions.push_back(NewCollide);
-                }
+                //one penetrating point is enough for the pair
+                Collisions.AddContact(first, second);
+                break;
             }
         }
     }
+
+    Collisions.EndFrame();
 }
@@ -3,17 +3,45 @@
 #include "GLM/glm.hpp"
 #include "GLM/common.hpp"
 #include "Physics.h"
+#include "CollisionEvents.h"
 #include "Camera.h"
 #include "Transform.h"
 #include "Render.h"
+#include "TaskScheduler.h"
+#include "PhysicsDebugDraw.h"
+#include "SpatialQuery.h"
+#include "Prefab.h"
 #include <vector>
 
+//settings used when a scene builds its physics world
+struct SMI_PhysicsSettings
+{
+	//builds btDiscreteDynamicsWorldMt, which solves islands on the shared SMI_TaskScheduler
+	bool Multithreaded = false;
+	//number of threads physics runs on (including the main thread), 0 uses every hardware thread
+	int NumThreads = 0;
+	//pool sizes for contact manifolds and collision algorithms, raise these for scenes with thousands of bodies
+	int MaxPersistentManifolds = 4096;
+	int MaxCollisionAlgorithms = 4096;
+};
+
+//counts of the bodies in a physics world, used to check how many are sleeping
+struct SMI_PhysicsStats
+{
+	int ActiveBodies = 0;
+	int SleepingBodies = 0;
+	int StaticBodies = 0;
+};
+
+//tag for parked entities (ex: pooled projectiles), they aren't rendered and their bodies aren't simulated
+struct SMI_Inactive {};
+
 //class to create a scene 
 class SMI_Scene
 {
 public:
 	//constructor calls
-	SMI_Scene();
+	SMI_Scene(const SMI_PhysicsSettings& settings = SMI_PhysicsSettings());
 
 	//copy, move, and assignment operators
 	SMI_Scene(const SMI_Scene& oldScene) = default;
@@ -25,6 +53,11 @@ public:
 
 	entt::entity CreateEntity();
 	void DeleteEntity(entt::entity target);
+	//parks or unparks an entity without destroying it, parked bodies stay in the world but don't move or collide
+	void setEntityActive(entt::entity target, bool active);
+	bool getEntityActive(entt::entity target) const { return !Store.has<SMI_Inactive>(target); }
+	//creates count copies of a prefab in one pass, transforms (if given) holds one transform per instance
+	std::vector<entt::entity> Instantiate(const SMI_Prefab& prefab, size_t count, const SMI_Transform* transforms = nullptr);
 	entt::registry& GetRegistry() { return Store; }
 
 	//function declarations for a scene 
@@ -47,9 +80,20 @@ public:
 
 	//Physics for scenes
 	//gravity setter and getter
-	void setGravity(const glm::vec3& _gravity) { gravity = _gravity; }
+	void setGravity(const glm::vec3& _gravity);
 	glm::vec3 getGravity() const { return gravity; }
 
+	//getter for the settings the physics world was built with
+	const SMI_PhysicsSettings& getPhysicsSettings() const { return PhysicsSettings; }
+	//changes how many threads physics runs on, only used by multithreaded scenes
+	void setPhysicsThreads(int numThreads);
+
+	//how long (in seconds) a body has to stay under its sleep thresholds before it sleeps, shared by every world
+	static void setSleepTime(float seconds) { gDeactivationTime = seconds; }
+	static float getSleepTime() { return gDeactivationTime; }
+	//counts active, sleeping and static (or kinematic) bodies, walks every body so it's meant for debugging
+	SMI_PhysicsStats getPhysicsStats() const;
+
 	//setter and getter for active scene 
 	void setActive(const bool& _isActive) { isActive = _isActive; }
 	bool getActive() const { return isActive; }
@@ -62,6 +106,29 @@ public:
 	void setCamera(const Camera::Sptr& _cam) { camera = _cam; }
 	Camera::Sptr getCamera() const { return camera; }
 
+	//debug drawer used by PostRender to show the physics world, the scene doesn't own it
+	void setDebugDrawer(SMI_PhysicsDebugDraw* drawer);
+	SMI_PhysicsDebugDraw* getDebugDrawer() const { return DebugDrawer; }
+	//draws the physics world through the debug drawer, skipping anything outside its region
+	void DrawPhysicsDebug();
+
+	//spatial queries against the physics world, these can't run while the world is stepping
+	bool Raycast(const glm::vec3& from, const glm::vec3& to, SMI_RayHit& hit,
+		int mask = btBroadphaseProxy::AllFilter, entt::entity ignore = entt::null) const { return Queries.Raycast(from, to, hit, mask, ignore); }
+	bool SphereCast(const glm::vec3& from, const glm::vec3& to, float radius, SMI_RayHit& hit,
+		int mask = btBroadphaseProxy::AllFilter, entt::entity ignore = entt::null) const { return Queries.SphereCast(from, to, radius, hit, mask, ignore); }
+	int OverlapAabb(const glm::vec3& min, const glm::vec3& max, entt::entity* results, int maxResults,
+		int mask = btBroadphaseProxy::AllFilter) const { return Queries.OverlapAabb(min, max, results, maxResults, mask); }
+	int OverlapSphere(const SMI_OverlapQuery& query, entt::entity* results, int maxResults) const { return Queries.OverlapSphere(query, results, maxResults); }
+	//batch versions run across the thread pool and write into the caller's arrays, see SMI_SpatialQuery
+	void CastBatch(const SMI_CastQuery* queries, SMI_RayHit* hits, int count) const { Queries.CastBatch(queries, hits, count); }
+	void OverlapSphereBatch(const SMI_OverlapQuery* queries, int count, entt::entity* results, int maxPerQuery, int* counts) const {
+		Queries.OverlapSphereBatch(queries, count, results, maxPerQuery, counts);
+	}
+
+	//getter for this frame's collision events (begin, stay and end)
+	const SMI_CollisionTracker& getCollisions() const { return Collisions; }
+
 private:
 	//create registry
 	entt::registry Store;
@@ -75,22 +142,33 @@ private:
 	glm::vec3 gravity;
 
 	//physics world properties
+	SMI_PhysicsSettings PhysicsSettings;
 	btDefaultCollisionConfiguration* CollisionConfig;
 	btCollisionDispatcher* Dispatcher;
 	btBroadphaseInterface* OverlappingPairCache;
-	btSequentialImpulseConstraintSolver* Solver;
+	//sequential impulse solver, or a btConstraintSolverPoolMt for multithreaded worlds
+	btConstraintSolver* Solver;
 	//physics world
 	btDiscreteDynamicsWorld* physicsWorld;
+	SMI_PhysicsDebugDraw* DebugDrawer;
+	//runs queries against physicsWorld
+	SMI_SpatialQuery Queries;
+
 
+	//takes a body out of the world, waking anything it was touching so nothing is left floating
+	void RemoveBody(btRigidBody* body);
 
+protected:
 	//manages collisions
 	void CollisionManage();
 
-protected:
+	//the physics world, for scenes that need bullet directly (ex: benchmarks that build contacts by hand)
+	btDiscreteDynamicsWorld* getPhysicsWorld() const { return physicsWorld; }
+
 	//handle used to reference camera object
 	Camera::Sptr camera;
-	//vector to hold all collisions to manage
-	std::vector<SMI_Collision::sptr> Collisions;
+	//tracks entity pairs across frames and holds the collision events
+	SMI_CollisionTracker Collisions;
 };
 
 
@@ -107,8 +185,10 @@ inline void SMI_Scene::Attach<SMI_Physics>(entt::entity target)
 	SMI_Physics& phys = GetComponent<SMI_Physics>(target);
 
 	phys.setEntity(target);
+	phys.BindMotionState(Store);
+	//the world applies its gravity here, unless the body has it disabled
 	physicsWorld->addRigidBody(phys.getRigidBody());
-	phys.setInWorld(true);
+	phys.setInWorld(physicsWorld);
 }
 
 template <typename T>
@@ -123,8 +203,10 @@ inline void SMI_Scene::AttachCopy<SMI_Physics>(entt::entity target, const SMI_Ph
 	SMI_Physics& phys = GetComponent<SMI_Physics>(target);
 
 	phys.setEntity(target);
+	phys.BindMotionState(Store);
+	//the world applies its gravity here, unless the body has it disabled
 	physicsWorld->addRigidBody(phys.getRigidBody());
-	phys.setInWorld(true);
+	phys.setInWorld(physicsWorld);
 }
 
 template <typename T>
@@ -147,12 +229,8 @@ inline void SMI_Scene::Remove(entt::entity target)
 template <>
 inline void SMI_Scene::Remove<SMI_Physics>(entt::entity target)
 {
-	//deletes bullet components and physics
-	btRigidBody* TargetBody = Store.get<SMI_Physics>(target).getRigidBody();
-	delete TargetBody->getMotionState();
-	delete TargetBody->getCollisionShape();
-	physicsWorld->removeRigidBody(TargetBody);
-	delete TargetBody;
+	//takes the body out of the world, the component frees it (and its motion state) once removed
+	RemoveBody(Store.get<SMI_Physics>(target).getRigidBody());
 
 	//deletes component
 	Store.remove<SMI_Physics>(target);
@@ -1,5 +1,6 @@
 #include "Shader.h"
 #include "Logging.h"
+#include "RenderDevice.h"
 #include <fstream>
 #include <sstream>
 
@@ -9,50 +10,25 @@ Shader::Shader() :
 	_fs(0),
 	_handle(0)
 {
-	_handle = glCreateProgram();
+	_handle = IRenderDevice::Get()->CreateProgram();
 }
 
 Shader::~Shader() {
 	if (_handle != 0) {
-		glDeleteProgram(_handle);
+		IRenderDevice::Get()->DeleteProgram(_handle);
 		_handle = 0;
 	}
 }
 
 bool Shader::LoadShaderPart(const char* source, ShaderPartType type)
 {
-	// Creates a new shader part (VS, FS, GS, etc...)
-	GLuint handle = glCreateShader((GLenum)type);
-
-	// Load the GLSL source and compile it
-	glShaderSource(handle, 1, &source, nullptr);
-	glCompileShader(handle);
-
-	// Get the compilation status for the shader part
-	GLint status = 0;
-	glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
-
-	if (status == GL_FALSE) {
-		// Get the size of the error log
-		GLint logSize = 0;
-		glGetShaderiv(handle, GL_INFO_LOG_LENGTH, &logSize);
-
-		// Create a new character buffer for the log
-		char* log = new char[logSize];
-
-		// Get the log
-		glGetShaderInfoLog(handle, logSize, &logSize, log);
+	// Creates and compiles a new shader part (VS, FS, GS, etc...)
+	std::string log;
+	GLuint handle = IRenderDevice::Get()->CompileShader((GLenum)type, source, log);
 
+	if (handle == 0) {
 		// Dump error log
 		LOG_ERROR("Failed to compile shader part:\n{}", log);
-
-		// Clean up our log memory
-		delete[] log;
-
-		// Delete the broken shader result
-		glDeleteShader(handle);
-		handle = 0;
-
 		return false;
 	}
 
@@ -62,7 +38,7 @@ bool Shader::LoadShaderPart(const char* source, ShaderPartType type)
 		default: LOG_WARN("Not implemented"); break;
 	}
 
-	return status != GL_FALSE;
+	return true;
 }
 
 bool Shader::LoadShaderPartFromFile(const char* path, ShaderPartType type) {
@@ -93,99 +69,85 @@ bool Shader::Link()
 {
 	LOG_ASSERT(_vs != 0 && _fs != 0, "Must attach both a vertex and fragment shader!");
 
-	// Attach our two shaders
-	glAttachShader(_handle, _vs);
-	glAttachShader(_handle, _fs);
-
-	// Perform linking
-	glLinkProgram(_handle);
-
-	// Remove shader parts to save space (we can do this since we only needed the shader parts to compile an actual shader program)
-	glDetachShader(_handle, _vs);
-	glDeleteShader(_vs);
-	glDetachShader(_handle, _fs);
-	glDeleteShader(_fs);
+	// Links, then deletes the shader parts to save space (we only needed them to compile an actual shader program)
+	std::string log;
+	bool result = IRenderDevice::Get()->LinkProgram(_handle, _vs, _fs, log);
+	_vs = 0;
+	_fs = 0;
 
-	GLint status = 0;
-	glGetProgramiv(_handle, GL_LINK_STATUS, &status);
-
-	if (status == GL_FALSE)
-	{
-		// Get the length of the log
-		GLint length = 0;
-		glGetProgramiv(_handle, GL_INFO_LOG_LENGTH, &length);
-
-		if (length > 0) {
-			// Read the log from openGL
-			char* log = new char[length];
-			glGetProgramInfoLog(_handle, length, &length, log);
+	if (!result) {
+		if (!log.empty()) {
 			LOG_ERROR("Shader failed to link:\n{}", log);
-			delete[] log;
 		} else {
 			LOG_ERROR("Shader failed to link for an unknown reason!");
 		}
 	}
-	return status != GL_FALSE;
+	return result;
 }
 
 void Shader::Bind() {
 	// Simply calls glUseProgram with our shader handle
-	glUseProgram(_handle);
+	IRenderDevice::Get()->UseProgram(_handle);
 }
 
 void Shader::Unbind() {
 	// We unbind a shader program by using the default program (0)
-	glUseProgram(0);
+	IRenderDevice::Get()->UseProgram(0);
 }
 
 void Shader::SetUniformMatrix(int location, const glm::mat3* value, int count, bool transposed) {
-	glProgramUniformMatrix3fv(_handle, location, count, transposed, glm::value_ptr(*value));
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::Mat3, count, glm::value_ptr(*value), transposed);
 }
 void Shader::SetUniformMatrix(int location, const glm::mat4* value, int count, bool transposed) {
-	glProgramUniformMatrix4fv(_handle, location, count, transposed, glm::value_ptr(*value));
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::Mat4, count, glm::value_ptr(*value), transposed);
 }
 
 void Shader::SetUniform(int location, const float* value, int count) {
-	glProgramUniform1fv(_handle, location, count, value);
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::Float, count, value);
 }
 void Shader::SetUniform(int location, const glm::vec2* value, int count) {
-	glProgramUniform2fv(_handle, location, count, glm::value_ptr(*value));
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::Vec2, count, glm::value_ptr(*value));
 }
 void Shader::SetUniform(int location, const glm::vec3* value, int count) {
-	glProgramUniform3fv(_handle, location, count, glm::value_ptr(*value));
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::Vec3, count, glm::value_ptr(*value));
 }
 void Shader::SetUniform(int location, const glm::vec4* value, int count) {
-	glProgramUniform4fv(_handle, location, count, glm::value_ptr(*value));
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::Vec4, count, glm::value_ptr(*value));
 }
 
 void Shader::SetUniform(int location, const int* value, int count) {
-	glProgramUniform1iv(_handle, location, count, value);
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::Int, count, value);
 }
 void Shader::SetUniform(int location, const glm::ivec2* value, int count) {
-	glProgramUniform2iv(_handle, location, count, glm::value_ptr(*value));
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::IVec2, count, glm::value_ptr(*value));
 }
 void Shader::SetUniform(int location, const glm::ivec3* value, int count) {
-	glProgramUniform3iv(_handle, location, count, glm::value_ptr(*value));
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::IVec3, count, glm::value_ptr(*value));
 }
 void Shader::SetUniform(int location, const glm::ivec4* value, int count) {
-	glProgramUniform4iv(_handle, location, count, glm::value_ptr(*value));
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::IVec4, count, glm::value_ptr(*value));
 }
 
 void Shader::SetUniform(int location, const bool* value, int count) {
 	LOG_ASSERT(count == 1, "SetUniform for bools only supports setting single values at a time!");
-	glProgramUniform1i(location, *value, 1);
+	// GL takes bools as ints
+	int data = *value;
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::Int, 1, &data);
 }
 void Shader::SetUniform(int location, const glm::bvec2* value, int count) {
 	LOG_ASSERT(count == 1, "SetUniform for bools only supports setting single values at a time!");
-	glProgramUniform2i(location, value->x, value->y, 1);
+	glm::ivec2 data = glm::ivec2(*value);
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::IVec2, 1, glm::value_ptr(data));
 }
 void Shader::SetUniform(int location, const glm::bvec3* value, int count) {
 	LOG_ASSERT(count == 1, "SetUniform for bools only supports setting single values at a time!");
-	glProgramUniform3i(location, value->x, value->y, value->z, 1);
+	glm::ivec3 data = glm::ivec3(*value);
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::IVec3, 1, glm::value_ptr(data));
 }
 void Shader::SetUniform(int location, const glm::bvec4* value, int count) {
 	LOG_ASSERT(count == 1, "SetUniform for bools only supports setting single values at a time!");
-	glProgramUniform4i(location, value->x, value->y, value->z, value->w, 1);
+	glm::ivec4 data = glm::ivec4(*value);
+	IRenderDevice::Get()->SetUniform(_handle, location, UniformType::IVec4, 1, glm::value_ptr(data));
 }
 
 int Shader::__GetUniformLocation(const std::string& name) {
@@ -195,7 +157,7 @@ int Shader::__GetUniformLocation(const std::string& name) {
 
 	// If our entry was not found, we call glGetUniform and store it for next time
 	if (it == _uniformLocs.end()) {
-		result = glGetUniformLocation(_handle, name.c_str());
+		result = IRenderDevice::Get()->GetUniformLocation(_handle, name.c_str());
 		_uniformLocs[name] = result;
 	}
 	// Otherwise, we had a value in the map, return it
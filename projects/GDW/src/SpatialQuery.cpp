@@ -0,0 +1,376 @@
+#include "SpatialQuery.h"
+#include "Physics.h"
+#include "TaskScheduler.h"
+#include "BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h"
+#include "BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h"
+#include "BulletCollision/NarrowPhaseCollision/btPointCollector.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+
+namespace
+{
+    //bullet's broadphase ray test shares one stack unless bullet is built with BT_THREADSAFE, so each thread keeps its own
+    thread_local btNodeStack QueryStack;
+
+    btVector3 ToBt(const glm::vec3& vec)
+    {
+        return btVector3(vec.x, vec.y, vec.z);
+    }
+
+    glm::vec3 ToGlm(const btVector3& vec)
+    {
+        return glm::vec3(vec.getX(), vec.getY(), vec.getZ());
+    }
+
+    bool Filtered(const btBroadphaseProxy* proxy, int mask, entt::entity ignore)
+    {
+        if ((proxy->m_collisionFilterGroup & mask) == 0)
+            return true;
+
+        return ignore != entt::null && SMI_Physics::getEntity(static_cast<const btCollisionObject*>(proxy->m_clientObject)) == ignore;
+    }
+
+    //closest ray result that can skip an entity
+    struct RayCallback : public btCollisionWorld::ClosestRayResultCallback
+    {
+        RayCallback(const btVector3& from, const btVector3& to, int mask, entt::entity ignore) :
+            btCollisionWorld::ClosestRayResultCallback(from, to), Ignore(ignore)
+        {
+            m_collisionFilterMask = mask;
+        }
+
+        bool needsCollision(btBroadphaseProxy* proxy) const override
+        {
+            return !Filtered(proxy, m_collisionFilterMask, Ignore);
+        }
+
+        entt::entity Ignore;
+    };
+
+    //closest sweep result that can skip an entity
+    struct SweepCallback : public btCollisionWorld::ClosestConvexResultCallback
+    {
+        SweepCallback(const btVector3& from, const btVector3& to, int mask, entt::entity ignore) :
+            btCollisionWorld::ClosestConvexResultCallback(from, to), Ignore(ignore)
+        {
+            m_collisionFilterMask = mask;
+        }
+
+        bool needsCollision(btBroadphaseProxy* proxy) const override
+        {
+            return !Filtered(proxy, m_collisionFilterMask, Ignore);
+        }
+
+        entt::entity Ignore;
+    };
+
+    //runs the narrowphase cast against every leaf the ray touches
+    struct CastPolicy : public btDbvt::ICollide
+    {
+        const btTransform* From;
+        const btTransform* To;
+        const btConvexShape* Shape;
+        RayCallback* Ray;
+        SweepCallback* Sweep;
+
+        void Process(const btDbvtNode* leaf) override
+        {
+            btBroadphaseProxy* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+            btCollisionObject* obj = static_cast<btCollisionObject*>(proxy->m_clientObject);
+
+            if (Ray != nullptr)
+            {
+                if (Ray->needsCollision(proxy))
+                    btCollisionWorld::rayTestSingle(*From, *To, obj, obj->getCollisionShape(), obj->getWorldTransform(), *Ray);
+            }
+            else if (Sweep->needsCollision(proxy))
+            {
+                btCollisionWorld::objectQuerySingle(Shape, *From, *To, obj, obj->getCollisionShape(), obj->getWorldTransform(), *Sweep, 0.f);
+            }
+        }
+    };
+
+    //collects every leaf whose aabb overlaps the query
+    struct OverlapPolicy : public btDbvt::ICollide
+    {
+        btVector3 Min;
+        btVector3 Max;
+        int Mask;
+        entt::entity Ignore;
+        //optional exact test against the object's shape
+        const btVector3* SphereCenter = nullptr;
+        btScalar SphereRadius = 0.f;
+
+        entt::entity* Results;
+        int MaxResults;
+        int Count = 0;
+
+        void Process(const btDbvtNode* leaf) override
+        {
+            if (Count >= MaxResults)
+                return;
+
+            btBroadphaseProxy* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+            if (Filtered(proxy, Mask, Ignore))
+                return;
+            //leaf volumes in the dynamic tree are padded, so check the proxy's real aabb
+            if (!TestAabbAgainstAabb2(proxy->m_aabbMin, proxy->m_aabbMax, Min, Max))
+                return;
+
+            const btCollisionObject* obj = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+            if (SphereCenter != nullptr && !SphereOverlaps(obj->getCollisionShape(), obj->getWorldTransform()))
+                return;
+
+            Results[Count++] = SMI_Physics::getEntity(obj);
+        }
+
+        bool SphereOverlaps(const btCollisionShape* shape, const btTransform& trans) const;
+    };
+
+    //tests a sphere against the triangles of a concave shape
+    struct SphereTriangleCallback : public btTriangleCallback
+    {
+        btVector3 Center;
+        btScalar RadiusSquared;
+        bool Hit = false;
+
+        void processTriangle(btVector3* tri, int partId, int triangleIndex) override
+        {
+            if (Hit)
+                return;
+
+            //closest point on the triangle to the center (Ericson, Real-Time Collision Detection 5.1.5)
+            const btVector3& a = tri[0];
+            const btVector3& b = tri[1];
+            const btVector3& c = tri[2];
+            btVector3 ab = b - a, ac = c - a, ap = Center - a;
+            btVector3 closest;
+
+            btScalar d1 = ab.dot(ap), d2 = ac.dot(ap);
+            btVector3 bp = Center - b;
+            btScalar d3 = ab.dot(bp), d4 = ac.dot(bp);
+            btVector3 cp = Center - c;
+            btScalar d5 = ab.dot(cp), d6 = ac.dot(cp);
+            btScalar va = d3 * d6 - d5 * d4, vb = d5 * d2 - d1 * d6, vc = d1 * d4 - d3 * d2;
+
+            if (d1 <= 0.f && d2 <= 0.f)
+                closest = a;
+            else if (d3 >= 0.f && d4 <= d3)
+                closest = b;
+            else if (d6 >= 0.f && d5 <= d6)
+                closest = c;
+            else if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+                closest = a + ab * (d1 / (d1 - d3));
+            else if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+                closest = a + ac * (d2 / (d2 - d6));
+            else if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+                closest = b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+            else
+            {
+                btScalar denom = 1.f / (va + vb + vc);
+                closest = a + ab * (vb * denom) + ac * (vc * denom);
+            }
+
+            Hit = (closest - Center).length2() <= RadiusSquared;
+        }
+    };
+
+    bool OverlapPolicy::SphereOverlaps(const btCollisionShape* shape, const btTransform& trans) const
+    {
+        if (shape->isCompound())
+        {
+            const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+            for (int i = 0; i < compound->getNumChildShapes(); i++)
+            {
+                if (SphereOverlaps(compound->getChildShape(i), trans * compound->getChildTransform(i)))
+                    return true;
+            }
+            return false;
+        }
+
+        if (shape->isConcave())
+        {
+            SphereTriangleCallback callback;
+            callback.Center = trans.invXform(*SphereCenter);
+            callback.RadiusSquared = SphereRadius * SphereRadius;
+            btVector3 extent = btVector3(SphereRadius, SphereRadius, SphereRadius);
+            static_cast<const btConcaveShape*>(shape)->processAllTriangles(&callback, callback.Center - extent, callback.Center + extent);
+            return callback.Hit;
+        }
+
+        if (shape->isConvex())
+        {
+            btSphereShape sphere = btSphereShape(SphereRadius);
+            btVoronoiSimplexSolver simplex;
+            btGjkEpaPenetrationDepthSolver penetration;
+            btGjkPairDetector gjk = btGjkPairDetector(&sphere, static_cast<const btConvexShape*>(shape), &simplex, &penetration);
+
+            btGjkPairDetector::ClosestPointInput input;
+            input.m_transformA.setIdentity();
+            input.m_transformA.setOrigin(*SphereCenter);
+            input.m_transformB = trans;
+
+            btPointCollector output;
+            gjk.getClosestPoints(input, output, nullptr);
+            return output.m_hasResult && output.m_distance <= 0.f;
+        }
+
+        //anything else only gets the aabb test
+        return true;
+    }
+}
+
+SMI_SpatialQuery::SMI_SpatialQuery(btCollisionWorld* world)
+{
+    setWorld(world);
+}
+
+void SMI_SpatialQuery::setWorld(btCollisionWorld* world)
+{
+    World = world;
+    //scenes always build a dbvt broadphase
+    Broadphase = world != nullptr ? static_cast<btDbvtBroadphase*>(world->getBroadphase()) : nullptr;
+}
+
+bool SMI_SpatialQuery::Raycast(const glm::vec3& from, const glm::vec3& to, SMI_RayHit& hit, int mask, entt::entity ignore) const
+{
+    SMI_CastQuery query;
+    query.From = from;
+    query.To = to;
+    query.Mask = mask;
+    query.Ignore = ignore;
+    return Cast(query, hit);
+}
+
+bool SMI_SpatialQuery::SphereCast(const glm::vec3& from, const glm::vec3& to, float radius, SMI_RayHit& hit, int mask, entt::entity ignore) const
+{
+    SMI_CastQuery query;
+    query.From = from;
+    query.To = to;
+    query.Radius = radius;
+    query.Mask = mask;
+    query.Ignore = ignore;
+    return Cast(query, hit);
+}
+
+bool SMI_SpatialQuery::Cast(const SMI_CastQuery& query, SMI_RayHit& hit) const
+{
+    hit = SMI_RayHit();
+
+    btVector3 from = ToBt(query.From);
+    btVector3 to = ToBt(query.To);
+    btVector3 dir = to - from;
+    btScalar length = dir.length();
+    if (length < SIMD_EPSILON)
+        return false;
+    dir /= length;
+
+    //same setup btDbvtBroadphase::rayTest uses
+    btVector3 dirInverse;
+    dirInverse[0] = dir[0] == 0.f ? btScalar(BT_LARGE_FLOAT) : 1.f / dir[0];
+    dirInverse[1] = dir[1] == 0.f ? btScalar(BT_LARGE_FLOAT) : 1.f / dir[1];
+    dirInverse[2] = dir[2] == 0.f ? btScalar(BT_LARGE_FLOAT) : 1.f / dir[2];
+    unsigned int signs[3] = { dirInverse[0] < 0.f, dirInverse[1] < 0.f, dirInverse[2] < 0.f };
+
+    btTransform fromTrans, toTrans;
+    fromTrans.setIdentity();
+    fromTrans.setOrigin(from);
+    toTrans.setIdentity();
+    toTrans.setOrigin(to);
+
+    btSphereShape sphere = btSphereShape(query.Radius);
+    RayCallback ray = RayCallback(from, to, query.Mask, query.Ignore);
+    SweepCallback sweep = SweepCallback(from, to, query.Mask, query.Ignore);
+
+    CastPolicy policy;
+    policy.From = &fromTrans;
+    policy.To = &toTrans;
+    policy.Shape = &sphere;
+    policy.Ray = query.Radius > 0.f ? nullptr : &ray;
+    policy.Sweep = &sweep;
+
+    //sphere casts grow the node bounds by the radius
+    btVector3 extent = btVector3(query.Radius, query.Radius, query.Radius);
+    for (int i = 0; i < 2; i++)
+    {
+        Broadphase->m_sets[i].rayTestInternal(Broadphase->m_sets[i].m_root, from, to, dirInverse, signs, length,
+            -extent, extent, QueryStack, policy);
+    }
+
+    if (policy.Ray != nullptr)
+    {
+        if (!ray.hasHit())
+            return false;
+
+        hit.Entity = SMI_Physics::getEntity(ray.m_collisionObject);
+        hit.Point = ToGlm(ray.m_hitPointWorld);
+        hit.Normal = ToGlm(ray.m_hitNormalWorld);
+        hit.Fraction = ray.m_closestHitFraction;
+    }
+    else
+    {
+        if (!sweep.hasHit())
+            return false;
+
+        hit.Entity = SMI_Physics::getEntity(sweep.m_hitCollisionObject);
+        hit.Point = ToGlm(sweep.m_hitPointWorld);
+        hit.Normal = ToGlm(sweep.m_hitNormalWorld);
+        hit.Fraction = sweep.m_closestHitFraction;
+    }
+
+    return true;
+}
+
+int SMI_SpatialQuery::OverlapAabb(const glm::vec3& min, const glm::vec3& max, entt::entity* results, int maxResults, int mask) const
+{
+    OverlapPolicy policy;
+    policy.Min = ToBt(min);
+    policy.Max = ToBt(max);
+    policy.Mask = mask;
+    policy.Ignore = entt::null;
+    policy.Results = results;
+    policy.MaxResults = maxResults;
+
+    btDbvtVolume volume = btDbvtVolume::FromMM(policy.Min, policy.Max);
+    for (int i = 0; i < 2; i++)
+        Broadphase->m_sets[i].collideTVNoStackAlloc(Broadphase->m_sets[i].m_root, volume, QueryStack, policy);
+
+    return policy.Count;
+}
+
+int SMI_SpatialQuery::OverlapSphere(const SMI_OverlapQuery& query, entt::entity* results, int maxResults) const
+{
+    btVector3 center = ToBt(query.Center);
+    btVector3 extent = btVector3(query.Radius, query.Radius, query.Radius);
+
+    OverlapPolicy policy;
+    policy.Min = center - extent;
+    policy.Max = center + extent;
+    policy.Mask = query.Mask;
+    policy.Ignore = query.Ignore;
+    policy.SphereCenter = &center;
+    policy.SphereRadius = query.Radius;
+    policy.Results = results;
+    policy.MaxResults = maxResults;
+
+    btDbvtVolume volume = btDbvtVolume::FromMM(policy.Min, policy.Max);
+    for (int i = 0; i < 2; i++)
+        Broadphase->m_sets[i].collideTVNoStackAlloc(Broadphase->m_sets[i].m_root, volume, QueryStack, policy);
+
+    return policy.Count;
+}
+
+void SMI_SpatialQuery::CastBatch(const SMI_CastQuery* queries, SMI_RayHit* hits, int count) const
+{
+    SMI_TaskScheduler::Get()->getPool().ParallelFor(0, count, BatchGrain, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+            Cast(queries[i], hits[i]);
+    });
+}
+
+void SMI_SpatialQuery::OverlapSphereBatch(const SMI_OverlapQuery* queries, int count, entt::entity* results, int maxPerQuery, int* counts) const
+{
+    SMI_TaskScheduler::Get()->getPool().ParallelFor(0, count, BatchGrain, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+            counts[i] = OverlapSphere(queries[i], results + static_cast<size_t>(i) * maxPerQuery, maxPerQuery);
+    });
+}
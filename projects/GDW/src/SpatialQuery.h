@@ -0,0 +1,72 @@
+#pragma once
+#include "GLM/glm.hpp"
+#include "entt.hpp"
+#include "btBulletDynamicsCommon.h"
+
+//closest hit from a ray or sphere cast
+struct SMI_RayHit
+{
+	entt::entity Entity = entt::null;
+	glm::vec3 Point = glm::vec3(0.f);
+	glm::vec3 Normal = glm::vec3(0.f);
+	//how far along the cast the hit was, 0 is the start and 1 is the end
+	float Fraction = 1.f;
+
+	bool Hit() const { return Entity != entt::null; }
+};
+
+//a ray (Radius 0) or sphere cast, used by the batch functions
+struct SMI_CastQuery
+{
+	glm::vec3 From = glm::vec3(0.f);
+	glm::vec3 To = glm::vec3(0.f);
+	float Radius = 0.f;
+	//collision groups the cast can hit
+	int Mask = btBroadphaseProxy::AllFilter;
+	//entity the cast ignores, ex: the agent doing a line of sight check
+	entt::entity Ignore = entt::null;
+};
+
+//a sphere overlap, used by the batch functions
+struct SMI_OverlapQuery
+{
+	glm::vec3 Center = glm::vec3(0.f);
+	float Radius = 0.f;
+	int Mask = btBroadphaseProxy::AllFilter;
+	entt::entity Ignore = entt::null;
+};
+
+//runs queries against a world's dbvt broadphase, keeping its own traversal stacks per thread
+//so any number of queries can run at once, as long as the world isn't being stepped at the same time
+class SMI_SpatialQuery
+{
+public:
+	SMI_SpatialQuery(btCollisionWorld* world = nullptr);
+
+	void setWorld(btCollisionWorld* world);
+
+	//single queries, return true on a hit
+	bool Raycast(const glm::vec3& from, const glm::vec3& to, SMI_RayHit& hit,
+		int mask = btBroadphaseProxy::AllFilter, entt::entity ignore = entt::null) const;
+	bool SphereCast(const glm::vec3& from, const glm::vec3& to, float radius, SMI_RayHit& hit,
+		int mask = btBroadphaseProxy::AllFilter, entt::entity ignore = entt::null) const;
+	//runs a ray cast for Radius 0, otherwise a sphere cast
+	bool Cast(const SMI_CastQuery& query, SMI_RayHit& hit) const;
+
+	//overlaps write up to maxResults entities and return how many were written
+	int OverlapAabb(const glm::vec3& min, const glm::vec3& max, entt::entity* results, int maxResults,
+		int mask = btBroadphaseProxy::AllFilter) const;
+	int OverlapSphere(const SMI_OverlapQuery& query, entt::entity* results, int maxResults) const;
+
+	//batch queries split across the thread pool, hits[i] is the result of queries[i]
+	void CastBatch(const SMI_CastQuery* queries, SMI_RayHit* hits, int count) const;
+	//query i writes up to maxPerQuery entities starting at results[i * maxPerQuery], and how many into counts[i]
+	void OverlapSphereBatch(const SMI_OverlapQuery* queries, int count, entt::entity* results, int maxPerQuery, int* counts) const;
+
+private:
+	btCollisionWorld* World;
+	btDbvtBroadphase* Broadphase;
+
+	//queries handed to each pool task at once
+	static const int BatchGrain = 16;
+};
@@ -0,0 +1,52 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <mutex>
+
+SMI_TaskScheduler* SMI_TaskScheduler::Get()
+{
+    if (Instance == nullptr)
+    {
+        Instance = std::make_unique<SMI_TaskScheduler>();
+        //has to be set before any of the multithreaded bullet classes are made
+        btSetTaskScheduler(Instance.get());
+    }
+
+    return Instance.get();
+}
+
+SMI_TaskScheduler::SMI_TaskScheduler(int numThreads) :
+    btITaskScheduler("SMI_ThreadPool"),
+    Pool(std::min(numThreads <= 0 ? ThreadPool::GetHardwareThreads() : numThreads, static_cast<int>(BT_MAX_THREAD_COUNT)))
+{
+    MaxThreads = std::min(std::max(numThreads, ThreadPool::GetHardwareThreads()), static_cast<int>(BT_MAX_THREAD_COUNT));
+}
+
+void SMI_TaskScheduler::setNumThreads(int numThreads)
+{
+    if (numThreads <= 0)
+        numThreads = ThreadPool::GetHardwareThreads();
+
+    Pool.SetNumThreads(std::min(numThreads, MaxThreads));
+}
+
+void SMI_TaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+{
+    Pool.ParallelFor(iBegin, iEnd, grainSize, [&body](int chunkBegin, int chunkEnd) {
+        body.forLoop(chunkBegin, chunkEnd);
+    });
+}
+
+btScalar SMI_TaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body)
+{
+    btScalar sum = btScalar(0);
+    std::mutex sumMutex;
+
+    Pool.ParallelFor(iBegin, iEnd, grainSize, [&](int chunkBegin, int chunkEnd) {
+        btScalar partial = body.sumLoop(chunkBegin, chunkEnd);
+
+        std::lock_guard<std::mutex> lock(sumMutex);
+        sum += partial;
+    });
+
+    return sum;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "ThreadPool.h"
+#include "LinearMath/btThreads.h"
+#include <memory>
+
+//bullet task scheduler that runs bullet's parallel loops on our thread pool
+//note: bullet only splits work across threads when its libraries are built with BT_THREADSAFE
+class SMI_TaskScheduler : public btITaskScheduler
+{
+public:
+	//gets the shared scheduler, creating it and handing it to bullet on first use
+	static SMI_TaskScheduler* Get();
+
+	SMI_TaskScheduler(int numThreads = 0);
+	virtual ~SMI_TaskScheduler() = default;
+
+	//btITaskScheduler interface
+	int getMaxNumThreads() const override { return MaxThreads; }
+	int getNumThreads() const override { return Pool.GetNumThreads(); }
+	void setNumThreads(int numThreads) override;
+	void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+	btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+	//the pool the scheduler runs on, can be shared by other systems between physics steps
+	ThreadPool& getPool() { return Pool; }
+
+private:
+	ThreadPool Pool;
+	//most threads setNumThreads will give the pool, the hardware threads (or more if asked for up front)
+	//capped to what bullet can track
+	int MaxThreads;
+
+	inline static std::unique_ptr<SMI_TaskScheduler> Instance = nullptr;
+};
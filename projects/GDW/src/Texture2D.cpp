@@ -1,6 +1,8 @@
 #include "Texture2D.h"
 #include <stb_image.h>
 #include <Logging.h>
+#include "Profiler.h"
+#include "RenderDevice.h"
 #include "GLM/glm.hpp"
 
 /// <summary>
@@ -29,21 +31,21 @@ Texture2D::Texture2D(const std::string& filePath) : ITexture(TextureType::_2D) {
 
 void Texture2D::SetMinFilter(MinFilter value) {
 	_description.MinificationFilter = value;
-	glTextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
+	IRenderDevice::Get()->TextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
 }
 
 void Texture2D::SetMagFilter(MagFilter value) {
 	_description.MagnificationFilter = value;
-	glTextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
+	IRenderDevice::Get()->TextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
 }
 
 void Texture2D::SetAnisoLevel(float value) {
 	if (value != _description.MaxAnisotropic) {
 		_description.MaxAnisotropic = glm::clamp(value, 1.0f, ITexture::GetLimits().MAX_ANISOTROPY);
-		glTextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
+		IRenderDevice::Get()->TextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
 
 		if (_description.GenerateMipMaps) {
-			glGenerateTextureMipmap(_handle);
+			IRenderDevice::Get()->GenerateMipmap(_handle);
 		}
 	}
 }
@@ -56,14 +58,14 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 	// Align the data store to the size of a single component to ensure we don't get weirdness with images that aren't RGBA
 	// See https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glPixelStore.xhtml
 	int componentSize = (GLint)GetTexelComponentSize(type);
-	glPixelStorei(GL_PACK_ALIGNMENT, componentSize);
+	IRenderDevice::Get()->PixelStore(GL_PACK_ALIGNMENT, componentSize);
 
 	// Upload our data to our image
-	glTextureSubImage2D(_handle, 0, offsetX, offsetY, width, height, (GLenum)format, (GLenum)type, data);
+	IRenderDevice::Get()->TextureSubImage2D(_handle, 0, offsetX, offsetY, width, height, (GLenum)format, (GLenum)type, data);
 
 	// If requested, generate mip-maps for our texture
 	if (_description.GenerateMipMaps) {
-		glGenerateTextureMipmap(_handle);
+		IRenderDevice::Get()->GenerateMipmap(_handle);
 	}
 }
 
@@ -71,51 +73,37 @@ void Texture2D::_LoadDataFromFile() {
 	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
 	if (!_description.Filename.empty()) {
-		// Variables that will store properties about our image
-		int width, height, numChannels;
-		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
-
-		// Use STBI to load the image
-		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
-
-		// If we could not load any data, warn and return null
-		if (data == nullptr) {
-			LOG_WARN("STBI Failed to load image from \"{}\"", _description.Filename);
-			return ;
+		Texture2DImage image;
+		if (LoadImageFromFile(_description.Filename, image, _description.FormatHint)) {
+			_LoadImage(image);
 		}
+	}
+}
 
-		// We should estimate a good format for our data
-
-		// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
-		if (targetChannels != 0)
-			numChannels = targetChannels;
-
-		// We'll determine a recommended format for the image based on number of channels
-		// We hinted that we wanted a certain number of channels, but we're not guaranteed
-		// that all those channels exist (ex: loading an RGB image but requesting RGBA)
-		InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
-		PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
+void Texture2D::_LoadImage(const Texture2DImage& image) {
+	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
-		// This is one of those poorly documented things in OpenGL
-		if ((numChannels * width) % 4 != 0) {
-			LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
-		}
+	// We'll determine a recommended format for the image based on number of channels
+	// We hinted that we wanted a certain number of channels, but we're not guaranteed
+	// that all those channels exist (ex: loading an RGB image but requesting RGBA)
+	InternalFormat internal_format = GetInternalFormatForChannels8(image.Channels);
+	PixelFormat    image_format = GetPixelFormatForChannels(image.Channels);
 
-		// Update our description to match what we loaded
-		_description.Format = internal_format;
-		_description.Width = width;
-		_description.Height = height;
+	// This is one of those poorly documented things in OpenGL
+	if ((image.Channels * image.Width) % 4 != 0) {
+		LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
+	}
 
-		// Allocates our memory
-		_SetTextureParams();
+	// Update our description to match what we loaded
+	_description.Format = internal_format;
+	_description.Width = image.Width;
+	_description.Height = image.Height;
 
-		// Upload data to our texture
-		LoadData(width, height, image_format, PixelType::UByte, data);
+	// Allocates our memory
+	_SetTextureParams();
 
-		// We now have data in the image, we can clear the STBI data
-		stbi_image_free(data);
-	}
+	// Upload data to our texture
+	LoadData(image.Width, image.Height, image_format, PixelType::UByte, (void*)image.Pixels.data());
 }
 
 void Texture2D::_SetTextureParams() {
@@ -129,13 +117,14 @@ void Texture2D::_SetTextureParams() {
 		// Calculate how many layers of storage to allocate based on whether mipmaps are enabled or not
 		int layers = _description.GenerateMipMaps ? CalcRequiredMipLevels(_description.Width, _description.Height) : 1;
 		// Allocates the memory for our texture
-		glTextureStorage2D(_handle, layers, (GLenum)_description.Format, _description.Width, _description.Height);
-
-		glTextureParameteri(_handle, GL_TEXTURE_WRAP_S, (GLenum)_description.HorizontalWrap);
-		glTextureParameteri(_handle, GL_TEXTURE_WRAP_T, (GLenum)_description.VerticalWrap);
-		glTextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, (GLenum)_description.MinificationFilter);
-		glTextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, (GLenum)_description.MagnificationFilter);
-		glTextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
+		IRenderDevice* device = IRenderDevice::Get();
+		device->TextureStorage2D(_handle, layers, (GLenum)_description.Format, _description.Width, _description.Height);
+
+		device->TextureParameteri(_handle, GL_TEXTURE_WRAP_S, (GLenum)_description.HorizontalWrap);
+		device->TextureParameteri(_handle, GL_TEXTURE_WRAP_T, (GLenum)_description.VerticalWrap);
+		device->TextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, (GLenum)_description.MinificationFilter);
+		device->TextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, (GLenum)_description.MagnificationFilter);
+		device->TextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
 	}
 }
 
@@ -148,4 +137,49 @@ Texture2D::Sptr Texture2D::LoadFromFile(const std::string& path, const Texture2D
 	Texture2D::Sptr result = std::make_shared<Texture2D>(desc);
 
 	return result;
-}
\ No newline at end of file
+}
+
+bool Texture2D::LoadImageFromFile(const std::string& path, Texture2DImage& image, PixelFormat formatHint) {
+	SMI_PROFILE_CPU("Decode texture");
+
+	// Variables that will store properties about our image
+	int width, height, numChannels;
+	const int targetChannels = GetTexelComponentCount(formatHint);
+
+	// Use STBI to load the image
+	// The flip flag is global to STBI, every load sets it to the same value so worker threads can share it
+	stbi_set_flip_vertically_on_load(true);
+	uint8_t* data = stbi_load(path.c_str(), &width, &height, &numChannels, targetChannels);
+
+	// If we could not load any data, warn and return
+	if (data == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", path);
+		return false;
+	}
+
+	// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
+	if (targetChannels != 0)
+		numChannels = targetChannels;
+
+	image.Filename = path;
+	image.Width = width;
+	image.Height = height;
+	image.Channels = numChannels;
+	image.Pixels.assign(data, data + (size_t)width * height * numChannels);
+
+	// We have our own copy of the data, we can clear the STBI data
+	stbi_image_free(data);
+	return true;
+}
+
+Texture2D::Sptr Texture2D::CreateFromImage(const Texture2DImage& image, const Texture2DDescription& description) {
+	// Clear the filename so the constructor doesn't try to load it
+	Texture2DDescription desc = description;
+	desc.Filename = "";
+
+	Texture2D::Sptr result = std::make_shared<Texture2D>(desc);
+	result->_description.Filename = image.Filename;
+	result->_LoadImage(image);
+
+	return result;
+}
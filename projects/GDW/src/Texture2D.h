@@ -1,5 +1,6 @@
 #pragma once
 #include "ITexture.h"
+#include <vector>
 
 /// <summary>
 /// Describes all parameters we can manipulate with our 2D Textures
@@ -70,6 +71,27 @@ struct Texture2DDescription {
 	{ }
 };
 
+/// <summary>
+/// An image decoded on the CPU, this can be loaded on any thread and uploaded to a texture later
+/// </summary>
+struct Texture2DImage {
+	/// <summary>
+	/// The path the image was loaded from
+	/// </summary>
+	std::string          Filename;
+	int                  Width;
+	int                  Height;
+	/// <summary>
+	/// The number of 8 bit channels per pixel in Pixels
+	/// </summary>
+	int                  Channels;
+	std::vector<uint8_t> Pixels;
+
+	Texture2DImage() :
+		Filename(""), Width(0), Height(0), Channels(0)
+	{ }
+};
+
 class Texture2D : public ITexture {
 public:
 	typedef std::shared_ptr<Texture2D> Sptr;
@@ -155,10 +177,28 @@ protected:
 	/// </summary>
 	void _LoadDataFromFile();
 	/// <summary>
+	/// Allocates our texture's memory and uploads a decoded image into it
+	/// Will overwrite description size and format
+	/// </summary>
+	void _LoadImage(const Texture2DImage& image);
+	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
 	void _SetTextureParams();
 
 public:
 	static Texture2D::Sptr LoadFromFile(const std::string& path, const Texture2DDescription& description = Texture2DDescription(), bool forceRgba = true);
+
+	/// <summary>
+	/// Decodes an image file without touching OpenGL, so it is safe to call from a worker thread
+	/// </summary>
+	/// <param name="path">The path of the image file</param>
+	/// <param name="image">The image to load into</param>
+	/// <param name="formatHint">Determines the number of channels to load</param>
+	/// <returns>True if the image was loaded</returns>
+	static bool LoadImageFromFile(const std::string& path, Texture2DImage& image, PixelFormat formatHint = PixelFormat::RGBA);
+	/// <summary>
+	/// Creates a texture from an image decoded with LoadImageFromFile, must be called on the thread that owns the GL context
+	/// </summary>
+	static Texture2D::Sptr CreateFromImage(const Texture2DImage& image, const Texture2DDescription& description = Texture2DDescription());
 };
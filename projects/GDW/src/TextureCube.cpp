@@ -1,4 +1,5 @@
 #include "TextureCube.h"
+#include "RenderDevice.h"
 #include <filesystem>
 #include "stb_image.h"
 
@@ -134,10 +135,10 @@ void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>
 	_SetTextureParams();
 
 	// Set our pixel alignment to a single byte so we don't get banding
-	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	IRenderDevice::Get()->PixelStore(GL_PACK_ALIGNMENT, 1);
 
 	// Upload our data to our image (note that the custom enum tools let us convert to base type [GLenum] with the * operator)
-	glTextureSubImage3D(_handle, 0, 0, 0, 0, _description.Size, _description.Size, 6, *_description.FormatHint, *PixelType::UByte, datastore);
+	IRenderDevice::Get()->TextureSubImage3D(_handle, 0, 0, 0, 0, _description.Size, _description.Size, 6, *_description.FormatHint, *PixelType::UByte, datastore);
 	delete[] datastore;
 }
 
@@ -145,12 +146,13 @@ void TextureCube::_SetTextureParams(){
 	// Make sure the size is greater than zero and that we have a format specified before trying to set parameters
 	if (_description.Size > 0 && _description.Format != InternalFormat::Unknown) {
 		// Allocates the memory for our texture
-		glTextureStorage2D(_handle, 1, (GLenum)_description.Format, _description.Size, _description.Size);
+		IRenderDevice* device = IRenderDevice::Get();
+		device->TextureStorage2D(_handle, 1, (GLenum)_description.Format, _description.Size, _description.Size);
 
 		// Set up our texture parameters
-		glTextureParameteri(_handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTextureParameteri(_handle, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, (GLenum)_description.MinificationFilter);
-		glTextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, (GLenum)_description.MagnificationFilter);
+		device->TextureParameteri(_handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		device->TextureParameteri(_handle, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		device->TextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, (GLenum)_description.MinificationFilter);
+		device->TextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, (GLenum)_description.MagnificationFilter);
 	}
 }
@@ -119,7 +119,7 @@ constexpr InternalFormat GetInternalFormatForChannels8(int numChannels) {
 		case 4:
 			return InternalFormat::RGBA8;
 		default:
-			LOG_WARN(false, "Unsupported texture format with {0} channels", numChannels);
+			LOG_WARN("Unsupported texture format with {0} channels", numChannels);
 			return InternalFormat::Unknown;
 	}
 }
@@ -134,7 +134,7 @@ constexpr PixelFormat GetPixelFormatForChannels(int numChannels) {
 		case 4:
 			return PixelFormat::RGBA;
 		default:
-			LOG_WARN(false, "Unsupported texture format with {0} channels", numChannels);
+			LOG_WARN("Unsupported texture format with {0} channels", numChannels);
 			return PixelFormat::Unknown;
 	}
 }
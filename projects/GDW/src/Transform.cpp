@@ -79,6 +79,15 @@ glm::mat3 SMI_Transform::GetNormal() const
 
 void SMI_Transform::SetParent(SMI_Transform* parent)
 {
+	//If we had a parent before, remove this as a child from that object.
+	if (m_parent != nullptr)
+		m_parent->RemoveChild(this);
+
+	m_parent = parent;
+
+	//If we have a parent now, add this as a child to that object.
+	if (m_parent != nullptr)
+		m_parent->AddChild(this);
 }
 
 void SMI_Transform::FixedRotate(glm::vec3 _rot)
@@ -100,8 +109,17 @@ SMI_Transform::~SMI_Transform()
 
 void SMI_Transform::AddChild(SMI_Transform* child)
 {
+	m_children.push_back(child);
 }
 
 void SMI_Transform::RemoveChild(SMI_Transform* child)
 {
+	for (auto it = m_children.begin(); it != m_children.end(); ++it)
+	{
+		if (*it == child)
+		{
+			m_children.erase(it);
+			break;
+		}
+	}
 }
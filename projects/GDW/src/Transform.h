@@ -40,6 +40,8 @@ public:
 	void setScale(const glm::vec3 _Scale) { Scale = _Scale; RecomputeGlobal(); }
 	void setRot(const glm::quat _Rot) { Rot = _Rot; RecomputeGlobal(); }
 	void SetDegree(const glm::vec3 _Rot) { Rot = glm::quat(glm::radians(_Rot)); RecomputeGlobal(); }
+	//sets position and rotation together so the matrix is only recomputed once (used by physics)
+	void setPosRot(const glm::vec3 _Pos, const glm::quat _Rot) { Pos = _Pos; Rot = _Rot; RecomputeGlobal(); }
 
 	//getter functions
 	glm::vec3 getPos() const { return Pos; }
@@ -1,4 +1,5 @@
 #include "ObjLoader.h"
+#include "Profiler.h"
 
 #include <string>
 #include <sstream>
@@ -30,7 +31,8 @@ static inline void trim(std::string& s) {
 
 #pragma endregion 
 
-VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
+void ObjLoader::ParseFile(const std::string& filename, std::vector<glm::vec3>& positions, std::vector<glm::vec2>& uvs,
+	std::vector<glm::vec3>& nrml, std::vector<glm::ivec3>& vertecies)
 {
 	// Open our file in binary mode
 	std::ifstream file;
@@ -42,12 +44,6 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 	}
 
 	std::string line;
-	
-	// TODO: Load data from file
-	std::vector<glm::vec3> positions;
-	std::vector<glm::vec2> uvs;
-	std::vector<glm::vec3> nrml;
-	std::vector<glm::vec3> vertecies;
 
 	glm::vec3 vecData;
 	glm::ivec3 vertexIndicies;
@@ -96,9 +92,26 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 			}
 		}
 	}
+}
+
+VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
+{
+	return CreateVAO(LoadVertexDataFromFile(filename));
+}
+
+std::vector<VertexPosNormTexCol> ObjLoader::LoadVertexDataFromFile(const std::string& filename)
+{
+	SMI_PROFILE_CPU("Parse obj");
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> nrml;
+	std::vector<glm::ivec3> vertecies;
+
+	ParseFile(filename, positions, uvs, nrml, vertecies);
 
-	// TODO: Generate mesh from the data we loaded
 	std::vector<VertexPosNormTexCol> vertexData;
+	vertexData.reserve(vertecies.size());
 
 	for (int i = 0; i < vertecies.size(); i++)
 	{
@@ -114,6 +127,11 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 		vertexData.push_back(VertexPosNormTexCol(position, normal, uv, color));
 	}
 
+	return vertexData;
+}
+
+VertexArrayObject::Sptr ObjLoader::CreateVAO(const std::vector<VertexPosNormTexCol>& vertexData)
+{
 	// Create a vertex buffer and load all our vertex data
 	VertexBuffer::Sptr vertexBuffer = VertexBuffer::Create();
 	vertexBuffer->LoadData(vertexData.data(), vertexData.size());
@@ -123,5 +141,23 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 	result->AddVertexBuffer(vertexBuffer, VertexPosNormTexCol::V_DECL);
 
 	return result;
-	//return VertexArrayObject::Create();
+}
+
+ObjMeshData ObjLoader::LoadMeshDataFromFile(const std::string& filename)
+{
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> nrml;
+	std::vector<glm::ivec3> vertecies;
+
+	ObjMeshData result;
+	ParseFile(filename, result.Positions, uvs, nrml, vertecies);
+
+	// Faces index straight into the position list, so we can keep them as an index buffer
+	result.Indices.reserve(vertecies.size());
+	for (const glm::ivec3& attribs : vertecies)
+	{
+		result.Indices.push_back(static_cast<uint32_t>(attribs.x));
+	}
+
+	return result;
 }
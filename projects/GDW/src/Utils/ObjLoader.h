@@ -3,12 +3,32 @@
 #include "MeshBuilder.h"
 #include "MeshFactory.h"
 
+//positions and triangle indices of a model, without any of the render attributes
+//used for building collision shapes from the same files as our meshes
+struct ObjMeshData
+{
+	std::vector<glm::vec3> Positions;
+	std::vector<uint32_t> Indices;
+};
+
 class ObjLoader
 {
 public:
 	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
 
+	//loads the render vertices of a model without touching OpenGL, safe to call from a worker thread
+	static std::vector<VertexPosNormTexCol> LoadVertexDataFromFile(const std::string& filename);
+	//uploads vertices from LoadVertexDataFromFile, must be called on the thread that owns the GL context
+	static VertexArrayObject::Sptr CreateVAO(const std::vector<VertexPosNormTexCol>& vertexData);
+
+	//loads only the positions and triangle indices of a model
+	static ObjMeshData LoadMeshDataFromFile(const std::string& filename);
+
 protected:
+	//reads the attributes and face indices (position, uv, normal) of an obj file
+	static void ParseFile(const std::string& filename, std::vector<glm::vec3>& positions, std::vector<glm::vec2>& uvs,
+		std::vector<glm::vec3>& nrml, std::vector<glm::ivec3>& vertecies);
+
 	ObjLoader() = default;
 	~ObjLoader() = default;
 };
\ No newline at end of file
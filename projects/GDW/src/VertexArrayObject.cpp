@@ -2,6 +2,7 @@
 #include "IndexBuffer.h"
 #include "VertexBuffer.h"
 #include "Logging.h"
+#include "RenderDevice.h"
 
 VertexArrayObject::VertexArrayObject() :
 	_indexBuffer(nullptr),
@@ -9,13 +10,13 @@ VertexArrayObject::VertexArrayObject() :
 	_vertexCount(0),
 	_vertexBuffers(std::vector<VertexBufferBinding>())
 {
-	glCreateVertexArrays(1, &_handle);
+	_handle = IRenderDevice::Get()->CreateVertexArray();
 }
 
 VertexArrayObject::~VertexArrayObject()
 {
 	if (_handle != 0) {
-		glDeleteVertexArrays(1, &_handle);
+		IRenderDevice::Get()->DeleteVertexArray(_handle);
 		_handle = 0;
 	}
 }
@@ -46,9 +47,8 @@ void VertexArrayObject::AddVertexBuffer(const VertexBuffer::Sptr& buffer, const
 	Bind();
 	buffer->Bind();
 	for (const BufferAttribute& attrib : attributes) {
-		glEnableVertexArrayAttrib(_handle, attrib.Slot);
-		glVertexAttribPointer(attrib.Slot, attrib.Size, (GLenum)attrib.Type, attrib.Normalized, attrib.Stride,
-							  (void*)attrib.Offset);
+		IRenderDevice::Get()->VertexAttribute(_handle, attrib.Slot, attrib.Size, (GLenum)attrib.Type, attrib.Normalized, attrib.Stride,
+											  attrib.Offset);
 	}
 	Unbind();
 }
@@ -56,17 +56,17 @@ void VertexArrayObject::AddVertexBuffer(const VertexBuffer::Sptr& buffer, const
 void VertexArrayObject::Draw(DrawMode mode) {
 	Bind();
 	if (_indexBuffer == nullptr) {
-		glDrawArrays((GLenum)mode, 0, _vertexCount);
+		IRenderDevice::Get()->DrawArrays((GLenum)mode, 0, _vertexCount);
 	} else {
-		glDrawElements((GLenum)mode, _indexBuffer->GetElementCount(), (GLenum)_indexBuffer->GetElementType(), nullptr);
+		IRenderDevice::Get()->DrawElements((GLenum)mode, _indexBuffer->GetElementCount(), (GLenum)_indexBuffer->GetElementType(), 0);
 	}
-	Unbind();
+	// We stay bound, so drawing this VAO again (or the next draw's bind) doesn't cost an extra call
 }
 
 void VertexArrayObject::Bind() {
-	glBindVertexArray(_handle);
+	IRenderDevice::Get()->BindVertexArray(_handle);
 }
 
 void VertexArrayObject::Unbind() {
-	glBindVertexArray(0);
+	IRenderDevice::Get()->BindVertexArray(0);
 }
@@ -4,6 +4,7 @@
 #include <GLM/gtc/matrix_transform.hpp>
 #include <GLM/gtc/type_ptr.hpp>
 #include <Logging.h>
+#include <TTK/Input.h>
 
 #include "IndexBuffer.h"
 #include "VertexBuffer.h"
@@ -13,8 +14,18 @@
 #include "Player.h"
 #include "Physics.h"
 #include "Scene.h"
+#include "PhysicsStressScene.h"
+#include "ProjectilePool.h"
+#include "LevelStreaming.h"
+#include "Profiler.h"
+#include "NullRenderDevice.h"
+#include "RecordingRenderDevice.h"
+#include "FrameCapture.h"
+#include "MicroBench.h"
+#include "EngineBenchmarks.h"
 #include "Texture2D.h"
 #include "TextureCube.h"
+#include "NOU/GLState.h"
 
 #include "Utils/MeshBuilder.h"
 #include "Utils/MeshFactory.h"
@@ -24,9 +35,19 @@
 #include <memory>
 #include <filesystem>
 #include <json.hpp>
+#include <imgui.h>
+#include <imgui_impl_glfw.h>
+#include <imgui_impl_opengl3.h>
 #include <fstream>
 #include <string>
 #include <iostream>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <map>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
 
 #define LOG_GL_NOTIFICATIONS
 
@@ -86,14 +107,17 @@ void GlfwWindowResizedCallback(GLFWwindow* window, int width, int height) {
 /// Handles intializing GLFW, should be called before initGLAD, but after Logger::Init()
 /// Also handles creating the GLFW window
 /// </summary>
+/// <param name="visible">False to keep the window hidden, for headless runs</param>
 /// <returns>True if GLFW was initialized, false if otherwise</returns>
-bool initGLFW() {
+bool initGLFW(bool visible = true) {
 	// Initialize GLFW
 	if (glfwInit() == GLFW_FALSE) {
 		LOG_ERROR("Failed to initialize GLFW");
 		return false;
 	}
 
+	glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+
 	//Create a new GLFW window and make it current
 	window = glfwCreateWindow(windowSize.x, windowSize.y, windowTitle.c_str(), nullptr, nullptr);
 	glfwMakeContextCurrent(window);
@@ -116,6 +140,25 @@ bool initGLAD() {
 	return true;
 }
 
+/// <summary>
+/// Sets up ImGui on our window, only used for the profiler overlay
+/// </summary>
+void initImGui() {
+	ImGui::CreateContext();
+	ImGui_ImplGlfw_InitForOpenGL(window, true);
+	ImGui_ImplOpenGL3_Init("#version 410");
+	ImGui::StyleColorsDark();
+}
+
+/// <summary>
+/// Shuts down ImGui, needs to happen while the GL context is still alive
+/// </summary>
+void shutdownImGui() {
+	ImGui_ImplOpenGL3_Shutdown();
+	ImGui_ImplGlfw_Shutdown();
+	ImGui::DestroyContext();
+}
+
 
 GLuint shader_program;
 
@@ -176,6 +219,43 @@ T Lerp(T a, T b, float t)
 }
 
 
+//static props in the level, these are streamed in and out in chunks along x as the camera moves
+//the solid ones (floors, crates and the like) get collision, merged into one body per chunk
+static const SMI_ChunkObject LevelProps[] = {
+	{ "Models/window1.obj", "Textures/BrownTex.1001.png", glm::vec3(-0.2, -6, 1), glm::vec3(90, -10, 90) },
+	{ "Models/window1.obj", "Textures/BrownTex.1001.png", glm::vec3(-10.2, -6, 1), glm::vec3(90, -10, 90) },
+	{ "Models/window1.obj", "Textures/BrownTex.1001.png", glm::vec3(-20.2, -6, 1), glm::vec3(90, -10, 90) },
+	{ "Models/window1.obj", "Textures/BrownTex.1001.png", glm::vec3(-39.8, -6, -3.7), glm::vec3(90, -10, 90) },
+	{ "Models/window1.obj", "Textures/BrownTex.1001.png", glm::vec3(-49.8, -6, -3.7), glm::vec3(90, -10, 90) },
+	{ "Models/window1.obj", "Textures/BrownTex.1001.png", glm::vec3(-60.8, -6, -3.7), glm::vec3(90, -10, 90) },
+	{ "Models/barrel1.obj", "Textures/Barrel.png", glm::vec3(-0.6, 0, 2.7), glm::vec3(0, 90, 0), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/Untitled.1001.png", glm::vec3(0.03, 0, -0.8), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/Untitled.1001.png", glm::vec3(-1.8, 0, -0.8), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/Untitled.1001.png", glm::vec3(-12.8, 0, -0.8), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/Untitled.1001.png", glm::vec3(-23.8, 0, -0.8), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/Untitled.1001.png", glm::vec3(-30.8, 0, -0.8), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/Crates1.obj", "Textures/box3.png", glm::vec3(-16.8, -2, 3.8), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/Crates1.obj", "Textures/box3.png", glm::vec3(-16.8, -2, 2.2), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/BrownTex.1001.png", glm::vec3(-45.8, 0, -5.6), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/shelf12.obj", "Textures/shelf.png", glm::vec3(-49.8, -1.2, -0.6), glm::vec3(0, 0, 0) },
+	{ "Models/cholder.obj", "Textures/Barrel.png", glm::vec3(-50.8, -2, 1.8), glm::vec3(90, 0, 90) },
+	{ "Models/nba1.obj", "Textures/BrownTex.1001.png", glm::vec3(-57.2, 0, -5.6), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/shelf12.obj", "Textures/shelf.png", glm::vec3(-59.8, 0, -2.6), glm::vec3(90, 0, 90) },
+	{ "Models/nba1.obj", "Textures/road.png", glm::vec3(-79.8, 0, 0.6), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/road.png", glm::vec3(-88.8, 0, 0.6), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/road.png", glm::vec3(-99.8, 0, 0.6), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/nba1.obj", "Textures/Road.png", glm::vec3(-129.8, 0, 0.6), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/building1.obj", "Textures/build.png", glm::vec3(-79.8, -6, 3.2), glm::vec3(90, 0, -90) },
+	{ "Models/building1.obj", "Textures/build.png", glm::vec3(-94.8, -6, 3.2), glm::vec3(90, 0, -90) },
+	{ "Models/build2.obj", "Textures/build2.png", glm::vec3(-87.8, -6, 3.2), glm::vec3(90, 0, 90) },
+	{ "Models/project.obj", "Textures/Table_Mat.png", glm::vec3(-3.6, 0, 3.4), glm::vec3(90, 0, 0) },
+	{ "Models/plank.obj", "Textures/platform.png", glm::vec3(-103.8, -1.6, 5.6), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/road block.obj", "Textures/road_bock.png", glm::vec3(-105.8, 1.2, 3.3), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/road block.obj", "Textures/road_bock.png", glm::vec3(-105.8, -1.2, 3.3), glm::vec3(90, 0, 90), glm::vec3(1.f), true },
+	{ "Models/bartable.obj", "Textures/BrownTex.1001.png", glm::vec3(-0.2, 0, 2.7), glm::vec3(90, 0, -90), glm::vec3(1.f), true },
+	{ "Models/garbage bin.obj", "Textures/bin.png", glm::vec3(-8.7, 0, 2.7), glm::vec3(90, 0, -90), glm::vec3(1.f), true },
+};
+
 class GameScene : public SMI_Scene
 {
 public:
@@ -193,10 +273,14 @@ public:
 		shader->Link();
 
 		// GL states, we'll enable depth testing and backface fulling
-		glEnable(GL_DEPTH_TEST);
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
-		glClearColor(0.2f, 0.2f, 0.5f, 1.0f);
+		IRenderDevice* device = IRenderDevice::Get();
+		device->Enable(GL_DEPTH_TEST);
+		device->Enable(GL_CULL_FACE);
+		device->CullFace(GL_BACK);
+		device->ClearColor(glm::vec4(0.2f, 0.2f, 0.5f, 1.0f));
+
+		//physics debug drawing, toggled with F3 during gameplay
+		setDebugDrawer(&PhysicsDebug);
 
 		// Get uniform location for the model view projection
 		Camera::Sptr camera = Camera::Create();
@@ -237,312 +321,28 @@ public:
 			AttachCopy(character, CharaPhys);
 		}
 
-		//creates object
-		VertexArrayObject::Sptr vao4 = ObjLoader::LoadFromFile("Models/window1.obj");
-		{
-			barrel = CreateEntity();
-
-			//create texture
-			Texture2D::Sptr window1Texture = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr BarrelMat = SMI_Material::Create();
-			BarrelMat->setShader(shader);
-
-			//set textures
-			BarrelMat->setTexture(window1Texture, 0);
-			//render
-			Renderer BarrelRend = Renderer(BarrelMat, vao4);
-			AttachCopy(barrel, BarrelRend);
-			//transform
-			SMI_Transform BarrelTrans = SMI_Transform();
-
-			BarrelTrans.setPos(glm::vec3(-0.2, -6, 1));
-
-			BarrelTrans.SetDegree(glm::vec3(90, -10, 90));
-			AttachCopy(barrel, BarrelTrans);
-		}
-		VertexArrayObject::Sptr win = ObjLoader::LoadFromFile("Models/window1.obj");
-		{
-			wa1 = CreateEntity();
-			//create texture
-			Texture2D::Sptr WinTexture = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr BarrelMa = SMI_Material::Create();
-
-
-			BarrelMa->setShader(shader);
-
-			//set textures
-			BarrelMa->setTexture(WinTexture, 0);
-			//render
-			Renderer BarrelRen = Renderer(BarrelMa, win);
-			AttachCopy(wa1, BarrelRen);
-			//transform
-			SMI_Transform winTrans1 = SMI_Transform();
-
-			winTrans1.setPos(glm::vec3(-10.2, -6, 1));
-
-			winTrans1.SetDegree(glm::vec3(90, -10, 90));
-			AttachCopy(wa1, winTrans1);
-		}
-		VertexArrayObject::Sptr win1 = ObjLoader::LoadFromFile("Models/window1.obj");
-		{
-			wa2 = CreateEntity();
-			Texture2D::Sptr window2Texture = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr BarrelM = SMI_Material::Create();
-			BarrelM->setShader(shader);
-
-			//set textures
-			BarrelM->setTexture(window2Texture, 0);
-			//render
-			Renderer BarrelRe = Renderer(BarrelM, win1);
-			AttachCopy(wa2, BarrelRe);
-			//transform
-			SMI_Transform winTrans = SMI_Transform();
-
-			winTrans.setPos(glm::vec3(-20.2, -6, 1));
-
-			winTrans.SetDegree(glm::vec3(90, -10, 90));
-			AttachCopy(wa2, winTrans);
-		}
-		VertexArrayObject::Sptr win2 = ObjLoader::LoadFromFile("Models/window1.obj");
-		{
-			wa3 = CreateEntity();
-
-			//create texture
-			Texture2D::Sptr Window3Texture = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr windowmat = SMI_Material::Create();
-			windowmat->setShader(shader);
-
-			//set textures
-			windowmat->setTexture(Window3Texture, 0);
-			//render
-			Renderer windowren = Renderer(windowmat, win2);
-			AttachCopy(wa3, windowren);
-			//transform
-			SMI_Transform windowTrans = SMI_Transform();
-
-			windowTrans.setPos(glm::vec3(-39.8, -6, -3.7));
-
-			windowTrans.SetDegree(glm::vec3(90, -10, 90));
-			AttachCopy(wa3, windowTrans);
-		}
-		VertexArrayObject::Sptr win3 = ObjLoader::LoadFromFile("Models/window1.obj");
-		{
-			wa3 = CreateEntity();
-
-			//create texture
-			Texture2D::Sptr win3Texture = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr windowmat1 = SMI_Material::Create();
-			windowmat1->setShader(shader);
-
-			//set textures
-			windowmat1->setTexture(win3Texture, 0);
-			//render
-			Renderer windowren1 = Renderer(windowmat1, win3);
-			AttachCopy(wa3, windowren1);
-			//transform
-			SMI_Transform windowTrans1 = SMI_Transform();
-
-			windowTrans1.setPos(glm::vec3(-49.8, -6, -3.7));
-
-			windowTrans1.SetDegree(glm::vec3(90, -10, 90));
-			AttachCopy(wa3, windowTrans1);
-		}
-		VertexArrayObject::Sptr win4 = ObjLoader::LoadFromFile("Models/window1.obj");
-		{
-			wa4 = CreateEntity();
-
-			//create texture
-			Texture2D::Sptr win5Texture = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr windowmat2 = SMI_Material::Create();
-			windowmat2->setShader(shader);
-
-			//set textures
-			windowmat2->setTexture(win5Texture, 0);
-			//render
-			Renderer windowren2 = Renderer(windowmat2, win4);
-			AttachCopy(wa4, windowren2);
-			//transform
-			SMI_Transform windowTrans2 = SMI_Transform();
-
-			windowTrans2.setPos(glm::vec3(-60.8, -6, -3.7));
-
-			windowTrans2.SetDegree(glm::vec3(90, -10, 90));
-			AttachCopy(wa4, windowTrans2);
-		}
-		VertexArrayObject::Sptr vao5 = ObjLoader::LoadFromFile("Models/barrel1.obj");
-		{
-
-			barrel1 = CreateEntity();
-
-			//create texture
-			Texture2D::Sptr BarrelTexture = Texture2D::Create("Textures/Barrel.png");
-
-			//material
-			SMI_Material::Sptr BarrelMat1 = SMI_Material::Create();
-			BarrelMat1->setShader(shader);
-
-			//set textures
-			BarrelMat1->setTexture(BarrelTexture, 0);
-
-			//render
-			Renderer BarrelRend1 = Renderer(BarrelMat1, vao5);
-			AttachCopy(barrel1, BarrelRend1);
-			//transform
-			SMI_Transform BarrelTrans1 = SMI_Transform();
-
-			BarrelTrans1.setPos(glm::vec3(-0.6, 0, 2.7));
-
-			BarrelTrans1.SetDegree(glm::vec3(0, 90, 0));
-			AttachCopy(barrel1, BarrelTrans1);
-		}
-
-
-		VertexArrayObject::Sptr vao6 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			barrel2 = CreateEntity();
-
-			Texture2D::Sptr floortex = Texture2D::Create("Textures/Untitled.1001.png");
-			//material
-			SMI_Material::Sptr BarrelMat2 = SMI_Material::Create();
-			BarrelMat2->setShader(shader);
-
-			//set textures
-			BarrelMat2->setTexture(floortex, 0);
-			//render
-			Renderer BarrelRend2 = Renderer(BarrelMat2, vao6);
-			AttachCopy(barrel2, BarrelRend2);
-			//transform
-			SMI_Transform BarrelTrans2 = SMI_Transform();
-
-			BarrelTrans2.setPos(glm::vec3(0.03, 0, -0.8));
-
-			BarrelTrans2.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(barrel2, BarrelTrans2);
-		}
-
-		VertexArrayObject::Sptr vao7 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			barrel3 = CreateEntity();
-
-			Texture2D::Sptr floor1Texture = Texture2D::Create("Textures/Untitled.1001.png");
-			//material
-			SMI_Material::Sptr BarrelMat3 = SMI_Material::Create();
-			BarrelMat3->setShader(shader);
-
-			//set textures
-			BarrelMat3->setTexture(floor1Texture, 0);
-			//render
-			Renderer BarrelRend3 = Renderer(BarrelMat3, vao7);
-			AttachCopy(barrel3, BarrelRend3);
-			//transform
-			SMI_Transform BarrelTrans3 = SMI_Transform();
-
-			BarrelTrans3.setPos(glm::vec3(-1.8, 0, -0.8));
-
-			BarrelTrans3.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(barrel3, BarrelTrans3);
-		}
-		VertexArrayObject::Sptr vao8 = ObjLoader::LoadFromFile("Models/nba1.obj");
+		//bullets, shot with F and recycled through a pool
 		{
+			MeshBuilder<VertexPosNormTexCol> BulletMesh;
+			MeshFactory::AddIcoSphere(BulletMesh, glm::vec3(0.f), 0.1f, 1);
 
-			barrel4 = CreateEntity();
-
-			Texture2D::Sptr window10Texture = Texture2D::Create("Textures/Untitled.1001.png");
-			//material
-			SMI_Material::Sptr BarrelMat4 = SMI_Material::Create();
-			BarrelMat4->setShader(shader);
-
-			//set textures
-			BarrelMat4->setTexture(window10Texture, 0);
-			//render
-			Renderer BarrelRend4 = Renderer(BarrelMat4, vao8);
-			AttachCopy(barrel4, BarrelRend4);
-			//transform
-			SMI_Transform BarrelTrans4 = SMI_Transform();
+			SMI_Material::Sptr BulletMat = SMI_Material::Create();
+			BulletMat->setShader(shader);
 
-			BarrelTrans4.setPos(glm::vec3(-12.8, 0, -0.8));
+			SMI_Prefab BulletPrefab;
+			BulletPrefab.setRenderer(Renderer(BulletMat, BulletMesh.Bake()));
+			BulletPrefab.setPhysics(SMI_ShapeCache::GetSphere(0.1f), SMI_PhysicsBodyType::DYNAMIC, 0.05f, false);
 
-			BarrelTrans4.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(barrel4, BarrelTrans4);
+			Bullets = std::make_unique<SMI_ProjectilePool>(*this, BulletPrefab, 64, 2.f);
 		}
-		VertexArrayObject::Sptr wall3 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			walls3 = CreateEntity();
 
-			Texture2D::Sptr wall3Texture = Texture2D::Create("Textures/Untitled.1001.png");
-			//material
-			SMI_Material::Sptr WallMat = SMI_Material::Create();
-			WallMat->setShader(shader);
+		//static props, everything near the camera is loaded now and the rest streams in during Update
+		Level = std::make_unique<SMI_LevelStreamer>(*this, shader);
+		for (const SMI_ChunkObject& prop : LevelProps)
+			Level->AddObject(prop);
+		Level->setSynchronous(SyncStreaming);
+		Level->LoadNow(camera->GetPosition().x);
 
-			//set textures
-			WallMat->setTexture(wall3Texture, 0);
-			//render
-			Renderer WallRend = Renderer(WallMat, wall3);
-			AttachCopy(walls3, WallRend);
-			//transform
-			SMI_Transform WallTrans = SMI_Transform();
-
-			WallTrans.setPos(glm::vec3(-23.8, 0, -0.8));
-
-			WallTrans.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(walls3, WallTrans);
-		}
-		VertexArrayObject::Sptr wall4 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			walls4 = CreateEntity();
-
-			Texture2D::Sptr window90Texture = Texture2D::Create("Textures/Untitled.1001.png");
-			//material
-			SMI_Material::Sptr WallMat1 = SMI_Material::Create();
-			WallMat1->setShader(shader);
-
-			//set textures
-			WallMat1->setTexture(window90Texture, 0);
-			//render
-			Renderer WallRend1 = Renderer(WallMat1, wall4);
-			AttachCopy(walls4, WallRend1);
-			//transform
-			SMI_Transform WallTrans1 = SMI_Transform();
-
-			WallTrans1.setPos(glm::vec3(-30.8, 0, -0.8));
-
-			WallTrans1.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(walls4, WallTrans1);
-		}
-
-		VertexArrayObject::Sptr crate = ObjLoader::LoadFromFile("Models/Crates1.obj");
-		{
-
-			crate1 = CreateEntity();
-
-			Texture2D::Sptr crateTex = Texture2D::Create("Textures/box3.png");
-			//material
-			SMI_Material::Sptr BarrelMat5 = SMI_Material::Create();
-			BarrelMat5->setShader(shader);
-
-			//set textures
-			BarrelMat5->setTexture(crateTex, 0);
-			//render
-			Renderer BarrelRend5 = Renderer(BarrelMat5, crate);
-			AttachCopy(crate1, BarrelRend5);
-			//transform
-			SMI_Transform BarrelTrans5 = SMI_Transform();
-
-			BarrelTrans5.setPos(glm::vec3(-16.8, -2, 3.8));
-
-			BarrelTrans5.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(crate1, BarrelTrans5);
-		}
 		VertexArrayObject::Sptr door = ObjLoader::LoadFromFile("Models/Door2.obj");
 		{
 
@@ -567,75 +367,6 @@ public:
 			AttachCopy(door1, BarrelTrans6);
 		}
 
-		VertexArrayObject::Sptr crate1 = ObjLoader::LoadFromFile("Models/Crates1.obj");
-		{
-
-			crate2 = CreateEntity();
-
-			Texture2D::Sptr crate1Texture = Texture2D::Create("Textures/box3.png");
-			//material
-			SMI_Material::Sptr BarrelMat5 = SMI_Material::Create();
-			BarrelMat5->setShader(shader);
-
-			//set textures
-			BarrelMat5->setTexture(crate1Texture, 0);
-			//render
-			Renderer BarrelRend5 = Renderer(BarrelMat5, crate1);
-			AttachCopy(crate2, BarrelRend5);
-			//transform
-			SMI_Transform BarrelTrans5 = SMI_Transform();
-
-			BarrelTrans5.setPos(glm::vec3(-16.8, -2, 2.2));
-
-			BarrelTrans5.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(crate2, BarrelTrans5);
-		}
-		VertexArrayObject::Sptr w = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			w1 = CreateEntity();
-
-			Texture2D::Sptr window1Texture6 = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr WallMat6 = SMI_Material::Create();
-			WallMat6->setShader(shader);
-
-			//set textures
-			WallMat6->setTexture(window1Texture6, 0);
-			//render
-			Renderer WallRend6 = Renderer(WallMat6, w);
-			AttachCopy(w1, WallRend6);
-			//transform
-			SMI_Transform WallTrans6 = SMI_Transform();
-
-			WallTrans6.setPos(glm::vec3(-45.8, 0, -5.6));
-
-			WallTrans6.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(w1, WallTrans6);
-		}
-		VertexArrayObject::Sptr shelf = ObjLoader::LoadFromFile("Models/shelf12.obj");
-		{
-
-			shelf1 = CreateEntity();
-
-			Texture2D::Sptr ShelfTex = Texture2D::Create("Textures/shelf.png");
-			//material
-			SMI_Material::Sptr WallMat7 = SMI_Material::Create();
-			WallMat7->setShader(shader);
-
-			//set textures
-			WallMat7->setTexture(ShelfTex, 0);
-			//render
-			Renderer WallRend7 = Renderer(WallMat7, shelf);
-			AttachCopy(shelf1, WallRend7);
-			//transform
-			SMI_Transform WallTrans7 = SMI_Transform();
-
-			WallTrans7.setPos(glm::vec3(-49.8, -1.2, -0.6));
-
-			WallTrans7.SetDegree(glm::vec3(0, 0, 0));
-			AttachCopy(shelf1, WallTrans7);
-		}
 		VertexArrayObject::Sptr fan = ObjLoader::LoadFromFile("Models/cfan1.obj");
 		{
 
@@ -659,144 +390,6 @@ public:
 			fanTrans.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(fan1, fanTrans);
 		}
-		VertexArrayObject::Sptr fanHolder = ObjLoader::LoadFromFile("Models/cholder.obj");
-		{
-
-			fanH = CreateEntity();
-
-			Texture2D::Sptr fanholderTexture = Texture2D::Create("Textures/Barrel.png");
-			//material
-			SMI_Material::Sptr fanmat1 = SMI_Material::Create();
-			fanmat1->setShader(shader);
-
-			//set textures
-			fanmat1->setTexture(fanholderTexture, 0);
-			//render
-			Renderer fanrend1 = Renderer(fanmat1, fanHolder);
-			AttachCopy(fanH, fanrend1);
-			//transform
-			SMI_Transform fanTrans1 = SMI_Transform();
-
-			fanTrans1.setPos(glm::vec3(-50.8, -2, 1.8));
-
-			fanTrans1.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(fanH, fanTrans1);
-		}
-		VertexArrayObject::Sptr wall5 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			walls5 = CreateEntity();
-
-			Texture2D::Sptr wall5Texture = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr WallMat10 = SMI_Material::Create();
-			WallMat10->setShader(shader);
-
-			//set textures
-			WallMat10->setTexture(wall5Texture, 0);
-			//render
-			Renderer WallRend10 = Renderer(WallMat10, wall5);
-			AttachCopy(walls5, WallRend10);
-			//transform
-			SMI_Transform WallTrans10 = SMI_Transform();
-
-			WallTrans10.setPos(glm::vec3(-57.2, 0, -5.6));
-
-			WallTrans10.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(walls5, WallTrans10);
-		}
-		VertexArrayObject::Sptr shelf1 = ObjLoader::LoadFromFile("Models/shelf12.obj");
-		{
-
-			shel = CreateEntity();
-
-			Texture2D::Sptr shelf10Texture = Texture2D::Create("Textures/shelf.png");
-			//material
-			SMI_Material::Sptr ShelfM = SMI_Material::Create();
-			ShelfM->setShader(shader);
-
-			//set textures
-			ShelfM->setTexture(shelf10Texture, 0);
-			//render
-			Renderer ShelfRen7 = Renderer(ShelfM, shelf1);
-			AttachCopy(shel, ShelfRen7);
-			//transform
-			SMI_Transform ShelfTrans7 = SMI_Transform();
-
-			ShelfTrans7.setPos(glm::vec3(-59.8, 0, -2.6));
-
-			ShelfTrans7.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(shel, ShelfTrans7);
-		}
-		VertexArrayObject::Sptr w3 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			f = CreateEntity();
-
-			Texture2D::Sptr w3tex = Texture2D::Create("Textures/road.png");
-			//material
-			SMI_Material::Sptr floormat2 = SMI_Material::Create();
-			floormat2->setShader(shader);
-
-			//set textures
-			floormat2->setTexture(w3tex, 0);
-			//render
-			Renderer WallRend6 = Renderer(floormat2, w3);
-			AttachCopy(f, WallRend6);
-			//transform
-			SMI_Transform floorTrans1 = SMI_Transform();
-
-			floorTrans1.setPos(glm::vec3(-79.8, 0, 0.6));
-
-			floorTrans1.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(f, floorTrans1);
-		}
-		VertexArrayObject::Sptr w4 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			f1 = CreateEntity();
-
-			Texture2D::Sptr w4tex = Texture2D::Create("Textures/road.png");
-			//material
-			SMI_Material::Sptr floormat3 = SMI_Material::Create();
-			floormat3->setShader(shader);
-
-			//set textures
-			floormat3->setTexture(w4tex, 0);
-			//render
-			Renderer WallRend7 = Renderer(floormat3, w4);
-			AttachCopy(f1, WallRend7);
-			//transform
-			SMI_Transform floorTrans2 = SMI_Transform();
-
-			floorTrans2.setPos(glm::vec3(-88.8, 0, 0.6));
-
-			floorTrans2.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(f1, floorTrans2);
-		}
-		VertexArrayObject::Sptr w5 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			f2 = CreateEntity();
-
-			Texture2D::Sptr w5Texture = Texture2D::Create("Textures/road.png");
-			//material
-			SMI_Material::Sptr floormat4 = SMI_Material::Create();
-			floormat4->setShader(shader);
-
-			//set textures
-			floormat4->setTexture(w5Texture, 0);
-			//render
-			Renderer WallRend13 = Renderer(floormat4, w5);
-			AttachCopy(f2, WallRend13);
-			//transform
-			SMI_Transform floorTrans4 = SMI_Transform();
-
-			floorTrans4.setPos(glm::vec3(-99.8, 0, 0.6));
-
-			floorTrans4.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(f2, floorTrans4);
-		}
 		VertexArrayObject::Sptr w6 = ObjLoader::LoadFromFile("Models/nba1.obj");
 		{
 
@@ -820,29 +413,6 @@ public:
 			floorTrans5.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(f3, floorTrans5);
 		}
-		VertexArrayObject::Sptr w7 = ObjLoader::LoadFromFile("Models/nba1.obj");
-		{
-
-			L_plat = CreateEntity();
-
-			Texture2D::Sptr w7Texture = Texture2D::Create("Textures/Road.png");
-			//material
-			SMI_Material::Sptr floormat90 = SMI_Material::Create();
-			floormat90->setShader(shader);
-
-			//set textures
-			floormat90->setTexture(w7Texture, 0);
-			//render
-			Renderer WallRend195 = Renderer(floormat90, w7);
-			AttachCopy(L_plat, WallRend195);
-			//transform
-			SMI_Transform floorTrans905 = SMI_Transform();
-
-			floorTrans905.setPos(glm::vec3(-129.8, 0, 0.6));
-
-			floorTrans905.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(L_plat, floorTrans905);
-		}
 		VertexArrayObject::Sptr cars = ObjLoader::LoadFromFile("Models/car.obj");
 		{
 
@@ -866,74 +436,6 @@ public:
 			carTrans.SetDegree(glm::vec3(90, 0, 90));
 			AttachCopy(car, carTrans);
 		}
-		VertexArrayObject::Sptr building1 = ObjLoader::LoadFromFile("Models/building1.obj");
-		{
-			build = CreateEntity();
-
-			Texture2D::Sptr build1Texture = Texture2D::Create("Textures/build.png");
-			//material
-			SMI_Material::Sptr buildM = SMI_Material::Create();
-			buildM->setShader(shader);
-
-			//set textures
-			buildM->setTexture(build1Texture, 0);
-			//render
-			Renderer buildRen7 = Renderer(buildM, building1);
-			AttachCopy(build, buildRen7);
-			//transform
-			SMI_Transform buildTrans = SMI_Transform();
-
-			buildTrans.setPos(glm::vec3(-79.8, -6, 3.2));
-
-			buildTrans.SetDegree(glm::vec3(90, 0, -90));
-			AttachCopy(build, buildTrans);
-		}
-		VertexArrayObject::Sptr building2 = ObjLoader::LoadFromFile("Models/building1.obj");
-		{
-
-			build2 = CreateEntity();
-
-			Texture2D::Sptr build2Texture = Texture2D::Create("Textures/build.png");
-			//material
-			SMI_Material::Sptr buildM1 = SMI_Material::Create();
-			buildM1->setShader(shader);
-
-			//set textures
-			buildM1->setTexture(build2Texture, 0);
-			//render
-			Renderer build1Ren7 = Renderer(buildM1, building2);
-			AttachCopy(build2, build1Ren7);
-			//transform
-			SMI_Transform buildTrans1 = SMI_Transform();
-
-			buildTrans1.setPos(glm::vec3(-94.8, -6, 3.2));
-
-			buildTrans1.SetDegree(glm::vec3(90, 0, -90));
-			AttachCopy(build2, buildTrans1);
-		}
-		VertexArrayObject::Sptr building3 = ObjLoader::LoadFromFile("Models/build2.obj");
-		{
-
-			build3 = CreateEntity();
-
-			Texture2D::Sptr build3Texture = Texture2D::Create("Textures/build2.png");
-			//material
-			SMI_Material::Sptr buildM12 = SMI_Material::Create();
-			buildM12->setShader(shader);
-
-			//set textures
-			buildM12->setTexture(build3Texture, 0);
-			//render
-			Renderer build1Ren71 = Renderer(buildM12, building3);
-			AttachCopy(build3, build1Ren71);
-			//transform
-			SMI_Transform buildTrans12 = SMI_Transform();
-
-			buildTrans12.setPos(glm::vec3(-87.8, -6, 3.2));
-
-			buildTrans12.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(build3, buildTrans12);
-		}
 		VertexArrayObject::Sptr elevator1 = ObjLoader::LoadFromFile("Models/elevator.obj");
 		{
 
@@ -957,150 +459,12 @@ public:
 			WallTrans3.SetDegree(glm::vec3(90, 0, 0));
 			AttachCopy(elevator12, WallTrans3);
 		}
-		VertexArrayObject::Sptr Table1 = ObjLoader::LoadFromFile("Models/project.obj");
-		{
-
-			table = CreateEntity();
-
-			Texture2D::Sptr elevatorTexture = Texture2D::Create("Textures/Table_Mat.png");
-			//material
-			SMI_Material::Sptr WallMat41 = SMI_Material::Create();
-			WallMat41->setShader(shader);
-
-			//set textures
-			WallMat41->setTexture(elevatorTexture, 0);
-			//render
-			Renderer WallRend121 = Renderer(WallMat41, Table1);
-			AttachCopy(table, WallRend121);
-			//transform
-			SMI_Transform WallTrans31 = SMI_Transform();
-
-			WallTrans31.setPos(glm::vec3(-3.6, 0, 3.4));
-
-			WallTrans31.SetDegree(glm::vec3(90, 0, 0));
-			AttachCopy(table, WallTrans31);
-		}
-		VertexArrayObject::Sptr plank1 = ObjLoader::LoadFromFile("Models/plank.obj");
-		{
-
-			plank = CreateEntity();
-
-			Texture2D::Sptr plankTexture = Texture2D::Create("Textures/platform.png");
-			//material
-			SMI_Material::Sptr WallMat42 = SMI_Material::Create();
-			WallMat42->setShader(shader);
-
-			//set textures
-			WallMat42->setTexture(plankTexture, 0);
-			//render
-			Renderer WallRend120 = Renderer(WallMat42, plank1);
-			AttachCopy(plank, WallRend120);
-			//transform
-			SMI_Transform WallTrans35 = SMI_Transform();
-
-			WallTrans35.setPos(glm::vec3(-103.8, -1.6, 5.6));
-
-			WallTrans35.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(plank, WallTrans35);
-		}
-		VertexArrayObject::Sptr Roadblock = ObjLoader::LoadFromFile("Models/road block.obj");
-		{
-
-			roadb = CreateEntity();
-
-			Texture2D::Sptr roadbTexture = Texture2D::Create("Textures/road_bock.png");
-			//material
-			SMI_Material::Sptr lMat42 = SMI_Material::Create();
-			lMat42->setShader(shader);
-
-			//set textures
-			lMat42->setTexture(roadbTexture, 0);
-			//render
-			Renderer WallRend120 = Renderer(lMat42, Roadblock);
-			AttachCopy(roadb, WallRend120);
-			//transform
-			SMI_Transform WallTrans356 = SMI_Transform();
-
-			WallTrans356.setPos(glm::vec3(-105.8, 1.2, 3.3));
-
-			WallTrans356.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(roadb, WallTrans356);
-		}
-		VertexArrayObject::Sptr Roadblock1 = ObjLoader::LoadFromFile("Models/road block.obj");
-		{
-
-			roadb1 = CreateEntity();
-
-			Texture2D::Sptr roadbTexture1 = Texture2D::Create("Textures/road_bock.png");
-			//material
-			SMI_Material::Sptr lMat421 = SMI_Material::Create();
-			lMat421->setShader(shader);
-
-			//set textures
-			lMat421->setTexture(roadbTexture1, 0);
-			//render
-			Renderer WallRend1201 = Renderer(lMat421, Roadblock1);
-			AttachCopy(roadb1, WallRend1201);
-			//transform
-			SMI_Transform WallTrans3561 = SMI_Transform();
-
-			WallTrans3561.setPos(glm::vec3(-105.8, -1.2, 3.3));
-
-			WallTrans3561.SetDegree(glm::vec3(90, 0, 90));
-			AttachCopy(roadb1, WallTrans3561);
-		}
-		VertexArrayObject::Sptr bar = ObjLoader::LoadFromFile("Models/bartable.obj");
-		{
-			bartab = CreateEntity();
-			//create texture
-			Texture2D::Sptr WinTexture80 = Texture2D::Create("Textures/BrownTex.1001.png");
-			//material
-			SMI_Material::Sptr BarrelMa80 = SMI_Material::Create();
-
-
-			BarrelMa80->setShader(shader);
-
-			//set textures
-			BarrelMa80->setTexture(WinTexture80, 0);
-			//render
-			Renderer BarrelRen80 = Renderer(BarrelMa80, bar);
-			AttachCopy(bartab, BarrelRen80);
-			//transform
-			SMI_Transform winTrans180 = SMI_Transform();
-
-			winTrans180.setPos(glm::vec3(-0.2, 0, 2.7));
-
-			winTrans180.SetDegree(glm::vec3(90, 0, -90));
-			AttachCopy(bartab, winTrans180);
-		}
-		VertexArrayObject::Sptr garbage1 = ObjLoader::LoadFromFile("Models/garbage bin.obj");
-		{
-			garbage = CreateEntity();
-			//create texture
-			Texture2D::Sptr gTexture80 = Texture2D::Create("Textures/bin.png");
-			//material
-			SMI_Material::Sptr gMa80 = SMI_Material::Create();
-
-
-			gMa80->setShader(shader);
-
-			//set textures
-			gMa80->setTexture(gTexture80, 0);
-			//render
-			Renderer gRen80 = Renderer(gMa80, garbage1);
-			AttachCopy(garbage, gRen80);
-			//transform
-			SMI_Transform winTrans1801 = SMI_Transform();
-
-			winTrans1801.setPos(glm::vec3(-8.7, 0, 2.7));
-
-			winTrans1801.SetDegree(glm::vec3(90, 0, -90));
-			AttachCopy(garbage, winTrans1801);
-		}
 	}
 
 	void Update(float deltaTime)
 	{
+		SMI_PROFILE_CPU("Update");
+
 		//increment time
 		current += deltaTime;
 		c += deltaTime;
@@ -1120,24 +484,55 @@ public:
 		SMI_Physics& PlayerPhys = GetComponent<SMI_Physics>(character);
 		glm::vec3 NewCamPos = glm::vec3(PlayerPhys.GetPosition().x, camera->GetPosition().y, camera->GetPosition().z);
 		camera->SetPosition(NewCamPos);
+		Level->Update(NewCamPos.x);
 
 		//keyboard input
 		//move left
-		if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+		if (GetKey(GLFW_KEY_A) == GLFW_PRESS)
 		{
 			PlayerPhys.AddForce(glm::vec3(2.0, 0, 0));
+			Facing = 1.f;
 		}
 		//move right
-		if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+		if (GetKey(GLFW_KEY_D) == GLFW_PRESS)
 		{
 			PlayerPhys.AddForce(glm::vec3(-2, 0, 0));
+			Facing = -1.f;
 		}
 		//jump
-		if ((glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) && JumpState == GLFW_RELEASE)
+		if ((GetKey(GLFW_KEY_SPACE) == GLFW_PRESS) && JumpState == GLFW_RELEASE)
 		{
 			PlayerPhys.AddImpulse(glm::vec3(0, 0, 5));
 		}
-		JumpState = glfwGetKey(window, GLFW_KEY_SPACE);
+		JumpState = GetKey(GLFW_KEY_SPACE);
+
+		//shoot
+		if ((GetKey(GLFW_KEY_F) == GLFW_PRESS) && ShootState == GLFW_RELEASE)
+		{
+			Bullets->Spawn(PlayerPhys.GetPosition() + glm::vec3(Facing * 0.6f, 0, 0), glm::vec3(Facing * 15.f, 0, 0));
+		}
+		ShootState = GetKey(GLFW_KEY_F);
+
+		//bullets go back in the pool when they hit something other than the player
+		for (const SMI_CollisionEvent& event : getCollisions().getEvents())
+		{
+			if (event.type != SMI_CollisionEventType::BEGIN || event.Involves(character))
+				continue;
+
+			Bullets->Despawn(event.b1);
+			Bullets->Despawn(event.b2);
+		}
+		Bullets->Update(deltaTime);
+
+		//physics debug drawing
+		if ((GetKey(GLFW_KEY_F3) == GLFW_PRESS) && DebugState == GLFW_RELEASE)
+		{
+			PhysicsDebug.setEnabled(!PhysicsDebug.getEnabled());
+		}
+		DebugState = GetKey(GLFW_KEY_F3);
+		//only draw what's near the player
+		glm::vec3 PlayerPos = PlayerPhys.GetPosition();
+		PhysicsDebug.setRegion(PlayerPos - glm::vec3(30.f), PlayerPos + glm::vec3(30.f));
 
 		//rotation example
 		GetComponent<SMI_Transform>(fan1).FixedRotate(glm::vec3(0, 0, 30) * deltaTime * 8.0f);
@@ -1155,48 +550,31 @@ public:
 		SMI_Scene::Update(deltaTime);
 	}
 
+	void LogStats() const
+	{
+		Bullets->LogStats("bullets");
+		LOG_INFO("Level: {} of {} chunks loaded, {} entities, {} meshes and {} textures resident", Level->getLoadedChunkCount(),
+			Level->getChunkCount(), Level->getEntityCount(), Level->getResidentMeshCount(), Level->getResidentTextureCount());
+	}
+
+	//where Update reads keys from, the benchmark swaps in a script
+	void setKeySource(const std::function<int(int)>& source) { GetKey = source; }
+	//streams the level on the main thread, needs to be set before InitScene
+	void setSynchronousStreaming(bool synchronous) { SyncStreaming = synchronous; }
+
+	glm::vec3 getPlayerPosition() { return GetComponent<SMI_Physics>(character).GetPosition(); }
+
 	~GameScene() = default;
 
 private:
-	entt::entity barrel;
-	entt::entity barrel1;
-	entt::entity barrel2;
-	entt::entity barrel3;
-	entt::entity barrel4;
-	entt::entity crate1;
 	entt::entity door1;
-	entt::entity crate2;
-	entt::entity walls3;
-	entt::entity walls4;
 	entt::entity elevator1;
 	entt::entity elevator12;
-	entt::entity w1;
-	entt::entity shelf1;
 	entt::entity fan1;
-	entt::entity walls5;
-	entt::entity shel;
-	entt::entity fanH;
-	entt::entity f;
-	entt::entity f1;
-	entt::entity f2;
 	entt::entity f3;
 	entt::entity car;
-	entt::entity build;
-	entt::entity build2;
-	entt::entity build3;
 	entt::entity road1;
-	entt::entity wa1;
-	entt::entity wa2;
-	entt::entity wa3;
-	entt::entity wa4;
-	entt::entity bartab;
 	entt::entity chair;
-	entt::entity table;
-	entt::entity L_plat;
-	entt::entity plank;
-	entt::entity roadb;
-	entt::entity roadb1;
-	entt::entity garbage;
 	entt::entity character;
 
 	float max = 5;
@@ -1204,13 +582,529 @@ private:
 	float c = 0;
 
 	int JumpState = GLFW_RELEASE;
+	int DebugState = GLFW_RELEASE;
+	int ShootState = GLFW_RELEASE;
+	//direction the player last moved in along x
+	float Facing = -1.f;
+
+	std::unique_ptr<SMI_ProjectilePool> Bullets;
+	std::unique_ptr<SMI_LevelStreamer> Level;
+	bool SyncStreaming = false;
+
+	std::function<int(int)> GetKey = [](int key) { return glfwGetKey(window, key); };
+
+	SMI_PhysicsDebugDraw PhysicsDebug;
 };
 
+// Runs the physics stress scene at a range of thread counts and logs the step times, no window needed
+void RunPhysicsStress(int crateCount)
+{
+	SMI_PhysicsStressScene StressScene = SMI_PhysicsStressScene(crateCount);
+	StressScene.InitScene();
+
+	std::vector<int> threadCounts;
+	for (int threads = 1; threads <= ThreadPool::GetHardwareThreads(); threads *= 2)
+		threadCounts.push_back(threads);
+
+	StressScene.MeasureStepTimes(threadCounts);
+}
+
+// Times spawning count entities one at a time against spawning them from a prefab, and logs the cost per entity
+void RunInstantiateBench(int count)
+{
+	//no gl context here, the renderer only needs to be copied
+	SMI_Prefab prefab;
+	prefab.setRenderer(Renderer(SMI_Material::Create(), nullptr));
+
+	std::vector<SMI_Transform> transforms = std::vector<SMI_Transform>(count);
+	for (int i = 0; i < count; i++)
+		transforms[i].setPos(glm::vec3((i % 100) * 1.1f, (i / 100) * 1.1f, 0.f));
+
+	for (int withPhysics = 0; withPhysics < 2; withPhysics++)
+	{
+		if (withPhysics)
+			prefab.setPhysics(SMI_ShapeCache::GetBox(glm::vec3(0.5f)), SMI_PhysicsBodyType::DYNAMIC, 1.f);
+
+		//create + AttachCopy per entity
+		SMI_Scene OneByOne = SMI_Scene();
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < count; i++)
+		{
+			entt::entity entity = OneByOne.CreateEntity();
+			OneByOne.AttachCopy(entity, prefab.getRenderer());
+			OneByOne.AttachCopy(entity, transforms[i]);
+			if (withPhysics)
+				OneByOne.AttachCopy(entity, prefab.MakePhysics(transforms[i], entity));
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		float oneByOneNs = std::chrono::duration<float, std::nano>(end - start).count() / count;
+
+		//one Instantiate call
+		SMI_Scene Bulk = SMI_Scene();
+		start = std::chrono::high_resolution_clock::now();
+		Bulk.Instantiate(prefab, count, transforms.data());
+		end = std::chrono::high_resolution_clock::now();
+		float bulkNs = std::chrono::duration<float, std::nano>(end - start).count() / count;
+
+		LOG_INFO("Instantiate bench ({} entities, {}): AttachCopy {:.1f} ns per entity, Instantiate {:.1f} ns per entity",
+			count, withPhysics ? "with physics" : "no physics", oneByOneNs, bulkNs);
+	}
+}
+
+// Mean and percentiles of one system's per frame times
+nlohmann::json SummarizeTimes(std::vector<float> times)
+{
+	std::sort(times.begin(), times.end());
+
+	//nearest rank
+	auto percentile = [&times](float p) {
+		size_t rank = static_cast<size_t>(std::ceil(p * times.size()));
+		return times[std::max<size_t>(rank, 1) - 1];
+	};
+
+	float total = 0.f;
+	for (float ms : times)
+		total += ms;
+
+	return {
+		{"mean_ms", total / times.size()},
+		{"p50_ms", percentile(0.5f)},
+		{"p95_ms", percentile(0.95f)},
+		{"p99_ms", percentile(0.99f)},
+		{"max_ms", times.back()}
+	};
+}
+
+// Prints a benchmark's results, and writes them to outFile if there is one
+void WriteBenchResult(const nlohmann::json& result, const std::string& outFile)
+{
+	std::cout << result.dump(2) << std::endl;
+	if (!outFile.empty())
+	{
+		std::ofstream file = std::ofstream(outFile);
+		file << result.dump(2) << std::endl;
+		LOG_INFO("Wrote benchmark results to {}", outFile);
+	}
+}
+
+// Options for RunGameBench
+struct GameBenchSettings
+{
+	int Frames = 1000;
+	//false only runs Update
+	bool Render = true;
+	//renders through the null device, no window or gl driver needed
+	bool NullDevice = false;
+	//puts a recording device in front of the renderer and reports the command stream's size
+	bool Record = false;
+	//captures this frame to CaptureFile for --replay, -1 for none (needs Record)
+	int CaptureFrame = -1;
+	std::string CaptureFile = "bench_frame.smicap";
+	//where to write the json, empty for stdout only
+	std::string OutFile;
+};
+
+// Runs the game for a set number of frames with a fixed timestep and scripted input, and reports the
+// profiler's per system times as json (on stdout, and in OutFile if there is one)
+// The window is hidden, with render off the scene still needs the gl context for its assets but nothing is drawn
+// For a machine without a usable gpu, use the null device to time only the cpu side of rendering
+void RunGameBench(const GameBenchSettings& settings)
+{
+	const int frames = settings.Frames;
+	const bool render = settings.Render;
+
+	NullRenderDevice::Sptr nullDevice = nullptr;
+	if (settings.NullDevice) {
+		nullDevice = NullRenderDevice::Create();
+		IRenderDevice::Set(nullDevice);
+		SMI_Profiler::setGpuTiming(false);
+	}
+	else {
+		if (!initGLFW(false) || !initGLAD())
+			return;
+		//don't wait on vsync
+		glfwSwapInterval(0);
+	}
+
+	RecordingRenderDevice::Sptr recorder = nullptr;
+	if (settings.Record) {
+		recorder = RecordingRenderDevice::Create(nullDevice != nullptr ? IRenderDevice::Sptr(nullDevice) : std::make_shared<GLRenderDevice>());
+		IRenderDevice::Set(recorder);
+	}
+
+	SMI_Profiler::setEnabled(true);
+
+	//holds right the whole run, jumps every 90 frames and shoots every 30
+	int frame = 0;
+	GameScene BenchScene = GameScene();
+	BenchScene.setSynchronousStreaming(true);
+	BenchScene.setKeySource([&frame](int key) {
+		bool pressed = key == GLFW_KEY_D ||
+			(key == GLFW_KEY_SPACE && frame % 90 == 0) ||
+			(key == GLFW_KEY_F && frame % 30 == 0);
+		return pressed ? GLFW_PRESS : GLFW_RELEASE;
+	});
+	BenchScene.InitScene();
+
+	//the first frames compile shaders and warm up caches, they're left out of the stats
+	const float dt = 1.f / 60.f;
+	const int warmup = std::min(frames / 10, 60);
+	std::map<std::string, std::vector<float>> times;
+	size_t recordedCommands = 0;
+	size_t recordedBytes = 0;
+
+	for (frame = 0; frame < frames; frame++)
+	{
+		SMI_Profiler::BeginFrame();
+
+		//only this frame's commands are kept, so a long run doesn't pile them up
+		if (recorder != nullptr) {
+			if (frame == settings.CaptureFrame)
+				recorder->RequestCapture();
+			recorder->BeginFrame();
+		}
+		if (frame == warmup && nullDevice != nullptr)
+			nullDevice->ResetCounters();
+
+		BenchScene.Update(dt);
+		if (render)
+		{
+			IRenderDevice::Get()->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			BenchScene.Render();
+			BenchScene.PostRender();
+		}
+
+		SMI_Profiler::EndFrame();
+		if (render && nullDevice == nullptr)
+			glfwSwapBuffers(window);
+
+		if (frame < warmup)
+			continue;
+
+		if (recorder != nullptr) {
+			recordedCommands += recorder->GetFrame().Commands.size();
+			recordedBytes += recorder->GetFrame().GetByteSize();
+		}
+
+		times["Frame"].push_back(SMI_Profiler::getFrameTrack().getLast());
+		for (const SMI_ProfileTrack& track : SMI_Profiler::getTracks())
+			times[(track.IsGpu ? "GPU " : "") + std::string(track.Name)].push_back(track.getLast());
+	}
+
+	nlohmann::json systems;
+	for (const auto& pair : times)
+		systems[pair.first] = SummarizeTimes(pair.second);
+
+	//the player ends up in the same spot every run unless the simulation changed
+	glm::vec3 playerPos = BenchScene.getPlayerPosition();
+	const int measured = std::max(frames - warmup, 1);
+	nlohmann::json result = {
+		{"frames", frames},
+		{"warmup_frames", warmup},
+		{"dt", dt},
+		{"render", render},
+		{"device", nullDevice != nullptr ? "null" : "gl"},
+		{"gl_renderer", nullDevice != nullptr ? "none" : reinterpret_cast<const char*>(glGetString(GL_RENDERER))},
+		{"final_player_pos", { playerPos.x, playerPos.y, playerPos.z }},
+		{"systems", systems}
+	};
+	if (nullDevice != nullptr) {
+		result["draws_per_frame"] = (float)nullDevice->GetDrawCount() / measured;
+		result["device_calls_per_frame"] = (float)nullDevice->GetTotalCallCount() / measured;
+		result["device_errors"] = nullDevice->GetErrorCount();
+		nullDevice->LogStats();
+	}
+	if (recorder != nullptr) {
+		result["recorded_commands_per_frame"] = (float)recordedCommands / measured;
+		result["recorded_bytes_per_frame"] = (float)recordedBytes / measured;
+
+		//the last frame doesn't get another BeginFrame to end its capture
+		recorder->FinishCapture();
+		if (recorder->HasCapture()) {
+			FrameCapture capture = recorder->TakeCapture();
+			capture.Width = windowSize.x;
+			capture.Height = windowSize.y;
+			if (capture.Save(settings.CaptureFile)) {
+				LOG_INFO("Captured frame {} to {}", settings.CaptureFrame, settings.CaptureFile);
+				result["capture_file"] = settings.CaptureFile;
+			}
+		}
+	}
+
+	WriteBenchResult(result, settings.OutFile);
+
+	SMI_Profiler::Shutdown();
+}
+
+// Options for RunReplay
+struct ReplaySettings
+{
+	std::string CaptureFile;
+	int Iterations = 500;
+	//replays to the null device, which checks the capture's calls instead of timing them
+	bool NullDevice = false;
+	//where to write the json, empty for stdout only
+	std::string OutFile;
+};
+
+// Loads a captured frame (F5 in --capture mode, or --bench --capture-frame) and renders it over and over in a hidden window,
+// reporting the cpu time to issue it and the gpu time to draw it as json. None of the game runs, so unlike --bench
+// the numbers only move when the renderer, the shaders or the driver change. Returns false if the capture couldn't be
+// replayed, or (on the null device) if any of its calls were invalid
+bool RunReplay(const ReplaySettings& settings)
+{
+	FrameCapture capture;
+	if (!capture.Load(settings.CaptureFile))
+		return false;
+
+	NullRenderDevice::Sptr nullDevice = nullptr;
+	if (settings.NullDevice) {
+		nullDevice = NullRenderDevice::Create();
+		IRenderDevice::Set(nullDevice);
+	}
+	else {
+		//same size as the captured frame, so the fill cost matches
+		if (capture.Width > 0 && capture.Height > 0)
+			windowSize = glm::ivec2(capture.Width, capture.Height);
+		if (!initGLFW(false) || !initGLAD())
+			return false;
+		glfwSwapInterval(0);
+		glViewport(0, 0, windowSize.x, windowSize.y);
+	}
+
+	FrameReplayer replayer = FrameReplayer(capture, IRenderDevice::Get());
+	replayer.Setup();
+	if (nullDevice != nullptr)
+		nullDevice->ResetCounters();
+
+	GLuint query = 0;
+	if (nullDevice == nullptr)
+		glGenQueries(1, &query);
+
+	//the first iterations let the driver finish the setup's uploads and compile its shaders, they're left out of the stats
+	const int iterations = std::max(settings.Iterations, 1);
+	const int warmup = std::min(iterations / 10, 30);
+	std::vector<float> cpuTimes;
+	std::vector<float> gpuTimes;
+	for (int i = 0; i < warmup + iterations; i++)
+	{
+		if (query != 0)
+			glBeginQuery(GL_TIME_ELAPSED, query);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		replayer.ReplayFrame();
+		auto end = std::chrono::high_resolution_clock::now();
+
+		if (query != 0)
+		{
+			glEndQuery(GL_TIME_ELAPSED);
+			//waits on the gpu, so one iteration never overlaps the next
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+			if (i >= warmup)
+				gpuTimes.push_back(elapsed / 1000000.f);
+			glfwSwapBuffers(window);
+		}
+
+		if (i >= warmup)
+			cpuTimes.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+	}
+
+	nlohmann::json result = {
+		{"capture", settings.CaptureFile},
+		{"iterations", iterations},
+		{"warmup_iterations", warmup},
+		{"device", nullDevice != nullptr ? "null" : "gl"},
+		{"gl_renderer", nullDevice != nullptr ? "none" : reinterpret_cast<const char*>(glGetString(GL_RENDERER))},
+		{"resolution", { capture.Width, capture.Height }},
+		{"setup_commands", capture.Setup.Commands.size()},
+		{"setup_bytes", capture.Setup.GetByteSize()},
+		{"frame_commands", capture.Frame.Commands.size()},
+		{"frame_bytes", capture.Frame.GetByteSize()},
+		{"skipped_commands", replayer.GetSkippedCount()},
+		{"cpu", SummarizeTimes(cpuTimes)}
+	};
+	if (!gpuTimes.empty())
+		result["gpu"] = SummarizeTimes(gpuTimes);
+	if (nullDevice != nullptr) {
+		result["draws_per_frame"] = (float)nullDevice->GetDrawCount() / (warmup + iterations);
+		result["device_errors"] = nullDevice->GetErrorCount();
+		nullDevice->LogStats();
+	}
+
+	WriteBenchResult(result, settings.OutFile);
+
+	replayer.Teardown();
+	if (query != 0)
+		glDeleteQueries(1, &query);
+	return nullDevice == nullptr || nullDevice->GetErrorCount() == 0;
+}
+
+// Options for RunMicroBench
+struct MicroBenchSettings
+{
+	SMI_BenchSettings Bench;
+	//where to write the json, empty for stdout only
+	std::string OutFile;
+	//json from an earlier --out to compare against, empty to skip the comparison
+	std::string BaselineFile;
+	//how much slower (0.1 is 10%) a case's median can get before it counts as a regression
+	float Threshold = 0.1f;
+};
+
+// Times the engine's hot paths in isolation (see EngineBenchmarks.h), rendering goes to the null device so the driver
+// stays out of the numbers. Returns false if a case regressed against the baseline
+bool RunMicroBench(const MicroBenchSettings& settings)
+{
+	IRenderDevice::Set(NullRenderDevice::Create());
+
+	SMI_MicroBench bench = SMI_MicroBench(settings.Bench);
+	SMI_RunEngineBenchmarks(bench);
+	WriteBenchResult(bench.ToJson(), settings.OutFile);
+
+	bool passed = true;
+	if (!settings.BaselineFile.empty())
+		passed = bench.CompareBaseline(settings.BaselineFile, settings.Threshold);
+
+	IRenderDevice::Set(nullptr);
+	return passed;
+}
+
+// Reads a whole number of at least minimum from a command line argument, false if the argument isn't one
+bool ParseCount(const char* arg, int& value, int minimum = 1)
+{
+	char* end = nullptr;
+	errno = 0;
+	long result = std::strtol(arg, &end, 10);
+	if (end == arg || *end != '\0' || errno == ERANGE || result < minimum || result > INT_MAX)
+		return false;
+	value = (int)result;
+	return true;
+}
+
+// Reads a number from a command line argument, false if the argument isn't one
+bool ParseFloat(const char* arg, float& value)
+{
+	char* end = nullptr;
+	errno = 0;
+	float result = std::strtof(arg, &end);
+	if (end == arg || *end != '\0' || errno == ERANGE)
+		return false;
+	value = result;
+	return true;
+}
+
+// Reports a bad command line argument along with the mode's usage, returns the exit code
+int ArgumentError(const std::string& arg, const char* usage)
+{
+	LOG_ERROR("Invalid argument '{}', usage: {}", arg, usage);
+	Logger::Uninitialize();
+	return 1;
+}
+
 //main game loop inside here as well as call all needed shaders
-int main()
+int main(int argc, char** argv)
 {
 	Logger::Init(); // We'll borrow the logger from the toolkit, but we need to initialize it
 
+	// --physics-stress [crates] measures physics step time against the thread count instead of running the game
+	if (argc > 1 && std::string(argv[1]) == "--physics-stress") {
+		int crates = 4000;
+		if (argc > 3 || (argc > 2 && !ParseCount(argv[2], crates)))
+			return ArgumentError(argv[argc - 1], "GDW --physics-stress [crates]");
+		RunPhysicsStress(crates);
+		Logger::Uninitialize();
+		return 0;
+	}
+	// --instantiate-bench [count] measures the cost of spawning entities from a prefab
+	if (argc > 1 && std::string(argv[1]) == "--instantiate-bench") {
+		int count = 10000;
+		if (argc > 3 || (argc > 2 && !ParseCount(argv[2], count)))
+			return ArgumentError(argv[argc - 1], "GDW --instantiate-bench [count]");
+		RunInstantiateBench(count);
+		Logger::Uninitialize();
+		return 0;
+	}
+	// --bench [frames] [--no-render] [--null-device] [--record] [--capture-frame n] [--capture-out file] [--out file] runs the game headless with scripted input and reports timings
+	if (argc > 1 && std::string(argv[1]) == "--bench") {
+		const char* usage = "GDW --bench [frames] [--no-render] [--null-device] [--record] [--capture-frame n] [--capture-out file] [--out file]";
+		GameBenchSettings settings;
+		for (int i = 2; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg == "--no-render")
+				settings.Render = false;
+			else if (arg == "--null-device")
+				settings.NullDevice = true;
+			else if (arg == "--record")
+				settings.Record = true;
+			else if (arg == "--capture-frame" && i + 1 < argc) {
+				settings.Record = true;
+				if (!ParseCount(argv[++i], settings.CaptureFrame, 0))
+					return ArgumentError(argv[i], usage);
+			}
+			else if (arg == "--capture-out" && i + 1 < argc)
+				settings.CaptureFile = argv[++i];
+			else if (arg == "--out" && i + 1 < argc)
+				settings.OutFile = argv[++i];
+			else if (!ParseCount(argv[i], settings.Frames))
+				return ArgumentError(arg, usage);
+		}
+		RunGameBench(settings);
+		Logger::Uninitialize();
+		return 0;
+	}
+	// --replay file [iterations] [--null-device] [--out file] renders a captured frame over and over and reports timings
+	if (argc > 1 && std::string(argv[1]) == "--replay") {
+		const char* usage = "GDW --replay file [iterations] [--null-device] [--out file]";
+		if (argc < 3)
+			return ArgumentError(argv[1], usage);
+		ReplaySettings settings;
+		settings.CaptureFile = argv[2];
+		for (int i = 3; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg == "--null-device")
+				settings.NullDevice = true;
+			else if (arg == "--out" && i + 1 < argc)
+				settings.OutFile = argv[++i];
+			else if (!ParseCount(argv[i], settings.Iterations))
+				return ArgumentError(arg, usage);
+		}
+		bool passed = RunReplay(settings);
+		Logger::Uninitialize();
+		return passed ? 0 : 1;
+	}
+	// --microbench [--filter name] [--reps n] [--out file] [--baseline file] [--threshold f] times engine hot paths,
+	// exits with 1 if any of them got slower than the baseline
+	if (argc > 1 && std::string(argv[1]) == "--microbench") {
+		const char* usage = "GDW --microbench [--filter name] [--reps n] [--out file] [--baseline file] [--threshold f]";
+		MicroBenchSettings settings;
+		for (int i = 2; i < argc; i++) {
+			std::string arg = argv[i];
+			//every option takes a value
+			if (i + 1 >= argc)
+				return ArgumentError(arg, usage);
+			if (arg == "--filter")
+				settings.Bench.Filter = argv[++i];
+			else if (arg == "--reps") {
+				if (!ParseCount(argv[++i], settings.Bench.Repetitions))
+					return ArgumentError(argv[i], usage);
+			}
+			else if (arg == "--out")
+				settings.OutFile = argv[++i];
+			else if (arg == "--baseline")
+				settings.BaselineFile = argv[++i];
+			else if (arg == "--threshold") {
+				if (!ParseFloat(argv[++i], settings.Threshold))
+					return ArgumentError(argv[i], usage);
+			}
+			else
+				return ArgumentError(arg, usage);
+		}
+		bool passed = RunMicroBench(settings);
+		Logger::Uninitialize();
+		return passed ? 0 : 1;
+	}
+
 	//Initialize GLFW
 	if (!initGLFW())
 		return 1;
@@ -1224,14 +1118,37 @@ int main()
 	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 	glDebugMessageCallback(GlDebugMessage, nullptr);
 
+	initImGui();
+	// After ImGui, so it chains to ImGui's callbacks. It timestamps key and mouse events for the input latency stats
+	TTK::Input::Init(window);
+
 	// Our high-precision timer
 	double lastFrame = glfwGetTime();
 
+	// F2 turns the profiler and its overlay on and off, F4 starts and stops recording a trace
+	int ProfilerState = GLFW_RELEASE;
+	int TraceState = GLFW_RELEASE;
+	const std::string TraceFile = "profile_trace.json";
+
+	// --capture puts a recorder in front of the renderer, F5 then saves the next frame for --replay
+	RecordingRenderDevice::Sptr Recorder = nullptr;
+	int CaptureState = GLFW_RELEASE;
+	int CaptureCount = 0;
+	if (argc > 1 && std::string(argv[1]) == "--capture") {
+		Recorder = RecordingRenderDevice::Create(std::make_shared<GLRenderDevice>());
+		//only the captured frame's commands are kept
+		Recorder->SetRecording(false);
+		IRenderDevice::Set(Recorder);
+	}
+
 	GameScene MainScene = GameScene();
 	MainScene.InitScene();
 
 	///// Game loop /////
 	while (!glfwWindowShouldClose(window)) {
+		SMI_Profiler::BeginFrame();
+		if (Recorder != nullptr)
+			Recorder->BeginFrame();
 
 		glfwPollEvents();
 
@@ -1240,16 +1157,87 @@ int main()
 		float dt = static_cast<float>(thisFrame - lastFrame);
 
 		// Clear the color and depth buffers
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		IRenderDevice::Get()->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		MainScene.Update(dt);
 
 		MainScene.Render();
 
+		MainScene.PostRender();
+
+		if ((glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS) && ProfilerState == GLFW_RELEASE)
+			SMI_Profiler::setEnabled(!SMI_Profiler::getEnabled());
+		ProfilerState = glfwGetKey(window, GLFW_KEY_F2);
+
+		if ((glfwGetKey(window, GLFW_KEY_F4) == GLFW_PRESS) && TraceState == GLFW_RELEASE)
+		{
+			if (SMI_Profiler::getRecording())
+			{
+				SMI_Profiler::setRecording(false);
+				SMI_Profiler::ExportTrace(TraceFile);
+			}
+			else
+			{
+				SMI_Profiler::setEnabled(true);
+				SMI_Profiler::ClearTrace();
+				SMI_Profiler::setRecording(true);
+			}
+		}
+		TraceState = glfwGetKey(window, GLFW_KEY_F4);
+
+		if (Recorder != nullptr)
+		{
+			if ((glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS) && CaptureState == GLFW_RELEASE)
+				Recorder->RequestCapture();
+			CaptureState = glfwGetKey(window, GLFW_KEY_F5);
+
+			//a capture is done the frame after it was taken
+			if (Recorder->HasCapture())
+			{
+				FrameCapture capture = Recorder->TakeCapture();
+				capture.Width = windowSize.x;
+				capture.Height = windowSize.y;
+				std::string captureFile = "frame_capture_" + std::to_string(CaptureCount++) + ".smicap";
+				if (capture.Save(captureFile))
+					LOG_INFO("Captured a frame ({} commands) to {}", capture.Frame.Commands.size(), captureFile);
+			}
+		}
+
+		if (SMI_Profiler::getEnabled())
+		{
+			ImGui_ImplOpenGL3_NewFrame();
+			ImGui_ImplGlfw_NewFrame();
+			ImGui::NewFrame();
+			SMI_Profiler::DrawOverlay();
+			ImGui::Render();
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			//ImGui sets up (and restores) GL state behind the cache's back
+			nou::GLState::Invalidate();
+		}
+
+		SMI_Profiler::EndFrame();
+		nou::GLState::EndFrame();
+
 		lastFrame = thisFrame;
 		glfwSwapBuffers(window);
+
+		// The frame is handed off to be shown here, so this is as close as we get to input-to-screen time
+		uint64_t presented = glfwGetTimerValue();
+		for (uint64_t eventTicks : TTK::Input::GetFrameEventTimes())
+			SMI_Profiler::RecordInputLatency((float)((presented - eventTicks) * 1000.0 / glfwGetTimerFrequency()));
+		TTK::Input::Poll();
 	}
 
+	//a trace that's still recording when the window closes is written out too
+	if (SMI_Profiler::getRecording())
+		SMI_Profiler::ExportTrace(TraceFile);
+
+	MainScene.LogStats();
+
+	SMI_Profiler::Shutdown();
+	TTK::Input::Uninitialize();
+	shutdownImGui();
+
 	// Clean up the toolkit logger so we don't leak memory
 	Logger::Uninitialize();
 	return 0;